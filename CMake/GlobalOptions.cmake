@@ -14,6 +14,9 @@ pass_group_declare(GLOBAL)
 pass_option(GLOBAL HEMELB_BUILD_MULTISCALE "Build HemeLB Multiscale functionality" OFF)
 pass_option(GLOBAL HEMELB_BUILD_RBC "Build the resolved red blood cells functionality" OFF)
 pass_option(GLOBAL HEMELB_BUILD_TESTS "Build the tests" ON)
+pass_option(GLOBAL HEMELB_USE_LZ4 "Support geometry files with LZ4-compressed blocks" OFF)
+pass_option(GLOBAL HEMELB_USE_ZSTD "Support geometry files with Zstd-compressed blocks" OFF)
+pass_option(GLOBAL HEMELB_USE_HDF5 "Support property output and checkpoints in HDF5 (needs parallel HDF5)" OFF)
 
 pass_cachevar(GLOBAL HEMELB_DEPENDENCIES_PATH "${HEMELB_ROOT_DIR}/dependencies"
   FILEPATH "Path to find dependency find modules")
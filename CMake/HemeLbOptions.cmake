@@ -18,6 +18,7 @@ pass_option(HEMELB HEMELB_CALLGRIND "Compile unit tests that use callgrind" OFF)
 pass_option(HEMELB HEMELB_USE_KRUEGER_ORDERING "Use Krueger's LB-IBM algorithm reodering" ON)
 pass_option(HEMELB HEMELB_BUILD_DEBUGGER "Build the built in debugger" ON)
 pass_option(HEMELB HEMELB_BUILD_COLLOIDS "Build the colloids option" OFF)
+pass_option(HEMELB HEMELB_BUILD_BENCHMARKS "Build hemelb-bench, which times the LB update for every kernel and wall boundary" OFF)
 # pass_option(HEMELB HEMELB_DEBUGGER_IMPLEMENTATION "Which implementation to use for the debugger" none)
 # mark_as_advanced(HEMELB_DEBUGGER_IMPLEMENTATION)
 pass_option(HEMELB HEMELB_VALIDATE_GEOMETRY "Validate geometry" OFF)
@@ -30,9 +31,12 @@ else()
   set(_default_sse3_flag OFF)
 endif()
 pass_option(HEMELB HEMELB_USE_SSE3 "Use SSE3 intrinsics" ${_default_sse3_flag})
+pass_option(HEMELB HEMELB_USE_SIMD_KERNELS "Collide several bulk sites at once with SIMD versions of the LBGK, TRT and MRT kernels" OFF)
 pass_option(HEMELB HEMELB_USE_VELOCITY_WEIGHTS_FILE "Use Velocity weights file" OFF)
 
 pass_option(HEMELB HEMELB_SEPARATE_CONCERNS "Communicate for each concern separately" OFF)
+pass_option(HEMELB HEMELB_USE_OPENMP "Use OpenMP threads within each MPI process for the lattice site updates" OFF)
+pass_option(HEMELB HEMELB_COMPACT_NEIGHBOUR_INDICES "Store the streaming neighbour table with 32-bit indices (each rank's distribution count must fit)" ON)
 
 if (HEMELB_BUILD_RBC)
   set(_default_kernel GuoForcingLBGK)
@@ -78,6 +82,18 @@ pass_cachevar(HEMELB HEMELB_ALLTOALL_IMPLEMENTATION Separated
 pass_cachevar_choice(HEMELB HEMELB_STENCIL "FourPoint"
   STRING "HemeLB stencil type"
   TwoPoint ThreePoint FourPoint CosineApprox)
+pass_cachevar_choice(HEMELB HEMELB_DISTRIBUTION_LAYOUT "AoS"
+  STRING "Memory layout of the distribution arrays: site-major (AoS) or direction-major (SoA)"
+  AoS SoA)
+pass_cachevar_choice(HEMELB HEMELB_STREAMING_PATTERN "AB"
+  STRING "Streaming scheme: separate pre- and post-streaming arrays (AB) or a single array updated in place (AA)"
+  AB AA)
+pass_cachevar_choice(HEMELB HEMELB_HALO_EXCHANGE "Net"
+  STRING "How the LB distribution halo is exchanged: requests through the Net each step (Net), persistent point-to-point requests (Persistent) or a neighbourhood collective (Neighbour)"
+  Net Persistent Neighbour)
+pass_cachevar_choice(HEMELB HEMELB_SITE_ORDERING "Block"
+  STRING "Order of the local sites within each collision type: as read, by block then site (Block), or along a Morton or Hilbert space-filling curve"
+  Block Morton Hilbert)
 
 #
 # Specify the variables requiring forwarding
@@ -6,6 +6,7 @@
 #ifndef HEMELB_SIMULATIONMASTER_H
 #define HEMELB_SIMULATIONMASTER_H
 #include <memory>
+#include <optional>
 
 #include "lb/Lattices.h"
 #include "lb/lb.hpp"
@@ -23,6 +24,7 @@
 #include "net/phased/StepManager.h"
 #include "net/phased/NetConcern.h"
 #include "geometry/neighbouring/NeighbouringDataManager.h"
+#include "geometry/decomposition/LoadBalancer.h"
 #include "Traits.h"
 
 namespace hemelb
@@ -69,6 +71,11 @@ namespace hemelb
       std::shared_ptr<net::IteratedAction> GetCellController() {
         return cellController;
       }
+      //! Rebalance now, as if this rank had taken the given time
+      void ForceRebalance(double seconds)
+      {
+        Rebalance(seconds);
+      }
 #     endif
     protected:
 
@@ -104,6 +111,26 @@ namespace hemelb
        */
       void LogStabilityReport();
 
+      // Write site weights in proportion to the measured time per
+      // site of each collision type, if the configuration asks.
+      void WriteCalibratedSiteWeights();
+
+      // The site weights the domain was decomposed with.
+      geometry::decomposition::SiteWeights UsedSiteWeights() const;
+
+      // The time this rank has spent computing (rather than
+      // communicating) during the run so far.
+      double ComputeSeconds() const;
+
+      // Check the load balance if it is time to and redecompose the
+      // domain if it has got too bad. Collective.
+      void MaybeRebalance();
+
+      // Redecompose the domain in proportion to the time measured
+      // over the last period and move the simulation onto it.
+      // Collective.
+      void Rebalance(double seconds);
+
       std::shared_ptr<io::PathManager> fileManager;
       reporting::Timers timings;
       std::shared_ptr<reporting::Reporter> reporter;
@@ -130,6 +157,11 @@ namespace hemelb
       std::shared_ptr<net::phased::StepManager> stepManager;
       std::shared_ptr<net::phased::NetConcern> netConcern;
 
+      //! Decides when to rebalance, if the configuration asks for it.
+      std::optional<geometry::decomposition::LoadBalancer> loadBalancer;
+      //! ComputeSeconds() when the balance was last checked.
+      double computeSecondsAtLastCheck = 0.0;
+
       static constexpr LatticeTimeStep FORCE_FLUSH_PERIOD = 1000;
   };
 }
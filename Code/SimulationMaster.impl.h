@@ -9,6 +9,7 @@
 
 #include <map>
 #include <limits>
+#include <numeric>
 #include <cstdlib>
 #include <boost/uuid/uuid_io.hpp>
 
@@ -19,12 +20,18 @@
 #include "io/writers/XdrFileWriter.h"
 #include "util/utilityFunctions.h"
 #include "geometry/Domain.h"
+#include "geometry/GeometryReader.h"
+#include "geometry/decomposition/SiteWeights.h"
 #include "log/Logger.h"
 #include "lb/HFunction.h"
 #include "io/xml.h"
 #include "net/BuildInfo.h"
 #include "net/IOCommunicator.h"
 
+#ifdef HEMELB_BUILD_RBC
+#  include "redblood/CellController.h"
+#endif
+
 #ifdef HEMELB_BUILD_COLLOIDS
 #  include "colloids/BodyForces.h"
 #  include "colloids/BoundaryConditions.h"
@@ -150,8 +157,12 @@ namespace hemelb
   template<class TRAITS>
   void SimulationMaster<TRAITS>::Finalise()
   {
+    // Finish any extraction output still on its way to disk.
+    if (propertyExtractor)
+      propertyExtractor->Flush();
     timings[reporting::Timers::total].Stop();
     timings.Reduce();
+    WriteCalibratedSiteWeights();
     if (IsCurrentProcTheIOProc())
     {
       reporter->FillDictionary();
@@ -165,6 +176,123 @@ namespace hemelb
     log::Logger::Log<log::Info, log::Singleton>("Finish running simulation.");
   }
 
+  template<class TRAITS>
+  void SimulationMaster<TRAITS>::WriteCalibratedSiteWeights()
+  {
+    auto const& path = simConfig->GetMonitoringConfiguration().siteWeightsCalibrationPath;
+    if (!path)
+      return;
+
+    namespace dcmp = geometry::decomposition;
+    // Total the time and sites of each collision type over all
+    // processes, so the costs don't depend on how they were shared.
+    std::array<double, dcmp::COLLISION_TYPES> seconds;
+    std::array<std::uint64_t, dcmp::COLLISION_TYPES> sites;
+    for (unsigned i = 0; i < dcmp::COLLISION_TYPES; ++i)
+    {
+      seconds[i] = timings.Means()[reporting::Timers::CollisionTypeTimer(i)] * ioComms.Size();
+      sites[i] = domainData->GetMidDomainCollisionCount(i) + domainData->GetDomainEdgeCollisionCount(i);
+    }
+    ioComms.AllReduceInPlace(std::span<std::uint64_t>(sites), MPI_SUM);
+
+    // Types with no sites keep the weights used for this run.
+    auto const weights = dcmp::CalibrateSiteWeights(seconds, sites, UsedSiteWeights());
+    if (IsCurrentProcTheIOProc())
+    {
+      dcmp::WriteSiteWeights(*path, weights);
+      log::Logger::Log<log::Info, log::Singleton>(
+          "Wrote site weights %d %d %d %d %d %d (bulk, wall, inlet, outlet, inlet/wall, outlet/wall) to %s",
+          weights[0], weights[1], weights[2], weights[3], weights[4], weights[5], path->c_str()
+      );
+    }
+  }
+
+  template<class TRAITS>
+  geometry::decomposition::SiteWeights SimulationMaster<TRAITS>::UsedSiteWeights() const
+  {
+    auto const& weightsPath = simConfig->GetSiteWeightsPath();
+    return weightsPath ? geometry::decomposition::ReadSiteWeights(*weightsPath)
+        : geometry::decomposition::DefaultSiteWeights();
+  }
+
+  template<class TRAITS>
+  double SimulationMaster<TRAITS>::ComputeSeconds() const
+  {
+    using T = reporting::Timers;
+    double ans = 0.0;
+    for (auto t: {T::lb_calc, T::computeNodeDistributions, T::computeAndPostVelocities,
+                  T::updateDNC, T::computeAndPostForces, T::updateCellAndWallInteractions,
+                  T::cellRemoval})
+      ans += timings[t].Get();
+    return ans;
+  }
+
+  template<class TRAITS>
+  void SimulationMaster<TRAITS>::MaybeRebalance()
+  {
+    if (!loadBalancer || simulationState->IsTerminating()
+        || simulationState->GetTimeStep() > simulationState->GetTotalTimeSteps())
+      return;
+    if (simulationState->GetTimeStep() % simConfig->GetRebalanceConfig()->period != 0)
+      return;
+
+    // Time spent waiting for other ranks is the symptom, so only
+    // count the time spent computing.
+    auto const total = ComputeSeconds();
+    auto const seconds = total - computeSecondsAtLastCheck;
+    computeSecondsAtLastCheck = total;
+
+    auto const imbalance = geometry::decomposition::MeasuredImbalance(seconds, ioComms);
+    log::Logger::Log<log::Info, log::Singleton>("time step %i, load imbalance %.1f%%",
+                                                simulationState->GetTimeStep(), 100.0 * imbalance);
+    if (loadBalancer->ShouldRebalance(imbalance))
+      Rebalance(seconds);
+  }
+
+  template<class TRAITS>
+  void SimulationMaster<TRAITS>::Rebalance(double seconds)
+  {
+    namespace dcmp = geometry::decomposition;
+    timings[reporting::Timers::rebalance].Start();
+    auto const& conf = *simConfig->GetRebalanceConfig();
+
+    // Model the cost of each site, then scale that so each rank's
+    // total matches the time it took.
+    std::vector<site_t> vertices;
+#ifdef HEMELB_BUILD_RBC
+    if (auto c = std::dynamic_pointer_cast<redblood::CellController<Traits>>(cellController))
+      vertices = c->CountVerticesPerSite();
+#endif
+    auto const costs = dcmp::ModelSiteCosts(*domainData, UsedSiteWeights(), vertices, conf.cellVertexWeight);
+    auto const factor = dcmp::MeasuredLoadFactor(seconds, std::reduce(costs.begin(), costs.end()), ioComms);
+
+    // Move as few sites as will do until the next check.
+    auto const newRanks = dcmp::RepartitionSites(*domainData, dcmp::LoadWeights(costs, factor),
+                                                 double(conf.period), ioComms);
+    geometry::MovesMap departing;
+    geometry::GeometryReader reader(latticeType::GetLatticeInfo(), timings, ioComms);
+    auto geometry = reader.Redecompose(*domainData, newRanks, departing);
+
+    // Keep the old fields and cells until their state is moved over.
+    auto const oldFieldData = fieldData;
+    auto const oldCellController = cellController;
+    configuration::SimBuilder(*simConfig).Rebuild(*this, geometry);
+
+    dcmp::MigrateDistributions(*oldFieldData, departing, *fieldData, ioComms);
+#ifdef HEMELB_BUILD_RBC
+    if (auto c = std::dynamic_pointer_cast<redblood::CellController<Traits>>(oldCellController))
+      c->HandOverCells(*std::dynamic_pointer_cast<redblood::CellController<Traits>>(cellController));
+#endif
+
+    std::uint64_t moved = 0;
+    for (auto const& [_, sites]: departing)
+      moved += sites.size();
+    moved = ioComms.AllReduce(moved, MPI_SUM);
+    log::Logger::Log<log::Info, log::Singleton>("time step %i, rebalanced the domain, moving %lu sites",
+                                                simulationState->GetTimeStep(), moved);
+    timings[reporting::Timers::rebalance].Stop();
+  }
+
   template<class TRAITS>
   void SimulationMaster<TRAITS>::DoTimeStep()
   {
@@ -217,6 +345,7 @@ namespace hemelb
 
     fieldData->SwapOldAndNew();
     simulationState->Increment();
+    MaybeRebalance();
   }
 
   template<class TRAITS>
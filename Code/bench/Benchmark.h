@@ -0,0 +1,121 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_BENCH_BENCHMARK_H
+#define HEMELB_BENCH_BENCHMARK_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "Traits.h"
+#include "bench/SyntheticGeometry.h"
+#include "geometry/FieldData.h"
+#include "lb/lb.hpp"
+#include "net/phased/NetConcern.h"
+#include "net/phased/StepManager.h"
+#include "util/utilityFunctions.h"
+
+namespace hemelb::bench
+{
+    struct Options
+    {
+        site_t size = 32;
+        unsigned warmupSteps = 10;
+        unsigned steps = 200;
+    };
+
+    //! One timed run, on this rank only.
+    struct Result
+    {
+        std::string geometry;
+        std::string lattice;
+        std::string kernel;
+        std::string wall;
+        site_t sites;
+        double seconds;
+        //! Lower bound on the memory traffic of a site update: each
+        //! distribution read and written once, and its streaming index read.
+        double bytesPerSite;
+    };
+
+    using ResultSink = std::function<void(Result const&)>;
+
+    // The kernels and wall streamers benchmarked, named as in HEMELB_KERNEL and
+    // HEMELB_WALL_BOUNDARY.
+    template <lb::lattice_type L>
+    struct MRTBasisFor;
+    template <>
+    struct MRTBasisFor<lb::D3Q15> { using type = lb::DHumieresD3Q15MRTBasis; };
+    template <>
+    struct MRTBasisFor<lb::D3Q19> { using type = lb::DHumieresD3Q19MRTBasis; };
+
+    template <lb::lattice_type L>
+    using MRTKernel = lb::MRT<typename MRTBasisFor<L>::type>;
+    template <lb::lattice_type L>
+    using NNCYKernel = lb::LBGKNN<lb::CarreauYasudaRheologyModelHumanFit, L>;
+
+    template <typename C>
+    using SBBWall = lb::StreamerTypeFactory<lb::BounceBackLink<C>, lb::NullLink<C>>;
+    template <typename C>
+    using BFLWall = lb::StreamerTypeFactory<lb::BouzidiFirdaousLallemandLink<C>, lb::NullLink<C>>;
+    template <typename C>
+    using GZSWall = lb::StreamerTypeFactory<lb::GuoZhengShiLink<C>, lb::NullLink<C>>;
+    template <typename C>
+    using JunkYangWall = lb::JunkYangFactory<lb::NullLink<C>>;
+
+    // Time steps of the full LBM, through the same step manager as a
+    // simulation, on a domain at rest.
+    template <typename TRAITS>
+    double TimeLbm(std::shared_ptr<geometry::Domain> const& domain,
+                   net::IOCommunicator const& comms, Options const& opts)
+    {
+        using L = typename TRAITS::Lattice;
+        constexpr PhysicalTime TIME_STEP = 1e-4;
+        constexpr PhysicalDistance VOXEL_SIZE = 1e-4;
+
+        geometry::FieldData fieldData(domain);
+        net::Net net(comms);
+        reporting::Timers timings(comms);
+        lb::SimulationState state(TIME_STEP, opts.warmupSteps + opts.steps);
+        util::UnitConverter units(TIME_STEP, VOXEL_SIZE, PhysicalPosition::Zero(),
+                                  DEFAULT_FLUID_DENSITY_Kg_per_m3, 0.0);
+        geometry::neighbouring::NeighbouringDataManager ndm(fieldData, fieldData.GetNeighbouringData(), net);
+        lb::LBM<TRAITS> lbm(lb::LbmParameters(TIME_STEP, VOXEL_SIZE), &net, &fieldData, &state, timings, &ndm);
+        lb::BoundaryValues inlets(geometry::INLET_TYPE, *domain, {}, &state, comms, units);
+        lb::BoundaryValues outlets(geometry::OUTLET_TYPE, *domain, {}, &state, comms, units);
+        lbm.Initialise(&inlets, &outlets);
+
+        for (site_t i = 0; i < domain->GetLocalFluidSiteCount(); ++i)
+            for (Direction d = 0; d < L::NUMVECTORS; ++d)
+                *fieldData.GetFOld<L>(i, d) = L::EQMWEIGHTS[d];
+
+        net::phased::NetConcern netConcern(net);
+        net::phased::StepManager stepManager(2, &timings, net::separate_communications);
+        stepManager.RegisterIteratedActorSteps(lbm, 1);
+        stepManager.RegisterCommsForAllPhases(netConcern);
+        auto step = [&]() {
+            stepManager.CallActions();
+            fieldData.SwapOldAndNew();
+            state.Increment();
+        };
+
+        for (unsigned i = 0; i < opts.warmupSteps; ++i)
+            step();
+        double const start = util::myClock();
+        for (unsigned i = 0; i < opts.steps; ++i)
+            step();
+        return util::myClock() - start;
+    }
+
+    // Run every kernel and wall streamer on the lattice L for the
+    // given shape. Instantiated once per lattice, each in its own
+    // translation unit.
+    template <lb::lattice_type L>
+    void RunLattice(Shape shape, std::string const& latticeName,
+                    net::IOCommunicator const& comms, Options const& opts, ResultSink const& sink);
+}
+
+#endif
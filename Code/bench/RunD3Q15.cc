@@ -0,0 +1,12 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "bench/RunLattice.hpp"
+
+namespace hemelb::bench
+{
+    template void RunLattice<lb::D3Q15>(Shape, std::string const&, net::IOCommunicator const&,
+                                     Options const&, ResultSink const&);
+}
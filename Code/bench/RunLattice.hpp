@@ -0,0 +1,70 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_BENCH_RUNLATTICE_HPP
+#define HEMELB_BENCH_RUNLATTICE_HPP
+
+#include <type_traits>
+
+#include "bench/Benchmark.h"
+
+namespace hemelb::bench
+{
+    namespace detail {
+        template <lb::lattice_type L>
+        struct LatticeRunner
+        {
+            Shape shape;
+            std::string const& latticeName;
+            net::IOCommunicator const& comms;
+            Options const& opts;
+            ResultSink const& sink;
+            std::shared_ptr<geometry::Domain> domain;
+
+            template <template <class> class K, template <class> class W>
+            void Run(std::string const& kernelName, std::string const& wallName) const
+            {
+                using T = Traits<L, K, lb::Normal, lb::DefaultStreamer, W>;
+                double const bytesPerSite =
+                        L::NUMVECTORS * (2.0 * sizeof(distribn_t) + sizeof(geometry::neighbour_index_t));
+                auto const seconds = TimeLbm<T>(domain, comms, opts);
+                sink(Result{ToString(shape), latticeName, kernelName, wallName,
+                            domain->GetLocalFluidSiteCount(), seconds, bytesPerSite});
+            }
+
+            template <template <class> class K>
+            void RunWalls(std::string const& kernelName) const
+            {
+                Run<K, SBBWall>(kernelName, "SIMPLEBOUNCEBACK");
+                Run<K, BFLWall>(kernelName, "BFL");
+                // These read their neighbours' pre-streaming values, which
+                // single-buffer streaming overwrites.
+                if constexpr (!geometry::SINGLE_BUFFER_STREAMING) {
+                    // GZS collides a made-up site beyond the wall, which
+                    // has no index for the entropic kernels' per-site state.
+                    if constexpr (!std::is_same_v<K<L>, lb::EntropicAnsumali<L>>)
+                        Run<K, GZSWall>(kernelName, "GZS");
+                    Run<K, JunkYangWall>(kernelName, "JUNKYANG");
+                }
+            }
+        };
+    }
+
+    template <lb::lattice_type L>
+    void RunLattice(Shape shape, std::string const& latticeName,
+                    net::IOCommunicator const& comms, Options const& opts, ResultSink const& sink)
+    {
+        detail::LatticeRunner<L> const runner{shape, latticeName, comms, opts, sink,
+                                              MakeDomain(shape, opts.size, L::GetLatticeInfo(), comms)};
+        runner.template RunWalls<lb::LBGK>("LBGK");
+        runner.template RunWalls<lb::TRT>("TRT");
+        if constexpr (requires { typename MRTBasisFor<L>::type; })
+            runner.template RunWalls<MRTKernel>("MRT");
+        runner.template RunWalls<NNCYKernel>("NNCY");
+        runner.template RunWalls<lb::EntropicAnsumali>("EntropicAnsumali");
+    }
+}
+
+#endif
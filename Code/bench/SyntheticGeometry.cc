@@ -0,0 +1,136 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "bench/SyntheticGeometry.h"
+
+#include <random>
+
+#include "Exception.h"
+#include "geometry/GmyReadResult.h"
+#include "geometry/LookupTree.h"
+#include "io/formats/geometry.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb::bench
+{
+    namespace {
+        // The same as the usual geometry files
+        constexpr U16 BLOCK_SIZE = 8;
+        // Fraction of a porous medium that is solid
+        constexpr double SOLID_FRACTION = 0.3;
+
+        using Coord = util::Vector3D<site_t>;
+    }
+
+    std::string ToString(Shape s) {
+        switch (s) {
+            case Shape::Cube:
+                return "cube";
+            case Shape::Cylinder:
+                return "cylinder";
+            case Shape::FourCube:
+                return "fourcube";
+            case Shape::Porous:
+                return "porous";
+        }
+        throw (Exception() << "Unknown shape");
+    }
+
+    std::shared_ptr<geometry::Domain> MakeDomain(Shape shape, site_t size,
+                                                 lb::LatticeInfo const& lattice,
+                                                 net::IOCommunicator const& comms) {
+        using namespace geometry;
+        if (shape == Shape::FourCube)
+            size = 4;
+
+        // Fluid sites are at 1..size in each direction, so there is
+        // always a layer of solid around them.
+        auto const extent = size + 2;
+        auto const blocksAlong = U16((extent + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        GmyReadResult readResult(Vec16(blocksAlong, blocksAlong, blocksAlong), BLOCK_SIZE);
+
+        std::vector<char> solid(extent * extent * extent, 1);
+        auto flat = [&](Coord const& x) { return (x.x() * extent + x.y()) * extent + x.z(); };
+        auto isFluid = [&](Coord const& x) {
+            return x.IsInRange(Coord::Zero(), Coord(extent - 1)) && !solid[flat(x)];
+        };
+        std::mt19937 rng(42);
+        std::bernoulli_distribution solidSite(SOLID_FRACTION);
+        double const radius = 0.5 * size;
+        for (site_t i = 1; i <= size; ++i)
+            for (site_t j = 1; j <= size; ++j)
+                for (site_t k = 1; k <= size; ++k) {
+                    bool fluid = true;
+                    if (shape == Shape::Cylinder) {
+                        double const dx = i - 0.5 - radius, dy = j - 0.5 - radius;
+                        fluid = dx * dx + dy * dy <= radius * radius;
+                    } else if (shape == Shape::Porous) {
+                        fluid = !solidSite(rng);
+                    }
+                    solid[flat({i, j, k})] = !fluid;
+                }
+
+        auto blockOf = [&](Coord const& x) {
+            return readResult.GetBlockIdFromBlockCoordinates(
+                    U16(x.x() / BLOCK_SIZE), U16(x.y() / BLOCK_SIZE), U16(x.z() / BLOCK_SIZE));
+        };
+        auto forEachFluidSite = [&](auto&& f) {
+            for (site_t i = 0; i < extent; ++i)
+                for (site_t j = 0; j < extent; ++j)
+                    for (site_t k = 0; k < extent; ++k)
+                        if (Coord const x(i, j, k); isFluid(x))
+                            f(x);
+        };
+
+        // Count the fluid sites first, to allocate the blocks' storage.
+        std::vector<site_t> fluidSitesPerBlock(readResult.GetBlockCount(), 0);
+        forEachFluidSite([&](Coord const& x) { ++fluidSitesPerBlock[blockOf(x)]; });
+        auto const linksPerSite = lattice.GetNumVectors() - 1;
+        std::vector<U64> fluidBlocks;
+        std::vector<site_t> linksPerBlock;
+        for (site_t b = 0; b < readResult.GetBlockCount(); ++b) {
+            if (fluidSitesPerBlock[b] > 0) {
+                fluidBlocks.push_back(b);
+                linksPerBlock.push_back(fluidSitesPerBlock[b] * linksPerSite);
+            }
+        }
+        readResult.AllocateBlocks(fluidBlocks, linksPerBlock);
+
+        std::vector<site_t> linksUsed(readResult.GetBlockCount(), 0);
+        forEachFluidSite([&](Coord const& x) {
+            auto const blockId = blockOf(x);
+            auto const block = readResult.Blocks[blockId];
+            auto& site = block.Sites[readResult.GetSiteIdFromSiteCoordinates(
+                    x.x() % BLOCK_SIZE, x.y() % BLOCK_SIZE, x.z() % BLOCK_SIZE)];
+            site.isFluid = true;
+            site.targetProcessor = 0;
+            site.links = block.Links.subspan(linksUsed[blockId], linksPerSite);
+            linksUsed[blockId] += linksPerSite;
+            // Walls halfway along every link to a solid site, with
+            // the normal pointing out of the fluid.
+            util::Vector3D<float> normal = util::Vector3D<float>::Zero();
+            for (Direction d = 1; d < lattice.GetNumVectors(); ++d) {
+                auto const& c = lattice.GetVector(d);
+                if (!isFluid(x + c.as<site_t>())) {
+                    site.links[d - 1].type = io::formats::geometry::CutType::WALL;
+                    site.links[d - 1].distanceToIntersection = 0.5;
+                    normal += c.as<float>();
+                }
+            }
+            if (normal != util::Vector3D<float>::Zero()) {
+                site.wallNormalAvailable = true;
+                site.wallNormal = normal.Normalise();
+            }
+        });
+
+        auto tree = octree::build_block_tree(readResult.GetBlockDimensions(), fluidSitesPerBlock);
+        // All the blocks are on rank zero.
+        std::vector<U64> firstBlockOfRank(comms.Size() + 1, tree.levels.back().node_ids.size());
+        firstBlockOfRank[0] = 0;
+        readResult.block_store = std::make_unique<octree::DistributedStore>(
+                readResult.GetSitesPerBlock(), std::move(tree), std::move(firstBlockOfRank), comms);
+        return std::make_shared<Domain>(lattice, readResult, comms);
+    }
+}
@@ -0,0 +1,38 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_BENCH_SYNTHETICGEOMETRY_H
+#define HEMELB_BENCH_SYNTHETICGEOMETRY_H
+
+#include <memory>
+#include <string>
+
+#include "units.h"
+#include "geometry/Domain.h"
+
+namespace hemelb::net { class IOCommunicator; }
+
+namespace hemelb::bench
+{
+    // Shapes that can be made in memory, without a geometry file.
+    // All the boundaries are walls: there are no iolets.
+    enum class Shape
+    {
+        Cube, //! A size^3 box of fluid
+        Cylinder, //! A tube of diameter and length size, along z
+        FourCube, //! The 4^3 box of the unit tests' four cube, regardless of size
+        Porous //! A size^3 box with 30% of the sites randomly (but reproducibly) solid
+    };
+
+    std::string ToString(Shape s);
+
+    // Build a domain of the given shape with every site on the one rank
+    // of comms, with links for the lattice given.
+    std::shared_ptr<geometry::Domain> MakeDomain(Shape shape, site_t size,
+                                                 lb::LatticeInfo const& lattice,
+                                                 net::IOCommunicator const& comms);
+}
+
+#endif
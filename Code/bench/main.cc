@@ -0,0 +1,192 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+// hemelb-bench: times the LB update of every kernel and wall streamer
+// on synthetic geometries, for each lattice, with the layout and
+// streaming pattern this was built with.
+//
+// Every MPI process runs the same benchmarks independently on its own
+// copy of the geometry (there is no halo), so running one process per
+// core measures a node at full load. The update rates are summed over
+// processes and compared with the memory bandwidth measured by a STREAM
+// triad, run by all processes at once.
+//
+// Usage: hemelb-bench [-size N] [-steps N] [-warmup N] [-shape NAME]... [-out FILE]
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "build_info.h"
+#include "Exception.h"
+#include "bench/Benchmark.h"
+#include "log/Logger.h"
+#include "net/mpi.h"
+#include "net/IOCommunicator.h"
+#include "util/utilityFunctions.h"
+
+namespace hemelb::bench
+{
+    namespace {
+        struct Arguments
+        {
+            Options opts;
+            std::vector<Shape> shapes;
+            std::string output = "hemelb-bench.json";
+        };
+
+        Shape ParseShape(std::string const& name)
+        {
+            for (auto s: {Shape::Cube, Shape::Cylinder, Shape::FourCube, Shape::Porous})
+                if (ToString(s) == name)
+                    return s;
+            throw (Exception() << "Unknown shape '" << name << "'");
+        }
+
+        Arguments ParseArguments(int argc, char* argv[])
+        {
+            Arguments ans;
+            for (int i = 1; i < argc; ++i) {
+                std::string const flag = argv[i];
+                if (i + 1 == argc)
+                    throw (Exception() << "Missing value for " << flag);
+                std::string const value = argv[++i];
+                if (flag == "-size") {
+                    ans.opts.size = std::stol(value);
+                } else if (flag == "-steps") {
+                    ans.opts.steps = std::stoul(value);
+                } else if (flag == "-warmup") {
+                    ans.opts.warmupSteps = std::stoul(value);
+                } else if (flag == "-shape") {
+                    ans.shapes.push_back(ParseShape(value));
+                } else if (flag == "-out") {
+                    ans.output = value;
+                } else {
+                    throw (Exception() << "Unknown option " << flag
+                           << "; usage: hemelb-bench [-size N] [-steps N] [-warmup N] [-shape NAME]... [-out FILE]");
+                }
+            }
+            if (ans.shapes.empty())
+                ans.shapes = {Shape::Cube, Shape::Cylinder, Shape::FourCube, Shape::Porous};
+            return ans;
+        }
+
+        // Sustained memory bandwidth, in bytes per second, of the triad
+        // a[i] = b[i] + s * c[i] run by every process at once, summed
+        // over processes: the best of several repeats.
+        double StreamTriadBandwidth(net::MpiCommunicator const& world)
+        {
+            // Large enough to defeat the caches
+            constexpr std::size_t N = 1 << 23;
+            constexpr int REPEATS = 5;
+            std::vector<double> a(N, 0.0), b(N, 1.0), c(N, 2.0);
+            double best = 0.0;
+            for (int r = 0; r < REPEATS; ++r) {
+                world.Barrier();
+                double const start = util::myClock();
+                for (std::size_t i = 0; i < N; ++i)
+                    a[i] = b[i] + 3.0 * c[i];
+                double const seconds = util::myClock() - start;
+                // The slowest process sets the pace for the node.
+                double const slowest = world.AllReduce(seconds, MPI_MAX);
+                best = std::max(best, 3.0 * sizeof(double) * N * world.Size() / slowest);
+            }
+            // Stop the compiler discarding the loop
+            if (a[N / 2] != 7.0)
+                throw (Exception() << "STREAM triad gave the wrong answer");
+            return best;
+        }
+
+        void WriteJson(std::ostream& out, std::vector<Result> const& results,
+                       std::vector<double> const& mlups, double bandwidth,
+                       Arguments const& args, int nProcs)
+        {
+            out << "{\n"
+                << "  \"build\": {\n"
+                << "    \"revision\": \"" << build_info::REVISION_HASH.c_str() << "\",\n"
+                << "    \"build_type\": \"" << build_info::BUILD_TYPE.c_str() << "\",\n"
+                << "    \"distribution_layout\": \"" << build_info::DISTRIBUTION_LAYOUT.c_str() << "\",\n"
+                << "    \"streaming_pattern\": \"" << build_info::STREAMING_PATTERN.c_str() << "\",\n"
+                << "    \"simd_kernels\": " << (build_info::USE_SIMD_KERNELS ? "true" : "false") << ",\n"
+                << "    \"compact_neighbour_indices\": "
+                << (build_info::COMPACT_NEIGHBOUR_INDICES ? "true" : "false") << "\n"
+                << "  },\n"
+                << "  \"processes\": " << nProcs << ",\n"
+                << "  \"size\": " << args.opts.size << ",\n"
+                << "  \"steps\": " << args.opts.steps << ",\n"
+                << "  \"stream_triad_GBps\": " << bandwidth / 1e9 << ",\n"
+                << "  \"results\": [";
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                auto const& r = results[i];
+                // The rate at which the measured bandwidth could move
+                // the minimum traffic of a site update.
+                double const rooflineMlups = bandwidth / r.bytesPerSite / 1e6;
+                out << (i ? "," : "") << "\n    {"
+                    << "\"geometry\": \"" << r.geometry << "\", "
+                    << "\"lattice\": \"" << r.lattice << "\", "
+                    << "\"kernel\": \"" << r.kernel << "\", "
+                    << "\"wall\": \"" << r.wall << "\", "
+                    << "\"sites\": " << r.sites << ", "
+                    << "\"mlups\": " << mlups[i] << ", "
+                    << "\"bytes_per_site\": " << r.bytesPerSite << ", "
+                    << "\"roofline_mlups\": " << rooflineMlups << ", "
+                    << "\"roofline_fraction\": " << mlups[i] / rooflineMlups << "}";
+            }
+            out << "\n  ]\n}\n";
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace hemelb;
+  using namespace hemelb::bench;
+  net::MpiEnvironment mpi(argc, argv);
+  log::Logger::Init();
+  try
+  {
+    auto const world = net::MpiCommunicator::World();
+    auto const args = ParseArguments(argc, argv);
+    // Each process on its own
+    net::IOCommunicator const self(world.Split(world.Rank()));
+
+    double const bandwidth = StreamTriadBandwidth(world);
+
+    std::vector<Result> results;
+    std::vector<double> mlups;
+    ResultSink const sink = [&](Result const& r) {
+      // Keep the processes in step, so that they all share the memory
+      // bandwidth during each benchmark.
+      auto const total = world.Reduce(r.sites * args.opts.steps / r.seconds, MPI_SUM, 0);
+      world.Barrier();
+      results.push_back(r);
+      mlups.push_back(total / 1e6);
+      if (world.Rank() == 0)
+        log::Logger::Log<log::Info, log::Singleton>("%s %s %s %s: %.1f MLUPS",
+                                                    r.geometry.c_str(), r.lattice.c_str(),
+                                                    r.kernel.c_str(), r.wall.c_str(), total / 1e6);
+    };
+
+    for (auto shape: args.shapes) {
+      RunLattice<lb::D3Q15>(shape, "D3Q15", self, args.opts, sink);
+      RunLattice<lb::D3Q19>(shape, "D3Q19", self, args.opts, sink);
+      RunLattice<lb::D3Q27>(shape, "D3Q27", self, args.opts, sink);
+    }
+
+    if (world.Rank() == 0) {
+      std::ofstream out(args.output);
+      WriteJson(out, results, mlups, bandwidth, args, world.Size());
+      if (!out)
+        throw (Exception() << "Could not write " << args.output);
+    }
+  }
+  catch (std::exception& e)
+  {
+    log::Logger::Log<log::Critical, log::OnePerCore>(e.what());
+    mpi.Abort(-1);
+  }
+}
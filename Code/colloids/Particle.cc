@@ -99,9 +99,13 @@ namespace hemelb::colloids
     {
       // first, update the position: newPosition = oldPosition + velocity + bodyForces * drag
       // then,  update the owner rank for the particle based on its new position
+      SetOwnerFromSite(latDatLBM.GetProcIdFromGlobalCoords(Move()));
+    }
 
+    util::Vector3D<site_t> Particle::Move()
+    {
       if (log::Logger::ShouldDisplay<log::Trace>())
-        log::Logger::Log<log::Trace, log::OnePerCore>("In colloids::Particle::UpdatePosition, id: %i,\nposition: {%g,%g,%g}\nvelocity: {%g,%g,%g}\nbodyForces: {%g,%g,%g}\n",
+        log::Logger::Log<log::Trace, log::OnePerCore>("In colloids::Particle::Move, id: %i,\nposition: {%g,%g,%g}\nvelocity: {%g,%g,%g}\nbodyForces: {%g,%g,%g}\n",
                                                       particleId,
                                                       globalPosition.x(),
                                                       globalPosition.y(),
@@ -115,14 +119,19 @@ namespace hemelb::colloids
 
       globalPosition += GetVelocity();
 
+      if (log::Logger::ShouldDisplay<log::Trace>())
+        log::Logger::Log<log::Trace, log::OnePerCore>("In colloids::Particle::Move, id: %i, position is now: {%g,%g,%g}\n",
+                                                      particleId,
+                                                      globalPosition.x(),
+                                                      globalPosition.y(),
+                                                      globalPosition.z());
+
       // round the global position of the particle to the nearest site coordinates
-      auto const siteGlobalPosition = (globalPosition + util::Vector3D{0.5, 0.5, 0.5}).as<site_t>();
-//      const util::Vector3D<site_t> siteGlobalPosition((site_t) (0.5 + globalPosition.x),
-//                                                      (site_t) (0.5 + globalPosition.y),
-//                                                      (site_t) (0.5 + globalPosition.z));
+      return (globalPosition + util::Vector3D{0.5, 0.5, 0.5}).as<site_t>();
+    }
 
-      // convert the site coordinates into a local site index and find owner rank
-      proc_t procId = latDatLBM.GetProcIdFromGlobalCoords(siteGlobalPosition);
+    void Particle::SetOwnerFromSite(proc_t procId)
+    {
       isValid = (procId != SITE_OR_BLOCK_SOLID);
       if (isValid && (ownerRank != procId))
       {
@@ -135,13 +144,6 @@ namespace hemelb::colloids
                                                         "INVALID");
         ownerRank = procId;
       }
-
-      if (log::Logger::ShouldDisplay<log::Trace>())
-        log::Logger::Log<log::Trace, log::OnePerCore>("In colloids::Particle::UpdatePosition, id: %i, position is now: {%g,%g,%g}\n",
-                                                      particleId,
-                                                      globalPosition.x(),
-                                                      globalPosition.y(),
-                                                      globalPosition.z());
     }
 
     Dimensionless Particle::GetViscosity() const
@@ -151,6 +151,14 @@ namespace hemelb
         /** updates the position of this particle using body forces and fluid velocity */
         void UpdatePosition(const geometry::Domain& latDatLBM);
 
+        /** moves this particle using body forces and fluid velocity, returning the
+         *  coordinates of the nearest lattice site, whose owner must then be given
+         *  to SetOwnerFromSite */
+        [[nodiscard]] util::Vector3D<site_t> Move();
+
+        /** sets the owner rank from that of the site nearest this particle */
+        void SetOwnerFromSite(proc_t procId);
+
         /** calculates the effects of all body forces on this particle */
         void CalculateBodyForces();
 
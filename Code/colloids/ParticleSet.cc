@@ -189,13 +189,21 @@ namespace hemelb
 
       // only update the position for particles that are locally owned because
       // only the owner has velocity contributions from all neighbouring ranks
-      for (std::vector<Particle>::iterator iter = particles.begin(); iter != particles.end();
-          iter++)
+      std::vector<Particle*> moved;
+      std::vector<util::Vector3D<site_t>> sites;
+      for (Particle& particle : particles)
       {
-        Particle& particle = *iter;
         if (particle.GetOwnerRank() == localRank)
-          particle.UpdatePosition(latDatLBM);
+        {
+          sites.push_back(particle.Move());
+          moved.push_back(&particle);
+        }
       }
+
+      // find the new owners all at once, rather than one lookup per particle
+      auto const owners = latDatLBM.GetRankIndexFromGlobalCoords(sites);
+      for (std::size_t i = 0; i < moved.size(); ++i)
+        moved[i]->SetOwnerFromSite(owners[i][0]);
     }
 
     const void ParticleSet::CalculateBodyForces()
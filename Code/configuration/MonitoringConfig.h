@@ -6,6 +6,9 @@
 #ifndef HEMELB_CONFIGURATION_MONITORINGCONFIG_H
 #define HEMELB_CONFIGURATION_MONITORINGCONFIG_H
 
+#include <filesystem>
+#include <optional>
+
 /* #include "extraction/GeometrySelectors.h" */
 #include "extraction/PropertyOutputFile.h"
 
@@ -23,6 +26,7 @@ namespace hemelb
       double convergenceRelativeTolerance = 0.0; ///< Convergence check relative tolerance
       bool convergenceTerminate = false; ///< Whether to terminate a converged run or not
       bool doIncompressibilityCheck = false; ///< Whether to turn on the IncompressibilityChecker or not
+      std::optional<std::filesystem::path> siteWeightsCalibrationPath; ///< Where to write site weights measured during the run, if anywhere
     };
   }
 }
@@ -43,7 +43,11 @@ namespace hemelb::configuration {
         geometry::GeometryReader reader(lat_info,
                                         timings,
                                         ioComms);
-        return reader.LoadAndDecompose(config.GetDataFilePath());
+        if (auto const& weightsPath = config.GetSiteWeightsPath())
+            reader.SetSiteWeights(geometry::decomposition::ReadSiteWeights(*weightsPath));
+        reader.SetHierarchicalDecomposition(config.UseHierarchicalDecomposition());
+        reader.SetDistributedHeader(config.UseDistributedHeader());
+        return reader.LoadAndDecompose(config.GetDataFilePath(), config.GetDecompositionCachePath());
     }
 
     lb::LbmParameters SimBuilder::BuildLbmParams() const {
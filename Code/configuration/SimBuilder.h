@@ -73,6 +73,13 @@ namespace hemelb::configuration {
         template <typename T>
         void operator()(T & control) const;
 
+        // Collective. Rebuild the parts of the simulation that depend
+        // on the domain decomposition for a new one, keeping the
+        // simulation state and extraction files. The caller must then
+        // fill in the distributions.
+        template <typename T>
+        void Rebuild(T & control, geometry::GmyReadResult& geometry) const;
+
         // The below could probably be protected/private, but handy for testing.
         [[nodiscard]] std::shared_ptr<lb::SimulationState> BuildSimulationState() const;
         [[nodiscard]] geometry::GmyReadResult ReadGmy(
@@ -109,22 +116,53 @@ namespace hemelb::configuration {
                 io::PathManager const& fileManager,
                 std::vector<reporting::Reportable*> const & reps
         ) const;
+
+    private:
+        // Build everything that depends on the domain decomposition,
+        // from the domain up to the step manager.
+        template <typename T>
+        void BuildForGeometry(T & control, geometry::GmyReadResult& geometry, bool rebuilding) const;
     };
 
 
     template <typename T>
     void SimBuilder::operator()(T& control) const {
-        using traitsType = typename T::Traits;
-        using latticeType = typename T::latticeType;
-
         auto& timings = control.timings;
         auto& ioComms = control.ioComms;
-        auto& lat_info = latticeType::GetLatticeInfo();
+        auto& lat_info = T::latticeType::GetLatticeInfo();
 
         control.unitConverter = unit_converter;
 
         control.simulationState = BuildSimulationState();
 
+        timings[reporting::Timers::latDatInitialise].Start();
+        // Use a reader to read in the file.
+        log::Logger::Log<log::Info, log::Singleton>("Loading and decomposing geometry file %s.", config.GetDataFilePath().c_str());
+        auto readGeometryData = ReadGmy(lat_info, timings, ioComms);
+        timings[reporting::Timers::latDatInitialise].Stop();
+
+        BuildForGeometry(control, readGeometryData, false);
+
+        if (auto const& rebalance = config.GetRebalanceConfig())
+            control.loadBalancer.emplace(rebalance->threshold);
+    }
+
+    template <typename T>
+    void SimBuilder::Rebuild(T& control, geometry::GmyReadResult& geometry) const {
+        log::Logger::Log<log::Info, log::Singleton>("Rebuilding the simulation on the new decomposition.");
+        BuildForGeometry(control, geometry, true);
+    }
+
+    template <typename T>
+    void SimBuilder::BuildForGeometry(T& control, geometry::GmyReadResult& readGeometryData,
+                                      bool rebuilding) const {
+        using traitsType = typename T::Traits;
+        using latticeType = typename T::latticeType;
+
+        auto& timings = control.timings;
+        auto& ioComms = control.ioComms;
+        auto& lat_info = latticeType::GetLatticeInfo();
+
         std::vector<reporting::Reportable*> things_to_report({
             &control.build_info, &timings, &*control.simulationState
         });
@@ -136,9 +174,6 @@ namespace hemelb::configuration {
         };
 
         timings[reporting::Timers::latDatInitialise].Start();
-        // Use a reader to read in the file.
-        log::Logger::Log<log::Info, log::Singleton>("Loading and decomposing geometry file %s.", config.GetDataFilePath().c_str());
-        auto readGeometryData = ReadGmy(lat_info, timings, ioComms);
         // Create a new lattice based on that info and return it.
         log::Logger::Log<log::Info, log::Singleton>("Initialising domain.");
         control.domainData = std::make_shared<geometry::Domain>(lat_info,
@@ -146,6 +181,9 @@ namespace hemelb::configuration {
                                                                 ioComms);
         log::Logger::Log<log::Info, log::Singleton>("Initialising field data.");
         control.fieldData = std::make_shared<geometry::FieldData>(control.domainData);
+        // The Domain has what it needs, so free the file's blocks now
+        // rather than carry them through the run.
+        readGeometryData.ReleaseBlocks();
         things_to_report.push_back(control.domainData.get());
         timings[reporting::Timers::latDatInitialise].Stop();
 
@@ -230,8 +268,12 @@ namespace hemelb::configuration {
 
         lbm->Initialise(control.inletValues.get(),
                         control.outletValues.get());
-        auto ic = BuildInitialCondition();
-        lbm->SetInitialConditions(ic, ioComms);
+        // When rebuilding, the distributions are moved over from the
+        // old decomposition instead.
+        if (!rebuilding) {
+            auto ic = BuildInitialCondition();
+            lbm->SetInitialConditions(ic, ioComms);
+        }
         ndm->ShareNeeds();
         ndm->TransferNonFieldDependentInformation();
 
@@ -242,13 +284,19 @@ namespace hemelb::configuration {
                 unit_converter
         );
 
-        control.propertyExtractor = BuildPropertyExtraction(
-                control.fileManager->GetDataExtractionPath(),
-                *control.simulationState,
-                *control.propertyDataSource,
-                timings,
-                ioComms
-        );
+        if (rebuilding) {
+            // Carry on writing the same files.
+            if (control.propertyExtractor)
+                control.propertyExtractor->SetDataSource(*control.propertyDataSource);
+        } else {
+            control.propertyExtractor = BuildPropertyExtraction(
+                    control.fileManager->GetDataExtractionPath(),
+                    *control.simulationState,
+                    *control.propertyDataSource,
+                    timings,
+                    ioComms
+            );
+        }
         maybe_register_actor(control.propertyExtractor, 1);
 
         control.netConcern = std::make_shared<net::phased::NetConcern>(
@@ -74,6 +74,8 @@ namespace hemelb::configuration
       if (topNode.GetChildOrNull("colloids") != io::xml::Element::Missing())
       {
         hasColloidSection = true;
+        if (rebalanceConf)
+          throw Exception() << "Rebalancing during the run is not supported with colloids";
       }
 
       DoIOForInitialConditions(topNode.GetChildOrThrow("initialconditions"));
@@ -177,6 +179,48 @@ namespace hemelb::configuration
       //  <datafile path="relative path to GMY" />
       // </geometry>
       dataFilePath = RelPathToFullPath(geometryEl.GetChildOrThrow("datafile").GetAttributeOrThrow("path"));
+
+      // Optional element
+      // <site_weights path="relative path to weights file" />
+      if (auto weightsEl = geometryEl.GetChildOrNull("site_weights"))
+        siteWeightsPath = RelPathToFullPath(weightsEl.GetAttributeOrThrow("path"));
+
+      // Optional element
+      // <decomposition_cache path="relative path to cache" />
+      // The path is optional and defaults to the GMY's with ".decomp" appended.
+      if (auto cacheEl = geometryEl.GetChildOrNull("decomposition_cache"))
+      {
+        if (auto cachePath = cacheEl.GetAttributeMaybe("path")) {
+          decompositionCachePath = RelPathToFullPath(*cachePath);
+        } else {
+          decompositionCachePath = dataFilePath;
+          *decompositionCachePath += ".decomp";
+        }
+      }
+
+      // Optional element
+      // <hierarchical_decomposition />
+      hierarchicalDecomposition = bool(geometryEl.GetChildOrNull("hierarchical_decomposition"));
+
+      // Optional element
+      // <distributed_header />
+      distributedHeader = bool(geometryEl.GetChildOrNull("distributed_header"));
+
+      // Optional element
+      // <rebalance period="unsigned" threshold="float" cell_vertex_weight="float" />
+      // The threshold defaults to 0.1 and the vertex weight to 1.
+      if (auto rebalanceEl = geometryEl.GetChildOrNull("rebalance"))
+      {
+        rebalanceConf = RebalanceConfig{
+            rebalanceEl.GetAttributeOrThrow<LatticeTimeStep>("period"),
+            rebalanceEl.GetAttributeMaybe<double>("threshold").value_or(0.1),
+            rebalanceEl.GetAttributeMaybe<double>("cell_vertex_weight").value_or(1.0)
+        };
+        if (rebalanceConf->period == 0)
+          throw Exception() << "Rebalancing period must be positive: " << rebalanceEl.GetPath();
+        if (rebalanceConf->threshold <= 0.0)
+          throw Exception() << "Rebalancing threshold must be positive: " << rebalanceEl.GetPath();
+      }
     }
 
     /**
@@ -311,6 +355,9 @@ namespace hemelb::configuration
 	auto file = extraction::PropertyOutputFile{};
 	file.filename = cpEl.GetAttributeOrThrow("file");
 	cpEl.GetAttributeOrThrow("period", file.frequency);
+	file.async_buffers = cpEl.GetAttributeMaybe<unsigned>("async_buffers").value_or(0U);
+	file.ranks_per_writer = cpEl.GetAttributeMaybe<unsigned>("ranks_per_writer").value_or(1U);
+	DoIOForOutputFormat(cpEl, file);
 	// Configure the file
 	file.geometry.reset(new extraction::WholeGeometrySelector());
 	file.ts_mode = extraction::single_timestep_files{};
@@ -327,6 +374,31 @@ namespace hemelb::configuration
       }
     }
 
+    void SimConfig::DoIOForOutputFormat(const io::xml::Element& outputEl, extraction::PropertyOutputFile& file)
+    {
+      namespace xtr = io::formats::extraction;
+      auto&& format = outputEl.GetAttributeMaybe("format").value_or("xtr");
+      if (format == "hdf5") {
+	file.hdf5 = true;
+      } else if (format != "xtr") {
+	throw Exception() << "Invalid value of format attribute '" << format
+			  << "' at: " << outputEl.GetPath();
+      }
+
+      auto const version = outputEl.GetAttributeMaybe<std::uint32_t>("format_version").value_or(xtr::XdrVersionNumber);
+      if (version != xtr::XdrVersionNumber && version != xtr::VersionNumber)
+	throw Exception() << "Invalid value of format_version attribute '" << version
+			  << "' at: " << outputEl.GetPath();
+      file.format_version = version;
+
+      file.compression = outputEl.GetAttributeMaybe<unsigned>("compression").value_or(0U);
+      if (file.compression > 9)
+	throw Exception() << "Invalid value of compression attribute '" << file.compression
+			  << "' (must be 0-9) at: " << outputEl.GetPath();
+      if (file.compression && !file.hdf5)
+	throw Exception() << "The compression attribute needs format=\"hdf5\" at: " << outputEl.GetPath();
+    }
+
     extraction::PropertyOutputFile SimConfig::DoIOForPropertyOutputFile(
         const io::xml::Element& propertyoutputEl)
     {
@@ -358,6 +430,9 @@ namespace hemelb::configuration
       }
 
       propertyoutputEl.GetAttributeOrThrow("period", file.frequency);
+      file.async_buffers = propertyoutputEl.GetAttributeMaybe<unsigned>("async_buffers").value_or(0U);
+      file.ranks_per_writer = propertyoutputEl.GetAttributeMaybe<unsigned>("ranks_per_writer").value_or(1U);
+      DoIOForOutputFormat(propertyoutputEl, file);
 
       io::xml::Element geometryEl = propertyoutputEl.GetChildOrThrow("geometry");
       auto type = geometryEl.GetAttributeOrThrow("type");
@@ -771,6 +846,11 @@ namespace hemelb::configuration
 
       monitoringConfig.doIncompressibilityCheck = (monEl.GetChildOrNull("incompressibility")
           != io::xml::Element::Missing());
+
+      // Optional element
+      // <site_weights_calibration path="relative path to weights file" />
+      if (auto calEl = monEl.GetChildOrNull("site_weights_calibration"))
+        monitoringConfig.siteWeightsCalibrationPath = RelPathToFullPath(calEl.GetAttributeOrThrow("path"));
     }
 
     void SimConfig::DoIOForSteadyFlowConvergence(const io::xml::Element& convEl)
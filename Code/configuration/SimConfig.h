@@ -131,6 +131,14 @@ namespace hemelb::configuration
         FluidInfo fluid;
     };
 
+    // Repartitioning the domain during a run, when the ranks'
+    // compute times have drifted apart.
+    struct RebalanceConfig {
+        LatticeTimeStep period; //! Steps between measurements of the load imbalance
+        double threshold; //! Repartition when the slowest rank's time exceeds the mean by this fraction
+        double cellVertexWeight; //! The cost of a cell vertex, relative to a bulk fluid site
+    };
+
     struct FlowExtensionConfig {
         PhysicalDistance length_m;
         PhysicalDistance radius_m;
@@ -288,6 +296,31 @@ namespace hemelb::configuration
         {
           return dataFilePath;
         }
+        //! The file of site weights for the decomposition, if not the compiled-in ones
+        const std::optional<path>& GetSiteWeightsPath() const
+        {
+          return siteWeightsPath;
+        }
+        //! Where to cache the domain decomposition, if anywhere
+        const std::optional<path>& GetDecompositionCachePath() const
+        {
+          return decompositionCachePath;
+        }
+        //! Whether to decompose the domain between nodes first, then within each
+        bool UseHierarchicalDecomposition() const
+        {
+          return hierarchicalDecomposition;
+        }
+        //! Whether each process holds only a slice of the GMY header
+        bool UseDistributedHeader() const
+        {
+          return distributedHeader;
+        }
+        //! How to repartition the domain during the run, if at all
+        const std::optional<RebalanceConfig>& GetRebalanceConfig() const
+        {
+          return rebalanceConf;
+        }
         LatticeTimeStep GetTotalTimeSteps() const
         {
           return sim_info.time.total_steps;
@@ -405,6 +438,7 @@ namespace hemelb::configuration
         extraction::OutputField DoIOForPropertyField(const io::xml::Element& xmlNode);
         extraction::PropertyOutputFile DoIOForPropertyOutputFile(
             const io::xml::Element& propertyoutputEl);
+        void DoIOForOutputFormat(const io::xml::Element& outputEl, extraction::PropertyOutputFile& file);
         extraction::StraightLineGeometrySelector* DoIOForLineGeometry(
             const io::xml::Element& xmlNode);
         extraction::PlaneGeometrySelector* DoIOForPlaneGeometry(const io::xml::Element&);
@@ -441,6 +475,11 @@ namespace hemelb::configuration
     private:
         path xmlFilePath;
         path dataFilePath;
+        std::optional<path> siteWeightsPath;
+        std::optional<path> decompositionCachePath;
+        bool hierarchicalDecomposition = false;
+        bool distributedHeader = false;
+        std::optional<RebalanceConfig> rebalanceConf;
 
         std::vector<extraction::PropertyOutputFile> propertyOutputs;
         /**
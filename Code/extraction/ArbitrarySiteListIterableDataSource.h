@@ -104,6 +104,14 @@ namespace hemelb
           return;
         }
 
+        /**
+         * Moves straight to the site with the given index.
+         */
+        bool ReadAt(site_t index)
+        {
+          return false;
+        }
+
         /**
          * Returns true iff the passed location is within the lattice.
          *
@@ -0,0 +1,165 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_FIELDENCODING_H
+#define HEMELB_EXTRACTION_FIELDENCODING_H
+
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "extraction/GeometrySelector.h"
+#include "extraction/IterableDataSource.h"
+#include "extraction/OutputField.h"
+#include "io/formats/extraction.h"
+#include "util/variant.h"
+
+// Helpers shared by the writers of the different property output
+// file formats.
+namespace hemelb::extraction
+{
+    namespace detail
+    {
+      // Helper for writing values converted to the type contained in
+      // the code::Type variant tag value.
+      //
+      // Use of std::variant + visit ensures that we generate all the
+      // types required with only a single implementation.
+      template <typename XDRW, typename... MemTs>
+      void write(XDRW& writer, code::Type tc, MemTs... vals) {
+	using common_t = std::common_type_t<MemTs...>;
+	static_assert(std::conjunction_v<std::is_same<common_t, MemTs>...>,
+		      "Values must be of uniform type");
+
+	std::visit([&] (auto tag) {
+	    using FileT = decltype(tag);
+	    (writer << ... << FileT(vals));
+	  },
+	  tc);
+      }
+    }
+
+    // Write the values of one field at the data source's current
+    // site.
+    template <typename W>
+    void EncodeField(W& writer, OutputField const& fieldSpec, IterableDataSource& src, int rank) {
+      using detail::write;
+      overload_visit(
+	fieldSpec.src,
+	[&](source::Pressure) {
+	  write(writer, fieldSpec.typecode, src.GetPressure() - fieldSpec.offset[0]);
+	},
+	[&](source::Velocity) {
+	  auto&& v = src.GetVelocity();
+	  write(writer, fieldSpec.typecode, v.x(), v.y(), v.z());
+	},
+	//! @TODO: Work out how to handle the different stresses.
+	[&](source::VonMisesStress) {
+	  write(writer, fieldSpec.typecode, src.GetVonMisesStress());
+	},
+	[&](source::ShearStress) {
+	  write(writer, fieldSpec.typecode, src.GetShearStress());
+	},
+	[&](source::ShearRate) {
+	  write(writer, fieldSpec.typecode, src.GetShearRate());
+	},
+	[&](source::StressTensor) {
+	  util::Matrix3D tensor = src.GetStressTensor();
+	  // Only the upper triangular part of the symmetric
+	  // tensor is stored. Storage is row-wise.
+	  write(writer, fieldSpec.typecode,
+		tensor[0][0], tensor[0][1], tensor[0][2],
+			      tensor[1][1], tensor[1][2],
+					    tensor[2][2]);
+	},
+	[&](source::Traction) {
+	  auto&& t = src.GetTraction();
+	  write(writer, fieldSpec.typecode, t.x(), t.y(), t.z());
+	},
+	[&](source::TangentialProjectionTraction) {
+	  auto&& t = src.GetTangentialProjectionTraction();
+	  write(writer, fieldSpec.typecode, t.x(), t.y(), t.z());
+	},
+	[&](source::Distributions) {
+	  unsigned numComponents = src.GetNumVectors();
+	  distribn_t const* d_ptr = src.GetDistribution();
+	  for (auto i = 0U; i < numComponents; i++)
+	  {
+	    write(writer, fieldSpec.typecode, d_ptr[i]);
+	  }
+	},
+	[&](source::MpiRank) {
+	  write(writer, fieldSpec.typecode, rank);
+	}
+      );
+    }
+
+    // Just enough of a writer for EncodeField, storing values
+    // little-endian, one after another.
+    struct LittleEndianWriter {
+      char* pos;
+      template <typename T>
+      LittleEndianWriter& operator<<(T val) {
+	io::formats::extraction::ToLittleEndian(val, pos);
+	pos += sizeof(T);
+	return *this;
+      }
+    };
+
+    // Returns the number of items written for the field.
+    inline unsigned GetFieldLength(source::Type src, IterableDataSource const& dataSource)
+    {
+      return overload_visit(src,
+	[](source::Pressure) {
+	  return 1U;
+	},
+	[](source::Velocity) {
+	  return 3U;
+	},
+	[](source::ShearStress) {
+	  return 1U;
+	},
+	[](source::VonMisesStress) {
+	  return 1U;
+	},
+	[](source::ShearRate) {
+	  return 1U;
+	},
+	[](source::StressTensor) {
+	  return 6U;
+	},
+	[](source::Traction) {
+	  return 3U;
+	},
+	[](source::TangentialProjectionTraction) {
+	  return 3U;
+	},
+	[&](source::Distributions) {
+	  return dataSource.GetNumVectors();
+	},
+	[](source::MpiRank) {
+	  return 1U;
+	}
+      );
+    }
+
+    // The indices in the data source of the sites on this rank that
+    // the geometry includes.
+    inline std::vector<site_t> FindWrittenSites(IterableDataSource& dataSource, GeometrySelector const& geometry)
+    {
+      std::vector<site_t> ans;
+      dataSource.Reset();
+      for (site_t i = 0; dataSource.ReadNext(); ++i)
+      {
+	if (geometry.Include(dataSource, dataSource.GetPosition()))
+	{
+	  ans.push_back(i);
+	}
+      }
+      return ans;
+    }
+}
+
+#endif // HEMELB_EXTRACTION_FIELDENCODING_H
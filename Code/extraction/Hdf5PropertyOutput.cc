@@ -0,0 +1,403 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+
+#include "extraction/Hdf5PropertyOutput.h"
+#include "extraction/FieldEncoding.h"
+#include "io/formats/hdf5.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb::extraction
+{
+    namespace fmt = io::formats::hdf5;
+    using io::hdf5::Check;
+    using io::hdf5::Id;
+
+    namespace
+    {
+      // The end of the XDMF file, after the last timestep.
+      constexpr char const* XDMF_TAIL = "    </Grid>\n  </Domain>\n</Xdmf>\n";
+
+      // Timesteps in a chunk of the time dataset.
+      constexpr hsize_t TIME_CHUNK = 256;
+
+      // A field's dataset has shape (timesteps, sites) for scalars
+      // and (timesteps, sites, values) otherwise.
+      int FieldRank(hsize_t len) {
+	return len == 1 ? 2 : 3;
+      }
+
+      hid_t FileType(code::Type const& tc) {
+	return std::visit([](auto tag) {
+	    return io::hdf5::LittleEndianType<decltype(tag)>();
+	  },
+	  tc);
+      }
+
+      char const* XdmfNumberType(code::Type const& tc) {
+	return overload_visit(tc,
+	  [](float) { return "NumberType=\"Float\" Precision=\"4\""; },
+	  [](double) { return "NumberType=\"Float\" Precision=\"8\""; },
+	  [](std::int32_t) { return "NumberType=\"Int\" Precision=\"4\""; },
+	  [](std::uint32_t) { return "NumberType=\"UInt\" Precision=\"4\""; },
+	  [](std::int64_t) { return "NumberType=\"Int\" Precision=\"8\""; },
+	  [](std::uint64_t) { return "NumberType=\"UInt\" Precision=\"8\""; }
+	);
+      }
+
+      // How XDMF should present a field with this many values per
+      // site. The stress tensor's six values are in the order XDMF
+      // expects of a symmetric tensor.
+      char const* XdmfAttributeType(hsize_t len) {
+	switch (len) {
+	case 1:
+	  return "Scalar";
+	case 3:
+	  return "Vector";
+	case 6:
+	  return "Tensor6";
+	default:
+	  return "Matrix";
+	}
+      }
+
+      std::string XmlEscape(std::string_view s) {
+	std::string ans;
+	for (char c: s) {
+	  switch (c) {
+	  case '&':
+	    ans += "&amp;";
+	    break;
+	  case '<':
+	    ans += "&lt;";
+	    break;
+	  case '>':
+	    ans += "&gt;";
+	    break;
+	  case '"':
+	    ans += "&quot;";
+	    break;
+	  default:
+	    ans += c;
+	  }
+	}
+	return ans;
+      }
+    }
+
+    Hdf5PropertyOutput::Hdf5PropertyOutput(IterableDataSource& dataSource,
+					   const PropertyOutputFile& outputSpec_,
+					   const net::IOCommunicator& ioComms) :
+        comms(ioComms), dataSource(&dataSource), outputSpec(outputSpec_)
+    {
+#if !H5_VERSION_GE(1, 10, 2)
+      if (outputSpec.compression)
+	throw Exception() << "Compressed HDF5 output of " << outputSpec.filename
+			  << " needs HDF5 1.10.2 or later";
+#endif
+
+      // The XDMF file describes all the timesteps, so for single
+      // timestep files it is named without the '%d'.
+      xdmf_file_name = outputSpec.filename;
+      if (std::holds_alternative<single_timestep_files>(outputSpec.ts_mode)) {
+	auto names = SplitFileName(outputSpec.filename);
+	xdmf_file_name = names.basename;
+	output_file_pattern = std::move(names.pattern);
+      }
+      xdmf_file_name.replace_extension(".xdmf");
+
+      Distribute();
+
+      // Start the XDMF file, with no timesteps yet.
+      if (comms.OnIORank())
+      {
+	std::ofstream xdmf(xdmf_file_name, std::ios::binary | std::ios::trunc);
+	xdmf << "<?xml version=\"1.0\" ?>\n"
+	     << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+	     << "<Xdmf Version=\"2.0\">\n"
+	     << "  <Domain>\n"
+	     << "    <Grid Name=\"" << XmlEscape(xdmf_file_name.stem().native())
+	     << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+	xdmf_end = xdmf.tellp();
+	xdmf << XDMF_TAIL;
+	if (!xdmf)
+	  throw Exception() << "Error writing XDMF file " << xdmf_file_name;
+      }
+
+      // If we are doing all timesteps in one file, set it up now.
+      if (std::holds_alternative<multi_timestep_file>(outputSpec.ts_mode)) {
+	StartFile(outputSpec.filename);
+	StartGroup();
+      }
+    }
+
+    // The handles are closed in reverse order of declaration, so
+    // the datasets and group before the file, ignoring any errors.
+    Hdf5PropertyOutput::~Hdf5PropertyOutput() = default;
+
+    void Hdf5PropertyOutput::Distribute()
+    {
+      written_sites = FindWrittenSites(*dataSource, *outputSpec.geometry);
+      local_site_count = written_sites.size();
+      global_site_count = comms.AllReduce(local_site_count, MPI_SUM);
+      // Each rank's sites are together, in rank order.
+      first_site = comms.Scan(local_site_count, MPI_SUM) - local_site_count;
+
+      // Big enough for the coordinates or any one field, and never
+      // empty as HDF5 wants a buffer even when writing nothing.
+      std::uint64_t site_len = 3 * sizeof(double);
+      for (auto& f: outputSpec.fields)
+	site_len = std::max<std::uint64_t>(site_len,
+					   GetFieldLength(f.src, *dataSource) * code::type_to_size(f.typecode));
+      buffer.resize(std::max<std::uint64_t>(local_site_count * site_len, 1));
+    }
+
+    bool Hdf5PropertyOutput::ShouldWrite(unsigned long timestepNumber) const
+    {
+      return ( (timestepNumber % outputSpec.frequency) == 0);
+    }
+
+    const PropertyOutputFile& Hdf5PropertyOutput::GetOutputSpec() const
+    {
+      return outputSpec;
+    }
+
+    void Hdf5PropertyOutput::StartFile(std::filesystem::path const& fn)
+    {
+      file_name = fn;
+      file = io::hdf5::CreateFile(fn, comms);
+
+      auto const& origin = dataSource->GetOrigin();
+      io::hdf5::WriteAttribute<std::uint32_t>(file, "version", std::array{fmt::VersionNumber});
+      io::hdf5::WriteAttribute<double>(file, "voxel_size", std::array{double(dataSource->GetVoxelSize())});
+      io::hdf5::WriteAttribute<double>(file, "origin",
+				       std::array{double(origin.x()), double(origin.y()), double(origin.z())});
+    }
+
+    void Hdf5PropertyOutput::StartGroup()
+    {
+      group = Id(H5Gcreate(file, std::to_string(group_number).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+		 "creating group");
+      auto const dxpl = io::hdf5::CollectiveTransfer();
+
+      // The positions of the sites, on the grid and in metres.
+      {
+	std::array<hsize_t, 2> const dims{global_site_count, 3};
+	std::array<hsize_t, 2> const start{first_site, 0};
+	std::array<hsize_t, 2> const count{local_site_count, 3};
+	auto const space = io::hdf5::Dataspace(dims);
+	Id grid(H5Dcreate(group, fmt::GridName, H5T_STD_U32LE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+		"creating grid dataset");
+	Id coords(H5Dcreate(group, fmt::CoordinatesName, H5T_IEEE_F64LE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+		  "creating coordinates dataset");
+	auto const mem = io::hdf5::SelectPart(space, start, count);
+
+	LittleEndianWriter writer{buffer.data()};
+	for (auto site: written_sites)
+	{
+	  dataSource->ReadAt(site);
+	  auto const& position = dataSource->GetPosition();
+	  writer << (uint32_t) position.x() << (uint32_t) position.y() << (uint32_t) position.z();
+	}
+	Check(H5Dwrite(grid, H5T_STD_U32LE, mem, space, dxpl, buffer.data()), "writing grid");
+
+	double const voxel = dataSource->GetVoxelSize();
+	auto const& origin = dataSource->GetOrigin();
+	writer = LittleEndianWriter{buffer.data()};
+	for (auto site: written_sites)
+	{
+	  dataSource->ReadAt(site);
+	  auto const& position = dataSource->GetPosition();
+	  writer << double(origin.x() + voxel * position.x())
+		 << double(origin.y() + voxel * position.y())
+		 << double(origin.z() + voxel * position.z());
+	}
+	Check(H5Dwrite(coords, H5T_IEEE_F64LE, mem, space, dxpl, buffer.data()), "writing coordinates");
+      }
+
+      // The timesteps, which grow by one each write.
+      {
+	std::array<hsize_t, 1> const dims{0}, maxdims{H5S_UNLIMITED}, chunk{TIME_CHUNK};
+	Id dcpl(H5Pcreate(H5P_DATASET_CREATE), "creating dataset properties");
+	Check(H5Pset_chunk(dcpl, 1, chunk.data()), "setting chunks");
+	times = Id(H5Dcreate(group, fmt::TimeName, H5T_STD_U64LE, io::hdf5::Dataspace(dims, maxdims),
+			     H5P_DEFAULT, dcpl, H5P_DEFAULT),
+		   "creating time dataset");
+      }
+
+      // The fields, which grow by a row each write. A chunk is part
+      // of one row, so a write only touches its own chunks.
+      field_datasets.clear();
+      for (auto& f: outputSpec.fields)
+      {
+	hsize_t const len = GetFieldLength(f.src, *dataSource);
+	int const rank = FieldRank(len);
+	hsize_t const chunk_sites = std::clamp<hsize_t>(fmt::ChunkBytes / (len * code::type_to_size(f.typecode)),
+							1, std::max<hsize_t>(global_site_count, 1));
+	std::array<hsize_t, 3> const dims{0, global_site_count, len};
+	std::array<hsize_t, 3> const maxdims{H5S_UNLIMITED, std::max<hsize_t>(global_site_count, chunk_sites), len};
+	std::array<hsize_t, 3> const chunk{1, chunk_sites, len};
+
+	Id dcpl(H5Pcreate(H5P_DATASET_CREATE), "creating dataset properties");
+	Check(H5Pset_chunk(dcpl, rank, chunk.data()), "setting chunks");
+	if (outputSpec.compression) {
+	  Check(H5Pset_shuffle(dcpl), "setting shuffle filter");
+	  Check(H5Pset_deflate(dcpl, outputSpec.compression), "setting deflate filter");
+	} else {
+	  // Every value gets written, so don't fill the chunks first.
+	  Check(H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER), "setting fill time");
+	}
+
+	auto const space = io::hdf5::Dataspace(std::span(dims).first(rank), std::span(maxdims).first(rank));
+	auto& ds = field_datasets.emplace_back(
+	  H5Dcreate(group, f.name.c_str(), FileType(f.typecode), space, H5P_DEFAULT, dcpl, H5P_DEFAULT),
+	  "creating field dataset");
+	if (!f.offset.empty())
+	  io::hdf5::WriteAttribute<double>(ds, "offset", f.offset);
+      }
+      rows = 0;
+    }
+
+    void Hdf5PropertyOutput::EndFile()
+    {
+      if (!file.IsValid())
+	return;
+      field_datasets.clear();
+      times.Close();
+      group.Close();
+      file.Close();
+    }
+
+    void Hdf5PropertyOutput::Write(unsigned long timestepNumber, unsigned long totalSteps)
+    {
+      // Don't write if we shouldn't this iteration.
+      if (!ShouldWrite(timestepNumber))
+      {
+	return;
+      }
+
+      if (std::holds_alternative<single_timestep_files>(outputSpec.ts_mode)) {
+	StartFile(TimestepFileName(output_file_pattern, timestepNumber, totalSteps));
+	StartGroup();
+      }
+
+      auto const dxpl = io::hdf5::CollectiveTransfer();
+      hsize_t const row = rows++;
+
+      // The IO rank writes the timestep number.
+      {
+	Check(H5Dset_extent(times, &rows), "extending time dataset");
+	Id space(H5Dget_space(times), "getting time dataspace");
+	std::array<hsize_t, 1> const count{comms.OnIORank() ? 1U : 0U};
+	auto const mem = io::hdf5::SelectPart(space, std::array{row}, count);
+	std::uint64_t const ts = timestepNumber;
+	Check(H5Dwrite(times, H5T_NATIVE_UINT64, mem, space, dxpl, &ts), "writing time");
+      }
+
+      // One pass over the sites for each field, so each field's
+      // values are contiguous.
+      for (std::size_t i = 0; i < outputSpec.fields.size(); ++i)
+      {
+	auto const& fieldSpec = outputSpec.fields[i];
+	auto const& ds = field_datasets[i];
+	hsize_t const len = GetFieldLength(fieldSpec.src, *dataSource);
+	int const rank = FieldRank(len);
+
+	std::array<hsize_t, 3> const dims{rows, global_site_count, len};
+	Check(H5Dset_extent(ds, dims.data()), "extending field dataset");
+
+	LittleEndianWriter writer{buffer.data()};
+	for (auto site: written_sites)
+	{
+	  dataSource->ReadAt(site);
+	  EncodeField(writer, fieldSpec, *dataSource, comms.Rank());
+	}
+
+	Id space(H5Dget_space(ds), "getting field dataspace");
+	std::array<hsize_t, 3> const start{row, first_site, 0};
+	std::array<hsize_t, 3> const count{1, local_site_count, len};
+	auto const mem = io::hdf5::SelectPart(space, std::span(start).first(rank), std::span(count).first(rank));
+	auto const type = FileType(fieldSpec.typecode);
+	Check(H5Dwrite(ds, type, mem, space, dxpl, buffer.data()), "writing field");
+      }
+
+      if (comms.OnIORank())
+	DescribeTimestep(timestepNumber);
+
+      if (std::holds_alternative<single_timestep_files>(outputSpec.ts_mode))
+	EndFile();
+    }
+
+    void Hdf5PropertyOutput::DescribeTimestep(std::uint64_t timestepNumber)
+    {
+      auto const n = std::to_string(global_site_count);
+      // The XDMF file is in the same directory as the HDF5 files.
+      auto const location = XmlEscape(file_name.filename().native()) + ":/" + std::to_string(group_number) + "/";
+
+      std::ostringstream grid;
+      grid << "      <Grid Name=\"" << timestepNumber << "\" GridType=\"Uniform\">\n"
+	   << "        <Time Value=\"" << timestepNumber << "\"/>\n"
+	   << "        <Topology TopologyType=\"Polyvertex\" NumberOfElements=\"" << n
+	   << "\" NodesPerElement=\"1\"/>\n"
+	   << "        <Geometry GeometryType=\"XYZ\">\n"
+	   << "          <DataItem Dimensions=\"" << n << " 3\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">"
+	   << location << fmt::CoordinatesName << "</DataItem>\n"
+	   << "        </Geometry>\n";
+      for (auto& f: outputSpec.fields)
+      {
+	hsize_t const len = GetFieldLength(f.src, *dataSource);
+	auto const per_site = len == 1 ? std::string{} : " " + std::to_string(len);
+	auto const zero = len == 1 ? "" : " 0";
+	auto const one = len == 1 ? "" : " 1";
+	// This timestep's row of the field.
+	grid << "        <Attribute Name=\"" << XmlEscape(f.name) << "\" AttributeType=\""
+	     << XdmfAttributeType(len) << "\" Center=\"Node\">\n"
+	     << "          <DataItem ItemType=\"HyperSlab\" Dimensions=\"1 " << n << per_site << "\">\n"
+	     << "            <DataItem Dimensions=\"3 " << FieldRank(len) << "\" Format=\"XML\">"
+	     << rows - 1 << " 0" << zero << " 1 1" << one << " 1 " << n << per_site << "</DataItem>\n"
+	     << "            <DataItem Dimensions=\"" << rows << " " << n << per_site << "\" "
+	     << XdmfNumberType(f.typecode) << " Format=\"HDF\">" << location << XmlEscape(f.name) << "</DataItem>\n"
+	     << "          </DataItem>\n"
+	     << "        </Attribute>\n";
+      }
+      grid << "      </Grid>\n";
+
+      // Insert it before the closing tags.
+      auto const text = grid.str();
+      std::fstream xdmf(xdmf_file_name, std::ios::in | std::ios::out | std::ios::binary);
+      xdmf.seekp(xdmf_end);
+      xdmf << text << XDMF_TAIL;
+      if (!xdmf)
+	throw Exception() << "Error writing XDMF file " << xdmf_file_name;
+      xdmf_end += text.size();
+    }
+
+    void Hdf5PropertyOutput::Flush()
+    {
+      if (file.IsValid())
+	Check(H5Fflush(file, H5F_SCOPE_GLOBAL), "flushing file");
+    }
+
+    void Hdf5PropertyOutput::SetDataSource(IterableDataSource& source)
+    {
+      auto const old_global_count = global_site_count;
+      dataSource = &source;
+      Distribute();
+      if (global_site_count != old_global_count)
+	throw Exception() << "Redistributed extraction for " << outputSpec.filename
+			  << " has a different number of sites";
+
+      // The sites are now in a different order, so the timesteps
+      // from here on go in a new group with the new positions.
+      if (std::holds_alternative<multi_timestep_file>(outputSpec.ts_mode)) {
+	++group_number;
+	StartGroup();
+      }
+    }
+}
@@ -0,0 +1,121 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_HDF5PROPERTYOUTPUT_H
+#define HEMELB_EXTRACTION_HDF5PROPERTYOUTPUT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "extraction/IterableDataSource.h"
+#include "extraction/PropertyOutput.h"
+#include "extraction/PropertyOutputFile.h"
+#include "io/Hdf5.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    class IOCommunicator;
+  }
+  namespace extraction
+  {
+    // Writes this core's part of a property output file in HDF5
+    // (see doc/dev/file-formats/hdf5.md). Every field is a chunked
+    // dataset with one row per timestep, written collectively, and
+    // an XDMF file alongside lets ParaView or VisIt read it as is.
+    class Hdf5PropertyOutput : public PropertyOutput
+    {
+    public:
+      // Collective on the communicator.
+      Hdf5PropertyOutput(IterableDataSource& dataSource, const PropertyOutputFile& outputSpec,
+			 const net::IOCommunicator& ioComms);
+
+      // Closes the file, so every rank must destroy it together.
+      // Errors aren't reported here: call Flush first.
+      ~Hdf5PropertyOutput() override;
+
+      bool ShouldWrite(unsigned long timestepNumber) const override;
+
+      const PropertyOutputFile& GetOutputSpec() const override;
+
+      // Collective on the communicator.
+      void Write(unsigned long timestepNumber, unsigned long totalSteps) override;
+
+      // Writes finish before Write returns, so this only flushes
+      // HDF5's buffers to the file. Collective on the communicator.
+      void Flush() override;
+
+      // Later timesteps go in a new group of the same file, with the
+      // sites in their new order. Collective on the communicator.
+      void SetDataSource(IterableDataSource& source) override;
+
+    private:
+      // Work out which sites this rank writes and where they go.
+      void Distribute();
+
+      // Create the file and write the attributes of its root
+      // group. Collective.
+      void StartFile(std::filesystem::path const& fn);
+
+      // Create the group for the current order of the sites, holding
+      // their positions and the (empty) datasets of the time and the
+      // fields. Collective.
+      void StartGroup();
+
+      // Close the file, if one is open. Collective.
+      void EndFile();
+
+      // Add the timestep just written to the XDMF file. Only on the
+      // IO rank.
+      void DescribeTimestep(std::uint64_t timestepNumber);
+
+      // Our communicator
+      const net::IOCommunicator& comms;
+
+      // The data source to use for file output.
+      IterableDataSource* dataSource;
+
+      // PropertyOutputFile spec.
+      PropertyOutputFile outputSpec;
+
+      // For single-timestep-per-file mode, hold the pattern we'll
+      // pass to printf.
+      std::string output_file_pattern;
+
+      // The XDMF file describing all the timesteps written and,
+      // on the IO rank, where its closing tags start.
+      std::filesystem::path xdmf_file_name;
+      std::uint64_t xdmf_end = 0;
+
+      // The indices in the data source of the sites this rank
+      // writes, and where they start amongst all the sites.
+      std::vector<site_t> written_sites;
+      std::uint64_t local_site_count;
+      std::uint64_t global_site_count;
+      std::uint64_t first_site;
+
+      // The file being written, the group for the current order of
+      // the sites (the first is "0", the next "1", ...) and its
+      // datasets.
+      std::filesystem::path file_name;
+      io::hdf5::Id file;
+      unsigned group_number = 0;
+      io::hdf5::Id group;
+      io::hdf5::Id times;
+      std::vector<io::hdf5::Id> field_datasets;
+      // The number of timesteps in the group.
+      hsize_t rows = 0;
+
+      // Buffer to serialise one field into before writing.
+      std::vector<char> buffer;
+    };
+  }
+}
+
+#endif // HEMELB_EXTRACTION_HDF5PROPERTYOUTPUT_H
@@ -100,6 +100,16 @@ namespace hemelb::extraction
          */
         virtual void Reset() = 0;
 
+        /**
+         * Moves straight to the site with the given index, counting
+         * from zero in the order ReadNext visits the sites. Returns
+         * true if there is such a site.
+         *
+         * @param index
+         * @return
+         */
+        virtual bool ReadAt(site_t index) = 0;
+
         /**
          * Returns true iff the passed location is within the lattice.
          *
@@ -75,8 +75,23 @@ namespace hemelb::extraction
 
     const distribn_t* LbDataSourceIterator::GetDistribution() const
     {
-      auto site = data.GetSite(position);
-      return site.GetFOld(data.GetDomain().GetLatticeInfo().GetNumVectors());
+      auto&& dom = data.GetDomain();
+      auto const NV = dom.GetLatticeInfo().GetNumVectors();
+      if constexpr (geometry::CONTIGUOUS_SITE_VIEWS) {
+        return data.GetSite(position).GetFOld(NV);
+      } else if constexpr (geometry::SINGLE_BUFFER_STREAMING) {
+        // Updating in place has overwritten this step's fOld by the time we are
+        // asked, so give the most recent distributions instead.
+        distributionBuffer.resize(NV);
+        for (unsigned i = 0; i < NV; ++i)
+          distributionBuffer[i] = *data.GetFNew(data.GetFNewIndex(position, i));
+        return distributionBuffer.data();
+      } else {
+        distributionBuffer.resize(NV);
+        for (unsigned i = 0; i < NV; ++i)
+          distributionBuffer[i] = *data.GetFOld(data.GetFOldIndex(position, i));
+        return distributionBuffer.data();
+      }
     }
 
     void LbDataSourceIterator::Reset()
@@ -84,6 +99,12 @@ namespace hemelb::extraction
       position = -1;
     }
 
+    bool LbDataSourceIterator::ReadAt(site_t index)
+    {
+      position = index;
+      return position >= 0 && position < data.GetDomain().GetLocalFluidSiteCount();
+    }
+
     bool LbDataSourceIterator::IsValidLatticeSite(const util::Vector3D<site_t>& location) const
     {
       return data.GetDomain().IsValidLatticeSite(location);
@@ -6,6 +6,8 @@
 #ifndef HEMELB_EXTRACTION_LBDATASOURCEITERATOR_H
 #define HEMELB_EXTRACTION_LBDATASOURCEITERATOR_H
 
+#include <vector>
+
 #include "extraction/IterableDataSource.h"
 #include "geometry/FieldData.h"
 #include "lb/MacroscopicPropertyCache.h"
@@ -100,6 +102,11 @@ namespace hemelb::extraction
          */
         void Reset() override;
 
+        /**
+         * Moves straight to the site with the given local contiguous index.
+         */
+        bool ReadAt(site_t index) override;
+
         /**
          * Returns true iff the passed location is within the lattice.
          *
@@ -164,6 +171,11 @@ namespace hemelb::extraction
          * Iteration variable for tracking progress through all the local fluid sites.
          */
         site_t position;
+        /**
+         * Scratch space for a site's distributions when the layout does not store
+         * them contiguously.
+         */
+        mutable std::vector<distribn_t> distributionBuffer;
     };
 }
 
@@ -8,11 +8,15 @@
 #include "geometry/FieldData.h"
 #include "io/formats/formats.h"
 #include "io/formats/extraction.h"
+#include "io/formats/hdf5.h"
 #include "io/formats/offset.h"
 #include "io/readers/XdrFileReader.h"
 #include "io/readers/XdrMemReader.h"
 #include "log/Logger.h"
 #include "util/span.h"
+#ifdef HEMELB_USE_HDF5
+#include "io/Hdf5.h"
+#endif
 
 namespace hemelb::extraction {
   namespace fmt = hemelb::io::formats;
@@ -46,9 +50,32 @@ namespace hemelb::extraction {
       // Open the file as read-only.
       // TODO: raise an exception if the file does not exist.
       auto inputFile = net::MpiFile::Open(comms, filePath, MPI_MODE_RDONLY);
+
+      // HDF5 checkpoints are recognised by their signature.
+      std::array<char, fmt::hdf5::Signature.size()> signature{};
+      if (comms.OnIORank() && inputFile.GetSize() >= MPI_Offset(signature.size()))
+	inputFile.ReadAt(0, std::span(signature));
+      comms.Broadcast(std::span(signature), comms.GetIORank());
+      if (signature == fmt::hdf5::Signature) {
+#ifdef HEMELB_USE_HDF5
+	inputFile.Close();
+	LoadHdf5(latDat, targetTime);
+	return;
+#else
+	throw Exception() << "Checkpoint " << filePath
+			  << " is an HDF5 file, but this build of HemeLB has no HDF5 support";
+#endif
+      }
+
       // Set the view to the file.
       inputFile.SetView(0, MPI_CHAR, MPI_CHAR, "native");
       ReadExtractionHeaders(inputFile, NUMVECTORS);
+      comms.Broadcast(version, comms.GetIORank());
+      comms.Broadcast(numberOfSites, comms.GetIORank());
+      if (version == fmt::extraction::VersionNumber) {
+	LoadColumns(inputFile, latDat, targetTime);
+	return;
+      }
 
       // Now read offset file.
       ReadOffsets(offsetPath);
@@ -129,32 +156,17 @@ namespace hemelb::extraction {
 	  dataReader.read(tmp.z());
 
 	  // Convert to canonical type
-	  util::Vector3D<site_t> grid{tmp};
-	  // Look up the site ID and rank, as decomposed by this run
-	  // of HemeLB, for the grid coordinate read from the
-	  // checkpoint file.
-	  proc_t rank; site_t index;
-	  if (!dom.GetContiguousSiteId(grid, rank, index)) {
-	    // function returns a 'valid' flag
-	    throw Exception() << "Cannot get valid site from extracted site coordinate";
-	  }
-	  if (rank != comms.Rank())
-	    throw Exception() << "Site read on rank " << comms.Rank()
-			      << " but should be read on " << rank;
-	  if (index != iSite)
-	    throw Exception() << "Site read at index " << iSite
-			      << " but should be read at " << index;
+	  CheckSite(dom, util::Vector3D<site_t>{tmp}, iSite);
 	}
 
-	distribn_t* f_old_p = latDat->GetFOld(iSite * NUMVECTORS);
-	distribn_t* f_new_p = latDat->GetFNew(iSite * NUMVECTORS);
 	// distField is read on IO rank and checked to be equal to
 	// NUMVECTORS so we use that instead of broadcasting and
 	// storing.
 	for (auto i = 0U; i < NUMVECTORS; i++) {
 	  distribn_t field_val;
 	  dataReader.read(field_val);
-	  f_new_p[i] = f_old_p[i] = field_val;
+	  auto const idx = dom.GetDistributionIndex(iSite, i);
+	  *latDat->GetFNew(idx) = *latDat->GetFOld(idx) = field_val;
 	}
       }
 
@@ -163,6 +175,198 @@ namespace hemelb::extraction {
 			  << " sites but expected " << dom.GetLocalFluidSiteCount();
     }
 
+    void LocalDistributionInput::LoadColumns(net::MpiFile& inputFile, geometry::FieldData* latDat,
+					     std::optional<LatticeTimeStep>& targetTime)
+    {
+      namespace xtr = fmt::extraction;
+      auto&& dom = latDat->GetDomain();
+      const auto NUMVECTORS = dom.GetLatticeInfo().GetNumVectors();
+
+      // Our sites are together in each array, in rank order.
+      uint64_t const nSites = dom.GetLocalFluidSiteCount();
+      uint64_t const firstSite = comms.Scan(nSites, MPI_SUM) - nSites;
+      if (comms.AllReduce(nSites, MPI_SUM) != numberOfSites)
+	throw Exception() << "Checkpoint has " << numberOfSites
+			  << " sites but the domain has " << comms.AllReduce(nSites, MPI_SUM);
+
+      uint64_t const siteLength = NUMVECTORS * sizeof(double);
+      uint64_t const tableLength = 8 + 12 * numberOfSites;
+      uint64_t const recordLength = 8 + siteLength * numberOfSites;
+
+      // On the IO rank, walk the records to find the timestep wanted
+      // (or the last) and the position table before it.
+      std::array<uint64_t, 3> found{};  // table start, record start, timestep
+      if (comms.OnIORank()) {
+	bool have = false;
+	uint64_t table = 0;
+	uint64_t const fileSize = inputFile.GetSize();
+	std::vector<char> tagBuf(8);
+	for (uint64_t pos = totalXtrHeaderLength; pos < fileSize;) {
+	  inputFile.ReadAt(pos, to_span(tagBuf));
+	  auto const tag = xtr::FromLittleEndian<uint64_t>(tagBuf.data());
+	  if (tag == xtr::PositionTableTag) {
+	    table = pos;
+	    pos += tableLength;
+	    continue;
+	  }
+	  if (table == 0)
+	    throw Exception() << "Checkpoint timestep " << tag << " has no position table before it";
+	  if (!targetTime || tag == *targetTime) {
+	    found = {table, pos, tag};
+	    have = true;
+	    if (targetTime)
+	      break;
+	  }
+	  pos += recordLength;
+	}
+	if (!have) {
+	  if (targetTime)
+	    throw Exception() << "Target timestep " << *targetTime << " not found in checkpoint file.";
+	  throw Exception() << "Checkpoint file contains no timesteps";
+	}
+      }
+      comms.Broadcast(std::span(found), comms.GetIORank());
+      timestep = found[2];
+      if (!targetTime)
+	targetTime = timestep;
+
+      log::Logger::Log<log::Info, log::Singleton>("Reading checkpoint from timestep %d", timestep);
+      std::vector<char> positions(12 * nSites);
+      inputFile.ReadAt(found[0] + 8 + 12 * firstSite, to_span(positions));
+      std::vector<char> distributions(siteLength * nSites);
+      inputFile.ReadAt(found[1] + 8 + siteLength * firstSite, to_span(distributions));
+
+      for (site_t iSite = 0; iSite < site_t(nSites); ++iSite) {
+	char const* pos = positions.data() + 12 * iSite;
+	CheckSite(dom,
+		  util::Vector3D<site_t>(xtr::FromLittleEndian<uint32_t>(pos),
+					 xtr::FromLittleEndian<uint32_t>(pos + 4),
+					 xtr::FromLittleEndian<uint32_t>(pos + 8)),
+		  iSite);
+
+	char const* d = distributions.data() + siteLength * iSite;
+	for (auto i = 0U; i < NUMVECTORS; i++) {
+	  auto const idx = dom.GetDistributionIndex(iSite, i);
+	  *latDat->GetFNew(idx) = *latDat->GetFOld(idx) = xtr::FromLittleEndian<double>(d + 8 * i);
+	}
+      }
+    }
+
+#ifdef HEMELB_USE_HDF5
+    void LocalDistributionInput::LoadHdf5(geometry::FieldData* latDat, std::optional<LatticeTimeStep>& targetTime)
+    {
+      namespace h5 = io::hdf5;
+      auto&& dom = latDat->GetDomain();
+      const auto NUMVECTORS = dom.GetLatticeInfo().GetNumVectors();
+
+      // Our sites are together in each dataset, in rank order.
+      uint64_t const nSites = dom.GetLocalFluidSiteCount();
+      uint64_t const firstSite = comms.Scan(nSites, MPI_SUM) - nSites;
+      uint64_t const totalSites = comms.AllReduce(nSites, MPI_SUM);
+
+      auto const file = h5::OpenFile(filePath, comms);
+
+      // Find the group and row of the timestep wanted (or the last
+      // one). Metadata reads are collective, so every rank looks.
+      std::optional<std::array<uint64_t, 3>> found;  // group, row, timestep
+      for (uint64_t group = 0; !(found && targetTime); ++group) {
+	auto const groupName = std::to_string(group);
+	if (h5::Check(H5Lexists(file, groupName.c_str(), H5P_DEFAULT), "looking for group") == 0)
+	  break;
+	h5::Id times(H5Dopen(file, (groupName + "/" + fmt::hdf5::TimeName).c_str(), H5P_DEFAULT),
+		     "opening time dataset");
+	h5::Id space(H5Dget_space(times), "getting time dataspace");
+	std::vector<uint64_t> steps(h5::Check(H5Sget_simple_extent_npoints(space), "getting time count"));
+	h5::Check(H5Dread(times, H5T_NATIVE_UINT64, H5S_ALL, H5S_ALL, H5P_DEFAULT, steps.data()), "reading times");
+	for (uint64_t row = 0; row < steps.size(); ++row) {
+	  if (!targetTime || steps[row] == *targetTime) {
+	    found = {group, row, steps[row]};
+	    if (targetTime)
+	      break;
+	  }
+	}
+      }
+      if (!found) {
+	if (targetTime)
+	  throw Exception() << "Target timestep " << *targetTime << " not found in checkpoint file.";
+	throw Exception() << "Checkpoint file contains no timesteps";
+      }
+      auto const [group, row, step] = *found;
+      timestep = step;
+      if (!targetTime)
+	targetTime = timestep;
+
+      auto const groupName = std::to_string(group) + "/";
+      h5::Id grid(H5Dopen(file, (groupName + fmt::hdf5::GridName).c_str(), H5P_DEFAULT), "opening grid dataset");
+      h5::Id dists(H5Dopen(file, (groupName + "distributions").c_str(), H5P_DEFAULT),
+		   "opening distributions dataset");
+
+      // The distributions should be doubles, with shape (timesteps,
+      // sites, NUMVECTORS).
+      h5::Id distSpace(H5Dget_space(dists), "getting distributions dataspace");
+      std::array<hsize_t, 3> dims{};
+      if (H5Sget_simple_extent_ndims(distSpace) != 3)
+	throw Exception() << "Checkpoint distributions should have 3 dimensions";
+      h5::Check(H5Sget_simple_extent_dims(distSpace, dims.data(), nullptr), "getting distributions shape");
+      if (dims[1] != totalSites)
+	throw Exception() << "Checkpoint has " << dims[1]
+			  << " sites but the domain has " << totalSites;
+      if (dims[2] != NUMVECTORS)
+	throw Exception() << "Checkpoint field distributions contains " << dims[2]
+			  << " distributions but this build of HemeLB requires " << NUMVECTORS;
+      h5::Id type(H5Dget_type(dists), "getting distributions type");
+      if (H5Tget_class(type) != H5T_FLOAT || H5Tget_size(type) != sizeof(double))
+	throw Exception() << "Checkpoint contains wrong data type";
+
+      log::Logger::Log<log::Info, log::Singleton>("Reading checkpoint from timestep %d", timestep);
+      auto const dxpl = h5::CollectiveTransfer();
+
+      std::vector<uint32_t> positions(3 * nSites);
+      {
+	h5::Id space(H5Dget_space(grid), "getting grid dataspace");
+	auto const mem = h5::SelectPart(space, std::array<hsize_t, 2>{firstSite, 0},
+					std::array<hsize_t, 2>{nSites, 3});
+	h5::Check(H5Dread(grid, H5T_NATIVE_UINT32, mem, space, dxpl, positions.data()), "reading grid");
+      }
+      std::vector<double> distributions(NUMVECTORS * nSites);
+      {
+	auto const mem = h5::SelectPart(distSpace, std::array<hsize_t, 3>{row, firstSite, 0},
+					std::array<hsize_t, 3>{1, nSites, NUMVECTORS});
+	h5::Check(H5Dread(dists, H5T_NATIVE_DOUBLE, mem, distSpace, dxpl, distributions.data()),
+		  "reading distributions");
+      }
+
+      for (site_t iSite = 0; iSite < site_t(nSites); ++iSite) {
+	CheckSite(dom,
+		  util::Vector3D<site_t>(positions[3 * iSite], positions[3 * iSite + 1], positions[3 * iSite + 2]),
+		  iSite);
+	for (auto i = 0U; i < NUMVECTORS; i++) {
+	  auto const idx = dom.GetDistributionIndex(iSite, i);
+	  *latDat->GetFNew(idx) = *latDat->GetFOld(idx) = distributions[NUMVECTORS * iSite + i];
+	}
+      }
+    }
+#endif
+
+    void LocalDistributionInput::CheckSite(geometry::Domain const& dom, util::Vector3D<site_t> const& grid,
+					   site_t iSite) const
+    {
+      // Look up the site ID and rank, as decomposed by this run
+      // of HemeLB, for the grid coordinate read from the
+      // checkpoint file.
+      proc_t rank; site_t index;
+      if (!dom.GetContiguousSiteId(grid, rank, index)) {
+	// function returns a 'valid' flag
+	throw Exception() << "Cannot get valid site from extracted site coordinate";
+      }
+      if (rank != comms.Rank())
+	throw Exception() << "Site read on rank " << comms.Rank()
+			  << " but should be read on " << rank;
+      if (index != iSite)
+	throw Exception() << "Site read at index " << iSite
+			  << " but should be read at " << index;
+    }
+
     void LocalDistributionInput::ReadExtractionHeaders(net::MpiFile& inputFile, const unsigned NUMVECTORS) {
       // The headers technically aren't needed (because of the offset
       // file), but we check that they are as expected.
@@ -172,7 +376,7 @@ namespace hemelb::extraction {
 	auto preambleReader = io::XdrMemReader(preambleBuf);
 
 	// Read the magic numbers.
-	uint32_t hlbMagicNumber, extMagicNumber, version;
+	uint32_t hlbMagicNumber, extMagicNumber;
 	preambleReader.read(hlbMagicNumber);
 	preambleReader.read(extMagicNumber);
 	preambleReader.read(version);
@@ -194,10 +398,11 @@ namespace hemelb::extraction {
 	}
 
 	// Check the version number.
-	if (version != fmt::extraction::VersionNumber)
+	if (version != fmt::extraction::XdrVersionNumber && version != fmt::extraction::VersionNumber)
 	{
 	  throw Exception() << "Version number incorrect."
-			    << " Supported: " << unsigned(fmt::extraction::VersionNumber)
+			    << " Supported: " << unsigned(fmt::extraction::XdrVersionNumber)
+			    << " and " << unsigned(fmt::extraction::VersionNumber)
 			    << " Input: " << version;
 	}
 
@@ -213,7 +418,6 @@ namespace hemelb::extraction {
 	  preambleReader.read(origin[2]);
 	}
 	// Obtain the total number of sites, fields & header len
-	uint64_t numberOfSites;
 	uint32_t numberOfFields, lengthOfFieldHeader;
 	preambleReader.read(numberOfSites);
 	preambleReader.read(numberOfFields);
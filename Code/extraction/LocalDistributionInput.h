@@ -26,6 +26,7 @@ namespace hemelb
   }
   namespace geometry
   {
+    class Domain;
     class FieldData;
   }
   namespace extraction
@@ -47,7 +48,8 @@ namespace hemelb
       // the file and will set the argument to that value.
       //
       // Requires the checkpoint have been saved with exactly the same
-      // domain decomposition as currently running.
+      // domain decomposition as currently running. Reads both version
+      // 5 and version 6 extraction files, and HDF5 files.
       void LoadDistribution(geometry::FieldData* latDat, std::optional<LatticeTimeStep>& initalTime);
 
     private:
@@ -55,6 +57,18 @@ namespace hemelb
       void ReadExtractionHeaders(net::MpiFile&, const unsigned NUMVECTORS);
       void ReadOffsets(const std::string&);
 
+      // Load from a version 6 file, which needs no offset file as
+      // each field is one array over all the sites.
+      void LoadColumns(net::MpiFile&, geometry::FieldData* latDat, std::optional<LatticeTimeStep>& targetTime);
+
+      // Load from an HDF5 file, as written with format="hdf5". Only
+      // available when built with HDF5.
+      void LoadHdf5(geometry::FieldData* latDat, std::optional<LatticeTimeStep>& targetTime);
+
+      // Check that the site read at index iSite, with the grid
+      // position given, is where this run would put it.
+      void CheckSite(geometry::Domain const& dom, util::Vector3D<site_t> const& grid, site_t iSite) const;
+
       const net::IOCommunicator& comms;
 
       // The path to the file to read from.
@@ -62,6 +76,9 @@ namespace hemelb
       std::filesystem::path offsetPath;
 
       InputField distField;
+      // From the main header
+      uint32_t version;
+      uint64_t numberOfSites;
       uint64_t localStart;
       uint64_t localStop;
       uint64_t timestep;
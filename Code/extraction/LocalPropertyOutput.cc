@@ -3,13 +3,18 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
+#include <numeric>
+
 #include "hassert.h"
 #include "extraction/LocalPropertyOutput.h"
+#include "extraction/FieldEncoding.h"
 #include "io/formats/formats.h"
 #include "io/formats/extraction.h"
 #include "io/formats/offset.h"
 #include "io/writers/XdrMemWriter.h"
 #include "io/writers/XdrVectorWriter.h"
+#include "log/Logger.h"
 #include "net/IOCommunicator.h"
 #include "util/span.h"
 #include "constants.h"
@@ -33,6 +38,9 @@ namespace hemelb::extraction
 	return encode(enc << arg, args...);
       }
 
+      // Tag for sending data to the writer
+      constexpr int FORWARD_TAG = 0;
+
       // XDR encode some values and return the result buffer
       template <typename... Ts>
       std::vector<char> quick_encode(Ts... args) {
@@ -42,24 +50,6 @@ namespace hemelb::extraction
 	return ans;
       }
 
-      // Helper for writing values converted to the type contained in
-      // the code::Type variant tag value.
-      //
-      // Use of std::variant + visit ensures that we generate all the
-      // types required with only a single implementation.
-      template <typename XDRW, typename... MemTs>
-      void write(XDRW& writer, code::Type tc, MemTs... vals) {
-	using common_t = std::common_type_t<MemTs...>;
-	static_assert(std::conjunction_v<std::is_same<common_t, MemTs>...>,
-		      "Values must be of uniform type");
-
-	std::visit([&] (auto tag) {
-	    using FileT = decltype(tag);
-	    (writer << ... << FileT(vals));
-	  },
-	  tc);
-      }
-
     }  // namespace
 
     static unsigned CalcFieldHeaderLength(std::vector<OutputField> const& fields);
@@ -67,47 +57,29 @@ namespace hemelb::extraction
     LocalPropertyOutput::LocalPropertyOutput(IterableDataSource& dataSource,
                                              const PropertyOutputFile& outputSpec_,
                                              const net::IOCommunicator& ioComms) :
-        comms(ioComms), dataSource(dataSource), outputSpec(outputSpec_)
+        comms(ioComms), dataSource(&dataSource), outputSpec(outputSpec_)
     {
       if (std::holds_alternative<multi_timestep_file>(outputSpec.ts_mode)) {
 	// Just replace extension with .off
 	offset_file_name = io::formats::offset::ExtractionToOffset(outputSpec.filename);
 	// empty output_file_pattern is OK
       } else if (std::holds_alternative<single_timestep_files>(outputSpec.ts_mode)) {
-	// Get views of the whole path
-	std::string_view p = outputSpec.filename.native();
-	auto i_pcd = p.find("%d", 0, 2);
-	// The part before %d
-	auto beginning = p.substr(0, i_pcd);
-	// The part after
-	auto end = p.substr(i_pcd + 2);
-	// Construct the path without '%d'
-	std::string basename{beginning};
-	basename += end;
-	// Use this to compute offset file name
-	offset_file_name = io::formats::offset::ExtractionToOffset(basename);
-	// Build the pattern
-	output_file_pattern += beginning;
-	output_file_pattern += "%*ld";
-	output_file_pattern += end;
+	auto names = SplitFileName(outputSpec.filename);
+	// Use the name without '%d' to compute offset file name
+	offset_file_name = io::formats::offset::ExtractionToOffset(names.basename);
+	output_file_pattern = std::move(names.pattern);
       }
 
       header_length = io::formats::extraction::MainHeaderLength + CalcFieldHeaderLength(outputSpec.fields);
 
-      // Count sites on this rank
-      local_site_count = CountWrittenSitesOnRank();
-      global_site_count = comms.AllReduce(local_site_count, MPI_SUM);
-
-      // Calculate how long local writes need to be (recall only IO
-      // rank writes the timestep).
-      auto const site_len = CalcSiteWriteLen(outputSpec.fields);
-      local_data_write_length = local_site_count * site_len  + (comms.OnIORank() ? 8U : 0U);
-      // Everyone needs to know the total length written during one iteration
-      global_data_write_length = site_len * global_site_count + 8U;
+      // Group the ranks of each node that share a writer.
+      auto const& node = comms.GetNodeComm();
+      auto const group_size = outputSpec.ranks_per_writer;
+      writers = node.Split(group_size ? node.Rank() / group_size : 0);
 
-      // Work out the offset for where this rank writes its data
-      auto const local_write_end = comms.Scan(local_data_write_length, MPI_SUM) + header_length;
-      local_write_start = local_write_end - local_data_write_length;
+      slots.resize(std::max(1U, outputSpec.async_buffers));
+      Distribute();
+      record_start = header_length;
 
       // Prepare the header information on the IO proc.
       if (comms.OnIORank())
@@ -115,9 +87,6 @@ namespace hemelb::extraction
 	header_data = PrepareHeader();
       }
 
-      // Create the buffer that we'll write each iteration's data into.
-      buffer.resize(local_data_write_length);
-
       // Write the offset file
       WriteOffsetFile();
 
@@ -127,17 +96,208 @@ namespace hemelb::extraction
       }
     }
 
-    uint64_t LocalPropertyOutput::CountWrittenSitesOnRank() {
-      auto n = uint64_t{0};
-      dataSource.Reset();
-      while (dataSource.ReadNext())
+    void LocalPropertyOutput::Distribute() {
+      // Find the sites on this rank
+      written_sites = FindWrittenSites(*dataSource, *outputSpec.geometry);
+      local_site_count = written_sites.size();
+      global_site_count = comms.AllReduce(local_site_count, MPI_SUM);
+
+      // Calculate how long local writes need to be (recall only IO
+      // rank writes the timestep).
+      auto const site_len = CalcSiteWriteLen(outputSpec.fields);
+      std::uint64_t const timestep_len = comms.OnIORank() ? 8U : 0U;
+      local_data_write_length = local_site_count * site_len  + timestep_len;
+      // Everyone needs to know the total length written during one iteration
+      global_data_write_length = site_len * global_site_count + 8U;
+
+      // Work out the offset for where this rank writes its data
+      rank_write_offset = comms.Scan(local_data_write_length, MPI_SUM) - local_data_write_length;
+
+      if (outputSpec.format_version == io::formats::extraction::XdrVersionNumber) {
+	// Everything about a site is together, so each rank's part
+	// of a timestep is one piece.
+	data_layout = MakeLayout({{rank_write_offset, 0, local_data_write_length}});
+      } else {
+	// Each field is one array over all the sites, in which this
+	// rank's sites are together. The positions aren't repeated.
+	auto const first_site = comms.Scan(local_site_count, MPI_SUM) - local_site_count;
+	std::vector<Stripe> pieces{{0, 0, timestep_len}};
+	std::uint64_t field_start = 8;
+	for (auto& f: outputSpec.fields) {
+	  std::uint64_t const len = GetFieldLength(f.src) * code::type_to_size(f.typecode);
+	  pieces.push_back({field_start + first_site * len, 0, local_site_count * len});
+	  field_start += global_site_count * len;
+	}
+	global_data_write_length -= 12 * global_site_count;
+	data_layout = MakeLayout(std::move(pieces));
+
+	table_length = 8 + 12 * global_site_count;
+	table_layout = MakeLayout({{0, 0, timestep_len}, {8 + 12 * first_site, 0, 12 * local_site_count}});
+      }
+
+      // Create the buffers that we'll write each iteration's data into.
+      for (auto& slot: slots)
+	slot.buffer.resize(data_layout.buffer_length);
+    }
+
+    LocalPropertyOutput::Layout LocalPropertyOutput::MakeLayout(std::vector<Stripe> pieces) const {
+      Layout ans;
+      std::vector<std::uint64_t> offsets, lengths;
+      for (auto& piece: pieces) {
+	piece.buffer_offset = ans.buffer_length;
+	ans.buffer_length += piece.length;
+	offsets.push_back(piece.file_offset);
+	lengths.push_back(piece.length);
+      }
+
+      // The writer lays out its group's data in file order, so that
+      // pieces which are adjacent in the file make one stripe.
+      auto const member_offsets = writers.Gather(offsets, 0);
+      ans.member_lengths = writers.Gather(lengths, 0);
+      if (writers.Rank() == 0) {
+	std::vector<std::size_t> order(member_offsets.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+	    return member_offsets[a] < member_offsets[b];
+	  });
+
+	ans.member_displacements.assign(order.size(), 0);
+	ans.buffer_length = 0;
+	for (auto i: order) {
+	  auto const len = ans.member_lengths[i];
+	  if (len == 0)
+	    continue;
+	  ans.member_displacements[i] = ans.buffer_length;
+	  auto& stripes = ans.stripes;
+	  if (!stripes.empty() && stripes.back().file_offset + stripes.back().length == member_offsets[i])
+	    stripes.back().length += len;
+	  else
+	    stripes.push_back({member_offsets[i], ans.buffer_length, len});
+	  ans.buffer_length += len;
+	}
+	// Our own pieces are now amongst the group's.
+	for (std::size_t i = 0; i < pieces.size(); ++i)
+	  pieces[i].buffer_offset = ans.member_displacements[i];
+      }
+      ans.pieces = std::move(pieces);
+      return ans;
+    }
+
+    void LocalPropertyOutput::Forward(WriteSlot& slot, Layout const& layout, std::uint64_t start) {
+      auto const n_pieces = layout.pieces.size();
+      slot.file = outputFile;
+      if (writers.Rank() == 0)
       {
-	if (outputSpec.geometry->Include(dataSource, dataSource.GetPosition()))
-        {
-	  ++n;
+	// Collect the group's data. Rather than wait for it here, the
+	// writes start once it has arrived, so the simulation can go
+	// on meanwhile.
+	for (auto i = n_pieces; i < layout.member_lengths.size(); ++i)
+	{
+	  if (layout.member_lengths[i] == 0)
+	    continue;
+	  auto& req = slot.receives.emplace_back();
+	  net::MpiCall{MPI_Irecv}(slot.buffer.data() + layout.member_displacements[i],
+				  (int) layout.member_lengths[i], MPI_CHAR,
+				  int(i / n_pieces), FORWARD_TAG, writers, &req);
+	}
+	for (auto& stripe: layout.stripes)
+	  slot.pending_writes.push_back({start + stripe.file_offset, stripe.buffer_offset, stripe.length});
+	StartWrites(slot, false);
+      }
+      else
+      {
+	// Send our data to the writer.
+	for (auto& piece: layout.pieces)
+	{
+	  if (piece.length == 0)
+	    continue;
+	  auto& req = slot.requests.emplace_back();
+	  net::MpiCall{MPI_Isend}(slot.buffer.data() + piece.buffer_offset, (int) piece.length,
+				  MPI_CHAR, 0, FORWARD_TAG, writers, &req);
 	}
       }
-      return n;
+    }
+
+    void LocalPropertyOutput::StartWrites(WriteSlot& slot, bool wait)
+    {
+      if (slot.pending_writes.empty())
+	return;
+
+      if (wait)
+      {
+	net::MpiCall{MPI_Waitall}((int) slot.receives.size(), slot.receives.data(), MPI_STATUSES_IGNORE);
+      }
+      else
+      {
+	int received;
+	net::MpiCall{MPI_Testall}((int) slot.receives.size(), slot.receives.data(), &received,
+				  MPI_STATUSES_IGNORE);
+	if (!received)
+	  return;
+      }
+      slot.receives.clear();
+
+      // The data are already copied out of the data source, so
+      // these only need starting.
+      auto const data = to_const_span(slot.buffer);
+      for (auto& write: slot.pending_writes)
+      {
+	slot.requests.push_back(slot.file.IWriteAt(write.file_offset,
+						   data.subspan(write.buffer_offset, write.length)));
+      }
+      slot.pending_writes.clear();
+    }
+
+    LocalPropertyOutput::~LocalPropertyOutput()
+    {
+      // The owner should have flushed (PropertyWriter's users do). If
+      // not, the buffers must still outlive the requests using them,
+      // but errors are ignored as a destructor can't report them.
+      for (auto& slot: slots)
+      {
+	if (slot.receives.empty() && slot.requests.empty())
+	  continue;
+	log::Logger::Log<log::Warning, log::OnePerCore>("Output to %s destroyed before being flushed",
+							outputSpec.filename.c_str());
+	MPI_Waitall((int) slot.receives.size(), slot.receives.data(), MPI_STATUSES_IGNORE);
+	MPI_Waitall((int) slot.requests.size(), slot.requests.data(), MPI_STATUSES_IGNORE);
+      }
+    }
+
+    void LocalPropertyOutput::Complete(WriteSlot& slot)
+    {
+      StartWrites(slot, true);
+      net::MpiCall{MPI_Waitall}((int) slot.requests.size(), slot.requests.data(), MPI_STATUSES_IGNORE);
+      slot.requests.clear();
+      slot.file.Close();
+    }
+
+    void LocalPropertyOutput::Flush()
+    {
+      // Oldest first, so every rank closes files in the same order.
+      for (std::size_t i = 0; i < slots.size(); ++i)
+	Complete(slots[(next_slot + i) % slots.size()]);
+    }
+
+    void LocalPropertyOutput::SetDataSource(IterableDataSource& source) {
+      auto const old_global_length = global_data_write_length;
+
+      // The buffers are about to be resized.
+      Flush();
+      dataSource = &source;
+      Distribute();
+      if (global_data_write_length != old_global_length)
+	throw Exception() << "Redistributed extraction for " << outputSpec.filename
+			  << " has a different number of sites";
+
+      // The sites are now in a different order, so the timesteps
+      // from here on need the new positions.
+      if (outputSpec.format_version != io::formats::extraction::XdrVersionNumber
+	  && std::holds_alternative<multi_timestep_file>(outputSpec.ts_mode))
+	WritePositionTable();
+
+      // The offsets now describe the timesteps written from here on.
+      WriteOffsetFile();
     }
 
     // Work out how many bytes are needed to write one site's data.
@@ -185,9 +345,9 @@ namespace hemelb::extraction
       // Encoder for ONLY the main header (note shorter length)
       headerWriter << std::uint32_t(io::formats::HemeLbMagicNumber)
 		   << std::uint32_t(io::formats::extraction::MagicNumber)
-		   << std::uint32_t(io::formats::extraction::VersionNumber);
-      headerWriter << double(dataSource.GetVoxelSize());
-      const util::Vector3D<distribn_t> &origin = dataSource.GetOrigin();
+		   << std::uint32_t(outputSpec.format_version);
+      headerWriter << double(dataSource->GetVoxelSize());
+      const util::Vector3D<distribn_t> &origin = dataSource->GetOrigin();
       headerWriter << double(origin[0]) << double(origin[1]) << double(origin[2]);
 
       // Write the total site count and number of fields
@@ -235,20 +395,11 @@ namespace hemelb::extraction
         // Write from the buffer
         outputFile.WriteAt(0, to_const_span(header_data));
       }
-    }
+      record_start = header_length;
 
-    template <typename... Ts>
-    std::string safe_fmt(std::string const& pattern, Ts... args) {
-        int sz = std::snprintf(nullptr, 0,
-                               pattern.data(), args...);
-        if (sz < 0)
-            throw Exception() << "Formatting error";
-
-        // +1 for the null terminator
-        std::string ans(sz + 1, '\0');
-        std::snprintf(ans.data(), ans.size(),
-                      pattern.data(), args...);
-        return ans;
+      // Version 6 files give the positions once, up front.
+      if (outputSpec.format_version != io::formats::extraction::XdrVersionNumber)
+	WritePositionTable();
     }
 
     void LocalPropertyOutput::Write(unsigned long timestepNumber, unsigned long totalSteps)
@@ -259,118 +410,132 @@ namespace hemelb::extraction
             return;
         }
 
-        if (std::holds_alternative<single_timestep_files>(outputSpec.ts_mode)) {
-            int prec = 3;
-            unsigned long next = 1000;
-            while (totalSteps > next) {
-                prec += 1;
-                next *= 10;
-            }
-            std::string fn = safe_fmt(output_file_pattern, prec, timestepNumber);
-            StartFile(fn);
-        }
-
-      // Don't write if this core doesn't do anything.
-      if (local_data_write_length > 0)
-      {
-	// Create the buffer.
-	auto xdrWriter = io::MakeXdrWriter(buffer.begin(), buffer.end());
-
-	// Firstly, the IO proc must write the iteration number.
-	if (comms.OnIORank())
-	{
-	  xdrWriter << (uint64_t) timestepNumber;
-	}
+        // Start writing any earlier timesteps whose data have now
+        // reached the writer.
+        for (auto& earlier: slots)
+            StartWrites(earlier, false);
 
-	dataSource.Reset();
+        // Reuse the buffer of the oldest write, waiting for it if it
+        // is still going.
+        auto& slot = slots[next_slot];
+        Complete(slot);
+        next_slot = (next_slot + 1) % slots.size();
 
-	while (dataSource.ReadNext())
-	{
-	  const util::Vector3D<site_t>& position = dataSource.GetPosition();
-	  if (outputSpec.geometry->Include(dataSource, position))
-	  {
-	    // Write the position
-	    xdrWriter << (uint32_t) position.x() << (uint32_t) position.y() << (uint32_t) position.z();
-
-	    // Write for each field.
-	    for (auto& fieldSpec: outputSpec.fields)
-	    {
-	      overload_visit(
-	        fieldSpec.src,
-		[&](source::Pressure) {
-		  write(xdrWriter, fieldSpec.typecode, dataSource.GetPressure() - fieldSpec.offset[0]);
-		},
-		[&](source::Velocity) {
-		  auto&& v = dataSource.GetVelocity();
-		  write(xdrWriter, fieldSpec.typecode, v.x(), v.y(), v.z());
-		},
-		//! @TODO: Work out how to handle the different stresses.
-		[&](source::VonMisesStress) {
-		  write(xdrWriter, fieldSpec.typecode, dataSource.GetVonMisesStress());
-		},
-		[&](source::ShearStress) {
-		  write(xdrWriter, fieldSpec.typecode, dataSource.GetShearStress());
-		},
-		[&](source::ShearRate) {
-		  write(xdrWriter, fieldSpec.typecode, dataSource.GetShearRate());
-		},
-		[&](source::StressTensor) {
-		  util::Matrix3D tensor = dataSource.GetStressTensor();
-		  // Only the upper triangular part of the symmetric
-		  // tensor is stored. Storage is row-wise.
-		  write(xdrWriter, fieldSpec.typecode,
-			tensor[0][0], tensor[0][1], tensor[0][2],
-                                      tensor[1][1], tensor[1][2],
-                                                    tensor[2][2]);
-		},
-		[&](source::Traction) {
-		  auto&& t = dataSource.GetTraction();
-		  write(xdrWriter, fieldSpec.typecode, t.x(), t.y(), t.z());
-		},
-		[&](source::TangentialProjectionTraction) {
-		  auto&& t = dataSource.GetTangentialProjectionTraction();
-		  write(xdrWriter, fieldSpec.typecode, t.x(), t.y(), t.z());
-		},
-		[&](source::Distributions) {
-		  unsigned numComponents = dataSource.GetNumVectors();
-		  distribn_t const* d_ptr = dataSource.GetDistribution();
-		  for (auto i = 0U; i < numComponents; i++)
-		  {
-		    write(xdrWriter, fieldSpec.typecode, d_ptr[i]);
-		  }
-		},
-		[&](source::MpiRank) {
-		  write(xdrWriter, fieldSpec.typecode, comms.Rank());
-		}
-              );
-	    }
-	  }
-	}
+        if (std::holds_alternative<single_timestep_files>(outputSpec.ts_mode)) {
+            StartFile(TimestepFileName(output_file_pattern, timestepNumber, totalSteps));
+        }
 
-	// Actually do the MPI writing.
-	outputFile.WriteAt(local_write_start, to_const_span(buffer));
+      if (outputSpec.format_version == io::formats::extraction::XdrVersionNumber) {
+	// Don't write if this core doesn't do anything.
+	if (local_data_write_length > 0)
+	  EncodeXdr(slot.buffer.data() + data_layout.pieces[0].buffer_offset, timestepNumber);
+      } else {
+	EncodeColumns(slot, timestepNumber);
       }
 
+      // Actually do the MPI writing.
+      Forward(slot, data_layout, record_start);
+
       overload_visit(
         outputSpec.ts_mode,
 	[this](multi_timestep_file) {
 	  // Set the offset to the right place for writing on the next
 	  // iteration.
-	  local_write_start += global_data_write_length;
+	  record_start += global_data_write_length;
 	},
 	[this](single_timestep_files) {
+	  // The slot holds the file, which is closed once the write
+	  // completes.
 	  outputFile.Close();
 	}
       );
+
+      // Without asynchronous output, finish before returning.
+      if (outputSpec.async_buffers == 0)
+	Complete(slot);
+    }
+
+    void LocalPropertyOutput::EncodeXdr(char* dest, std::uint64_t timestepNumber)
+    {
+      auto xdrWriter = io::MakeXdrWriter(dest, dest + local_data_write_length);
+
+      // Firstly, the IO proc must write the iteration number.
+      if (comms.OnIORank())
+      {
+	xdrWriter << timestepNumber;
+      }
+
+      for (auto site: written_sites)
+      {
+	dataSource->ReadAt(site);
+	const util::Vector3D<site_t>& position = dataSource->GetPosition();
+	// Write the position
+	xdrWriter << (uint32_t) position.x() << (uint32_t) position.y() << (uint32_t) position.z();
+
+	// Write for each field.
+	for (auto& fieldSpec: outputSpec.fields)
+	{
+	  EncodeField(xdrWriter, fieldSpec, *dataSource, comms.Rank());
+	}
+      }
+    }
+
+    void LocalPropertyOutput::EncodeColumns(WriteSlot& slot, std::uint64_t timestepNumber)
+    {
+      auto piece = data_layout.pieces.begin();
+      if (comms.OnIORank())
+      {
+	io::formats::extraction::ToLittleEndian(timestepNumber, slot.buffer.data() + piece->buffer_offset);
+      }
+
+      // One pass over the sites for each field, so each field's
+      // values are contiguous.
+      for (auto& fieldSpec: outputSpec.fields)
+      {
+	++piece;
+	LittleEndianWriter writer{slot.buffer.data() + piece->buffer_offset};
+	for (auto site: written_sites)
+	{
+	  dataSource->ReadAt(site);
+	  EncodeField(writer, fieldSpec, *dataSource, comms.Rank());
+	}
+      }
+    }
+
+    void LocalPropertyOutput::WritePositionTable()
+    {
+      namespace fmt = io::formats::extraction;
+      // Positions are written rarely, so there's no need to overlap
+      // this with the simulation.
+      WriteSlot slot;
+      slot.buffer.resize(table_layout.buffer_length);
+      if (comms.OnIORank())
+      {
+	fmt::ToLittleEndian(fmt::PositionTableTag, slot.buffer.data() + table_layout.pieces[0].buffer_offset);
+      }
+      LittleEndianWriter writer{slot.buffer.data() + table_layout.pieces[1].buffer_offset};
+      for (auto site: written_sites)
+      {
+	dataSource->ReadAt(site);
+	const util::Vector3D<site_t>& position = dataSource->GetPosition();
+	writer << (uint32_t) position.x() << (uint32_t) position.y() << (uint32_t) position.z();
+      }
+
+      Forward(slot, table_layout, record_start);
+      Complete(slot);
+      record_start += table_length;
     }
 
     // Write the offset file.
     void LocalPropertyOutput::WriteOffsetFile() {
       namespace fmt = io::formats;
+      if (outputSpec.format_version != fmt::extraction::XdrVersionNumber)
+	return;
 
-      // Create the file.
+      // Create the file, or replace its offsets if redistributing.
       auto offsetFile = net::MpiFile::Open(comms, offset_file_name,
-				      MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL);
+				      MPI_MODE_WRONLY | MPI_MODE_CREATE | (offsets_written ? 0 : MPI_MODE_EXCL));
+      offsets_written = true;
 
       // On process 0 only, write the header
       if (comms.OnIORank()) {
@@ -384,50 +549,20 @@ namespace hemelb::extraction
 	offsetFile.WriteAt(0, to_const_span(buf));
       }
       // Every rank writes its offset
-      uint64_t offsetForOffset = comms.Rank() * sizeof(local_write_start)
+      uint64_t const first_write_start = header_length + rank_write_offset;
+      uint64_t offsetForOffset = comms.Rank() * sizeof(first_write_start)
 	+ fmt::offset::HeaderLength;
-      offsetFile.WriteAt(offsetForOffset, to_const_span(quick_encode(local_write_start)));
+      offsetFile.WriteAt(offsetForOffset, to_const_span(quick_encode(first_write_start)));
 
       // Last process writes total
       if (comms.Rank() == (comms.Size()-1)) {
-	offsetFile.WriteAt(offsetForOffset + sizeof(local_write_start),
-			   to_const_span(quick_encode(local_write_start + local_data_write_length)));
+	offsetFile.WriteAt(offsetForOffset + sizeof(first_write_start),
+			   to_const_span(quick_encode(first_write_start + local_data_write_length)));
       }
     }
 
     unsigned LocalPropertyOutput::GetFieldLength(source::Type src) const
     {
-      return overload_visit(src,
-	[](source::Pressure) {
-	  return 1U;
-	},
-	[](source::Velocity) {
-	  return 3U;
-	},
-	[](source::ShearStress) {
-	  return 1U;
-	},
-	[](source::VonMisesStress) {
-	  return 1U;
-	},
-	[](source::ShearRate) {
-	  return 1U;
-	},
-	[](source::StressTensor) {
-	  return 6U;
-	},
-	[](source::Traction) {
-	  return 3U;
-	},
-	[](source::TangentialProjectionTraction) {
-	  return 3U;
-	},
-	[&](source::Distributions) {
-	  return dataSource.GetNumVectors();
-	},
-	[](source::MpiRank) {
-	  return 1U;
-	}
-      );
+      return extraction::GetFieldLength(src, *dataSource);
     }
 }
@@ -7,6 +7,7 @@
 #define HEMELB_EXTRACTION_LOCALPROPERTYOUTPUT_H
 
 #include "extraction/IterableDataSource.h"
+#include "extraction/PropertyOutput.h"
 #include "extraction/PropertyOutputFile.h"
 #include "lb/Lattices.h"
 #include "net/mpi.h"
@@ -21,8 +22,8 @@ namespace hemelb
   namespace extraction
   {
     // Stores sufficient information to output property information
-    // from this core.
-    class LocalPropertyOutput
+    // from this core to an extraction file.
+    class LocalPropertyOutput : public PropertyOutput
     {
     public:
       // Initialises a LocalPropertyOutput. Required so we can use
@@ -30,25 +31,115 @@ namespace hemelb
       LocalPropertyOutput(IterableDataSource& dataSource, const PropertyOutputFile& outputSpec,
 			  const net::IOCommunicator& ioComms);
 
+      // Doesn't complete the writes still in flight, as that is
+      // collective and can fail: call Flush first. Any that remain
+      // are waited for on this rank only, with a warning.
+      ~LocalPropertyOutput() override;
+
       // True if this property output should be written on the current iteration.
-      bool ShouldWrite(unsigned long timestepNumber) const;
+      bool ShouldWrite(unsigned long timestepNumber) const override;
 
       // Returns the property output file object to be written.
-      const PropertyOutputFile& GetOutputSpec() const;
+      const PropertyOutputFile& GetOutputSpec() const override;
 
       // Write this core's section of the data file. Only writes if
       // appropriate for the current iteration number
-      void Write(unsigned long timestepNumber, unsigned long totalSteps);
+      void Write(unsigned long timestepNumber, unsigned long totalSteps) override;
+
+      // Wait for all the writes still in flight to finish (and,
+      // with single timestep files, close those files). Collective
+      // on the communicator.
+      void Flush() override;
 
-      // Write the offset file. Collective on the communicator.
+      // Write the offset file (only for version 5, as version 6 files
+      // don't need one). Collective on the communicator.
       void WriteOffsetFile();
 
+      // Take the data from another source, after the domain has been
+      // decomposed again. Later timesteps go on in the same file.
+      // Collective on the communicator.
+      void SetDataSource(IterableDataSource& source) override;
+
       // Returns the number of items written for the field.
       unsigned GetFieldLength(source::Type) const;
 
     private:
-      // How many sites does this MPI process write?
-      std::uint64_t CountWrittenSitesOnRank();
+      // A contiguous piece of a buffer, which goes to the same place
+      // in every record of one kind.
+      struct Stripe
+      {
+	// Bytes from the start of the record in the file
+	std::uint64_t file_offset;
+	// Bytes from the start of the buffer
+	std::uint64_t buffer_offset;
+	std::uint64_t length;
+      };
+
+      // The data for one timestep on its way to disk: the serialised
+      // data, the requests for sending it to the writer or writing it
+      // and the file it goes into. On a writer, the group's data are
+      // received into the buffer and the writes (with file offsets
+      // from the start of the file) wait until they have all
+      // arrived. The buffer can't be reused until the requests have
+      // completed.
+      struct WriteSlot
+      {
+	std::vector<char> buffer;
+	std::vector<MPI_Request> receives;
+	std::vector<Stripe> pending_writes;
+	std::vector<MPI_Request> requests;
+	net::MpiFile file;
+      };
+
+      // Where the data of one kind of record (a timestep or, in
+      // version 6 files, a position table) go.
+      struct Layout
+      {
+	// This rank's pieces of the record. Every member of a writer
+	// group has the same number, though some may be empty.
+	std::vector<Stripe> pieces;
+	// The length of the buffer needed.
+	std::uint64_t buffer_length = 0;
+	// On the writer, where each member's pieces go in the buffer
+	// (member by member) and their lengths.
+	std::vector<std::uint64_t> member_displacements;
+	std::vector<std::uint64_t> member_lengths;
+	// On the writer, the group's data in as few pieces as the
+	// file layout allows.
+	std::vector<Stripe> stripes;
+      };
+
+      // Start the slot's pending writes if its data have been
+      // received, or once they have if asked to wait.
+      void StartWrites(WriteSlot& slot, bool wait);
+
+      // Wait for the slot's writes to finish and close its file, if
+      // it has one. Collective on the communicator.
+      void Complete(WriteSlot& slot);
+
+      // Work out how a record of this rank's pieces (with their
+      // buffer offsets unset) is put together by its writer.
+      // Collective on the communicator.
+      Layout MakeLayout(std::vector<Stripe> pieces) const;
+
+      // Send the slot's data to the writer, which writes the group's
+      // data into the record starting at the given place in the file
+      // once they have arrived. Collective on the communicator.
+      void Forward(WriteSlot& slot, Layout const& layout, std::uint64_t record_start);
+
+      // Serialise one timestep in the original XDR format.
+      void EncodeXdr(char* dest, std::uint64_t timestepNumber);
+
+      // Serialise one timestep as little-endian arrays, one per
+      // field, into the layout's pieces.
+      void EncodeColumns(WriteSlot& slot, std::uint64_t timestepNumber);
+
+      // Write the positions of the sites for a version 6 file at the
+      // current end of the file. Collective on the communicator.
+      void WritePositionTable();
+
+      // Work out how much this rank writes per timestep and where.
+      void Distribute();
 
       // How many bytes are written for a single site?
       std::uint64_t CalcSiteWriteLen(std::vector<OutputField> const& fields) const;
@@ -56,7 +147,8 @@ namespace hemelb
       // Make the XTR header
       std::vector<char> PrepareHeader() const;
 
-      // Open the file specified and write the header. Collective.
+      // Open the file specified and write the header (and the
+      // position table, if needed). Collective.
       void StartFile(std::string const& fn);
 
       // Our communicator
@@ -70,11 +162,16 @@ namespace hemelb
       net::MpiFile outputFile;
 
       // The data source to use for file output.
-      IterableDataSource& dataSource;
+      IterableDataSource* dataSource;
 
       // PropertyOutputFile spec.
       PropertyOutputFile outputSpec;
 
+      // The indices in the data source of the sites this rank
+      // writes. The selection doesn't change during a run, so this
+      // is found once rather than on every write.
+      std::vector<site_t> written_sites;
+
       // How many local/global sites will be written
       std::uint64_t local_site_count;
       std::uint64_t global_site_count;
@@ -87,12 +184,34 @@ namespace hemelb
       // The length, in bytes, of the local/global data write for one timestep
       std::uint64_t local_data_write_length;
       std::uint64_t global_data_write_length;
-
-      // Where, in bytes, to begin writing into the file.
-      std::uint64_t local_write_start;
-
-      // Buffer to serialise into before writing to disk.
-      std::vector<char> buffer;
+      // The length, in bytes, of a version 6 position table
+      std::uint64_t table_length;
+
+      // Where, in bytes, this rank's data starts within a timestep.
+      std::uint64_t rank_write_offset;
+
+      // Where, in bytes, the next record starts in the file.
+      std::uint64_t record_start;
+
+      // This rank and the others of its node that send their data to
+      // the same writer, which is rank zero of this communicator.
+      net::MpiCommunicator writers;
+      // How this rank's data get into timestep and position table
+      // records.
+      Layout data_layout;
+      Layout table_layout;
+
+      // Has the offset file been written yet?
+      bool offsets_written = false;
+
+      // Buffers to serialise into before writing to disk (on a
+      // writer, large enough for the whole group's data). With
+      // asynchronous output, the writes of up to this many timesteps
+      // can be in flight while the simulation goes on; otherwise
+      // there is one and each write finishes before Write returns.
+      std::vector<WriteSlot> slots;
+      // The slot to use next, i.e. the one holding the oldest write.
+      std::size_t next_slot = 0;
 
       // The MPI file to write the offsets into.
       std::string offset_file_name;
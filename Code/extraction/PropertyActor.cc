@@ -21,7 +21,7 @@ namespace hemelb::extraction
 
     void PropertyActor::SetRequiredProperties(lb::MacroscopicPropertyCache& propertyCache)
     {
-        const std::vector<LocalPropertyOutput*>& propertyOutputs =
+        const std::vector<PropertyOutput*>& propertyOutputs =
                 propertyWriter->GetPropertyOutputs();
 
         // Iterate over each property output spec.
@@ -82,4 +82,11 @@ namespace hemelb::extraction
       timers[reporting::Timers::extractionWriting].Stop();
     }
 
+    void PropertyActor::Flush()
+    {
+      timers[reporting::Timers::extractionWriting].Start();
+      propertyWriter->Flush();
+      timers[reporting::Timers::extractionWriting].Stop();
+    }
+
 }
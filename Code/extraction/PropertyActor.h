@@ -38,11 +38,26 @@ namespace hemelb::extraction
          */
         void SetRequiredProperties(lb::MacroscopicPropertyCache& propertyCache);
 
+        /**
+         * Collective. Write from another data source, after the domain
+         * has been decomposed again.
+         * @param dataSource
+         */
+        void SetDataSource(IterableDataSource& dataSource)
+        {
+          propertyWriter->SetDataSource(dataSource);
+        }
+
         /**
          * Override the iterated actor end of iteration method to perform writing.
          */
         void EndIteration() override;
 
+        /**
+         * Collective. Wait for any asynchronous writes to finish.
+         */
+        void Flush();
+
       private:
         const lb::SimulationState& simulationState;
         std::unique_ptr<PropertyWriter> propertyWriter;
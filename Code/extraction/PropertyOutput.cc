@@ -0,0 +1,63 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+#include <string_view>
+
+#include "extraction/PropertyOutput.h"
+#include "Exception.h"
+
+namespace hemelb::extraction
+{
+    namespace
+    {
+      template <typename... Ts>
+      std::string safe_fmt(std::string const& pattern, Ts... args) {
+        int sz = std::snprintf(nullptr, 0,
+                               pattern.data(), args...);
+        if (sz < 0)
+            throw Exception() << "Formatting error";
+
+        // +1 for the null terminator, which isn't part of the result
+        std::string ans(sz + 1, '\0');
+        std::snprintf(ans.data(), ans.size(),
+                      pattern.data(), args...);
+        ans.resize(sz);
+        return ans;
+      }
+    }
+
+    auto PropertyOutput::SplitFileName(std::filesystem::path const& filename) -> SplitName
+    {
+      SplitName ans;
+      // Get views of the whole path
+      std::string_view p = filename.native();
+      auto i_pcd = p.find("%d", 0, 2);
+      // The part before %d
+      auto beginning = p.substr(0, i_pcd);
+      // The part after
+      auto end = p.substr(i_pcd + 2);
+      // Construct the path without '%d'
+      ans.basename = beginning;
+      ans.basename += end;
+      // Build the pattern
+      ans.pattern += beginning;
+      ans.pattern += "%*ld";
+      ans.pattern += end;
+      return ans;
+    }
+
+    std::string PropertyOutput::TimestepFileName(std::string const& pattern, unsigned long timestepNumber,
+						 unsigned long totalSteps)
+    {
+      int prec = 3;
+      unsigned long next = 1000;
+      while (totalSteps > next) {
+        prec += 1;
+        next *= 10;
+      }
+      return safe_fmt(pattern, prec, timestepNumber);
+    }
+}
@@ -0,0 +1,62 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_PROPERTYOUTPUT_H
+#define HEMELB_EXTRACTION_PROPERTYOUTPUT_H
+
+#include <filesystem>
+#include <string>
+
+#include "extraction/IterableDataSource.h"
+#include "extraction/PropertyOutputFile.h"
+
+namespace hemelb::extraction
+{
+    // Interface to this core's part of one property output file,
+    // whatever format the file is in.
+    class PropertyOutput
+    {
+    public:
+      // Doesn't report errors, so call Flush first to complete the
+      // writes still in flight.
+      virtual ~PropertyOutput() = default;
+
+      // True if this property output should be written on the current iteration.
+      virtual bool ShouldWrite(unsigned long timestepNumber) const = 0;
+
+      // Returns the property output file object to be written.
+      virtual const PropertyOutputFile& GetOutputSpec() const = 0;
+
+      // Write this core's section of the data file. Only writes if
+      // appropriate for the current iteration number
+      virtual void Write(unsigned long timestepNumber, unsigned long totalSteps) = 0;
+
+      // Wait for all the writes still in flight to finish. Collective
+      // on the communicator.
+      virtual void Flush() = 0;
+
+      // Take the data from another source, after the domain has been
+      // decomposed again. Collective on the communicator.
+      virtual void SetDataSource(IterableDataSource& source) = 0;
+
+    protected:
+      // For single timestep files, the file name in the spec (which
+      // has exactly one '%d') split into a pattern for
+      // TimestepFileName and the name without the '%d'.
+      struct SplitName
+      {
+	std::string pattern;
+	std::string basename;
+      };
+      static SplitName SplitFileName(std::filesystem::path const& filename);
+
+      // The name of the file for one timestep, with the number padded
+      // to the same width for every timestep of the run.
+      static std::string TimestepFileName(std::string const& pattern, unsigned long timestepNumber,
+					  unsigned long totalSteps);
+    };
+}
+
+#endif // HEMELB_EXTRACTION_PROPERTYOUTPUT_H
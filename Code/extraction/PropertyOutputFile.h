@@ -10,6 +10,7 @@
 #include <variant>
 #include <vector>
 
+#include "io/formats/extraction.h"
 #include "util/clone_ptr.h"
 #include "extraction/GeometrySelector.h"
 #include "extraction/OutputField.h"
@@ -31,6 +32,21 @@ namespace hemelb::extraction
     util::clone_ptr<GeometrySelector> geometry;
     std::vector<OutputField> fields;
     file_timestep_mode ts_mode;
+    // How many timesteps' data may be in flight to disk at once. If
+    // zero, writes finish before the time step does.
+    unsigned async_buffers = 0;
+    // How many ranks of a node send their data to one of them, which
+    // writes it all to the file. If zero, one rank writes for the
+    // whole node.
+    unsigned ranks_per_writer = 1;
+    // The version of the extraction file format to write.
+    std::uint32_t format_version = io::formats::extraction::XdrVersionNumber;
+    // Write an HDF5 file, described by an XDMF file alongside it,
+    // instead of an extraction file.
+    bool hdf5 = false;
+    // For HDF5 files, the deflate level of the fields' chunks (zero
+    // for no compression).
+    unsigned compression = 0;
   };
 }
 
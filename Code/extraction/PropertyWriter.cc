@@ -4,20 +4,38 @@
 // license in the file LICENSE.
 
 #include "extraction/PropertyWriter.h"
+#include "extraction/LocalPropertyOutput.h"
+#ifdef HEMELB_USE_HDF5
+#include "extraction/Hdf5PropertyOutput.h"
+#endif
 
 namespace hemelb
 {
   namespace extraction
   {
+    namespace
+    {
+      PropertyOutput* CreateOutput(IterableDataSource& dataSource, const PropertyOutputFile& spec,
+                                   const net::IOCommunicator& ioComms)
+      {
+        if (!spec.hdf5)
+          return new LocalPropertyOutput(dataSource, spec, ioComms);
+#ifdef HEMELB_USE_HDF5
+        return new Hdf5PropertyOutput(dataSource, spec, ioComms);
+#else
+        throw Exception() << "Cannot write " << spec.filename
+                          << " as HDF5: this build of HemeLB has no HDF5 support (set HEMELB_USE_HDF5=ON)";
+#endif
+      }
+    }
+
     PropertyWriter::PropertyWriter(IterableDataSource& dataSource,
                                    const std::vector<PropertyOutputFile>& propertyOutputs,
                                    const net::IOCommunicator& ioComms)
     {
       for (unsigned outputNumber = 0; outputNumber < propertyOutputs.size(); ++outputNumber)
       {
-        localPropertyOutputs.push_back(new LocalPropertyOutput(dataSource,
-                                                               propertyOutputs[outputNumber],
-                                                               ioComms));
+        localPropertyOutputs.push_back(CreateOutput(dataSource, propertyOutputs[outputNumber], ioComms));
       }
     }
 
@@ -29,11 +47,19 @@ namespace hemelb
       }
     }
 
-    const std::vector<LocalPropertyOutput*>& PropertyWriter::GetPropertyOutputs() const
+    const std::vector<PropertyOutput*>& PropertyWriter::GetPropertyOutputs() const
     {
       return localPropertyOutputs;
     }
 
+    void PropertyWriter::SetDataSource(IterableDataSource& dataSource)
+    {
+      for (auto propertyOutput : localPropertyOutputs)
+      {
+        propertyOutput->SetDataSource(dataSource);
+      }
+    }
+
     void PropertyWriter::Write(unsigned long iterationNumber, unsigned long totalSteps) const
     {
       for (unsigned outputNumber = 0; outputNumber < localPropertyOutputs.size(); ++outputNumber)
@@ -41,5 +67,13 @@ namespace hemelb
         localPropertyOutputs[outputNumber]->Write((uint64_t) iterationNumber, totalSteps);
       }
     }
+
+    void PropertyWriter::Flush() const
+    {
+      for (auto propertyOutput : localPropertyOutputs)
+      {
+        propertyOutput->Flush();
+      }
+    }
   }
 }
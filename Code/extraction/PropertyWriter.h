@@ -6,12 +6,16 @@
 #ifndef HEMELB_EXTRACTION_PROPERTYWRITER_H
 #define HEMELB_EXTRACTION_PROPERTYWRITER_H
 
-#include "extraction/LocalPropertyOutput.h"
+#include "extraction/PropertyOutput.h"
 #include "extraction/PropertyOutputFile.h"
 #include "net/mpi.h"
 
 namespace hemelb
 {
+  namespace net
+  {
+    class IOCommunicator;
+  }
   namespace extraction
   {
     class PropertyWriter
@@ -41,16 +45,28 @@ namespace hemelb
         void Write(unsigned long iterationNumber, unsigned long totalSteps) const;
 
         /**
-         * Returns a vector of all the LocalPropertyOutputs.
+         * Collective. Wait for the writes of all the files to finish.
+         */
+        void Flush() const;
+
+        /**
+         * Collective. Take the data from another source, after the domain
+         * has been decomposed again.
+         * @param dataSource
+         */
+        void SetDataSource(IterableDataSource& dataSource);
+
+        /**
+         * Returns a vector of all the PropertyOutputs.
          * @return
          */
-        const std::vector<LocalPropertyOutput*>& GetPropertyOutputs() const;
+        const std::vector<PropertyOutput*>& GetPropertyOutputs() const;
 
       private:
         /**
          * Holds sufficient information to output property information from this core.
          */
-        std::vector<LocalPropertyOutput*> localPropertyOutputs;
+        std::vector<PropertyOutput*> localPropertyOutputs;
     };
   }
 }
@@ -0,0 +1,239 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+#define HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+
+#include <array>
+#include <concepts>
+#include <span>
+#include <type_traits>
+
+#include "build_info.h"
+#include "Exception.h"
+#include "units.h"
+
+namespace hemelb::geometry
+{
+    // A distribution layout decides where the value for (site,
+    // direction) lives in the FieldData distribution arrays. The first
+    // Q * Stride(N) entries of those arrays belong to the N local fluid
+    // sites, followed by the "rubbish site" and then the distributions
+    // shared with neighbouring ranks.
+    template <typename T>
+    concept distribution_layout = requires(site_t site, Direction dir, unsigned Q, site_t n) {
+        { T::SITE_CONTIGUOUS } -> std::convertible_to<bool>;
+        { T::Stride(n) } -> std::same_as<site_t>;
+        { T::Index(site, dir, Q, n) } -> std::same_as<site_t>;
+    };
+
+    // Site-major, "array of structures" layout: the Q values of a
+    // site are adjacent, i.e. f[site * Q + dir].
+    struct SiteMajorLayout
+    {
+        static constexpr bool SITE_CONTIGUOUS = true;
+
+        static constexpr site_t Stride(site_t nSites)
+        {
+            return nSites;
+        }
+
+        static constexpr site_t Index(site_t site, Direction dir, unsigned Q, site_t)
+        {
+            return site * Q + dir;
+        }
+    };
+
+    // Direction-major, "structure of arrays" layout: the values for
+    // one direction are adjacent for consecutive sites, i.e. f[dir *
+    // stride + site]. The stride is the site count padded up to a
+    // whole number of SIMD-width lanes so each direction's array starts
+    // aligned and a vector loop over sites never straddles two directions.
+    struct DirectionMajorLayout
+    {
+        static constexpr bool SITE_CONTIGUOUS = false;
+        // Eight doubles is one AVX-512 register (or two AVX2 ones).
+        static constexpr site_t PADDING = 8;
+
+        static constexpr site_t Stride(site_t nSites)
+        {
+            return (nSites + PADDING - 1) / PADDING * PADDING;
+        }
+
+        static constexpr site_t Index(site_t site, Direction dir, unsigned, site_t stride)
+        {
+            return dir * stride + site;
+        }
+    };
+
+    namespace detail {
+        constexpr auto get_default_layout() {
+            constexpr auto LAYOUT = build_info::DISTRIBUTION_LAYOUT;
+            if constexpr (LAYOUT == "AoS") {
+                return SiteMajorLayout{};
+            } else if constexpr (LAYOUT == "SoA") {
+                return DirectionMajorLayout{};
+            } else {
+                throw (Exception() << "Configured with invalid DISTRIBUTION_LAYOUT");
+            }
+        }
+    }
+    // The layout used by FieldData, chosen by the build system.
+    using DistributionLayout = decltype(detail::get_default_layout());
+    static_assert(distribution_layout<DistributionLayout>);
+
+    // Does FieldData keep a single distribution array, updated in
+    // place with the AA pattern, rather than separate arrays for the
+    // pre- and post-streaming values? See FieldData for the scheme.
+    inline constexpr bool SINGLE_BUFFER_STREAMING = [] {
+        constexpr auto PATTERN = build_info::STREAMING_PATTERN;
+        static_assert(PATTERN == "AB" || PATTERN == "AA",
+                      "Configured with invalid STREAMING_PATTERN");
+        return PATTERN == "AA";
+    }();
+
+    // Can the Q distributions of a site be viewed as a std::span?
+    inline constexpr bool CONTIGUOUS_SITE_VIEWS =
+            DistributionLayout::SITE_CONTIGUOUS && !SINGLE_BUFFER_STREAMING;
+
+    // View of the Q distributions of a single site for layouts where
+    // they are not adjacent in memory. Supports the indexing subset of
+    // std::span's interface.
+    template <typename T, std::size_t Q>
+    class StridedDistSpan
+    {
+        T* ptr;
+        site_t stride;
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+
+        constexpr StridedDistSpan(T* p, site_t s) : ptr{p}, stride{s}
+        {
+        }
+
+        // Contiguous data is just a stride of one.
+        template <typename U>
+        requires std::convertible_to<U(*)[], T(*)[]>
+        constexpr StridedDistSpan(std::span<U, Q> s) : ptr{s.data()}, stride{1}
+        {
+        }
+
+        // Allow mutable -> const conversion
+        template <typename U>
+        requires std::convertible_to<U(*)[], T(*)[]>
+        constexpr StridedDistSpan(StridedDistSpan<U, Q> const& other) : ptr{&other[0]}, stride{other.Stride()}
+        {
+        }
+
+        constexpr T& operator[](std::size_t i) const
+        {
+            return ptr[i * stride];
+        }
+
+        static constexpr std::size_t size()
+        {
+            return Q;
+        }
+
+        constexpr site_t Stride() const
+        {
+            return stride;
+        }
+    };
+
+    // View of the Q distributions of a single site where each one
+    // may be anywhere in the array, as happens with in-place
+    // streaming. Holds the Q indices, so is cheap only to read.
+    template <typename T, std::size_t Q>
+    class IndirectDistSpan
+    {
+        T* base;
+        std::array<site_t, Q> indices;
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+
+        constexpr IndirectDistSpan(T* b, std::array<site_t, Q> const& idx) : base{b}, indices{idx}
+        {
+        }
+
+        // Contiguous data, such as a neighbouring rank's copy of a
+        // site, is just the indices 0 to Q-1.
+        template <typename U>
+        requires std::convertible_to<U(*)[], T(*)[]>
+        constexpr IndirectDistSpan(std::span<U, Q> s) : base{s.data()}
+        {
+            for (std::size_t i = 0; i < Q; ++i)
+                indices[i] = i;
+        }
+
+        // Allow mutable -> const conversion
+        template <typename U>
+        requires std::convertible_to<U(*)[], T(*)[]>
+        constexpr IndirectDistSpan(IndirectDistSpan<U, Q> const& other) :
+                base{other.Base()}, indices{other.Indices()}
+        {
+        }
+
+        constexpr T& operator[](std::size_t i) const
+        {
+            return base[indices[i]];
+        }
+
+        static constexpr std::size_t size()
+        {
+            return Q;
+        }
+
+        constexpr T* Base() const
+        {
+            return base;
+        }
+
+        constexpr std::array<site_t, Q> const& Indices() const
+        {
+            return indices;
+        }
+    };
+
+    // The type of a view of one site's distributions in FieldData.
+    template <typename T, std::size_t Q>
+    using SiteDistSpan = std::conditional_t<
+            SINGLE_BUFFER_STREAMING,
+            IndirectDistSpan<T, Q>,
+            std::conditional_t<
+                    DistributionLayout::SITE_CONTIGUOUS,
+                    std::span<T, Q>,
+                    StridedDistSpan<T, Q>
+            >
+    >;
+    template <std::size_t Q>
+    using ConstSiteDistSpan = SiteDistSpan<const distribn_t, Q>;
+    template <std::size_t Q>
+    using MutSiteDistSpan = SiteDistSpan<distribn_t, Q>;
+
+    // Get something usable as a contiguous span from a view of a
+    // site's distributions. For contiguous data this is the view
+    // itself; otherwise the values are copied into an array, so hold
+    // on to the result for as long as any span made from it.
+    template <typename T, std::size_t Q>
+    constexpr auto Contiguous(std::span<T, Q> s)
+    {
+        return s;
+    }
+
+    template <typename T, std::size_t Q, template <typename, std::size_t> class View>
+    requires (!std::same_as<View<T, Q>, std::span<T, Q>>)
+    constexpr auto Contiguous(View<T, Q> const& s)
+    {
+        std::array<std::remove_cv_t<T>, Q> ans;
+        for (std::size_t i = 0; i < Q; ++i)
+            ans[i] = s[i];
+        return ans;
+    }
+}
+
+#endif // HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
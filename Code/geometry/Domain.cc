@@ -3,18 +3,36 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <limits>
+
+#include "Exception.h"
 #include "log/Logger.h"
 #include "geometry/BlockTraverser.h"
 #include "geometry/Domain.h"
 #include "geometry/GmyReadResult.h"
 #include "geometry/neighbouring/NeighbouringDomain.h"
 #include "geometry/LookupTree.h"
+#include "geometry/SiteOrdering.h"
 #include "net/IOCommunicator.h"
 #include "net/net.h"
 #include "reporting/Dict.h"
 
 namespace hemelb::geometry
 {
+    namespace {
+        // Reorder values so the i'th group of width is the one that was
+        // at position order[i].
+        template <typename T>
+        void Permute(std::vector<T>& values, std::vector<std::size_t> const& order, std::size_t width = 1)
+        {
+            std::vector<T> ans;
+            ans.reserve(values.size());
+            for (auto i: order)
+                ans.insert(ans.end(), values.begin() + i * width, values.begin() + (i + 1) * width);
+            values = std::move(ans);
+        }
+    }
+
         Domain::Domain(const lb::LatticeInfo& latticeInfo,
                        const net::IOCommunicator& comms_) :
                 latticeInfo(latticeInfo),
@@ -48,6 +66,7 @@ namespace hemelb::geometry
             CollectFluidSiteDistribution();
             CollectGlobalSiteExtrema();
             InitialiseNeighbourLookups();
+            CalculateStreamingLocality();
         }
 
     std::size_t Domain::GetBlockOctIndexFromBlockCoords(const util::Vector3D<std::uint16_t> &blockCoords) const {
@@ -121,20 +140,21 @@ namespace hemelb::geometry
           // in which case the targetProcessor is SITE_OR_BLOCK_SOLID
           // Or the neighbour is also on this processor
           // in which case the targetProcessor is localRank
-          if (readResult.Blocks[block_gmy_idx].Sites.empty())
+          auto const block_sites = readResult.Blocks[block_gmy_idx].Sites;
+          if (block_sites.empty())
               return SITE_OR_BLOCK_SOLID;
 
           auto site_local_coords = global_site_coords % readResult.GetBlockSize();
           site_gmy_idx = readResult.GetSiteIdFromSiteCoordinates(site_local_coords.x(),
                                                                  site_local_coords.y(),
                                                                  site_local_coords.z());
-          return readResult.Blocks[block_gmy_idx].Sites[site_gmy_idx].targetProcessor;
+          return block_sites[site_gmy_idx].targetProcessor;
         };
 
         for (auto leaf: rank_for_site_store->GetTree().IterLeaves()) {
             auto block_ijk = leaf.coords();
             site_t blockGmyIdx = GetBlockGmyIdxFromBlockCoords(block_ijk);
-            auto const& blockReadIn = readResult.Blocks[blockGmyIdx];
+            auto const blockReadIn = readResult.Blocks[blockGmyIdx];
 
             if (blockReadIn.Sites.empty())
                 continue;
@@ -230,6 +250,34 @@ namespace hemelb::geometry
             }
         }
 
+        if constexpr (REORDER_SITES) {
+            // Renumber the sites of each range along the space-filling
+            // curve, so that sites near in space are near in memory.
+            // Everything indexed by site is built from these arrays.
+            auto const key = SelectedCurve();
+            auto const linksPerSite = latticeInfo.GetNumVectors() - 1;
+            auto reorder = [&](std::vector<site_t>& blockNumbers, std::vector<site_t>& siteNumbers,
+                               std::vector<SiteData>& data, std::vector<util::Vector3D<float>>& normals,
+                               std::vector<float>& distances) {
+                std::vector<util::Vector3D<site_t>> coords;
+                coords.reserve(blockNumbers.size());
+                for (std::size_t i = 0; i < blockNumbers.size(); ++i)
+                    coords.push_back(GetGlobalCoords(blockNumbers[i], GetSiteCoordsFromSiteId(siteNumbers[i])));
+                auto const order = CurveOrder(coords, key);
+                Permute(blockNumbers, order);
+                Permute(siteNumbers, order);
+                Permute(data, order);
+                Permute(normals, order);
+                Permute(distances, order, linksPerSite);
+            };
+            for (unsigned l = 0; l < COLLISION_TYPES; ++l) {
+                reorder(midDomainBlockNumber[l], midDomainSiteNumber[l], midDomainSiteData[l],
+                        midDomainWallNormals[l], midDomainWallDistance[l]);
+                reorder(domainEdgeBlockNumber[l], domainEdgeSiteNumber[l], domainEdgeSiteData[l],
+                        domainEdgeWallNormals[l], domainEdgeWallDistance[l]);
+            }
+        }
+
         PopulateWithReadData(midDomainBlockNumber,
                              midDomainSiteNumber,
                              midDomainSiteData,
@@ -359,10 +407,20 @@ namespace hemelb::geometry
         void Domain::CollectFluidSiteDistribution()
         {
             log::Logger::Log<log::Debug, log::Singleton>("Gathering site counts.");
-            fluidSitesOnEachProcessor = comms.AllGather(GetLocalFluidSiteCount());
-            totalFluidSites = std::reduce(
-                    fluidSitesOnEachProcessor.begin(), fluidSitesOnEachProcessor.end(),
-                    0, std::plus<>{});
+            // Only the node leaders gather every rank's count, then
+            // share them with the rest of their node.
+            using RankCount = std::array<site_t, 2>;
+            auto const& nodeComm = comms.GetNodeComm();
+            auto const nodeCounts = nodeComm.Gather(RankCount{comms.Rank(), GetLocalFluidSiteCount()}, 0);
+            std::vector<site_t> counts;
+            if (comms.AmNodeLeader()) {
+                counts.resize(comms.Size());
+                for (auto const& [rank, count]: comms.GetLeadersComm().AllGatherV(nodeCounts).data)
+                    counts[rank] = count;
+            }
+            fluidSitesOnEachProcessor = net::WinData<site_t>::Shared(counts, nodeComm);
+            auto const all = fluidSitesOnEachProcessor.Span();
+            totalFluidSites = std::reduce(all.begin(), all.end(), 0, std::plus<>{});
         }
 
         void Domain::CollectGlobalSiteExtrema()
@@ -413,8 +471,8 @@ namespace hemelb::geometry
             {
                 // Pointing to a few things, but not setting any variables.
                 // FirstSharedF points to start of shared_fs.
-                neighbouringProc.FirstSharedDistribution = GetLocalFluidSiteCount()
-                                                                         * latticeInfo.GetNumVectors() + 1 + totalSharedDistributionsSoFar;
+                neighbouringProc.FirstSharedDistribution = GetLocalDistributionCount() + 1
+                                                                         + totalSharedDistributionsSoFar;
                 totalSharedDistributionsSoFar += neighbouringProc.SharedDistributionCount;
             }
             auto sharedDistributionLocationForEachProc = InitialiseNeighbourLookup();
@@ -422,11 +480,47 @@ namespace hemelb::geometry
             InitialiseReceiveLookup(sharedDistributionLocationForEachProc);
         }
 
+        void Domain::CalculateStreamingLocality()
+        {
+            // Mean distance, in site ids, from each site to the local
+            // sites it streams to. The smaller this is, the more of the
+            // streaming target's cache lines are already resident.
+            auto const Q = latticeInfo.GetNumVectors();
+            auto const localDistributions = GetLocalDistributionCount();
+            double strideSum = 0.0;
+            site_t linkCount = 0;
+            for (site_t i = 0; i < GetLocalFluidSiteCount(); ++i)
+            {
+                for (Direction direction = 1; direction < Q; ++direction)
+                {
+                    auto const to = GetStreamedIndex(i, direction);
+                    // Skip the rubbish site and the distributions shared with other ranks
+                    if (to >= localDistributions)
+                        continue;
+                    site_t const j = DistributionLayout::SITE_CONTIGUOUS ? to / Q : to % GetDistributionStride();
+                    strideSum += std::abs(j - i);
+                    ++linkCount;
+                }
+            }
+            strideSum = comms.AllReduce(strideSum, MPI_SUM);
+            linkCount = comms.AllReduce(linkCount, MPI_SUM);
+            meanStreamingStride = linkCount ? strideSum / linkCount : 0.0;
+            log::Logger::Log<log::Info, log::Singleton>("Mean streaming stride %f sites (site ordering %s)",
+                                                        meanStreamingStride,
+                                                        build_info::SITE_ORDERING.c_str());
+        }
+
         auto Domain::InitialiseNeighbourLookup() -> proc2neighdata
         {
             proc2neighdata ans;
             const proc_t localRank = comms.Rank();
-            neighbourIndices.resize(latticeInfo.GetNumVectors() * GetLocalFluidSiteCount());
+            // The largest index streamed to is the last shared distribution.
+            if (GetLocalDistributionCount() + totalSharedFs > std::numeric_limits<neighbour_index_t>::max())
+                throw (Exception() << "Rank " << localRank << " has too many distributions for "
+                       << 8 * sizeof(neighbour_index_t) << "-bit neighbour indices;"
+                       << " rebuild with HEMELB_COMPACT_NEIGHBOUR_INDICES=OFF or use more ranks");
+            // Padding slots (if the layout has any) point at the rubbish site.
+            neighbourIndices.assign(GetLocalDistributionCount(), GetLocalDistributionCount());
             for (auto leaf: rank_for_site_store->GetTree().IterLeaves()) {
                 auto const& map_block_p = blocks[leaf.index()];
                 if (map_block_p.IsEmpty())
@@ -446,7 +540,7 @@ namespace hemelb::geometry
                     auto currentLocationCoords = lowest_site_in_block + siteTraverser.GetCurrentLocation();
                     // Set neighbour location for the distribution component at the centre of
                     // this site.
-                    SetNeighbourLocation(localIndex, 0, localIndex * latticeInfo.GetNumVectors() + 0);
+                    SetNeighbourLocation(localIndex, 0, GetDistributionIndex(localIndex, 0));
                     for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
                     {
                         // Work out positions of neighbours.
@@ -456,7 +550,7 @@ namespace hemelb::geometry
                             // Set the neighbour location to the rubbish site.
                             SetNeighbourLocation(localIndex,
                                                  direction,
-                                                 GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+                                                 GetLocalDistributionCount());
                             continue;
                         }
                         // Get the id of the processor which the neighbouring site lies on.
@@ -466,7 +560,7 @@ namespace hemelb::geometry
                             // initialize f_id to the rubbish site.
                             SetNeighbourLocation(localIndex,
                                                  direction,
-                                                 GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+                                                 GetLocalDistributionCount());
                             continue;
                         }
                         else
@@ -482,7 +576,7 @@ namespace hemelb::geometry
                             site_t contigSiteId = GetContiguousSiteId(neighbourCoords);
                             SetNeighbourLocation(localIndex,
                                                  direction,
-                                                 contigSiteId * latticeInfo.GetNumVectors() + direction);
+                                                 GetDistributionIndex(contigSiteId, direction));
                             continue;
                         }
                         else
@@ -549,7 +643,7 @@ namespace hemelb::geometry
         {
             proc_t localRank = comms.Rank();
             streamingIndicesForReceivedDistributions.resize(totalSharedFs);
-            site_t f_count = GetLocalFluidSiteCount() * latticeInfo.GetNumVectors();
+            site_t f_count = GetLocalDistributionCount();
             site_t sharedSitesSeen = 0;
             for (auto& neighbouringProc: neighbouringProcs) {
                 for (site_t sharedDistributionId = 0;
@@ -570,8 +664,8 @@ namespace hemelb::geometry
                     SetNeighbourLocation(contigSiteId, (unsigned int) ( (l)), ++f_count);
                     // Set the place where we put the received distribution functions, which is
                     // f_new[number of fluid site that sends, inverse direction].
-                    streamingIndicesForReceivedDistributions[sharedSitesSeen] = contigSiteId
-                                                                                * latticeInfo.GetNumVectors() + latticeInfo.GetInverseIndex(l);
+                    streamingIndicesForReceivedDistributions[sharedSitesSeen] =
+                            GetDistributionIndex(contigSiteId, latticeInfo.GetInverseIndex(l));
                     ++sharedSitesSeen;
                 }
 
@@ -588,6 +682,18 @@ namespace hemelb::geometry
                 GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)
         );
     }
+    std::vector<SiteRankIndex> Domain::GetRankIndexFromGlobalCoords(
+            std::span<util::Vector3D<site_t> const> globalSiteCoords) const {
+        std::vector<octree::DistributedStore::BlockSite> sites;
+        sites.reserve(globalSiteCoords.size());
+        for (auto const& globalCoords: globalSiteCoords) {
+            Vec16 blockCoords, localSiteCoords;
+            GetBlockAndLocalSiteCoords(globalCoords, blockCoords, localSiteCoords);
+            sites.emplace_back(blockCoords, GetLocalSiteIdFromLocalSiteCoords(localSiteCoords));
+        }
+        return rank_for_site_store->GetSiteData(sites);
+    }
+
         proc_t Domain::GetProcIdFromGlobalCoords(
                 const util::Vector3D<site_t>& globalSiteCoords) const
         {
@@ -707,6 +813,28 @@ namespace hemelb::geometry
         return local_idx >= n_mid_domain;
     }
 
+    std::vector<bool> Domain::IsSiteDomainEdge(std::span<SiteRankIndex const> sites) const {
+        // Add entries for the ranks not cached first, as adding to
+        // the map moves the others.
+        std::vector<int> missing;
+        for (auto const& [rank, local_idx]: sites)
+            if (!remote_counts_cache.contains(rank)) {
+                remote_counts_cache[rank];
+                missing.push_back(rank);
+            }
+        if (!missing.empty()) {
+            auto reads = shared_counts.begin_reads();
+            for (auto rank: missing)
+                reads.Get(std::span{remote_counts_cache[rank]}, rank, 0);
+        }
+
+        std::vector<bool> ans;
+        ans.reserve(sites.size());
+        for (auto const& [rank, local_idx]: sites)
+            ans.push_back(IsSiteDomainEdge(rank, local_idx));
+        return ans;
+    }
+
     site_t Domain::GetMidDomainSiteCount() const
     {
         return total(&GetMidDomainCollisionCount(0));
@@ -754,11 +882,13 @@ namespace hemelb::geometry
             dictionary.SetIntValue("SITES", GetTotalFluidSites());
             dictionary.SetIntValue("BLOCKS", blockCount);
             dictionary.SetIntValue("SITESPERBLOCK", sitesPerBlockVolumeUnit);
-            for (std::size_t n = 0; n < fluidSitesOnEachProcessor.size(); n++)
+            dictionary.SetFormattedValue("MEANSTREAMINGSTRIDE", "%lf", meanStreamingStride);
+            auto const sitesOnEachProcessor = fluidSitesOnEachProcessor.Span();
+            for (std::size_t n = 0; n < sitesOnEachProcessor.size(); n++)
             {
                 reporting::Dict proc = dictionary.AddSectionDictionary("PROCESSOR");
                 proc.SetIntValue("RANK", n);
-                proc.SetIntValue("SITES", fluidSitesOnEachProcessor[n]);
+                proc.SetIntValue("SITES", sitesOnEachProcessor[n]);
             }
         }
         neighbouring::NeighbouringDomain &Domain::GetNeighbouringData()
@@ -6,8 +6,11 @@
 #ifndef HEMELB_GEOMETRY_DOMAIN_H
 #define HEMELB_GEOMETRY_DOMAIN_H
 
+#include <cstdint>
 #include <memory>
 #include <map>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 #include <boost/container/flat_map.hpp>
@@ -15,6 +18,7 @@
 #include "constants.h"
 #include "units.h"
 #include "geometry/Block.h"
+#include "geometry/DistributionLayout.h"
 #include "geometry/NeighbouringProcessor.h"
 #include "geometry/Site.h"
 #include "geometry/SiteDataBare.h"
@@ -49,6 +53,10 @@ namespace hemelb::geometry
     namespace octree { class DistributedStore; }
     using SiteRankIndex = std::array<int, 2>;
 
+    // Entries of the streaming table, which point into the distribution
+    // arrays. Halving their size halves the index traffic of streaming.
+    using neighbour_index_t = std::conditional_t<build_info::COMPACT_NEIGHBOUR_INDICES, std::uint32_t, site_t>;
+
     // Hold geometrical and indexing type data about the domain to be simulated.
     class Domain : public reporting::Reportable
     {
@@ -147,6 +155,10 @@ namespace hemelb::geometry
 
         proc_t GetProcIdFromGlobalCoords(const util::Vector3D<site_t>& globalSiteCoords) const;
         SiteRankIndex GetRankIndexFromGlobalCoords(const util::Vector3D<site_t>& globalSiteCoords) const;
+        // As above, for many sites at once, which needs many fewer RMA
+        // operations than looking them up one by one.
+        std::vector<SiteRankIndex> GetRankIndexFromGlobalCoords(
+                std::span<util::Vector3D<site_t> const> globalSiteCoords) const;
 
         /**
          * True if the given coordinates correspond to a valid block within the bounding
@@ -173,6 +185,12 @@ namespace hemelb::geometry
             return blocks[GetBlockOctIndexFromBlockCoords(blockCoords)];
         }
 
+        // The rank and index of every fluid site, with the octree of
+        // the blocks that have any.
+        inline octree::DistributedStore const& GetRankForSiteStore() const {
+            return *rank_for_site_store;
+        }
+
         /**
          * Get the number of fluid sites local to this proc.
          * @return
@@ -182,6 +200,44 @@ namespace hemelb::geometry
           return shared_counts.Span()[2 * COLLISION_TYPES];
         }
 
+        /**
+         * Get the number of slots per lattice direction in the distribution arrays. This is
+         * at least the local fluid site count; the layout may pad it.
+         * @return
+         */
+        inline site_t GetDistributionStride() const
+        {
+          return DistributionLayout::Stride(GetLocalFluidSiteCount());
+        }
+
+        /**
+         * Get the number of distribution array entries belonging to local fluid sites. This is
+         * also the index of the 'rubbish site' that links leaving the geometry stream to.
+         * @return
+         */
+        inline site_t GetLocalDistributionCount() const
+        {
+          return latticeInfo.GetNumVectors() * GetDistributionStride();
+        }
+
+        /**
+         * Get the index into the distribution arrays of the given site and direction, according
+         * to the configured DistributionLayout.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return DistributionLayout::Index(siteIndex, direction, LatticeType::NUMVECTORS, GetDistributionStride());
+        }
+
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return DistributionLayout::Index(siteIndex, direction, latticeInfo.GetNumVectors(), GetDistributionStride());
+        }
+
         site_t GetContiguousSiteId(util::Vector3D<site_t> location) const;
         site_t GetContiguousSiteId(site_t x, site_t y, site_t z) const
         {
@@ -253,6 +309,9 @@ namespace hemelb::geometry
         // Use (rank, local contiguous index) to specify the site.
         // Will do RMA iff required data not cached.
         bool IsSiteDomainEdge(int rank, site_t local_idx) const;
+        // As above, for many sites at once, getting the data for all
+        // the ranks not cached in one RMA epoch.
+        std::vector<bool> IsSiteDomainEdge(std::span<SiteRankIndex const> sites) const;
 
         site_t GetMidDomainSiteCount() const;
         site_t GetDomainEdgeSiteCount() const;
@@ -302,7 +361,7 @@ namespace hemelb::geometry
          */
         inline site_t const& GetFluidSiteCountOnProc(proc_t proc) const
         {
-          return fluidSitesOnEachProcessor[proc];
+          return fluidSitesOnEachProcessor.Span()[proc];
         }
 
         /**
@@ -332,6 +391,16 @@ namespace hemelb::geometry
           return globalSiteMaxes;
         }
 
+        /**
+         * Get the mean, over all ranks, of the distance in local site ids
+         * between a site and the sites on the same rank that it streams to.
+         * @return
+         */
+        inline double GetMeanStreamingStride() const
+        {
+          return meanStreamingStride;
+        }
+
         void Report(reporting::Dict& dictionary) override;
 
         neighbouring::NeighbouringDomain &GetNeighbouringData();
@@ -371,6 +440,7 @@ namespace hemelb::geometry
         void CollectGlobalSiteExtrema();
 
         void InitialiseNeighbourLookups();
+        void CalculateStreamingLocality();
 
         using point_direction = std::pair<util::Vector3D<site_t>, site_t>;
         // These checks are to ensure that the vector below has contiguous
@@ -396,7 +466,7 @@ namespace hemelb::geometry
         inline void SetNeighbourLocation(const site_t siteIndex, const unsigned int direction,
                                          const site_t distributionIndex)
         {
-          neighbourIndices[siteIndex * latticeInfo.GetNumVectors() + direction] = distributionIndex;
+          neighbourIndices[GetDistributionIndex(siteIndex, direction)] = neighbour_index_t(distributionIndex);
         }
 
         Vec16 GetBlockIJK(site_t block) const;
@@ -430,7 +500,12 @@ namespace hemelb::geometry
         template<typename LatticeType>
         site_t GetStreamedIndex(site_t iSiteIndex, unsigned int iDirectionIndex) const
         {
-          return neighbourIndices[iSiteIndex * LatticeType::NUMVECTORS + iDirectionIndex];
+          return neighbourIndices[GetDistributionIndex<LatticeType>(iSiteIndex, iDirectionIndex)];
+        }
+
+        site_t GetStreamedIndex(site_t iSiteIndex, unsigned int iDirectionIndex) const
+        {
+          return neighbourIndices[GetDistributionIndex(iSiteIndex, iDirectionIndex)];
         }
 
         /**
@@ -520,11 +595,12 @@ namespace hemelb::geometry
         std::vector<util::Vector3D<site_t> > globalSiteCoords; //! Hold the global site coordinates for each contiguous site.
         std::vector<util::Vector3D<distribn_t> > wallNormalAtSite; //! Holds the wall normal near the fluid site, where appropriate
         std::vector<SiteData> siteData; //! Holds the SiteData for each site.
-        std::vector<site_t> fluidSitesOnEachProcessor; //! Array containing numbers of fluid sites on each processor.
+        net::WinData<site_t> fluidSitesOnEachProcessor; //! Numbers of fluid sites on each processor, one copy per node.
         site_t totalFluidSites; //! The total number of fluid sites in the geometry.
         util::Vector3D<site_t> globalSiteMins, globalSiteMaxes; //! The minimal and maximal coordinates of any fluid sites.
-        std::vector<site_t> neighbourIndices; //! Data about neighbouring fluid sites.
+        std::vector<neighbour_index_t> neighbourIndices; //! Data about neighbouring fluid sites, indexed like the distributions.
         std::vector<site_t> streamingIndicesForReceivedDistributions; //! The indices to stream to for distributions received from other processors.
+        double meanStreamingStride = 0.0; //! See GetMeanStreamingStride.
         std::shared_ptr<neighbouring::NeighbouringDomain> neighbouringData;
         std::unique_ptr<octree::DistributedStore> rank_for_site_store;
         const net::IOCommunicator& comms;
@@ -8,23 +8,54 @@
 #include "geometry/NeighbouringProcessor.h"
 #include "geometry/neighbouring/NeighbouringDomain.h"
 #include "lb/lattices/LatticeInfo.h"
+#include "net/IOCommunicator.h"
 #include "net/net.h"
 
 namespace hemelb::geometry {
     FieldData::FieldData(std::shared_ptr <domain_type> d) :
             m_domain{d},
             m_currentDistributions(CalcDistSize(*d)),
-            m_nextDistributions(CalcDistSize(*d)),
+            m_nextDistributions(SINGLE_BUFFER_STREAMING ? 0 : CalcDistSize(*d)),
+            m_receivedDistributions(SINGLE_BUFFER_STREAMING ? d->totalSharedFs : 0),
             m_force(d->GetLocalFluidSiteCount()),
             m_neighbouringFields{std::make_unique<neighbouring::NeighbouringFieldData>(d->neighbouringData)} {
 
     }
 
     std::size_t FieldData::CalcDistSize(Domain const &d) {
-        return d.GetLocalFluidSiteCount() * d.latticeInfo.GetNumVectors() + 1 + d.totalSharedFs;
+        return d.GetLocalDistributionCount() + 1 + d.totalSharedFs;
+    }
+
+    site_t FieldData::PreCollisionIndex(site_t site_idx, Direction direction, bool oddStep) const {
+        auto const own = m_domain->GetDistributionIndex(site_idx, direction);
+        if constexpr (SINGLE_BUFFER_STREAMING) {
+            if (oddStep) {
+                auto const inverse = m_domain->GetLatticeInfo().GetInverseIndex(direction);
+                auto const src = m_domain->GetStreamedIndex(site_idx, inverse);
+                if (src != m_domain->GetLocalDistributionCount())
+                    return src;
+            }
+        }
+        return own;
     }
 
     void FieldData::SendAndReceive(net::Net *net) {
+        if constexpr (SINGLE_BUFFER_STREAMING) {
+            // Both kinds of step stream the values leaving for other ranks to the shared
+            // slots, which must not be overwritten before they are sent. So receive into a
+            // separate buffer and copy in CopyReceived.
+            auto const &dom = GetDomain();
+            for (auto const &proc: dom.neighbouringProcs) {
+                net->RequestReceive<distribn_t>(
+                        &m_receivedDistributions[proc.FirstSharedDistribution - dom.neighbouringProcs[0].FirstSharedDistribution],
+                        (int) proc.SharedDistributionCount,
+                        proc.Rank);
+                net->RequestSend<distribn_t>(GetFNew(proc.FirstSharedDistribution),
+                                             (int) proc.SharedDistributionCount,
+                                             proc.Rank);
+            }
+            return;
+        }
         for (auto const &proc: GetDomain().neighbouringProcs) {
             // Request the receive into the appropriate bit of FOld.
             net->RequestReceive<distribn_t>(GetFOld(proc.FirstSharedDistribution),
@@ -38,8 +69,48 @@ namespace hemelb::geometry {
         }
     }
 
+    void FieldData::StartHaloExchange() {
+        auto const &dom = GetDomain();
+        if (dom.neighbouringProcs.empty())
+            return;
+        // Offsets are relative to the first shared distribution, as all
+        // the shared distributions are contiguous.
+        auto const first = dom.neighbouringProcs[0].FirstSharedDistribution;
+        if (!m_haloExchange) {
+            std::vector<net::HaloBlock> blocks;
+            for (auto const &proc: dom.neighbouringProcs)
+                blocks.push_back({proc.Rank,
+                                  int(proc.FirstSharedDistribution - first),
+                                  int(proc.SharedDistributionCount)});
+            m_haloExchange = net::MakeHaloExchange(dom.GetCommunicator(), std::move(blocks));
+        }
+        // See SendAndReceive for where the values go.
+        distribn_t *recv = SINGLE_BUFFER_STREAMING ? m_receivedDistributions.data() : GetFOld(first);
+        m_haloExchange->Start(GetFNew(first), recv);
+    }
+
+    bool FieldData::TestHaloExchange() {
+        return !m_haloExchange || m_haloExchange->Test();
+    }
+
+    void FieldData::WaitHaloExchange() {
+        if (m_haloExchange)
+            m_haloExchange->Wait();
+    }
+
     void FieldData::CopyReceived() {
         auto const &dom = GetDomain();
+        if constexpr (SINGLE_BUFFER_STREAMING) {
+            // After an odd step, the received values go where the next (even) step reads
+            // them: the receiving site's own slot. After an even step, the next (odd) step
+            // pulls them from the shared slots.
+            for (site_t i = 0; i < dom.totalSharedFs; i++) {
+                auto const dest = m_oddStep ? dom.streamingIndicesForReceivedDistributions[i]
+                                            : dom.neighbouringProcs[0].FirstSharedDistribution + i;
+                m_currentDistributions[dest] = m_receivedDistributions[i];
+            }
+            return;
+        }
         // Copy the distribution functions received from the neighbouring
         // processors into the destination buffer "f_new".
         for (site_t i = 0; i < dom.totalSharedFs; i++) {
@@ -7,15 +7,18 @@
 #define HEMELB_GEOMETRY_FIELDDATA_H
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <memory>
 #include <vector>
 
 #include "hassert.h"
 #include "units.h"
+#include "geometry/DistributionLayout.h"
 #include "geometry/Domain.h"
 #include "geometry/Site.h"
 #include "geometry/neighbouring/NeighbouringDomain.h"
+#include "net/HaloExchange.h"
 #include "util/Vector3D.h"
 
 namespace hemelb::net { class Net; }
@@ -33,13 +36,72 @@ namespace hemelb::geometry {
         std::shared_ptr <domain_type> m_domain;
         // For now just, list our fields.
         std::vector <distribn_t> m_currentDistributions; //! The distribution values at the start of the current time step.
-        std::vector <distribn_t> m_nextDistributions; //! The distribution values for the next time step.
+        std::vector <distribn_t> m_nextDistributions; //! The distribution values for the next time step. Empty with single-buffer streaming.
+        std::vector <distribn_t> m_receivedDistributions; //! Staging for distributions received from neighbouring ranks, with single-buffer streaming.
+        bool m_oddStep = false; //! With single-buffer streaming, whether this is an odd (pull and push) step.
         std::vector <LatticeForceVector> m_force; //! Holds the force vector at a fluid site
 
         std::unique_ptr <neighbouring::NeighbouringFieldData> m_neighbouringFields;
+        std::unique_ptr <net::HaloExchange> m_haloExchange; //! Created on first use, unless the halo goes via the Net.
 
         static std::size_t CalcDistSize(Domain const &d);
 
+        std::vector <distribn_t> &NextDistributions() {
+            if constexpr (SINGLE_BUFFER_STREAMING) {
+                return m_currentDistributions;
+            } else {
+                return m_nextDistributions;
+            }
+        }
+
+        std::vector <distribn_t> const &NextDistributions() const {
+            if constexpr (SINGLE_BUFFER_STREAMING) {
+                return m_currentDistributions;
+            } else {
+                return m_nextDistributions;
+            }
+        }
+
+        // Get the index of the distribution the site collides in the given direction, on an
+        // even or odd step of single-buffer streaming. With separate arrays that is always
+        // the site's own slot.
+        template <typename LatticeType>
+        site_t PreCollisionIndex(site_t site_idx, Direction direction, bool oddStep) const {
+            auto const own = m_domain->GetDistributionIndex<LatticeType>(site_idx, direction);
+            if constexpr (SINGLE_BUFFER_STREAMING) {
+                if (oddStep) {
+                    // Pull from the upstream neighbour, which stored it in its slot for the
+                    // opposite direction. Bounced-back values are in our own slot.
+                    auto const src = m_domain->GetStreamedIndex<LatticeType>(site_idx,
+                                                                            LatticeType::INVERSEDIRECTIONS[direction]);
+                    if (src != m_domain->GetLocalDistributionCount())
+                        return src;
+                }
+            }
+            return own;
+        }
+
+        site_t PreCollisionIndex(site_t site_idx, Direction direction, bool oddStep) const;
+
+        // Make a view of one site's distributions in the given array.
+        template <typename LatticeType, typename View, typename Array>
+        View MakeSiteView(Array& dists, site_t site_idx, bool oddStep) const {
+            constexpr auto Q = LatticeType::NUMVECTORS;
+            if constexpr (SINGLE_BUFFER_STREAMING) {
+                std::array<site_t, Q> indices;
+                for (Direction i = 0; i < Q; ++i)
+                    indices[i] = PreCollisionIndex<LatticeType>(site_idx, i, oddStep);
+                return View{dists.data(), indices};
+            } else {
+                auto first = &dists[m_domain->GetDistributionIndex<LatticeType>(site_idx, 0)];
+                if constexpr (DistributionLayout::SITE_CONTIGUOUS) {
+                    return View{first, Q};
+                } else {
+                    return View{first, m_domain->GetDistributionStride()};
+                }
+            }
+        }
+
     public:
         FieldData() = default;
 
@@ -136,13 +198,102 @@ namespace hemelb::geometry {
          * @return
          */
         inline distribn_t *GetFNew(site_t distributionIndex) {
-            return &m_nextDistributions[distributionIndex];
+            return &NextDistributions()[distributionIndex];
+        }
+
+        /**
+         * Get the index of the fOld value for the given site and direction, i.e. the
+         * distribution the site collides this step. For when you haven't got a lattice type handy.
+         * @param site_idx
+         * @param direction
+         * @return
+         */
+        site_t GetFOldIndex(site_t site_idx, Direction direction) const {
+            return PreCollisionIndex(site_idx, direction, m_oddStep);
+        }
+
+        /**
+         * Get the index of the fNew value for the given site and direction, i.e. the
+         * distribution the site will collide next step.
+         * @param site_idx
+         * @param direction
+         * @return
+         */
+        site_t GetFNewIndex(site_t site_idx, Direction direction) const {
+            return PreCollisionIndex(site_idx, direction, !m_oddStep);
+        }
+
+        /**
+         * Get the index that the post-collision distribution of the given site leaving in the
+         * given direction must be streamed to.
+         * @param site_idx
+         * @param direction
+         * @return
+         */
+        template <typename LatticeType>
+        site_t GetStreamedIndex(site_t site_idx, Direction direction) const {
+            auto const dest = m_domain->GetStreamedIndex<LatticeType>(site_idx, direction);
+            if constexpr (SINGLE_BUFFER_STREAMING) {
+                // On even steps only links to other ranks leave the site; the rest are
+                // stored in the site's own slot for the opposite direction.
+                if (!m_oddStep && dest <= m_domain->GetLocalDistributionCount())
+                    return m_domain->GetDistributionIndex<LatticeType>(site_idx,
+                                                                       LatticeType::INVERSEDIRECTIONS[direction]);
+            }
+            return dest;
+        }
+
+        /**
+         * Get a pointer to the fOld value for the given site and direction.
+         * @param site_idx
+         * @param direction
+         * @return
+         */
+        template <typename LatticeType>
+        distribn_t *GetFOld(site_t site_idx, Direction direction) {
+            return &m_currentDistributions[PreCollisionIndex<LatticeType>(site_idx, direction, m_oddStep)];
+        }
+
+        template <typename LatticeType>
+        const distribn_t *GetFOld(site_t site_idx, Direction direction) const {
+            return &m_currentDistributions[PreCollisionIndex<LatticeType>(site_idx, direction, m_oddStep)];
+        }
+
+        /**
+         * Get a view of the fOld values of a site. Unless the layout is site-major and
+         * there are separate fOld and fNew arrays, this is not a std::span.
+         * @param site_idx
+         * @return
+         */
+        template <typename LatticeType>
+        auto GetFOld(site_t site_idx) {
+            return MakeSiteView<LatticeType, MutSiteDistSpan<LatticeType::NUMVECTORS>>(m_currentDistributions, site_idx, m_oddStep);
+        }
+
+        template <typename LatticeType>
+        auto GetFOld(site_t site_idx) const {
+            return MakeSiteView<LatticeType, ConstSiteDistSpan<LatticeType::NUMVECTORS>>(m_currentDistributions, site_idx, m_oddStep);
+        }
+
+        /**
+         * Get a pointer to the fNew value for the given site and direction.
+         * @param site_idx
+         * @param direction
+         * @return
+         */
+        template <typename LatticeType>
+        distribn_t *GetFNew(site_t site_idx, Direction direction) {
+            return &NextDistributions()[PreCollisionIndex<LatticeType>(site_idx, direction, !m_oddStep)];
+        }
+
+        template <typename LatticeType>
+        const distribn_t *GetFNew(site_t site_idx, Direction direction) const {
+            return &NextDistributions()[PreCollisionIndex<LatticeType>(site_idx, direction, !m_oddStep)];
         }
 
         template <typename LatticeType>
         auto GetFNew(site_t site_idx) {
-            constexpr auto Q = LatticeType::NUMVECTORS;
-            return MutDistSpan<Q>{&m_nextDistributions[site_idx * Q], Q};
+            return MakeSiteView<LatticeType, MutSiteDistSpan<LatticeType::NUMVECTORS>>(NextDistributions(), site_idx, !m_oddStep);
         }
 
         /**
@@ -152,18 +303,22 @@ namespace hemelb::geometry {
          * @return
          */
         inline const distribn_t *GetFNew(site_t distributionIndex) const {
-            return &m_nextDistributions[distributionIndex];
+            return &NextDistributions()[distributionIndex];
         }
 
         template <typename LatticeType>
         auto GetFNew(site_t site_idx) const {
-            constexpr auto Q = LatticeType::NUMVECTORS;
-            return ConstDistSpan<Q>{&m_nextDistributions[site_idx * Q], Q};
+            return MakeSiteView<LatticeType, ConstSiteDistSpan<LatticeType::NUMVECTORS>>(NextDistributions(), site_idx, !m_oddStep);
         }
 
-        //! Swap the fOld and fNew arrays around.
+        //! Swap the fOld and fNew arrays around. With a single array, move on to the other
+        //! kind of in-place step instead.
         inline void SwapOldAndNew() {
-            m_currentDistributions.swap(m_nextDistributions);
+            if constexpr (SINGLE_BUFFER_STREAMING) {
+                m_oddStep = !m_oddStep;
+            } else {
+                m_currentDistributions.swap(m_nextDistributions);
+            }
         }
 
         //! Reset forces to some constant value
@@ -209,6 +364,15 @@ namespace hemelb::geometry {
 
         void SendAndReceive(net::Net *net);
 
+        // Alternatives to SendAndReceive that exchange the same values
+        // through the HaloExchange chosen at build time, instead of the
+        // Net. Start after the domain-edge sites have been streamed and
+        // wait before CopyReceived.
+        void StartHaloExchange();
+        //! @return true if the exchange started last has completed
+        bool TestHaloExchange();
+        void WaitHaloExchange();
+
         void CopyReceived();
 
     };
@@ -6,18 +6,23 @@
 #ifndef HEMELB_GEOMETRY_GEOMETRYBLOCK_H
 #define HEMELB_GEOMETRY_GEOMETRYBLOCK_H
 
-#include <vector>
+#include <span>
 #include "geometry/GeometrySite.h"
 
 namespace hemelb::geometry
 {
     /***
      * Model of the information stored for a block in a geometry file.
-     * Just gives the array of sites
+     * Just gives the array of sites, which is empty if the block
+     * hasn't been read. Both spans view storage owned by the
+     * GmyReadResult (see GmyReadResult::AllocateBlocks).
      */
     struct BlockReadResult
     {
-        std::vector<GeometrySite> Sites;
+        std::span<GeometrySite> Sites;
+        //! Storage for the links of the fluid sites, handed out to
+        //! them in turn.
+        std::span<GeometrySiteLink> Links;
     };
 }
 
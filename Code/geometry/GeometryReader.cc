@@ -6,13 +6,27 @@
 #include <cmath>
 #include <list>
 #include <algorithm>
+#include <exception>
 #include <utility>
 #include <zlib.h>
 
+#ifdef HEMELB_USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef HEMELB_USE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HEMELB_USE_OPENMP
+#include <omp.h>
+#endif
+
 #include "io/formats/geometry.h"
 #include "io/readers/XdrMemReader.h"
 #include "geometry/decomposition/BasicDecomposition.h"
+#include "geometry/decomposition/DecompositionCache.h"
 #include "geometry/decomposition/OptimisedDecomposition.h"
+#include "geometry/Domain.h"
 #include "geometry/GeometryReader.h"
 #include "geometry/LookupTree.h"
 #include "net/net.h"
@@ -63,10 +77,60 @@ namespace hemelb::geometry
             gmy::CutType::WALL,
             gmy::CutType::INLET,
             gmy::CutType::OUTLET>;
+    using CodecValidator = EnumValidator<gmy::Codec,
+            gmy::Codec::ZLIB,
+            gmy::Codec::NONE,
+            gmy::Codec::LZ4,
+            gmy::Codec::ZSTD>;
     using WallNormalAvailabilityValidator = EnumValidator<gmy::WallNormalAvailability,
             gmy::WallNormalAvailability::NOT_AVAILABLE,
             gmy::WallNormalAvailability::AVAILABLE>;
 
+    namespace {
+        // What Redecompose sends of a site, as distribn_t values: its
+        // wall and iolet intersections, type and iolet id, the wall
+        // normal, then the distance to the wall along each link.
+        // That's enough to rebuild its GeometrySite, as each cut link
+        // is to a wall or an iolet of the site's type.
+        constexpr std::size_t SITE_FIELDS = 7;
+
+        void PackSite(Site<Domain const> const& site, Direction NV, std::vector<distribn_t>& values)
+        {
+            auto const& data = site.GetSiteData();
+            auto const& normal = site.GetWallNormal();
+            values.insert(values.end(), {
+                    distribn_t(data.GetWallIntersectionData()),
+                    distribn_t(data.GetIoletIntersectionData()),
+                    distribn_t(data.GetSiteType()),
+                    distribn_t(data.GetIoletId()),
+                    normal.x(), normal.y(), normal.z()
+            });
+            auto const* distances = site.GetWallDistances();
+            values.insert(values.end(), distances, distances + NV - 1);
+        }
+
+        void UnpackSite(std::span<distribn_t const> values, GeometrySite& site)
+        {
+            auto const wall = std::uint32_t(values[0]);
+            auto const iolet = std::uint32_t(values[1]);
+            auto const type = SiteType(unsigned(values[2]));
+            auto const ioletId = int(values[3]);
+            site.wallNormal = util::Vector3D<float>(values[4], values[5], values[6]);
+            // As the Domain has it, a missing normal is NO_VALUE as a float.
+            site.wallNormalAvailable = site.wallNormal.x() != float(NO_VALUE);
+            for (std::size_t d = 0; d < site.links.size(); ++d) {
+                auto& link = site.links[d];
+                link.distanceToIntersection = values[SITE_FIELDS + d];
+                if (wall & (1U << d)) {
+                    link.type = gmy::CutType::WALL;
+                } else if (iolet & (1U << d)) {
+                    link.type = type == INLET_TYPE ? gmy::CutType::INLET : gmy::CutType::OUTLET;
+                    link.ioletId = ioletId;
+                }
+            }
+        }
+    }
+
     GeometryReader::GeometryReader(const lb::LatticeInfo& latticeInfo,
                                    reporting::Timers &atimings, net::IOCommunicator ioComm) :
             latticeInfo(latticeInfo), computeComms(std::move(ioComm)), timings(atimings)
@@ -77,7 +141,235 @@ namespace hemelb::geometry
     {
     }
 
-    GmyReadResult GeometryReader::LoadAndDecompose(const std::string& dataFilePath)
+    GmyReadResult GeometryReader::LoadAndDecompose(
+        const std::string& dataFilePath,
+        std::optional<std::filesystem::path> const& decompositionCachePath
+    ) {
+        GmyReadResult geometry = ReadHeaderAndDecomposeBlocks(dataFilePath);
+
+        std::optional<decomposition::DecompositionCache> cache;
+        if (decompositionCachePath) {
+            cache.emplace(
+                *decompositionCachePath,
+                decomposition::DecompositionCache::Key{
+                    FingerprintGeometry(geometry),
+                    decomposition::DecompositionCache::LatticeFingerprint(latticeInfo),
+                    decomposition::DecompositionCache::SiteWeightsFingerprint(siteWeights),
+                    decomposition::DecompositionCache::DecompositionFingerprint(hierarchicalDecomposition,
+                                                                                computeComms)
+                },
+                computeComms
+            );
+            timings[reporting::Timers::fileRead].Start();
+            auto const cachedSites = cache->Read();
+            if (cachedSites) {
+                // Read just the blocks we need for the final
+                // decomposition, skipping its optimisation entirely.
+                log::Logger::Log<log::Info, log::Singleton>("Using the decomposition cached in %s",
+                                                            decompositionCachePath->c_str());
+                RereadBlocks(geometry, *cachedSites, {});
+                ImplementMoves(geometry, *cachedSites, {}, {});
+                if constexpr (build_info::VALIDATE_GEOMETRY) {
+                    ValidateGeometry(geometry);
+                }
+            }
+            timings[reporting::Timers::fileRead].Stop();
+            if (cachedSites)
+                return geometry;
+        }
+
+        ReadInitialBlocks(geometry);
+
+        log::Logger::Log<log::Info, log::Singleton>("Optimising the domain decomposition.");
+        timings[reporting::Timers::domainDecomposition].Start();
+
+        // Having done an initial decomposition of the geometry, and read in the data, we optimise the
+        // domain decomposition.
+        log::Logger::Log<log::Debug, log::OnePerCore>("Beginning domain decomposition optimisation");
+        OptimiseDomainDecomposition(geometry);
+        log::Logger::Log<log::Debug, log::OnePerCore>("Ending domain decomposition optimisation");
+
+        if constexpr (build_info::VALIDATE_GEOMETRY) {
+            log::Logger::Log<log::Info, log::Singleton>("Validating optimised decomposition");
+            ValidateGeometry(geometry);
+        }
+
+        timings[reporting::Timers::domainDecomposition].Stop();
+
+        if (cache) {
+            log::Logger::Log<log::Info, log::Singleton>("Caching the decomposition in %s",
+                                                        decompositionCachePath->c_str());
+            cache->Write(GetLocalSites(geometry));
+        }
+        return geometry;
+    }
+
+    GmyReadResult GeometryReader::Redecompose(Domain const& domain,
+                                              std::span<idx_t const> newRanks,
+                                              MovesMap& departing)
+    {
+        auto const nSites = domain.GetLocalFluidSiteCount();
+        if (std::ssize(newRanks) != nSites)
+            throw (Exception() << "Got " << newRanks.size() << " new ranks for " << nSites << " sites");
+
+        log::Logger::Log<log::Info, log::Singleton>("Redecomposing the domain from measured loads.");
+        timings[reporting::Timers::domainDecomposition].Start();
+
+        auto const rank = computeComms.Rank();
+        auto const P = computeComms.Size();
+        auto const NV = latticeInfo.GetNumVectors();
+        auto const valuesPerSite = SITE_FIELDS + NV - 1;
+
+        // The blocks and the ranks' slices of them don't change, only
+        // which rank has each site, so the new store starts from the
+        // old one's tree.
+        GmyReadResult geometry(domain.GetBlockDimensions(), domain.GetBlockSize());
+        auto const& oldStore = domain.GetRankForSiteStore();
+        std::vector<U64> firstBlockOfRank(P + 1);
+        for (int r = 0; r < P; ++r)
+            firstBlockOfRank[r] = oldStore.GetBlockRange(r).first;
+        firstBlockOfRank[P] = oldStore.GetBlockCount();
+        // Sharing the tree on the node takes the leader's copy, so
+        // the others needn't make one.
+        octree::LookupTree treeCopy(oldStore.GetTree().n_levels);
+        if (computeComms.GetNodeComm().Rank() == 0)
+            treeCopy.levels = oldStore.GetTree().levels;
+        geometry.block_store = std::make_unique<octree::DistributedStore>(
+                geometry.GetSitesPerBlock(), std::move(treeCopy), std::move(firstBlockOfRank), computeComms
+        );
+        auto const& tree = geometry.block_store->GetTree();
+
+        // Record each site's new rank, so every rank can look up those
+        // of the sites around its own, and pack it up for that rank.
+        std::map<int, SiteVec> sitesFor;
+        std::map<int, std::vector<distribn_t>> valuesFor;
+        {
+            auto write = geometry.block_store->begin_writes();
+            for (site_t i = 0; i < nSites; ++i) {
+                auto const site = domain.GetSite(i);
+                Vec16 blockCoords, siteCoords;
+                domain.GetBlockAndLocalSiteCoords(site.GetGlobalSiteCoords(), blockCoords, siteCoords);
+                U64 const block = tree.GetPath(blockCoords).leaf();
+                auto const siteIdx = domain.GetLocalSiteIdFromLocalSiteCoords(siteCoords);
+                auto const dest = proc_t(newRanks[i]);
+                if (dest < 0 || dest >= P)
+                    throw (Exception() << "Site " << i << " given to rank " << dest << " of " << P);
+                write(block)(siteIdx) = SiteRankIndex{dest, -1};
+                sitesFor[dest].push_back({block, U64(siteIdx)});
+                PackSite(site, NV, valuesFor[dest]);
+            }
+        }
+
+        // Send the sites leaving, keeping those that stay.
+        std::map<int, SiteVec> arriving;
+        std::map<int, std::vector<distribn_t>> arrivingValues;
+        auto const exchange = [&]<typename T>(std::map<int, std::vector<T>> const& out,
+                                              std::map<int, std::vector<T>>& in, int tag) {
+            net::sparse_exchange<T> xchg(computeComms, tag);
+            for (auto const& [dest, data]: out)
+                if (dest != rank)
+                    xchg.send(to_span(data), dest);
+            xchg.receive(
+                [&](int src, int count) {
+                    auto& rbuf = in[src];
+                    rbuf.resize(count);
+                    return rbuf.data();
+                },
+                [](int, T*) {
+                    // no-op
+                }
+            );
+        };
+        exchange(sitesFor, arriving, 445);
+        exchange(valuesFor, arrivingValues, 446);
+        departing.clear();
+        for (auto& [dest, sites]: sitesFor) {
+            if (dest == rank) {
+                arriving[rank] = std::move(sites);
+                arrivingValues[rank] = std::move(valuesFor[rank]);
+            } else {
+                departing[dest] = std::move(sites);
+            }
+        }
+
+        // This rank needs its sites' blocks and those around them, but
+        // links only for its own sites.
+        std::map<U64, site_t> sitesInBlock;
+        for (auto const& [src, sites]: arriving)
+            for (auto const& [block, siteIdx]: sites)
+                ++sitesInBlock[block];
+        std::vector<U64> ownBlocks;
+        for (auto const& [block, n]: sitesInBlock)
+            ownBlocks.push_back(block);
+        auto const wanted = DecideWhichBlocksToReadIncludingHalo(geometry, ownBlocks);
+
+        std::vector<std::pair<U64, site_t>> gmyLinks;
+        for (auto block: wanted) {
+            auto const n = sitesInBlock.contains(block) ? sitesInBlock[block] : 0;
+            gmyLinks.emplace_back(geometry.GetBlockIdFromBlockCoordinates(tree.GetLeafCoords(block)),
+                                  n * (NV - 1));
+        }
+        std::sort(gmyLinks.begin(), gmyLinks.end());
+        std::vector<U64> gmyBlocks;
+        std::vector<site_t> linksPerBlock;
+        for (auto const& [gmy, n]: gmyLinks) {
+            gmyBlocks.push_back(gmy);
+            linksPerBlock.push_back(n);
+        }
+        geometry.AllocateBlocks(gmyBlocks, linksPerBlock);
+
+        // The ranks of all the sites of those blocks, now that they're
+        // all written.
+        auto const SPB = geometry.GetSitesPerBlock();
+        std::vector<octree::DistributedStore::BlockSite> query;
+        query.reserve(wanted.size() * SPB);
+        for (auto block: wanted) {
+            auto const coords = tree.GetLeafCoords(block);
+            for (site_t s = 0; s < SPB; ++s)
+                query.emplace_back(coords, s);
+        }
+        auto const ranks = geometry.block_store->GetSiteData(query);
+        auto rankIt = ranks.begin();
+        for (auto block: wanted) {
+            auto const sites = geometry.Blocks[geometry.GetBlockIdFromBlockCoordinates(tree.GetLeafCoords(block))].Sites;
+            for (auto& site: sites) {
+                auto const proc = (*rankIt++)[0];
+                if (proc != SITE_OR_BLOCK_SOLID) {
+                    site.isFluid = true;
+                    site.targetProcessor = proc;
+                }
+            }
+        }
+
+        // Then unpack this rank's own sites, handing out each block's
+        // links in turn.
+        std::map<U64, std::span<GeometrySiteLink>> freeLinks;
+        for (auto const& [src, sites]: arriving) {
+            auto const& values = arrivingValues[src];
+            if (values.size() != sites.size() * valuesPerSite)
+                throw (Exception() << "Rank " << src << " sent " << values.size() << " values for "
+                                   << sites.size() << " sites");
+            for (std::size_t k = 0; k < sites.size(); ++k) {
+                auto const [block, siteIdx] = sites[k];
+                auto const data = geometry.Blocks[geometry.GetBlockIdFromBlockCoordinates(tree.GetLeafCoords(block))];
+                auto& site = data.Sites[siteIdx];
+                if (site.targetProcessor != rank)
+                    throw (Exception() << "Rank " << src << " sent site " << siteIdx << " of block " << block
+                                       << " but it belongs to rank " << site.targetProcessor);
+                auto& links = freeLinks.try_emplace(block, data.Links).first->second;
+                site.links = links.first(NV - 1);
+                links = links.subspan(NV - 1);
+                UnpackSite(std::span{values}.subspan(k * valuesPerSite, valuesPerSite), site);
+            }
+        }
+
+        // Only this rank's sites have links, so ValidateGeometry,
+        // which checks those of every site read, doesn't apply.
+        timings[reporting::Timers::domainDecomposition].Stop();
+        return geometry;
+    }
+
+    GmyReadResult GeometryReader::ReadHeaderAndDecomposeBlocks(const std::string& dataFilePath)
     {
         timings[reporting::Timers::fileRead].Start();
 
@@ -92,80 +384,63 @@ namespace hemelb::geometry
         GmyReadResult geometry = ReadPreamble();
 
         log::Logger::Log<log::Debug, log::OnePerCore>("Reading file header");
-        ReadHeader(geometry.GetBlockCount());
+        ReadHeader(geometry);
         timings[reporting::Timers::fileRead].Stop();
 
-        {
-            timings[reporting::Timers::initialDecomposition].Start();
-            principalProcForEachBlock.resize(geometry.GetBlockCount());
-
-            log::Logger::Log<log::Info, log::Singleton>("Creating block-level octree");
-            auto blockTree = octree::build_block_tree(
-                    geometry.GetBlockDimensions().as<octree::U16>(),
-                    fluidSitesOnEachBlock
-            );
-            nFluidBlocks = blockTree.levels.back().node_ids.size();
-            log::Logger::Log<log::Info, log::Singleton>(
-                "Geometry has %lu / %ld active blocks, total %ld sites",
-                nFluidBlocks,
-                geometry.GetBlockCount(),
-                blockTree.levels[0].sites_per_node[0]
-            );
-
-            // Get an initial base-level decomposition of the domain macro-blocks over processors.
-            // This will later be improved upon by ParMetis.
-            log::Logger::Log<log::Info, log::Singleton>("Beginning initial decomposition");
-            decomposition::BasicDecomposition basicDecomposer(geometry,
-                                                              computeComms.Size());
-
-            // This vector only has entries for blocks that have a least one fluid site
-            procForBlockOct = basicDecomposer.Decompose(blockTree, principalProcForEachBlock);
-            geometry.block_store = std::make_unique<octree::DistributedStore>(
-                    geometry.GetSitesPerBlock(),
-                    std::move(blockTree),
-                    procForBlockOct,
-                    computeComms
-            );
-            if constexpr (build_info::VALIDATE_GEOMETRY) {
-                log::Logger::Log<log::Info, log::Singleton>("Validating initial decomposition");
-                basicDecomposer.Validate(principalProcForEachBlock, computeComms);
-            }
-
-            timings[reporting::Timers::initialDecomposition].Stop();
-        }
+        timings[reporting::Timers::initialDecomposition].Start();
+
+        log::Logger::Log<log::Info, log::Singleton>("Creating block-level octree");
+        // If the header is distributed, this is already shared by the
+        // ranks of each node.
+        auto blockTree = header->BuildBlockTree();
+        blockTree.ShareOnNode(computeComms.GetNodeComm());
+        nFluidBlocks = blockTree.levels.back().node_ids.size();
+        log::Logger::Log<log::Info, log::Singleton>(
+            "Geometry has %lu / %ld active blocks, total %ld sites",
+            nFluidBlocks,
+            geometry.GetBlockCount(),
+            blockTree.levels[0].sites_per_node[0]
+        );
 
-        timings[reporting::Timers::fileRead].Start();
-        {
-          std::vector<U64> blocks_wanted;
-          blocks_wanted.reserve((2*nFluidBlocks) / computeComms.Size());
-          for (U64 i = 0; i < nFluidBlocks; ++i) {
-            if (procForBlockOct[i] == computeComms.Rank())
-              blocks_wanted.push_back(i);
-          }
-          ReadInBlocksWithHalo(geometry, blocks_wanted);
-        }
+        // Get an initial base-level decomposition of the domain macro-blocks over processors.
+        // This will later be improved upon by ParMetis.
+        log::Logger::Log<log::Info, log::Singleton>("Beginning initial decomposition");
+        decomposition::BasicDecomposition basicDecomposer(computeComms.Size());
+
+        // Each rank gets a slice of the blocks that have a least one
+        // fluid site. Only the node leaders need work this out.
+        std::vector<U64> firstBlockOfRank(computeComms.Size() + 1);
+        if (computeComms.AmNodeLeader())
+            firstBlockOfRank = basicDecomposer.Decompose(blockTree);
+        computeComms.GetNodeComm().Broadcast(std::span(firstBlockOfRank), 0);
         if constexpr (build_info::VALIDATE_GEOMETRY) {
-            ValidateGeometry(geometry);
+            log::Logger::Log<log::Info, log::Singleton>("Validating initial decomposition");
+            basicDecomposer.Validate(firstBlockOfRank, computeComms);
         }
-        timings[reporting::Timers::fileRead].Stop();
-
-        log::Logger::Log<log::Info, log::Singleton>("Optimising the domain decomposition.");
-        timings[reporting::Timers::domainDecomposition].Start();
+        geometry.block_store = std::make_unique<octree::DistributedStore>(
+                geometry.GetSitesPerBlock(),
+                std::move(blockTree),
+                std::move(firstBlockOfRank),
+                computeComms
+        );
 
-        // Having done an initial decomposition of the geometry, and read in the data, we optimise the
-        // domain decomposition.
-        log::Logger::Log<log::Debug, log::OnePerCore>("Beginning domain decomposition optimisation");
-        OptimiseDomainDecomposition(geometry, principalProcForEachBlock);
-        log::Logger::Log<log::Debug, log::OnePerCore>("Ending domain decomposition optimisation");
+        timings[reporting::Timers::initialDecomposition].Stop();
+        return geometry;
+    }
 
+    void GeometryReader::ReadInitialBlocks(GmyReadResult& geometry)
+    {
+        timings[reporting::Timers::fileRead].Start();
+        auto const [first, last] = geometry.block_store->GetBlockRange(computeComms.Rank());
+        std::vector<U64> blocks_wanted;
+        blocks_wanted.reserve(last - first);
+        for (U64 i = first; i < last; ++i)
+          blocks_wanted.push_back(i);
+        ReadInBlocksWithHalo(geometry, blocks_wanted);
         if constexpr (build_info::VALIDATE_GEOMETRY) {
-            log::Logger::Log<log::Info, log::Singleton>("Validating optimised decomposition");
             ValidateGeometry(geometry);
         }
-
-        timings[reporting::Timers::domainDecomposition].Stop();
-
-        return geometry;
+        timings[reporting::Timers::fileRead].Stop();
     }
 
     std::vector<char> GeometryReader::ReadAllProcesses(std::size_t start, unsigned nBytes)
@@ -239,44 +514,64 @@ namespace hemelb::geometry
       read_check(blocksZ);
       read_check(blockSize);
 
-      // Read the padding unsigned int.
-      unsigned paddingValue;
-      preambleReader.read(paddingValue);
+      // Read the codec, which was padding before there was a choice.
+      unsigned codecValue;
+      preambleReader.read(codecValue);
+      blockCodec = CodecValidator::Run(codecValue);
+      if ((blockCodec == gmy::Codec::LZ4 && !build_info::USE_LZ4)
+          || (blockCodec == gmy::Codec::ZSTD && !build_info::USE_ZSTD))
+      {
+        throw Exception() << "Geometry blocks are compressed with "
+            << (blockCodec == gmy::Codec::LZ4 ? "LZ4" : "Zstd")
+            << ", but HemeLB was built without support for it";
+      }
 
       return {Vec16(blocksX, blocksY, blocksZ), U16(blockSize)};
     }
 
     /**
-     * Read the header section, with minimal information about each block.
-     *
-     * Results are placed in the member arrays fluidSitesPerBlock,
-     * bytesPerCompressedBlock and bytesPerUncompressedBlock.
+     * Read the header section, with minimal information about each
+     * block, into header. If distributed, each node leader reads a
+     * slice of the header and shares it out between its node's ranks.
      */
-    void GeometryReader::ReadHeader(site_t blockCount)
+    void GeometryReader::ReadHeader(const GmyReadResult& geometry)
     {
-      site_t headerByteCount = GetHeaderLength(blockCount);
-      std::vector<char> headerBuffer = ReadAllProcesses(gmy::PreambleLength, headerByteCount);
-
-      // Create a Xdr translation object to translate from binary
-      auto preambleReader = io::XdrMemReader(headerBuffer.data(),
-                                             headerByteCount);
-
-      fluidSitesOnEachBlock.reserve(blockCount);
-      bytesPerCompressedBlock.reserve(blockCount);
-      bytesPerUncompressedBlock.reserve(blockCount);
+      auto const blockCount = geometry.GetBlockCount();
+      auto const dataStart = gmy::PreambleLength + GetHeaderLength(blockCount);
+      if (!distributedHeader) {
+        std::vector<char> headerBuffer = ReadAllProcesses(gmy::PreambleLength, GetHeaderLength(blockCount));
+        header.emplace(geometry.GetBlockDimensions(), 0, headerBuffer, dataStart, computeComms, false);
+        return;
+      }
 
-      // Read in all the data.
-      for (site_t block = 0; block < blockCount; block++)
-      {
-        unsigned int sites, bytes, uncompressedBytes;
-        preambleReader.read(sites);
-        preambleReader.read(bytes);
-        preambleReader.read(uncompressedBytes);
-
-        fluidSitesOnEachBlock.push_back(sites);
-        bytesPerCompressedBlock.push_back(bytes);
-        bytesPerUncompressedBlock.push_back(uncompressedBytes);
+      auto const& nodeComm = computeComms.GetNodeComm();
+      U64 nodeFirst = 0;
+      U64 nodeBlocks = 0;
+      std::vector<char> nodeRecords;
+      if (computeComms.AmNodeLeader()) {
+        auto const& leadersComm = computeComms.GetLeadersComm();
+        auto const N = U64(leadersComm.Size());
+        auto const n = U64(leadersComm.Rank());
+        nodeFirst = blockCount * n / N;
+        nodeBlocks = blockCount * (n + 1) / N - nodeFirst;
+        nodeRecords.resize(GetHeaderLength(nodeBlocks));
+        file.ReadAtAll(gmy::PreambleLength + GetHeaderLength(nodeFirst), to_span(nodeRecords));
       }
+      nodeComm.Broadcast(nodeFirst, 0);
+      nodeComm.Broadcast(nodeBlocks, 0);
+
+      // Each rank on the node gets the same share of its slice.
+      auto const S = U64(nodeComm.Size());
+      auto const sliceOf = [&](U64 k) { return nodeBlocks * k / S; };
+      std::vector<int> counts;
+      if (computeComms.AmNodeLeader())
+        for (U64 k = 0; k < S; ++k)
+          counts.push_back(GetHeaderLength(sliceOf(k + 1) - sliceOf(k)));
+      auto const records = nodeComm.ScatterV(nodeRecords, counts, 0);
+      nodeRecords = std::vector<char>();
+
+      header.emplace(geometry.GetBlockDimensions(), nodeFirst + sliceOf(nodeComm.Rank()),
+                     records, dataStart, computeComms, true);
     }
 
     // Args are vectors with index representing a block ID.
@@ -301,10 +596,9 @@ namespace hemelb::geometry
     }
 
 
-    // Return a map from block gmy index to compressed data, for
-    // those blocks that where the predicate returns true
-    template <std::predicate<std::size_t> PredT>
-    auto GeometryReader::ReadCompressedBlockData(GmyReadResult const& geometry, PredT&& want) -> block_cache {
+    // Return the compressed data of the wanted blocks, by GMY index
+    auto GeometryReader::ReadCompressedBlockData(GmyReadResult const& geometry,
+                                                 std::span<U64 const> wanted) -> compressed_blocks {
         // Strategy: read the entire file once and filter out those
         // blocks we want.
 
@@ -319,23 +613,20 @@ namespace hemelb::geometry
         log::Logger::Log<log::Info, log::Singleton>("Streaming geometry data and caching required blocks.");
         log::Logger::Log<log::Debug, log::Singleton>("Maximum buffer size %lu B", MAX_GMY_BUFFER_SIZE);
 
-        block_cache ans;
-
-        // Work out where blocks live in the gmy **file**
-        std::size_t const nBlocksGmy = bytesPerCompressedBlock.size();
-        log::Logger::Log<log::Debug, log::Singleton>("Number of GMY blocks %lu", nBlocksGmy);
-        std::size_t const dataStart = gmy::PreambleLength + GetHeaderLength(geometry.GetBlockCount());
-
-        // N + 1 elements, elem i holds the start of block i, elem i+1 holds the end
-        auto const blockBoundsGmy = [&] () {
-            std::vector<std::size_t> ans(nBlocksGmy + 1);
-            ans[0] = dataStart;
-            std::inclusive_scan(
-                bytesPerCompressedBlock.begin(), bytesPerCompressedBlock.end(),
-                ans.begin() + 1, std::plus<std::size_t>(), dataStart
-            );
-            return ans;
-        }();
+        // The header tells us the size and position of every block
+        // wanted, so can lay them out in one buffer before reading any.
+        compressed_blocks ans;
+        ans.gmy.assign(wanted.begin(), wanted.end());
+        ans.records = header->Lookup(wanted);
+        ans.offsets.resize(wanted.size() + 1);
+        ans.offsets[0] = 0;
+        for (std::size_t i = 0; i < wanted.size(); ++i)
+            ans.offsets[i + 1] = ans.offsets[i] + ans.records[i].compressedBytes;
+        ans.data.resize(ans.offsets.back());
+
+        // Where the block data lives in the gmy **file**
+        std::size_t const dataStart = header->GetDataStart();
+        std::size_t const dataEnd = header->GetDataEnd();
 
         log::Logger::Log<log::Debug, log::Singleton>("Setup node level shared memory");
 
@@ -343,8 +634,7 @@ namespace hemelb::geometry
         char* local_buf = nullptr;
 
         // Full size of buffer across node communicator
-        auto total_buf_size = std::min(blockBoundsGmy[nBlocksGmy] - blockBoundsGmy[0],
-                                       MAX_GMY_BUFFER_SIZE);
+        auto total_buf_size = std::min(dataEnd - dataStart, MAX_GMY_BUFFER_SIZE);
 
         auto&& nodeComm = computeComms.GetNodeComm();
         auto local_buf_size = (total_buf_size - 1) / nodeComm.Size() + 1;
@@ -360,24 +650,21 @@ namespace hemelb::geometry
         // Open a passive access epoch to the shared buffer
         net::MpiCall{MPI_Win_lock_all}(MPI_MODE_NOCHECK, win);
 
-        // Get to work reading chunks
-        std::size_t const* blockBoundsGmy_end = &*blockBoundsGmy.end();
-        for (std::size_t i_first_block = 0; i_first_block < nBlocksGmy; /* end of loop */) {
-          // Given we know which block we're starting at, figure out
-          // the most whole blocks we can fit in the buffer.
-          auto first_block_ptr = &blockBoundsGmy[i_first_block];
-          auto max_read_pos = *first_block_ptr + total_buf_size;
-          // upper bound gives the first elem after max_read_pos or _end if none
-          auto end_ptr = std::upper_bound(first_block_ptr, blockBoundsGmy_end, max_read_pos) - 1;
-          std::size_t n_blocks = end_ptr - first_block_ptr;
-          auto read_size = *end_ptr - *first_block_ptr;
-          log::Logger::Log<log::Debug, log::Singleton>("Reading blocks from %lu count %lu", i_first_block, n_blocks);
+        // Get to work reading chunks. Recall the blocks wanted are in
+        // GMY, hence file, order, so only have to look at those from
+        // the first not yet copied in full. Blocks may straddle
+        // chunks, so copy whatever part of each is in the chunk.
+        std::size_t next_wanted = 0;
+        for (auto chunk_start = dataStart; chunk_start < dataEnd; chunk_start += total_buf_size) {
+          auto const chunk_end = std::min(chunk_start + total_buf_size, dataEnd);
+          log::Logger::Log<log::Debug, log::Singleton>("Reading bytes from %lu count %lu",
+                                                       chunk_start, chunk_end - chunk_start);
 
           // Only read on node leader
           if (computeComms.AmNodeLeader()) {
-            auto sp = std::span<char>(buf, read_size);
+            auto sp = std::span<char>(buf, chunk_end - chunk_start);
             // Collective on leaders comm
-            file.ReadAtAll(*first_block_ptr, sp);
+            file.ReadAtAll(chunk_start, sp);
           }
           // Need to wait for leader to read
           nodeComm.Barrier();
@@ -386,19 +673,20 @@ namespace hemelb::geometry
 
           // Now we've read a chunk of the file. Go through it,
           // copying out the blocks we want.
-          for (std::size_t i = 0; i < n_blocks; ++i) {
-            auto block_gmy = i_first_block + i;
-            if (want(block_gmy)) {
-              // Recall std::map::operator[] will create the element.
-              auto& block_data = ans[block_gmy];
-              block_data.resize(bytesPerCompressedBlock[block_gmy]);
-
-              auto buf_pos = blockBoundsGmy[block_gmy] - blockBoundsGmy[i_first_block];
-              std::memcpy(block_data.data(), &buf[buf_pos], bytesPerCompressedBlock[block_gmy]);
-            }
+          for (auto i = next_wanted; i < wanted.size(); ++i) {
+            auto const& record = ans.records[i];
+            auto const block_end = record.offset + record.compressedBytes;
+            if (record.offset >= chunk_end)
+              break;
+            auto const lo = std::max(record.offset, chunk_start);
+            auto const hi = std::min(block_end, chunk_end);
+            std::memcpy(ans.data.data() + ans.offsets[i] + (lo - record.offset),
+                        buf + (lo - chunk_start), hi - lo);
+            if (block_end <= chunk_end)
+              next_wanted = i + 1;
           }
-
-          i_first_block += n_blocks;
+          // The leader mustn't read the next chunk until all are done with this one.
+          nodeComm.Barrier();
         }
         // Close the access epoch
         net::MpiCall{MPI_Win_unlock_all}(win);
@@ -437,44 +725,88 @@ namespace hemelb::geometry
       auto halo_wanted = DecideWhichBlocksToReadIncludingHalo(geometry, blocksWanted);
 
       // GMY file indexs of blocks we want.
-      std::vector<std::size_t> wanted_gmys;
+      std::vector<U64> wanted_gmys;
       wanted_gmys.reserve(halo_wanted.size());
       auto&& tree = geometry.block_store->GetTree();
       for (auto idx: halo_wanted) {
           auto ijk = tree.GetLeafCoords(idx);
           wanted_gmys.push_back(geometry.GetBlockIdFromBlockCoordinates(ijk));
       }
-      // Recall we hit every block in GMY order, so sort this. We now
-      // only have to test one value at a time and bump the iterator
-      // forward when it matches.
+      // Recall we hit every block in GMY order, so sort this.
       std::sort(wanted_gmys.begin(), wanted_gmys.end());
 
-      auto compressed_block_data = ReadCompressedBlockData(
-          geometry,
-          [lower=wanted_gmys.cbegin(), upper=wanted_gmys.cend()] (std::size_t gmy) mutable {
-            if (lower != upper && *lower == gmy) {
-              ++lower;
-              return true;
-            } else {
-              return false;
-            }
-          }
-      );
+      auto compressed_block_data = ReadCompressedBlockData(geometry, wanted_gmys);
 
-      for (auto& [gmy_idx, data]: compressed_block_data) {
-        DeserialiseBlock(geometry, data, gmy_idx);
+      DeserialiseBlocks(geometry, compressed_block_data);
+    }
+
+    void GeometryReader::DeserialiseBlocks(GmyReadResult& geometry,
+                                           compressed_blocks const& compressedBlocks)
+    {
+      timings[reporting::Timers::readParse].Start();
+      auto const nBlocks = std::ssize(compressedBlocks.gmy);
+
+      // The header tells us how many fluid sites, hence links, each
+      // block has, so its storage can be set aside up front.
+      auto const linksPerSite = latticeInfo.GetNumVectors() - 1;
+      std::vector<site_t> linksPerBlock(nBlocks);
+      for (std::ptrdiff_t i = 0; i < nBlocks; ++i)
+        linksPerBlock[i] = compressedBlocks.records[i].fluidSites * linksPerSite;
+      geometry.AllocateBlocks(compressedBlocks.gmy, linksPerBlock);
+
+      // Each block is parsed into its own slot of geometry.Blocks, so
+      // the result doesn't depend on the order or the threads. Errors
+      // are rethrown after the loop, that of the first block in GMY
+      // order, for the same reason.
+      std::vector<std::exception_ptr> errors(nBlocks);
+      double unzipSeconds = 0.0;
+      int nThreads = 1;
+#ifdef HEMELB_USE_OPENMP
+#pragma omp parallel
+#endif
+      {
+        std::vector<char> scratch;
+#ifdef HEMELB_USE_OPENMP
+#pragma omp single
+        nThreads = omp_get_num_threads();
+        // Blocks vary a lot in size, from mostly solid to all fluid.
+#pragma omp for schedule(dynamic) reduction(+:unzipSeconds)
+#endif
+        for (std::ptrdiff_t i = 0; i < nBlocks; ++i) {
+          try {
+            unzipSeconds += DeserialiseBlock(geometry, compressedBlocks[i], compressedBlocks.gmy[i],
+                                             compressedBlocks.records[i], scratch);
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+        }
       }
+      for (auto const& e: errors)
+        if (e)
+          std::rethrow_exception(e);
+
+      // The timers can't be shared between threads, so record the
+      // decompression time per thread.
+      auto& unzip = timings[reporting::Timers::unzip];
+      unzip.Set(unzip.Get() + unzipSeconds / nThreads);
+      timings[reporting::Timers::readParse].Stop();
     }
 
-    void GeometryReader::DeserialiseBlock(
-        GmyReadResult& geometry, std::vector<char> const& compressedBlockData,
-        site_t block_gmy
-    ) {
-        timings[reporting::Timers::readParse].Start();
+    double GeometryReader::DeserialiseBlock(
+        GmyReadResult& geometry, std::span<char const> compressedBlockData,
+        site_t block_gmy, GmyHeader::Record const& record, std::vector<char>& scratch
+    ) const {
+        double const unzipStart = util::myClock();
+        // Uncompressed blocks are parsed where they are.
+        auto blockData = compressedBlockData;
+        if (blockCodec != gmy::Codec::NONE) {
+          DecompressBlockData(blockCodec, compressedBlockData,
+                              record.uncompressedBytes, scratch);
+          blockData = scratch;
+        }
+        double const unzipSeconds = util::myClock() - unzipStart;
         // Create an Xdr interpreter.
-        auto blockData = DecompressBlockData(compressedBlockData,
-                                             bytesPerUncompressedBlock[block_gmy]);
-        io::XdrMemReader lReader(&blockData.front(), blockData.size());
+        io::XdrMemReader lReader(blockData.data(), blockData.size());
 
         ParseBlock(geometry, block_gmy, lReader);
 
@@ -490,26 +822,68 @@ namespace hemelb::geometry
             }
           }
           // Compare with the sites we expected to read.
-          if (numSitesRead != fluidSitesOnEachBlock[block_gmy])
+          if (numSitesRead != record.fluidSites)
           {
             log::Logger::Log<log::Error, log::OnePerCore>("Was expecting %i fluid sites on block %i but actually read %i",
-                                                          fluidSitesOnEachBlock[block_gmy],
+                                                          record.fluidSites,
                                                           block_gmy,
                                                           numSitesRead);
           }
         }
-      timings[reporting::Timers::readParse].Stop();
+        return unzipSeconds;
+    }
+
+    void GeometryReader::DecompressBlockData(gmy::Codec codec,
+                                             std::span<char const> compressed,
+                                             const unsigned int uncompressedBytes,
+                                             std::vector<char>& uncompressed)
+    {
+      switch (codec)
+      {
+        case gmy::Codec::ZLIB:
+          return InflateBlockData(compressed, uncompressedBytes, uncompressed);
+        case gmy::Codec::NONE:
+          uncompressed.assign(compressed.begin(), compressed.end());
+          return;
+        case gmy::Codec::LZ4:
+        {
+#ifdef HEMELB_USE_LZ4
+          uncompressed.resize(uncompressedBytes);
+          auto const n = LZ4_decompress_safe(compressed.data(), uncompressed.data(),
+                                             compressed.size(), uncompressed.size());
+          if (n != int(uncompressedBytes))
+            throw Exception() << "Decompression error for block";
+          return;
+#else
+          break;
+#endif
+        }
+        case gmy::Codec::ZSTD:
+        {
+#ifdef HEMELB_USE_ZSTD
+          uncompressed.resize(uncompressedBytes);
+          auto const n = ZSTD_decompress(uncompressed.data(), uncompressed.size(),
+                                         compressed.data(), compressed.size());
+          if (ZSTD_isError(n) || n != uncompressedBytes)
+            throw Exception() << "Decompression error for block";
+          return;
+#else
+          break;
+#endif
+        }
+      }
+      throw Exception() << "Unsupported codec for block";
     }
 
-    std::vector<char> GeometryReader::DecompressBlockData(const std::vector<char>& compressed,
-                                                          const unsigned int uncompressedBytes)
+    void GeometryReader::InflateBlockData(std::span<char const> compressed,
+                                          const unsigned int uncompressedBytes,
+                                          std::vector<char>& uncompressed)
     {
-      timings[reporting::Timers::unzip].Start();
       // For zlib return codes.
       int ret;
 
       // Set up the buffer for decompressed data. We know how long the the data is
-      std::vector<char> uncompressed(uncompressedBytes);
+      uncompressed.resize(uncompressedBytes);
 
       // Set up the inflator
       z_stream stream;
@@ -517,14 +891,14 @@ namespace hemelb::geometry
       stream.zfree = Z_NULL;
       stream.opaque = Z_NULL;
       stream.avail_in = compressed.size();
-      stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(&compressed.front()));
+      stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(compressed.data()));
 
       ret = inflateInit(&stream);
       if (ret != Z_OK)
         throw Exception() << "Decompression error for block";
 
       stream.avail_out = uncompressed.size();
-      stream.next_out = reinterpret_cast<unsigned char*>(&uncompressed.front());
+      stream.next_out = reinterpret_cast<unsigned char*>(uncompressed.data());
 
       ret = inflate(&stream, Z_FINISH);
       if (ret != Z_STREAM_END)
@@ -534,26 +908,23 @@ namespace hemelb::geometry
       ret = inflateEnd(&stream);
       if (ret != Z_OK)
         throw Exception() << "Decompression error for block";
-
-      timings[reporting::Timers::unzip].Stop();
-      return uncompressed;
     }
 
     void GeometryReader::ParseBlock(GmyReadResult& geometry, const site_t block,
-                                    io::XdrReader& reader)
+                                    io::XdrReader& reader) const
     {
-      // We start by clearing the sites on the block. We read the blocks twice (once before
-      // optimisation and once after), so there can be sites on the block from the previous read.
-      geometry.Blocks[block].Sites.clear();
-
-      for (site_t localSiteIndex = 0; localSiteIndex < geometry.GetSitesPerBlock();
-          ++localSiteIndex)
+      // The block's storage has been allocated (afresh, as we read
+      // the blocks twice, once before optimisation and once after).
+      auto const blockData = geometry.Blocks[block];
+      auto freeLinks = blockData.Links;
+      for (auto& site: blockData.Sites)
       {
-        geometry.Blocks[block].Sites.push_back(ParseSite(reader));
+        site = ParseSite(reader, freeLinks);
       }
     }
 
-    GeometrySite GeometryReader::ParseSite(io::XdrReader& reader)
+    GeometrySite GeometryReader::ParseSite(io::XdrReader& reader,
+                                           std::span<GeometrySiteLink>& freeLinks) const
     {
       // Read the site type
       unsigned readSiteType;
@@ -571,8 +942,12 @@ namespace hemelb::geometry
         return readInSite;
       }
 
-      // Prepare the links array to have enough space.
-      readInSite.links.resize(latticeInfo.GetNumVectors() - 1);
+      // Take enough space for the links.
+      auto const nLinks = latticeInfo.GetNumVectors() - 1;
+      if (freeLinks.size() < nLinks)
+        throw Exception() << "Malformed GMY file, block has more fluid sites than its header says";
+      readInSite.links = freeLinks.first(nLinks);
+      freeLinks = freeLinks.subspan(nLinks);
 
       bool isGmyWallSite = false;
 
@@ -669,7 +1044,7 @@ namespace hemelb::geometry
       // We check the isFluid property and the link type for each direction
       // We also validate that each processor has the same beliefs about each site.
       for (site_t block_gmy = 0; block_gmy < geometry.GetBlockCount(); ++block_gmy) {
-        auto const& block = geometry.Blocks[block_gmy];
+        auto const block = geometry.Blocks[block_gmy];
 
         if (block.Sites.empty()) {
           std::fill(myProcForSite.begin(), myProcForSite.end(), SITE_OR_BLOCK_SOLID);
@@ -728,6 +1103,33 @@ namespace hemelb::geometry
     }
 
 
+    std::uint64_t GeometryReader::FingerprintGeometry(const GmyReadResult& geometry) const
+    {
+      // Any change to the geometry will change the compressed length
+      // of the blocks involved, in practice, so this is much cheaper
+      // than hashing the whole file.
+      return decomposition::Fingerprint()
+          .Add(geometry.GetBlockDimensions())
+          .Add(geometry.GetBlockSize())
+          .Add(blockCodec)
+          .Add(header->Fingerprint())
+          .Get();
+    }
+
+    SiteVec GeometryReader::GetLocalSites(const GmyReadResult& geometry) const
+    {
+      SiteVec ans;
+      // Leaves are in OCT order
+      for (auto leaf: geometry.block_store->GetTree().IterLeaves()) {
+        auto const block_gmy = geometry.GetBlockIdFromBlockCoordinates(leaf.coords());
+        auto const sites = geometry.Blocks[block_gmy].Sites;
+        for (std::size_t i = 0; i < sites.size(); ++i)
+          if (sites[i].targetProcessor == computeComms.Rank())
+            ans.push_back({leaf.index(), i});
+      }
+      return ans;
+    }
+
     // Go through blocks_wanted and add any 26-neighbouring blocks that are non-solid, using OCT ids.
     std::vector<U64> GeometryReader::DecideWhichBlocksToReadIncludingHalo(
         const GmyReadResult& geometry, const std::vector<U64>& blocks_wanted
@@ -740,7 +1142,7 @@ namespace hemelb::geometry
       auto&& tree = geometry.block_store->GetTree();
 
       // Start with no blocks wanted.
-      std::vector<bool> want_block_on_this_rank(nFluidBlocks, false);
+      std::vector<U64> ans;
 
       // Main loop
       for (auto block_idx: blocks_wanted) {
@@ -771,25 +1173,23 @@ namespace hemelb::geometry
                       // with "no child" for all levels where the
                       // requested node doesn't exist.
                       if (neigh_idx != octree::Level::NC)
-                          want_block_on_this_rank[neigh_idx] = true;
+                          ans.push_back(neigh_idx);
                   }
       }
 
-      std::vector<U64> ans;
-      for (unsigned i = 0; i < nFluidBlocks; ++i) {
-        if (want_block_on_this_rank[i])
-          ans.push_back(i);
-      }
+      std::sort(ans.begin(), ans.end());
+      ans.erase(std::unique(ans.begin(), ans.end()), ans.end());
       return ans;
     }
 
-    void GeometryReader::OptimiseDomainDecomposition(GmyReadResult& geometry,
-                                                     const std::vector<proc_t>& procForEachBlock)
+    void GeometryReader::OptimiseDomainDecomposition(GmyReadResult& geometry)
     {
       decomposition::OptimisedDecomposition optimiser(timings,
                                                       computeComms,
                                                       geometry,
-                                                      latticeInfo);
+                                                      latticeInfo,
+                                                      siteWeights,
+                                                      hierarchicalDecomposition);
 
       timings[reporting::Timers::reRead].Start();
       log::Logger::Log<log::Debug, log::OnePerCore>("Rereading blocks");
@@ -916,7 +1316,7 @@ namespace hemelb::geometry
                 auto const block_ijk = tree.GetLeafCoords(block_oct);
                 auto const block_gmy = geometry.GetBlockIdFromBlockCoordinates(block_ijk);
 
-                auto& block_sites = geometry.Blocks[block_gmy].Sites;
+                auto const block_sites = geometry.Blocks[block_gmy].Sites;
                 for (auto it = block_start; it < block_end; ++it) {
                     auto [block, site_idx] = *it;
                     HASSERT(block == block_oct);
@@ -6,9 +6,13 @@
 #ifndef HEMELB_GEOMETRY_GEOMETRYREADER_H
 #define HEMELB_GEOMETRY_GEOMETRYREADER_H
 
+#include <filesystem>
+#include <optional>
+#include <span>
 #include <vector>
 #include <string>
 
+#include "io/formats/geometry.h"
 #include "io/readers/XdrReader.h"
 #include "lb/lattices/LatticeInfo.h"
 #include "lb/LbmParameters.h"
@@ -17,13 +21,16 @@
 #include "reporting/Timers.h"
 #include "util/Vector3D.h"
 #include "units.h"
+#include "geometry/GmyHeader.h"
 #include "geometry/GmyReadResult.h"
 #include "geometry/needs/Needs.h"
+#include "geometry/decomposition/SiteWeights.h"
 
 #include "net/MpiFile.h"
 
 namespace hemelb::geometry
 {
+    class Domain;
 
     class GeometryReader
     {
@@ -34,26 +41,82 @@ namespace hemelb::geometry
                        reporting::Timers &timings, net::IOCommunicator ioComm);
         ~GeometryReader();
 
-        GmyReadResult LoadAndDecompose(const std::string& dataFilePath);
+        // Read the geometry and decompose it over the ranks. If given
+        // a decomposition cache that matches, the decomposition is
+        // read from that instead, otherwise it is written there.
+        GmyReadResult LoadAndDecompose(
+            const std::string& dataFilePath,
+            std::optional<std::filesystem::path> const& decompositionCachePath = std::nullopt
+        );
+
+        // Decompose the domain again during a run, sending each of
+        // this rank's sites to the given rank (see
+        // decomposition::RepartitionSites). Collective.
+        //
+        // The file isn't read again: each site's data comes from the
+        // Domain that holds it now, so only the sites a rank gets have
+        // their links, and the blocks around them only the ranks of
+        // their sites, which is all a Domain needs. Fills departing
+        // with the sites leaving this rank, keyed by the rank they go
+        // to.
+        GmyReadResult Redecompose(Domain const& domain,
+                                  std::span<idx_t const> newRanks,
+                                  MovesMap& departing);
+
+        // Replace the compiled-in weights given to ParMETIS for each
+        // collision type.
+        void SetSiteWeights(decomposition::SiteWeights const& weights) {
+            siteWeights = weights;
+        }
+
+        // Optimise the decomposition first between the nodes, then
+        // within each (see decomposition::PartitionHierarchically).
+        void SetHierarchicalDecomposition(bool hierarchical) {
+            hierarchicalDecomposition = hierarchical;
+        }
+
+        // Hold only a slice of the GMY header on each rank, rather
+        // than all of it on every rank (see GmyHeader).
+        void SetDistributedHeader(bool distributed) {
+            distributedHeader = distributed;
+        }
 
     private:
         // Read from the file into a buffer on all processes.
         // This is collective and start and nBytes must be the same on all ranks.
         std::vector<char> ReadAllProcesses(std::size_t startBytes, unsigned nBytes);
 
+        // Open the file, read its preamble and header, and share the
+        // blocks over the ranks for the initial decomposition.
+        GmyReadResult ReadHeaderAndDecomposeBlocks(const std::string& dataFilePath);
+
+        // Read the blocks this rank has in the initial decomposition.
+        void ReadInitialBlocks(GmyReadResult& geometry);
+
         // Read the preamble and create the empty read result.
         GmyReadResult ReadPreamble();
 
         // Read the block header with basic size data for each block in
-        // the domain.
-        void ReadHeader(site_t blockCount);
+        // the domain, or this rank's slice of it.
+        void ReadHeader(const GmyReadResult& geometry);
+
+        // The compressed data of some blocks, in GMY order, held in
+        // one buffer and found by offset.
+        struct compressed_blocks {
+            std::vector<U64> gmy; // GMY index of each block
+            std::vector<GmyHeader::Record> records; // Header record of each block
+            std::vector<std::size_t> offsets; // Start of each block's data, then the end
+            std::vector<char> data;
 
-        // map from block GMY index to vect of data
-        using block_cache = std::map<U64, std::vector<char>>;
+            std::span<char const> operator[](std::size_t i) const {
+                return std::span<char const>(data).subspan(offsets[i], offsets[i + 1] - offsets[i]);
+            }
+        };
 
-        // Load compressed data from the file if the predicate is true for that block's GMY index.
-        template <std::predicate<std::size_t> PredT>
-        block_cache ReadCompressedBlockData(GmyReadResult const& geometry, PredT&& p);
+        // Load compressed data from the file for the blocks with the
+        // given GMY indices, which must be sorted.
+        compressed_blocks ReadCompressedBlockData(GmyReadResult const& geometry,
+                                                  std::span<U64 const> wanted);
 
 
         // Given a vector of the block OCT ids that we want, add a
@@ -68,26 +131,50 @@ namespace hemelb::geometry
             const GmyReadResult& geometry, const std::vector<U64>& blocks_wanted
         ) const;
 
-        // Parse a compressed block of data into the geometry at the given GMY index
-        void DeserialiseBlock(GmyReadResult& geometry,
-                              std::vector<char> const& compressed_data, site_t block_gmy);
-
-        // Decompress the block data
-        std::vector<char> DecompressBlockData(const std::vector<char>& compressed,
-                                              const unsigned int uncompressedBytes);
+        // Parse the compressed blocks into the geometry, on several
+        // threads if built with OpenMP.
+        void DeserialiseBlocks(GmyReadResult& geometry, compressed_blocks const& compressedBlocks);
+
+        // Parse a compressed block of data into the geometry at the
+        // given GMY index, which must have been allocated. Safe to call
+        // concurrently for different blocks, each with its own scratch
+        // buffer for the decompressed data. Returns the time spent
+        // decompressing.
+        double DeserialiseBlock(GmyReadResult& geometry, std::span<char const> compressed_data,
+                                site_t block_gmy, GmyHeader::Record const& record,
+                                std::vector<char>& scratch) const;
+
+        // Decompress the block data into uncompressed, reusing its capacity.
+        static void DecompressBlockData(io::formats::geometry::Codec codec,
+                                        std::span<char const> compressed,
+                                        const unsigned int uncompressedBytes,
+                                        std::vector<char>& uncompressed);
+
+        // Decompress block data compressed with zlib
+        static void InflateBlockData(std::span<char const> compressed,
+                                     const unsigned int uncompressedBytes,
+                                     std::vector<char>& uncompressed);
 
         // Given a reader for a block's data, parse that into the
         // GmyReadResult at the given index.
         void ParseBlock(GmyReadResult& geometry, const site_t block,
-                        io::XdrReader& reader);
+                        io::XdrReader& reader) const;
 
-        // Parse the next site from the XDR reader
-        GeometrySite ParseSite(io::XdrReader& reader);
+        // Parse the next site from the XDR reader, taking the storage
+        // for its links, if fluid, from the front of freeLinks.
+        GeometrySite ParseSite(io::XdrReader& reader, std::span<GeometrySiteLink>& freeLinks) const;
 
         // Use the OptimisedDecomposition class to refine a simple,
         // block-level initial decomposition.
-        void OptimiseDomainDecomposition(GmyReadResult& geometry,
-                                         const std::vector<proc_t>& procForEachBlock);
+        void OptimiseDomainDecomposition(GmyReadResult& geometry);
+
+        // Fingerprint of the preamble and header, standing in for the
+        // whole GMY file for the decomposition cache.
+        std::uint64_t FingerprintGeometry(const GmyReadResult& geometry) const;
+
+        // The sites assigned to this rank, sorted by block OCT index
+        // and then site index.
+        SiteVec GetLocalSites(const GmyReadResult& geometry) const;
 
         // Check for self-consistency
         void ValidateGeometry(const GmyReadResult& geometry);
@@ -120,18 +207,16 @@ namespace hemelb::geometry
         //! Communicator for all ranks that will need a slice of the geometry
         net::IOCommunicator computeComms;
 
+        //! The relative cost of each collision type, for the decomposition
+        decomposition::SiteWeights siteWeights = decomposition::DefaultSiteWeights();
+        bool hierarchicalDecomposition = false;
+        bool distributedHeader = false;
+        //! How the block data in the file is compressed
+        io::formats::geometry::Codec blockCodec = io::formats::geometry::Codec::ZLIB;
         //! How many blocks with at least one fluid site
         U64 nFluidBlocks;
-        //! The number of fluid sites on each block in the file.
-        std::vector<site_t> fluidSitesOnEachBlock;
-        //! The number of bytes each block in the file takes up while still compressed.
-        std::vector<unsigned int> bytesPerCompressedBlock;
-        //! The number of bytes each block in the file takes up when uncompressed.
-        std::vector<unsigned int> bytesPerUncompressedBlock;
-        //! The process assigned to each block.
-        std::vector<proc_t> principalProcForEachBlock;
-        //! The process for fluid-containing blocks in octree order
-        std::vector<proc_t> procForBlockOct;
+        //! The file's header, or this rank's slice of it.
+        std::optional<GmyHeader> header;
 
         //! Timings object for recording the time taken for each step of the domain decomposition.
         hemelb::reporting::Timers &timings;
@@ -6,7 +6,7 @@
 #ifndef HEMELB_GEOMETRY_GEOMETRYSITE_H
 #define HEMELB_GEOMETRY_GEOMETRYSITE_H
 
-#include <vector>
+#include <span>
 #include "constants.h"
 #include "units.h"
 #include "geometry/GeometrySiteLink.h"
@@ -19,7 +19,8 @@ namespace hemelb::geometry
      * this data will be broken up and placed in various arrays in hemelb::GmyReadResult::domain_type
      *
      * Note that this should be able to be returned by copy (as we sometimes do) so be careful about
-     * using heap-allocated data in this struct.
+     * using heap-allocated data in this struct. The links are a view of storage owned by the
+     * GmyReadResult, so copies share them.
      */
     struct GeometrySite
     {
@@ -39,9 +40,10 @@ namespace hemelb::geometry
         //! lattice-Boltzmann with it.
         bool isFluid;
 
-        //! A vector of the link data for each direction in the lattice currently being used
+        //! The link data for each direction in the lattice currently being used
         //! (NOT necessarily the same as the lattice used by the geometry file).
-        std::vector<GeometrySiteLink> links;
+        //! Empty for solid sites.
+        std::span<GeometrySiteLink> links;
 
         //! Whether there's a approximation of the wall normal available in this fluid site.
         bool wallNormalAvailable;
@@ -0,0 +1,228 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/GmyHeader.h"
+
+#include <algorithm>
+#include <map>
+
+#include "Exception.h"
+#include "geometry/decomposition/DecompositionCache.h"
+#include "io/formats/geometry.h"
+#include "io/readers/XdrMemReader.h"
+#include "net/SparseExchange.h"
+#include "util/span.h"
+
+namespace hemelb::geometry
+{
+    using gmy = io::formats::geometry;
+
+    GmyHeader::GmyHeader(Vec16 const& dims, U64 f, std::span<char const> records,
+                         std::size_t start, net::IOCommunicator c, bool d) :
+            dimensionsInBlocks(dims), comm(std::move(c)), distributed(d), first(f),
+            dataStart(start), dataEnd(start)
+    {
+        U64 const blockCount = U64(dims.x()) * dims.y() * dims.z();
+        if (records.size() % gmy::HeaderRecordLength)
+            throw (Exception() << "GMY header slice of " << records.size()
+                   << " B is not a whole number of records");
+        U64 const n = records.size() / gmy::HeaderRecordLength;
+        if (first + n > blockCount)
+            throw (Exception() << "GMY header slice goes past the last block");
+        if (!distributed && (first != 0 || n != blockCount))
+            throw (Exception() << "Need the whole GMY header unless it is distributed");
+
+        fluidSites.reserve(n);
+        uncompressedBytes.reserve(n);
+        offsets.reserve(n + 1);
+        auto reader = io::XdrMemReader(records.data(), records.size());
+        std::size_t pos = 0;
+        for (U64 i = 0; i < n; ++i) {
+            unsigned sites, bytes, uncompressed;
+            reader.read(sites);
+            reader.read(bytes);
+            reader.read(uncompressed);
+            fluidSites.push_back(sites);
+            uncompressedBytes.push_back(uncompressed);
+            offsets.push_back(pos);
+            pos += bytes;
+        }
+        offsets.push_back(pos);
+
+        // The data of each block follows that of the ones before it
+        // in GMY order, so our slice's starts after that of the
+        // slices of earlier blocks.
+        std::size_t before = 0;
+        std::size_t total = pos;
+        if (distributed) {
+            auto const all = comm.AllGather(std::array<U64, 3>{first, n, pos});
+            total = 0;
+            for (int r = 0; r < comm.Size(); ++r) {
+                auto const [rFirst, rCount, rBytes] = all[r];
+                total += rBytes;
+                if (rCount == 0)
+                    continue;
+                if (rFirst < first)
+                    before += rBytes;
+                slices.push_back({rFirst, U64(r)});
+            }
+            std::sort(slices.begin(), slices.end());
+
+            // Check the slices cover the blocks exactly.
+            U64 next = 0;
+            for (auto const& [sFirst, r]: slices) {
+                if (sFirst != next)
+                    throw (Exception() << "GMY header slices don't cover block " << next << " once");
+                next += all[r][1];
+            }
+            if (next != blockCount)
+                throw (Exception() << "GMY header slices cover " << next << " of " << blockCount << " blocks");
+        }
+        for (auto& o: offsets)
+            o += dataStart + before;
+        dataEnd = dataStart + total;
+    }
+
+    auto GmyHeader::LocalRecord(U64 block) const -> Record
+    {
+        if (block < first || block >= first + fluidSites.size())
+            throw (Exception() << "Block " << block << " is not in this rank's GMY header slice");
+        auto const i = block - first;
+        return {fluidSites[i], offsets[i + 1] - offsets[i], uncompressedBytes[i], offsets[i]};
+    }
+
+    auto GmyHeader::Lookup(std::span<U64 const> blocks) const -> std::vector<Record>
+    {
+        if (!std::is_sorted(blocks.begin(), blocks.end()))
+            throw (Exception() << "Blocks to look up in the GMY header must be sorted");
+
+        std::vector<Record> ans(blocks.size());
+        if (!distributed) {
+            for (std::size_t i = 0; i < blocks.size(); ++i)
+                ans[i] = LocalRecord(blocks[i]);
+            return ans;
+        }
+
+        // Ask the rank with each block's slice for its record, which
+        // it answers in the order asked.
+        auto const rank = comm.Rank();
+        std::map<int, std::vector<U64>> requests;
+        std::map<int, std::vector<std::size_t>> requestIndices;
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            auto const slice = std::upper_bound(
+                slices.begin(), slices.end(), blocks[i],
+                [](U64 b, std::array<U64, 2> const& s) { return b < s[0]; }
+            );
+            int const holder = (*(slice - 1))[1];
+            if (holder == rank) {
+                ans[i] = LocalRecord(blocks[i]);
+            } else {
+                requests[holder].push_back(blocks[i]);
+                requestIndices[holder].push_back(i);
+            }
+        }
+
+        std::map<int, std::vector<U64>> asked;
+        {
+            net::sparse_exchange<U64> xchg(comm, 452);
+            for (auto const& [dest, data]: requests)
+                xchg.send(to_span(data), dest);
+            xchg.receive(
+                [&](int src, int count) {
+                    auto& rbuf = asked[src];
+                    rbuf.resize(count);
+                    return rbuf.data();
+                },
+                [&](int src, U64* buf) {
+                    // no-op
+                }
+            );
+        }
+
+        using Reply = std::array<U64, 4>; // fluid sites, compressed, uncompressed, offset
+        std::map<int, std::vector<Reply>> replies;
+        {
+            std::map<int, std::vector<Reply>> answers;
+            for (auto const& [src, wanted]: asked) {
+                auto& data = answers[src];
+                for (auto block: wanted) {
+                    auto const r = LocalRecord(block);
+                    data.push_back({U64(r.fluidSites), r.compressedBytes, r.uncompressedBytes, r.offset});
+                }
+            }
+            net::sparse_exchange<Reply> xchg(comm, 453);
+            for (auto const& [dest, data]: answers)
+                xchg.send(to_span(data), dest);
+            xchg.receive(
+                [&](int src, int count) {
+                    auto& rbuf = replies[src];
+                    rbuf.resize(count);
+                    return rbuf.data();
+                },
+                [&](int src, Reply* buf) {
+                    // no-op
+                }
+            );
+        }
+
+        for (auto const& [src, data]: replies) {
+            auto const& indices = requestIndices.at(src);
+            for (std::size_t k = 0; k < data.size(); ++k) {
+                auto const& [sites, compressed, uncompressed, offset] = data[k];
+                ans[indices[k]] = {site_t(sites), compressed, uncompressed, offset};
+            }
+        }
+        return ans;
+    }
+
+    octree::LookupTree GmyHeader::BuildBlockTree() const
+    {
+        std::vector<octree::BlockSites> fluidBlocks;
+        auto const dy = U64(dimensionsInBlocks.y());
+        auto const dz = U64(dimensionsInBlocks.z());
+        for (std::size_t i = 0; i < fluidSites.size(); ++i) {
+            if (fluidSites[i]) {
+                auto const block = first + i;
+                auto const ijk = Vec16(block / (dy * dz), (block / dz) % dy, block % dz);
+                fluidBlocks.push_back({octree::ijk_to_oct(ijk), fluidSites[i]});
+            }
+        }
+        if (!distributed) {
+            std::sort(fluidBlocks.begin(), fluidBlocks.end());
+            return octree::build_block_tree(dimensionsInBlocks, fluidBlocks);
+        }
+
+        // Gather the blocks onto the node leaders, which build the
+        // tree; the other ranks start with an empty one and then
+        // share theirs.
+        fluidBlocks = comm.GetNodeComm().Gather(fluidBlocks, 0);
+        if (comm.AmNodeLeader()) {
+            fluidBlocks = comm.GetLeadersComm().AllGatherV(fluidBlocks).data;
+            std::sort(fluidBlocks.begin(), fluidBlocks.end());
+        }
+        auto tree = octree::build_block_tree(dimensionsInBlocks, fluidBlocks);
+        std::vector<octree::BlockSites>().swap(fluidBlocks);
+        tree.ShareOnNode(comm.GetNodeComm());
+        return tree;
+    }
+
+    std::uint64_t GmyHeader::Fingerprint() const
+    {
+        // Summing a fingerprint of each block means the result
+        // doesn't depend on which rank has it.
+        std::uint64_t ans = 0;
+        for (std::size_t i = 0; i < fluidSites.size(); ++i) {
+            ans += decomposition::Fingerprint()
+                .Add(first + i)
+                .Add(fluidSites[i])
+                .Add(offsets[i + 1] - offsets[i])
+                .Add(uncompressedBytes[i])
+                .Get();
+        }
+        if (distributed)
+            ans = comm.AllReduce(ans, MPI_SUM);
+        return ans;
+    }
+}
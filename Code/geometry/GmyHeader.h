@@ -0,0 +1,99 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_GMYHEADER_H
+#define HEMELB_GEOMETRY_GMYHEADER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "units.h"
+#include "geometry/LookupTree.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb::geometry
+{
+    // The header of a GMY file, which gives for each block of the
+    // bounding box (in GMY order) its number of fluid sites and the
+    // length of its data, compressed and not.
+    //
+    // Either every rank holds the whole header or, if distributed,
+    // each holds a contiguous slice of it. The latter keeps the memory
+    // for the header per rank in proportion to the number of blocks
+    // per rank, rather than to the bounding box, at the cost of
+    // communication to look up other blocks.
+    class GmyHeader
+    {
+    public:
+        // What the header says about one block.
+        struct Record
+        {
+            site_t fluidSites;
+            std::size_t compressedBytes;
+            std::size_t uncompressedBytes;
+            std::size_t offset; //! Where the block's data start in the file
+        };
+
+        // Collective. Parse the header records (as in the file) for
+        // the blocks from first onward. If distributed, the ranks'
+        // slices between them must cover all the blocks of the
+        // bounding box once, otherwise each rank must have all of
+        // them. dataStart is where the data of block 0 is in the file.
+        GmyHeader(Vec16 const& dimensionsInBlocks, U64 first, std::span<char const> records,
+                  std::size_t dataStart, net::IOCommunicator comm, bool distributed);
+
+        [[nodiscard]] bool IsDistributed() const {
+            return distributed;
+        }
+
+        // Where the data of the first block starts and the last ends in the file.
+        [[nodiscard]] std::size_t GetDataStart() const {
+            return dataStart;
+        }
+        [[nodiscard]] std::size_t GetDataEnd() const {
+            return dataEnd;
+        }
+
+        // Collective if distributed. The records of the given blocks,
+        // by GMY index, which must be sorted.
+        [[nodiscard]] std::vector<Record> Lookup(std::span<U64 const> blocks) const;
+
+        // Collective if distributed. The octree of the blocks with
+        // fluid sites. If distributed, only the node leaders gather
+        // the blocks to build it, which is then shared by the ranks
+        // of each node (see LookupTree::ShareOnNode).
+        [[nodiscard]] octree::LookupTree BuildBlockTree() const;
+
+        // Collective if distributed. Fingerprint of the records,
+        // which doesn't depend on how they are distributed.
+        [[nodiscard]] std::uint64_t Fingerprint() const;
+
+    private:
+        // The record for a block in this rank's slice.
+        [[nodiscard]] Record LocalRecord(U64 block) const;
+
+        Vec16 dimensionsInBlocks;
+        net::IOCommunicator comm;
+        bool distributed;
+
+        // This rank's slice: the fluid sites and uncompressed length
+        // of each block from first, and where each block's data
+        // starts in the file, then where the last ends.
+        U64 first;
+        std::vector<unsigned> fluidSites;
+        std::vector<unsigned> uncompressedBytes;
+        std::vector<std::size_t> offsets;
+
+        std::size_t dataStart;
+        std::size_t dataEnd;
+
+        // If distributed, the first block and rank of each non-empty
+        // slice, sorted by block.
+        std::vector<std::array<U64, 2>> slices;
+    };
+}
+
+#endif // HEMELB_GEOMETRY_GMYHEADER_H
@@ -4,14 +4,17 @@
 // license in the file LICENSE.
 
 #include "geometry/GmyReadResult.h"
+
+#include <algorithm>
+
+#include "Exception.h"
 #include "geometry/LookupTree.h"
 
 namespace hemelb::geometry {
     GmyReadResult::GmyReadResult(const Vec16& dimensionsInBlocks, U16 blockSize) :
             dimensionsInBlocks(dimensionsInBlocks), blockSize(blockSize),
             blockCount(dimensionsInBlocks.x() * dimensionsInBlocks.y() * dimensionsInBlocks.z()),
-            sitesPerBlock(util::NumericalFunctions::IntegerPower(blockSize, 3)),
-            Blocks(blockCount)
+            sitesPerBlock(util::NumericalFunctions::IntegerPower(blockSize, 3))
     {
     }
 
@@ -39,11 +42,85 @@ namespace hemelb::geometry {
 
     site_t GmyReadResult::FindFluidSiteIndexInBlock(site_t fluidSiteBlock, site_t neighbourSiteId) const
     {
-        auto& sites = Blocks[fluidSiteBlock].Sites;
+        auto const sites = Blocks[fluidSiteBlock].Sites;
         return std::count_if(
             &sites[0], &sites[neighbourSiteId], [](GeometrySite const& s) {
                 return s.isFluid;
             }
         );
     }
+
+    void GmyReadResult::AllocateBlocks(std::span<U64 const> blocks,
+                                       std::span<site_t const> linksPerBlock)
+    {
+        if (blocks.size() != linksPerBlock.size())
+            throw (Exception() << "Got link counts for " << linksPerBlock.size()
+                   << " blocks but allocating " << blocks.size());
+        if (!std::is_sorted(blocks.begin(), blocks.end()))
+            throw (Exception() << "Blocks to allocate must be sorted");
+
+        auto const replaced = [&](std::size_t b) {
+            return std::binary_search(blocks.begin(), blocks.end(), b);
+        };
+
+        // Size the new storage for the blocks that are kept and the
+        // new ones.
+        std::size_t nSites = blocks.size() * sitesPerBlock;
+        std::size_t nLinks = 0;
+        for (auto n: linksPerBlock)
+            nLinks += n;
+        for (auto const& [b, block]: Blocks.blocks) {
+            if (!replaced(b)) {
+                nSites += sitesPerBlock;
+                nLinks += block.Links.size();
+            }
+        }
+
+        std::vector<GeometrySite> sites;
+        std::vector<GeometrySiteLink> links;
+        sites.reserve(nSites);
+        links.reserve(nLinks);
+
+        // Copy the kept blocks over, pointing their sites at their
+        // links' new home.
+        for (auto& [b, block]: Blocks.blocks) {
+            if (replaced(b))
+                continue;
+            auto const siteStart = sites.size();
+            auto const linkStart = links.size();
+            sites.insert(sites.end(), block.Sites.begin(), block.Sites.end());
+            links.insert(links.end(), block.Links.begin(), block.Links.end());
+            auto const newSites = std::span(sites).subspan(siteStart, sitesPerBlock);
+            auto const newLinks = std::span(links).subspan(linkStart, block.Links.size());
+            for (auto& site: newSites) {
+                if (!site.links.empty())
+                    site.links = newLinks.subspan(site.links.data() - block.Links.data(),
+                                                  site.links.size());
+            }
+            block.Sites = newSites;
+            block.Links = newLinks;
+        }
+
+        // Then make room for the new ones.
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            auto& block = Blocks.blocks[blocks[i]];
+            auto const siteStart = sites.size();
+            auto const linkStart = links.size();
+            sites.resize(siteStart + sitesPerBlock, GeometrySite(false));
+            links.resize(linkStart + linksPerBlock[i]);
+            block.Sites = std::span(sites).subspan(siteStart, sitesPerBlock);
+            block.Links = std::span(links).subspan(linkStart, linksPerBlock[i]);
+        }
+
+        // Having reserved the exact size, nothing above has moved.
+        siteStorage = std::move(sites);
+        linkStorage = std::move(links);
+    }
+
+    void GmyReadResult::ReleaseBlocks()
+    {
+        Blocks = BlockReadResults();
+        siteStorage = std::vector<GeometrySite>();
+        linkStorage = std::vector<GeometrySiteLink>();
+    }
 }
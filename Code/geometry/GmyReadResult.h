@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <map>
+#include <span>
 #include <vector>
 
 #include "units.h"
@@ -28,6 +29,52 @@ namespace hemelb::geometry
     using SiteVec = std::vector<SiteDesc>;
     using MovesMap = std::map<int, SiteVec>;
 
+    /***
+     * The blocks a rank has read, keyed by GMY index. A block that
+     * hasn't been read looks like one with no sites, so this takes
+     * memory in proportion to the blocks read, not the bounding box.
+     *
+     * Indexing gives a copy of the block's views of its sites and
+     * links, through which they can still be changed.
+     */
+    class BlockReadResults
+    {
+        std::map<U64, BlockReadResult> blocks;
+        friend class GmyReadResult;
+
+      public:
+        inline BlockReadResult operator[](U64 block) const
+        {
+          auto it = blocks.find(block);
+          return it == blocks.end() ? BlockReadResult{} : it->second;
+        }
+
+        inline bool contains(U64 block) const
+        {
+          return blocks.contains(block);
+        }
+
+        //! The number of blocks read
+        inline std::size_t size() const
+        {
+          return blocks.size();
+        }
+        inline bool empty() const
+        {
+          return blocks.empty();
+        }
+
+        //! Iterate over the pairs of GMY index and block, in GMY order
+        inline auto begin() const
+        {
+          return blocks.begin();
+        }
+        inline auto end() const
+        {
+          return blocks.end();
+        }
+    };
+
     /***
      * Model of the information in a geometry file
      */
@@ -139,6 +186,25 @@ namespace hemelb::geometry
         /* Find a site index, taking into account ONLY fluid sites. */
         site_t FindFluidSiteIndexInBlock(site_t fluidSiteBlock, site_t neighbourSiteId) const;
 
+        /**
+         * Give each of the blocks (by GMY index, sorted) storage for
+         * all its sites, initially solid, and for the given number of
+         * links, replacing any it had. Other blocks keep what they
+         * have.
+         *
+         * The sites and links of all blocks live in one allocation
+         * each, rather than one per block and per site, so that
+         * reading many blocks doesn't fragment the heap.
+         */
+        void AllocateBlocks(std::span<U64 const> blocks, std::span<site_t const> linksPerBlock);
+
+        /**
+         * Free the sites and links of all blocks at once. Call when
+         * the Domain has been built, after which this can't be used
+         * to build another.
+         */
+        void ReleaseBlocks();
+
       private:
         Vec16 dimensionsInBlocks; //! The count of blocks in each direction
         U16 blockSize; //! Size of a block, in sites.
@@ -146,8 +212,11 @@ namespace hemelb::geometry
         site_t blockCount;
         site_t sitesPerBlock;
 
+        std::vector<GeometrySite> siteStorage; //! The sites of all blocks
+        std::vector<GeometrySiteLink> linkStorage; //! The links of all blocks
+
       public:
-        std::vector<BlockReadResult> Blocks; //! Array of Block models
+        BlockReadResults Blocks; //! The blocks read by this rank
         std::unique_ptr<octree::DistributedStore> block_store;
     };
 
@@ -16,6 +16,49 @@ namespace hemelb::geometry::octree {
         }
     }
 
+    void LookupTree::ShareOnNode(net::MpiCommunicator const& nodeComm) {
+        if (levels.front().node_ids.IsShared())
+            return;
+
+        // All the levels' IDs then site counts in one window and their
+        // children in another, packed on the leader.
+        bool const leader = nodeComm.Rank() == 0;
+        // The size of each level, and of its children, so ranks
+        // without the tree know how to split up the windows.
+        std::vector<U64> sizes(2 * levels.size());
+        if (leader)
+            for (std::size_t i = 0; i < levels.size(); ++i) {
+                sizes[2 * i] = levels[i].node_ids.size();
+                sizes[2 * i + 1] = levels[i].child_indices.size();
+            }
+        nodeComm.Broadcast(std::span(sizes), 0);
+
+        std::vector<U64> ids;
+        std::vector<std::array<std::size_t, 8>> children;
+        if (leader) {
+            for (auto const& L: levels) {
+                ids.insert(ids.end(), L.node_ids.begin(), L.node_ids.end());
+                ids.insert(ids.end(), L.sites_per_node.begin(), L.sites_per_node.end());
+                children.insert(children.end(), L.child_indices.begin(), L.child_indices.end());
+            }
+        }
+        sharedIds = net::WinData<U64>::Shared(ids, nodeComm);
+        sharedChildren = net::WinData<std::array<std::size_t, 8>>::Shared(children, nodeComm);
+
+        auto idMem = sharedIds.Span();
+        auto childMem = sharedChildren.Span();
+        for (std::size_t i = 0; i < levels.size(); ++i) {
+            auto& L = levels[i];
+            auto const n = sizes[2 * i];
+            L.node_ids.Share(idMem.subspan(0, n));
+            L.sites_per_node.Share(idMem.subspan(n, n));
+            idMem = idMem.subspan(2 * n);
+            auto const nc = sizes[2 * i + 1];
+            L.child_indices.Share(childMem.subspan(0, nc));
+            childMem = childMem.subspan(nc);
+        }
+    }
+
     std::size_t NodeRef::leaf() const {
         return path[tree->n_levels];
     }
@@ -129,20 +172,62 @@ namespace hemelb::geometry::octree {
         return !(lhs.mPos == rhs.mPos);
     }
 
-    LookupTree build_block_tree(const Vec16& dimensionsInBlocks, std::vector<site_t> const& fluidSitesPerBlock) {
-        auto biggest_dim = *std::max_element(dimensionsInBlocks.begin(), dimensionsInBlocks.end());
-        // What power of two is greater than or equal to the biggest dimension of the domain?
-        U16 N = 1;
-        U16 cube_size = 2U;
-        while (cube_size < biggest_dim) {
-            ++N;
-            cube_size *= 2;
+    namespace {
+        // The tree for a domain of these dimensions, with no nodes.
+        LookupTree empty_block_tree(const Vec16& dimensionsInBlocks) {
+            auto biggest_dim = *std::max_element(dimensionsInBlocks.begin(), dimensionsInBlocks.end());
+            // What power of two is greater than or equal to the biggest dimension of the domain?
+            U16 N = 1;
+            U16 cube_size = 2U;
+            while (cube_size < biggest_dim) {
+                ++N;
+                cube_size *= 2;
+            }
+            return LookupTree(N);
         }
-//        U64 max_blocks = cube_size;
-//        max_blocks *= cube_size;
-//        max_blocks *= cube_size;
 
-        LookupTree ans(N);
+        // Add a leaf to the tree, which must come after all those
+        // already added in octree order.
+        void add_leaf(LookupTree& tree, U64 oct, U64 nsites) {
+            // ll = leaf level - start here
+            auto ll = tree.n_levels;
+            tree.levels[ll].node_ids.push_back(oct);
+            tree.levels[ll].sites_per_node.push_back(nsites);
+
+            // pl = parent level
+            U16 pl = ll;
+            while (pl != 0) {
+                // Walk up the tree - doing the "increment" first to have an easy to express condition
+                --pl;
+                // The index of the child node relative to its parent
+                auto local = oct & 7U;
+                // Level index of the parent node by popping off the local part
+                oct >>= 3U;
+
+                auto& lvl = tree.levels[pl];
+                if (lvl.node_ids.empty() || lvl.node_ids.back() != oct) {
+                    // Have either:
+                    // - never reached this level of the tree, or
+                    // - need a new node (this is true because iterating over the block in octree order)
+                    lvl.node_ids.push_back(oct);
+                    lvl.sites_per_node.push_back(nsites);
+                    lvl.child_indices.push_back(Level::NOCHILDREN);
+                } else {
+                    // Update existing node
+                    lvl.sites_per_node.back() += nsites;
+                }
+                // Add index of child to parent
+                if (lvl.child_indices.back()[local] == Level::NC) {
+                    lvl.child_indices.back()[local] = tree.levels[pl + 1].node_ids.size() - 1;
+                } else {
+                    HASSERT(lvl.child_indices.back()[local] == tree.levels[pl + 1].node_ids.size() - 1);
+                }
+            }
+        }
+    }
+
+    LookupTree build_block_tree(const Vec16& dimensionsInBlocks, std::vector<site_t> const& fluidSitesPerBlock) {
+        LookupTree ans = empty_block_tree(dimensionsInBlocks);
 
         // Geometry file format decrees this layout of blocks
         auto const block_strides = util::Vector3D<std::size_t>(
@@ -155,69 +240,59 @@ namespace hemelb::geometry::octree {
         for (auto block_ijk: IterBounds{dimensionsInBlocks}) {
             auto block_i = Dot(block_ijk, block_strides);
             if (auto nsites = fluidSitesPerBlock[block_i]) {
-                // Add to the tree
-                auto oct = ijk_to_oct(block_ijk);
-                // ll = leaf level - start here
-                auto ll = N;
-                ans.levels[ll].node_ids.push_back(oct);
-                ans.levels[ll].sites_per_node.push_back(nsites);
-
-                // pl = parent level
-                U16 pl = ll;
-                while (pl != 0) {
-                    // Walk up the tree - doing the "increment" first to have an easy to express condition
-                    --pl;
-                    // The index of the child node relative to its parent
-                    auto local = oct & 7U;
-                    // Level index of the parent node by popping off the local part
-                    oct >>= 3U;
-
-                    auto& lvl = ans.levels[pl];
-                    if (lvl.node_ids.empty() || lvl.node_ids.back() != oct) {
-                        // Have either:
-                        // - never reached this level of the tree, or
-                        // - need a new node (this is true because iterating over the block in octree order)
-                        lvl.node_ids.push_back(oct);
-                        lvl.sites_per_node.push_back(nsites);
-                        lvl.child_indices.push_back(Level::NOCHILDREN);
-                    } else {
-                        // Update existing node
-                        lvl.sites_per_node.back() += nsites;
-                    }
-                    // Add index of child to parent
-                    if (lvl.child_indices.back()[local] == Level::NC) {
-                        lvl.child_indices.back()[local] = ans.levels[pl + 1].node_ids.size() - 1;
-                    } else {
-                        HASSERT(lvl.child_indices.back()[local] == ans.levels[pl + 1].node_ids.size() - 1);
-                    }
-                }
+                add_leaf(ans, ijk_to_oct(block_ijk), nsites);
             }
         }
         return ans;
     }
 
-    DistributedStore::DistributedStore(site_t spb, LookupTree tree, std::vector<int> ranks, net::MpiCommunicator c) :
+    LookupTree build_block_tree(const Vec16& dimensionsInBlocks, std::span<BlockSites const> fluidBlocks) {
+        LookupTree ans = empty_block_tree(dimensionsInBlocks);
+        for (std::size_t i = 0; i < fluidBlocks.size(); ++i) {
+            auto const [oct, nsites] = fluidBlocks[i];
+            if (i > 0 && oct <= fluidBlocks[i - 1][0])
+                throw (Exception() << "Blocks for the tree must be sorted by octree ID");
+            add_leaf(ans, oct, nsites);
+        }
+        return ans;
+    }
+
+    DistributedStore::DistributedStore(site_t spb, LookupTree tree, std::vector<U64> first_blocks,
+                                       net::IOCommunicator const& c) :
             sites_per_block(spb),
             block_tree(std::move(tree)),
-            storage_rank(std::move(ranks)),
-            comm(std::move(c))
+            first_block_of_rank(std::move(first_blocks)),
+            comm(c),
+            cache_capacity(std::max<std::size_t>(1, DEFAULT_CACHE_BYTES / (spb * sizeof(SiteRankIndex))))
     {
-        // Need to find the number of blocks per rank and then the max of those
-        int rank = comm.Rank();
-        int num_my_blocks = std::count(storage_rank.begin(), storage_rank.end(), rank);
-        auto max_blocks_per_rank = comm.AllReduce(num_my_blocks, MPI_MAX);
+        block_tree.ShareOnNode(c.GetNodeComm());
+
+        auto const nBlocks = block_tree.levels.back().node_ids.size();
+        if (first_block_of_rank.size() != std::size_t(comm.Size()) + 1 || first_block_of_rank.front() != 0
+            || first_block_of_rank.back() != nBlocks
+            || !std::is_sorted(first_block_of_rank.begin(), first_block_of_rank.end()))
+            throw (Exception() << "The ranks' slices must cover the " << nBlocks << " blocks in order");
+
+        // Every rank's window is big enough for the biggest slice.
+        std::size_t max_blocks_per_rank = 0;
+        for (int r = 0; r < comm.Size(); ++r) {
+            auto const [first, last] = GetBlockRange(r);
+            max_blocks_per_rank = std::max(max_blocks_per_rank, last - first);
+        }
         auto max_sites_per_rank = max_blocks_per_rank * sites_per_block;
 
         rank_that_owns_site_win = WinData(max_sites_per_rank, comm, {SITE_OR_BLOCK_SOLID, -1});
     }
 
+    int DistributedStore::GetBlockOwner(std::size_t block_idx) const {
+        // The last rank whose slice starts at or before the block
+        // (skipping any with no blocks).
+        auto const after = std::upper_bound(first_block_of_rank.begin(), first_block_of_rank.end() - 1, block_idx);
+        return std::distance(first_block_of_rank.begin(), after) - 1;
+    }
+
     MPI_Aint DistributedStore::ComputeBlockStart(std::size_t block_idx) const {
-        // What rank does it live on
-        auto rank = storage_rank[block_idx];
-        // To get the offset, need to know the number of blocks on that rank
-        auto begin = storage_rank.begin();
-        auto first_block_on_rank = std::lower_bound(begin, begin + block_idx, rank);
-        MPI_Aint block_offset = block_idx - std::distance(begin, first_block_on_rank);
+        MPI_Aint block_offset = block_idx - first_block_of_rank[GetBlockOwner(block_idx)];
         return block_offset * sites_per_block;
     }
 
@@ -230,7 +305,7 @@ namespace hemelb::geometry::octree {
     }
 
     auto DistributedStore::WriteSession::operator()(std::size_t block_idx) -> BlockWriteChunk {
-        return {store->storage_rank[block_idx], store->ComputeBlockStart(block_idx), &store->rank_that_owns_site_win};
+        return {store->GetBlockOwner(block_idx), store->ComputeBlockStart(block_idx), &store->rank_that_owns_site_win};
 
     }
     auto DistributedStore::WriteSession::operator()(Vec16 const& block_coord) -> BlockWriteChunk {
@@ -253,21 +328,84 @@ namespace hemelb::geometry::octree {
         return WriteSession{this};
     }
 
+    void DistributedStore::SetCacheCapacity(std::size_t blocks) {
+        if (blocks == 0)
+            throw (Exception() << "Cache must hold at least one block");
+        ClearCache();
+        cache_capacity = blocks;
+    }
+
     void DistributedStore::ClearCache() {
         cache.clear();
+        cache_lru.clear();
+        std::vector<SiteRankIndex>().swap(cache_data);
+    }
+
+    SiteRankIndex const* DistributedStore::FindCached(std::size_t block_idx) const {
+        auto it = cache.find(block_idx);
+        if (it == cache.end())
+            return nullptr;
+        auto const& [slot, lru_pos] = it->second;
+        cache_lru.splice(cache_lru.begin(), cache_lru, lru_pos);
+        return &cache_data[slot * sites_per_block];
+    }
+
+    SiteRankIndex* DistributedStore::InsertCached(std::size_t block_idx) const {
+        std::size_t slot;
+        if (cache.size() < cache_capacity) {
+            slot = cache.size();
+            cache_data.resize((slot + 1) * sites_per_block);
+        } else {
+            // Reuse the least recently used block's slot
+            auto const evicted = cache_lru.back();
+            slot = cache.at(evicted).slot;
+            cache.erase(evicted);
+            cache_lru.pop_back();
+        }
+        cache_lru.push_front(block_idx);
+        cache[block_idx] = {slot, cache_lru.begin()};
+        return &cache_data[slot * sites_per_block];
+    }
+
+    void DistributedStore::FetchBlocks(std::span<std::size_t const> block_idxs) const {
+        HASSERT(block_idxs.size() <= cache_capacity);
+        std::vector<std::size_t> missing;
+        for (auto b: block_idxs)
+            if (!FindCached(b))
+                missing.push_back(b);
+        if (missing.empty())
+            return;
+
+        // A rank's blocks are contiguous in its window in octree
+        // order, so get each run of consecutive blocks on the same
+        // rank in one go.
+        std::vector<SiteRankIndex> buf(missing.size() * sites_per_block);
+        {
+            auto reads = rank_that_owns_site_win.begin_reads();
+            std::size_t i = 0;
+            while (i < missing.size()) {
+                auto const rank = GetBlockOwner(missing[i]);
+                auto const last = GetBlockRange(rank).second;
+                std::size_t j = i + 1;
+                while (j < missing.size() && missing[j] == missing[j - 1] + 1 && missing[j] < last)
+                    ++j;
+                reads.Get(std::span<SiteRankIndex>(&buf[i * sites_per_block], (j - i) * sites_per_block),
+                          rank, ComputeBlockStart(missing[i]));
+                i = j;
+            }
+        }
+        for (std::size_t i = 0; i < missing.size(); ++i)
+            std::copy_n(&buf[i * sites_per_block], sites_per_block, InsertCached(missing[i]));
     }
 
     SiteRankIndex DistributedStore::GetSiteData(std::size_t blockIdx, site_t siteIdx) const {
-        if (!cache.contains(blockIdx)) {
+        auto data = FindCached(blockIdx);
+        if (!data) {
             // If data isn't in the cache, grab the whole block via RMA
-            auto rank = storage_rank[blockIdx];
-            std::vector<SiteRankIndex> tmp(sites_per_block);
-            rank_that_owns_site_win.Get(std::span<SiteRankIndex>(tmp.begin(), sites_per_block),
-                    rank, ComputeBlockStart(blockIdx));
-            cache[blockIdx] = std::move(tmp);
+            FetchBlocks(std::span(&blockIdx, 1));
+            data = FindCached(blockIdx);
         }
-        // Cache now must contain a copy of the remote data.
-        return cache[blockIdx][siteIdx];
+        return data[siteIdx];
     }
 
     SiteRankIndex DistributedStore::GetSiteData(const Vec16 &blockIjk, site_t siteIdx) const {
@@ -276,4 +414,37 @@ namespace hemelb::geometry::octree {
         else
             return {SITE_OR_BLOCK_SOLID, -1};
     }
+
+    std::vector<SiteRankIndex> DistributedStore::GetSiteData(std::span<BlockSite const> sites) const {
+        std::vector<SiteRankIndex> ans(sites.size(), {SITE_OR_BLOCK_SOLID, -1});
+
+        // The block (by index) of each query with a non-solid block, sorted by block
+        std::vector<std::pair<std::size_t, std::size_t>> queries;
+        queries.reserve(sites.size());
+        for (std::size_t i = 0; i < sites.size(); ++i)
+            if (auto blockIdx = block_tree.GetPath(sites[i].first).leaf(); blockIdx != Level::NC)
+                queries.emplace_back(blockIdx, i);
+        std::sort(queries.begin(), queries.end());
+
+        // Deal with as many blocks at a time as fit in the cache.
+        std::vector<std::size_t> blocks;
+        auto q = queries.begin();
+        while (q != queries.end()) {
+            blocks.clear();
+            auto stop = q;
+            for (; stop != queries.end(); ++stop) {
+                if (blocks.empty() || blocks.back() != stop->first) {
+                    if (blocks.size() == cache_capacity)
+                        break;
+                    blocks.push_back(stop->first);
+                }
+            }
+            FetchBlocks(blocks);
+            for (; q != stop; ++q) {
+                auto const& [blockIdx, i] = *q;
+                ans[i] = cache_data[cache.at(blockIdx).slot * sites_per_block + sites[i].second];
+            }
+        }
+        return ans;
+    }
 }
@@ -9,15 +9,16 @@
 #include <algorithm>
 #include <cstdint>
 #include <compare>
+#include <list>
 #include <memory>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
-#include <boost/container/flat_map.hpp>
-
 #include "Exception.h"
 #include "units.h"
 #include "util/Vector3D.h"
-#include "net/MpiCommunicator.h"
+#include "net/IOCommunicator.h"
 #include "net/MpiWindow.h"
 
 namespace hemelb::geometry {
@@ -106,6 +107,82 @@ namespace hemelb::geometry::octree
 
     class LookupTree;
 
+    // One of the arrays of a Level. While the tree is built, it owns
+    // its elements; once the tree is shared by the ranks of a node
+    // (see LookupTree::ShareOnNode) it is a read-only view of the one
+    // copy in the node's shared memory.
+    template <typename T>
+    class Column {
+        std::vector<T> owned;
+        // The elements, wherever they are.
+        std::span<T> elements;
+        bool shared = false;
+
+    public:
+        Column() = default;
+        // Copies own their elements.
+        Column(Column const& other) : owned(other.begin(), other.end()), elements(owned) {
+        }
+        Column& operator=(Column const& other) {
+            owned.assign(other.begin(), other.end());
+            elements = owned;
+            shared = false;
+            return *this;
+        }
+        // Moving a vector keeps its buffer, so the view stays valid.
+        Column(Column&&) noexcept = default;
+        Column& operator=(Column&&) noexcept = default;
+
+        void push_back(T const& val) {
+            if (shared)
+                throw (Exception() << "Cannot add to a tree level shared by the node");
+            owned.push_back(val);
+            elements = owned;
+        }
+
+        // Use the given memory, which holds a copy of the elements
+        // (if we have any), instead of our own.
+        void Share(std::span<T> memory) {
+            if (!elements.empty() && memory.size() != elements.size())
+                throw (Exception() << "Shared tree level has the wrong size");
+            elements = memory;
+            shared = true;
+            std::vector<T>().swap(owned);
+        }
+
+        [[nodiscard]] inline std::size_t size() const {
+            return elements.size();
+        }
+        [[nodiscard]] inline bool empty() const {
+            return elements.empty();
+        }
+        [[nodiscard]] inline bool IsShared() const {
+            return shared;
+        }
+        inline T& operator[](std::size_t i) const {
+            return elements[i];
+        }
+        inline T& back() const {
+            return elements.back();
+        }
+        inline T* data() const {
+            return elements.data();
+        }
+        inline auto begin() const {
+            return elements.begin();
+        }
+        inline auto end() const {
+            return elements.end();
+        }
+        inline operator std::span<T const>() const {
+            return elements;
+        }
+
+        friend bool operator==(Column const& a, Column const& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+    };
+
     // Single level of a condensed octree
     // Have a structure of arrays view on the data - vectors must have the same length
     class Level {
@@ -115,11 +192,11 @@ namespace hemelb::geometry::octree
         static constexpr std::array<std::size_t, 8> NOCHILDREN = {NC, NC, NC, NC, NC, NC, NC, NC};
 
         // The octree ID of the point - unique at the level and can be converted to 3D coordinates
-        std::vector<U64> node_ids;
+        Column<U64> node_ids;
         // The number of fluid sites under the node (is the sum of child sites_per_nodes)
-        std::vector<U64> sites_per_node;
+        Column<U64> sites_per_node;
         // The indexes of child nodes in the next Level's arrays
-        std::vector<std::array<std::size_t, 8>> child_indices;
+        Column<std::array<std::size_t, 8>> child_indices;
         // This level's ID (root node has level == 0)
         U16 level;
     };
@@ -179,12 +256,24 @@ namespace hemelb::geometry::octree
 
     // A tree with one level holds only the root node
     class LookupTree {
+        // If shared, the memory holding the levels' arrays.
+        net::WinData<U64> sharedIds;
+        net::WinData<std::array<std::size_t, 8>> sharedChildren;
+
     public:
         std::vector<Level> levels;
         U16 n_levels;
 
         explicit LookupTree(U16 N);
 
+        // Collective on nodeComm, which must be one per shared memory
+        // region. Replace the levels' arrays with views of one copy
+        // for the whole node, after which the tree is read only. The
+        // copy is that of the node's rank zero; the others must have
+        // either the same tree or an empty one with the same number
+        // of levels. Does nothing if already shared.
+        void ShareOnNode(net::MpiCommunicator const& nodeComm);
+
         // Get from the lowest level in the tree
         [[nodiscard]] NodeRef GetPath(Vec16 ijk) const;
         [[nodiscard]] NodeRef GetPath(U64 oct) const;
@@ -252,6 +341,14 @@ namespace hemelb::geometry::octree
 
     LookupTree build_block_tree(const Vec16& dimensionsInBlocks, std::vector<site_t> const& fluidSitesPerBlock);
 
+    // A block with at least one fluid site: its octree ID and how
+    // many fluid sites it has.
+    using BlockSites = std::array<U64, 2>;
+
+    // Build the tree from only the blocks with fluid sites, which must
+    // be sorted by octree ID.
+    LookupTree build_block_tree(const Vec16& dimensionsInBlocks, std::span<BlockSites const> fluidBlocks);
+
     // Store something (in this case the rank that owns a given site and its local index)
     // distributed across MPI processes.
     //
@@ -259,16 +356,20 @@ namespace hemelb::geometry::octree
     // they own in one epoch, then any process can query any site of
     // interest.
     //
-    // This is data is cached locally, so clearing this might be
-    // beneficial if access patterns change. Cache is cleared after
-    // a write session anyway.
+    // This is data is cached locally, a whole block at a time, in a
+    // least recently used cache of bounded size. Cache is cleared
+    // after a write session. Many queries should be made at once,
+    // which fetches the blocks needed with as few RMA operations as
+    // possible.
     class DistributedStore {
         // Needed for offset calculations
         MPI_Aint sites_per_block;
         // Octree describing layout of blocks
         LookupTree block_tree;
-        // Which MPI rank holds data for which block, **in octree order**.
-        std::vector<int> storage_rank;
+        // Each rank holds the data for a contiguous slice of the
+        // blocks **in octree order**. This is the first block of each
+        // rank's slice, then the number of blocks, so P + 1 long.
+        std::vector<U64> first_block_of_rank;
 
         net::MpiCommunicator comm;
         // MPI_Win and allocated data - holds which MPI rank owns a site
@@ -279,26 +380,57 @@ namespace hemelb::geometry::octree
         // access where possible. Particularly useful since a block
         // may be stored on a rank that doesn't own it.
         //
-        // Reset
-        mutable boost::container::flat_map<std::size_t, std::vector<SiteRankIndex>> cache;
+        // Up to cache_capacity blocks are kept, each in a slot of
+        // cache_data, dropping the least recently used.
+        std::size_t cache_capacity;
+        mutable std::vector<SiteRankIndex> cache_data;
+        // Block indices, most recently used first.
+        mutable std::list<std::size_t> cache_lru;
+        struct CacheEntry {
+            std::size_t slot;
+            std::list<std::size_t>::iterator lru_pos;
+        };
+        mutable std::unordered_map<std::size_t, CacheEntry> cache;
 
         // Compute the index within a partition's array where a block lives (block given by its flat index).
         [[nodiscard]] MPI_Aint ComputeBlockStart(std::size_t block_idx) const;
 
+        // The cached data for a block, or null, marking it as used.
+        SiteRankIndex const* FindCached(std::size_t block_idx) const;
+        // Make room in the cache for a block, returning where to put its data.
+        SiteRankIndex* InsertCached(std::size_t block_idx) const;
+        // Make sure the cache holds the given blocks, which must be
+        // sorted, unique and no more than the capacity.
+        void FetchBlocks(std::span<std::size_t const> block_idxs) const;
+
     public:
-        // Construct - collective on the communicator
-        DistributedStore(site_t sites_per_block, LookupTree tree, std::vector<int> ranks, net::MpiCommunicator c);
+        // A site: the coordinates of its block and its index in the block.
+        using BlockSite = std::pair<Vec16, site_t>;
+
+        // Bytes to cache remote data in unless told otherwise.
+        static constexpr std::size_t DEFAULT_CACHE_BYTES = 4 << 20;
+
+        // Construct - collective on the communicator. The tree is
+        // shared by the ranks of each node (see
+        // LookupTree::ShareOnNode). The slices (see
+        // first_block_of_rank above) must be the same on every rank.
+        DistributedStore(site_t sites_per_block, LookupTree tree, std::vector<U64> first_blocks,
+                         net::IOCommunicator const& c);
 
         [[nodiscard]] inline LookupTree const& GetTree() const {
             return block_tree;
         }
 
-        [[nodiscard]] inline auto GetBlockCount() const {
-            return storage_rank.size();
+        [[nodiscard]] inline std::size_t GetBlockCount() const {
+            return first_block_of_rank.back();
         }
 
-        [[nodiscard]] inline auto& GetBlockOwnerRank() const {
-            return storage_rank;
+        // The rank holding a block, by its index in octree order.
+        [[nodiscard]] int GetBlockOwner(std::size_t block_idx) const;
+
+        // The blocks held by a rank: the first and one past the last.
+        [[nodiscard]] inline std::pair<std::size_t, std::size_t> GetBlockRange(int rank) const {
+            return {first_block_of_rank[rank], first_block_of_rank[rank + 1]};
         }
 
         // Allow many writes to the same block, wherever it is.
@@ -334,6 +466,11 @@ namespace hemelb::geometry::octree
 
         [[nodiscard]] SiteRankIndex GetSiteData(Vec16 const& blockIjk, site_t siteIdx) const;
         [[nodiscard]] SiteRankIndex GetSiteData(std::size_t blockIdx, site_t siteIdx) const;
+        // Look up many sites at once.
+        [[nodiscard]] std::vector<SiteRankIndex> GetSiteData(std::span<BlockSite const> sites) const;
+
+        // How many blocks' data to cache at most. Clears the cache.
+        void SetCacheCapacity(std::size_t blocks);
 
         void ClearCache();
     };
@@ -7,6 +7,7 @@
 #define HEMELB_GEOMETRY_SITE_H
 
 #include <span>
+#include <utility>
 
 #include "units.h"
 #include "geometry/SiteData.h"
@@ -64,6 +65,12 @@ namespace hemelb::geometry
                 return &ds;
             }
         };
+
+        // Does the field type provide GetFOld<LatticeType>(site index)?
+        template <typename F, typename LatticeType>
+        concept has_layout_aware_fold = requires (F const& f, site_t i) {
+            f.template GetFOld<LatticeType>(i);
+        };
     }
 
     // There are two types of data about a site: the geometrical
@@ -190,13 +197,20 @@ namespace hemelb::geometry
           return m_domain->template GetStreamedIndex<LatticeType>(index, direction);
         }
 
+        // Field data that knows its distribution layout (i.e. FieldData) supplies the view of
+        // the site's distributions; others are assumed to store each site contiguously.
         template<typename LatticeType>
         auto GetFOld() const
         {
-            return ConstDistSpan<LatticeType::NUMVECTORS>{m_fieldData->GetFOld(index * LatticeType::NUMVECTORS), LatticeType::NUMVECTORS};
+            if constexpr (detail::has_layout_aware_fold<field_type, LatticeType>) {
+                return std::as_const(*m_fieldData).template GetFOld<LatticeType>(index);
+            } else {
+                return ConstDistSpan<LatticeType::NUMVECTORS>{m_fieldData->GetFOld(index * LatticeType::NUMVECTORS), LatticeType::NUMVECTORS};
+            }
         }
 
-        // Non-templated version of GetFOld, for when you haven't got a lattice type handy
+        // Non-templated version of GetFOld, for when you haven't got a lattice type handy.
+        // Only meaningful when a site's distributions are contiguous.
         const distribn_t* GetFOld(int numvectors) const
         {
           return m_fieldData->GetFOld(index * numvectors);
@@ -206,15 +220,20 @@ namespace hemelb::geometry
         template<typename LatticeType>
         auto GetFOld()
         {
-            auto ptr = m_fieldData->GetFOld(index * LatticeType::NUMVECTORS);
-            // To correctly return the Const/Mut span
-            return std::span<
-                    typename std::pointer_traits<decltype(ptr)>::element_type,
-                    LatticeType::NUMVECTORS
-            >{ptr, LatticeType::NUMVECTORS};
+            if constexpr (detail::has_layout_aware_fold<field_type, LatticeType>) {
+                return m_fieldData->template GetFOld<LatticeType>(index);
+            } else {
+                auto ptr = m_fieldData->GetFOld(index * LatticeType::NUMVECTORS);
+                // To correctly return the Const/Mut span
+                return std::span<
+                        typename std::pointer_traits<decltype(ptr)>::element_type,
+                        LatticeType::NUMVECTORS
+                >{ptr, LatticeType::NUMVECTORS};
+            }
         }
 
-        // Non-templated version of GetFOld, for when you haven't got a lattice type handy
+        // Non-templated version of GetFOld, for when you haven't got a lattice type handy.
+        // Only meaningful when a site's distributions are contiguous.
         auto GetFOld(int numvectors)
         {
             return m_fieldData->GetFOld(index * numvectors);
@@ -0,0 +1,82 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/SiteOrdering.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include "Exception.h"
+
+namespace hemelb::geometry
+{
+    namespace {
+        // Interleave the low CURVE_BITS bits of x, y and z, most
+        // significant first, with x's bit highest.
+        curve_key_t Interleave(std::array<curve_key_t, 3> const& x) {
+            curve_key_t ans = 0;
+            for (int bit = CURVE_BITS - 1; bit >= 0; --bit)
+                for (int i = 0; i < 3; ++i)
+                    ans = (ans << 1) | ((x[i] >> bit) & 1);
+            return ans;
+        }
+    }
+
+    curve_key_t MortonKey(util::Vector3D<site_t> const& coords) {
+        return Interleave({curve_key_t(coords.x()), curve_key_t(coords.y()), curve_key_t(coords.z())});
+    }
+
+    curve_key_t HilbertKey(util::Vector3D<site_t> const& coords) {
+        // J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707, 381 (2004).
+        std::array<curve_key_t, 3> x{curve_key_t(coords.x()), curve_key_t(coords.y()), curve_key_t(coords.z())};
+        constexpr curve_key_t M = curve_key_t(1) << (CURVE_BITS - 1);
+        // Inverse undo
+        for (curve_key_t Q = M; Q > 1; Q >>= 1) {
+            curve_key_t const P = Q - 1;
+            for (int i = 0; i < 3; ++i) {
+                if (x[i] & Q) {
+                    x[0] ^= P;
+                } else {
+                    curve_key_t const t = (x[0] ^ x[i]) & P;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                }
+            }
+        }
+        // Gray encode
+        for (int i = 1; i < 3; ++i)
+            x[i] ^= x[i - 1];
+        curve_key_t t = 0;
+        for (curve_key_t Q = M; Q > 1; Q >>= 1)
+            if (x[2] & Q)
+                t ^= Q - 1;
+        for (auto& xi: x)
+            xi ^= t;
+        return Interleave(x);
+    }
+
+    curve_key_fn SelectedCurve() {
+        constexpr auto CURVE = build_info::SITE_ORDERING;
+        if constexpr (CURVE == "Morton") {
+            return MortonKey;
+        } else if constexpr (CURVE == "Hilbert") {
+            return HilbertKey;
+        } else {
+            throw (Exception() << "No space-filling curve for SITE_ORDERING = " << CURVE.c_str());
+        }
+    }
+
+    std::vector<std::size_t> CurveOrder(std::span<util::Vector3D<site_t> const> coords,
+                                        curve_key_fn key) {
+        std::vector<curve_key_t> keys(coords.size());
+        std::transform(coords.begin(), coords.end(), keys.begin(), key);
+        std::vector<std::size_t> order(coords.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+        return order;
+    }
+}
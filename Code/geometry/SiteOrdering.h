@@ -0,0 +1,47 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_SITEORDERING_H
+#define HEMELB_GEOMETRY_SITEORDERING_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "build_info.h"
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb::geometry
+{
+    // Are the local sites of each collision type renumbered along a
+    // space-filling curve, rather than left in block then site order?
+    inline constexpr bool REORDER_SITES = build_info::SITE_ORDERING != "Block";
+
+    // Position along a space-filling curve through the lattice. Each
+    // coordinate must be non-negative and less than 2^CURVE_BITS.
+    using curve_key_t = std::uint64_t;
+    inline constexpr unsigned CURVE_BITS = 21;
+
+    // Z-order: the bits of the coordinates interleaved.
+    curve_key_t MortonKey(util::Vector3D<site_t> const& coords);
+
+    // Hilbert order, for which consecutive keys are always
+    // neighbouring sites (Skilling's transpose algorithm).
+    curve_key_t HilbertKey(util::Vector3D<site_t> const& coords);
+
+    using curve_key_fn = curve_key_t (*)(util::Vector3D<site_t> const&);
+
+    // The curve chosen by HEMELB_SITE_ORDERING.
+    curve_key_fn SelectedCurve();
+
+    // The permutation that sorts the coordinates along the curve,
+    // i.e. the position in coords of the site to put first, second,
+    // etc. Sites with equal keys keep their order.
+    std::vector<std::size_t> CurveOrder(std::span<util::Vector3D<site_t> const> coords,
+                                        curve_key_fn key);
+}
+
+#endif
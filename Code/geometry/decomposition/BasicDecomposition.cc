@@ -4,16 +4,15 @@
 // license in the file LICENSE.
 
 #include "geometry/decomposition/BasicDecomposition.h"
-#include "geometry/GmyReadResult.h"
 #include "geometry/LookupTree.h"
+#include "log/Logger.h"
 #include "net/mpi.h"
 
 namespace hemelb::geometry::decomposition
 {
 
-    BasicDecomposition::BasicDecomposition(const GmyReadResult& geometry,
-                                           int s) :
-            geometry(geometry), comm_size(s)
+    BasicDecomposition::BasicDecomposition(int s) :
+            comm_size(s)
     {
     }
 
@@ -32,29 +31,26 @@ namespace hemelb::geometry::decomposition
         return std::make_pair(n_lo, middle);
     }
 
-    // Assign a group of processes of size N (i.e. ranks 0.. N-1) to the blocks with cumulative site counts.
-    // Recursively split the range in half and assign depth-first.
-    void assign_range(std::vector<U64>::const_iterator count_begin, std::vector<U64>::const_iterator count_end,
-                      std::vector<int>::iterator rank_begin, std::vector<int>::iterator rank_end, int N);
-    void assign_range(std::vector<U64>::const_iterator count_begin, std::vector<U64>::const_iterator count_end,
-                      std::vector<int>::iterator rank_begin, std::vector<int>::iterator rank_end, int N) {
+    // Assign a group of processes of size N (i.e. ranks 0.. N-1) to the blocks with cumulative site counts,
+    // giving the first block of each. Recursively split the range in half and assign depth-first.
+    void assign_range(std::vector<U64>::const_iterator all_begin,
+                      std::vector<U64>::const_iterator count_begin, std::vector<U64>::const_iterator count_end,
+                      std::vector<U64>::iterator first_block, int N);
+    void assign_range(std::vector<U64>::const_iterator all_begin,
+                      std::vector<U64>::const_iterator count_begin, std::vector<U64>::const_iterator count_end,
+                      std::vector<U64>::iterator first_block, int N) {
+        *first_block = std::distance(all_begin, count_begin);
         if (N < 2)
             return;
 
         // Fairly split the communicator in half(ish)
         auto [n_lo, count_middle] = share_range(count_begin, count_end, N);
-        auto dn = std::distance(count_begin, count_middle);
-        auto rank_middle = rank_begin + dn;
         // Recursively assign the two halves
-        assign_range(count_begin, count_middle, rank_begin, rank_middle, n_lo);
-        assign_range(count_middle, count_end, rank_middle, rank_end, N - n_lo);
-        // The second half needs to have the ranks incremented
-        for (; rank_middle != rank_end; ++rank_middle)
-            *rank_middle += n_lo;
+        assign_range(all_begin, count_begin, count_middle, first_block, n_lo);
+        assign_range(all_begin, count_middle, count_end, first_block + n_lo, N - n_lo);
     }
 
-    std::vector<int> BasicDecomposition::Decompose(octree::LookupTree const& tree,
-                                                   std::vector<proc_t>& procAssignedToEachBlock) const
+    std::vector<U64> BasicDecomposition::Decompose(octree::LookupTree const& tree) const
     {
         // Root node of tree holds total fluid sites
         auto total_sites = tree.levels[0].sites_per_node[0];
@@ -73,43 +69,29 @@ namespace hemelb::geometry::decomposition
         if (cumulative_fluid_sites.back() != total_sites)
             throw (Exception() << "Octree is inconsistent");
 
-        // Going to divide the blocks amongst the ranks. Start with them all assigned to rank 0
-        std::vector<int> rank_for_block(n_nonsolid, 0);
-        assign_range(cumulative_fluid_sites.begin(), --cumulative_fluid_sites.end(),
-                     rank_for_block.begin(), rank_for_block.end(), comm_size);
-
-        // We need to return data organised in GMY file order
-        // Initialise output to SOLID, we will overwrite the non-solid below
-        std::fill(procAssignedToEachBlock.begin(), procAssignedToEachBlock.end(), SITE_OR_BLOCK_SOLID);
-
-        // We need to know the octree ID to map to 3D coords.
-        auto& block_oct_ids = tree.levels[tree.n_levels].node_ids;
-        auto& dims = geometry.GetBlockDimensions();
-        auto const strides = BlockLocation{dims[1]*dims[2], dims[2], 1};
-
-        for (std::size_t i = 0; i < n_nonsolid; ++i) {
-            auto ijk = octree::oct_to_ijk(block_oct_ids[i]);
-            auto gmy = Dot(ijk, strides);
-            procAssignedToEachBlock[gmy] = rank_for_block[i];
-        }
-        return rank_for_block;
+        // Going to divide the blocks amongst the ranks, in contiguous slices.
+        std::vector<U64> first_block_of_rank(comm_size + 1);
+        assign_range(cumulative_fluid_sites.begin(), cumulative_fluid_sites.begin(), --cumulative_fluid_sites.end(),
+                     first_block_of_rank.begin(), comm_size);
+        first_block_of_rank[comm_size] = n_nonsolid;
+        return first_block_of_rank;
     }
 
-    void BasicDecomposition::Validate(std::vector<proc_t>& procAssignedToEachBlock, net::MpiCommunicator const& communicator) const
+    void BasicDecomposition::Validate(std::vector<U64> const& firstBlockOfEachProc, net::MpiCommunicator const& communicator) const
     {
-        log::Logger::Log<log::Debug, log::OnePerCore>("Validating procForEachBlock");
+        log::Logger::Log<log::Debug, log::OnePerCore>("Validating firstBlockOfEachProc");
 
-        std::vector<proc_t> procForEachBlockRecv = communicator.AllReduce(procAssignedToEachBlock,
-                                                                          MPI_MAX);
+        std::vector<U64> firstBlockOfEachProcRecv = communicator.AllReduce(firstBlockOfEachProc,
+                                                                           MPI_MAX);
 
-        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        for (std::size_t proc = 0; proc < firstBlockOfEachProc.size(); ++proc)
         {
-            if (procAssignedToEachBlock[block] != procForEachBlockRecv[block])
+            if (firstBlockOfEachProc[proc] != firstBlockOfEachProcRecv[proc])
             {
-                log::Logger::Log<log::Critical, log::OnePerCore>("At least one other proc thought block %li should be on proc %li but we locally had it as %li",
-                                                                 block,
-                                                                 procAssignedToEachBlock[block],
-                                                                 procForEachBlockRecv[block]);
+                log::Logger::Log<log::Critical, log::OnePerCore>("At least one other proc thought proc %li should start at block %li but we locally had it as %li",
+                                                                 proc,
+                                                                 firstBlockOfEachProcRecv[proc],
+                                                                 firstBlockOfEachProc[proc]);
             }
         }
     }
@@ -12,7 +12,6 @@
 #include "util/Vector3D.h"
 
 namespace hemelb {
-    namespace geometry { class GmyReadResult; }
     namespace net { class MpiCommunicator; }
 
     namespace geometry::octree { class LookupTree; }
@@ -24,39 +23,36 @@ namespace hemelb {
             /**
              * Constructor to populate all fields necessary for a decomposition
              *
-             * NOTE: We need the geometry (and its associated octree) in order to try to keep
-             * contiguous blocks together, and to skip blocks with no fluid sites.
+             * NOTE: The octree given to Decompose lets us keep contiguous blocks
+             * together, and skip blocks with no fluid sites.
              *
-             * @param geometry
              * @param comm_size
-             * @param fluidSitesOnEachBlock
              */
-            BasicDecomposition(const GmyReadResult &geometry,
-                               int comm_size);
+            explicit BasicDecomposition(int comm_size);
 
             /**
              * Does a basic decomposition of the geometry without requiring any communication;
-             * produces a vector of the processor assigned to each block.
+             * gives each processor a contiguous slice of the blocks.
              *
              * To make this fast just assign in octree order.
              *
-             * @param rankForEachBlock A vector with the processor rank each block has been assigned to.
+             * @param blockTree The octree of the blocks with fluid sites.
              *
-             * @return a vector of the rank assigned to each non-solid block (i.e. leaf nodes on the tree).
+             * @return the index of the first non-solid block (i.e. leaf node on the tree)
+             * assigned to each rank, followed by the number of non-solid blocks.
              */
-            std::vector<int>
-            Decompose(octree::LookupTree const &blockTree, std::vector<proc_t> &procAssignedToEachBlock) const;
+            std::vector<U64>
+            Decompose(octree::LookupTree const &blockTree) const;
 
             /**
-             * Validates that all cores have the same beliefs about which proc is to be assigned
-             * to each proc by this decomposition.
+             * Validates that all cores have the same beliefs about which blocks are to be
+             * assigned to each proc by this decomposition.
              *
-             * @param procAssignedToEachBlock This core's decomposition result.
+             * @param firstBlockOfEachProc This core's decomposition result.
              */
-            void Validate(std::vector<proc_t> &procAssignedToEachBlock, net::MpiCommunicator const& comm) const;
+            void Validate(std::vector<U64> const& firstBlockOfEachProc, net::MpiCommunicator const& comm) const;
 
         private:
-            const GmyReadResult &geometry; //! The geometry being decomposed.
 	    int comm_size;
         };
     }
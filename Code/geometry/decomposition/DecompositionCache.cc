@@ -0,0 +1,201 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/decomposition/DecompositionCache.h"
+
+#include <fstream>
+#include <unistd.h>
+
+#include "hassert.h"
+#include "geometry/decomposition/HierarchicalPartition.h"
+#include "io/formats/decomposition.h"
+#include "io/formats/formats.h"
+#include "io/readers/XdrMemReader.h"
+#include "io/writers/XdrVectorWriter.h"
+#include "log/Logger.h"
+#include "net/MpiFile.h"
+#include "util/span.h"
+
+namespace hemelb::geometry::decomposition
+{
+    namespace fmt = io::formats;
+    namespace dcp = fmt::decomposition;
+
+    Fingerprint& Fingerprint::AddBytes(void const* data, std::size_t n)
+    {
+        constexpr std::uint64_t FNV_PRIME = 0x100000001b3ULL;
+        auto bytes = static_cast<unsigned char const*>(data);
+        for (std::size_t i = 0; i < n; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return *this;
+    }
+
+    std::uint64_t DecompositionCache::LatticeFingerprint(lb::LatticeInfo const& latticeInfo)
+    {
+        Fingerprint ans;
+        for (unsigned i = 0; i < latticeInfo.GetNumVectors(); ++i)
+            ans.Add(latticeInfo.GetVector(i));
+        return ans.Get();
+    }
+
+    std::uint64_t DecompositionCache::SiteWeightsFingerprint(SiteWeights const& weights)
+    {
+        return Fingerprint().Add(weights).Get();
+    }
+
+    std::uint64_t DecompositionCache::DecompositionFingerprint(bool hierarchical,
+                                                               net::IOCommunicator const& comms)
+    {
+        Fingerprint ans;
+        ans.Add(hierarchical);
+        if (hierarchical) {
+            auto const nodes = NodeOfEachRank(comms);
+            ans.Add(std::span<int const>(nodes));
+        }
+        return ans.Get();
+    }
+
+    DecompositionCache::DecompositionCache(std::filesystem::path p, Key k, net::MpiCommunicator c) :
+            path(std::move(p)), key(k), comm(std::move(c))
+    {
+    }
+
+    // Offset in the file of the first site record
+    static std::uint64_t RecordsStart(int nRanks)
+    {
+        return dcp::HeaderLength + std::uint64_t(nRanks + 1) * dcp::OffsetLength;
+    }
+
+    bool DecompositionCache::IsUsable() const
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        std::vector<char> header(dcp::HeaderLength);
+        if (!file.read(header.data(), header.size())) {
+            log::Logger::Log<log::Info, log::Singleton>("Decomposition cache %s is too short, ignoring it",
+                                                        path.c_str());
+            return false;
+        }
+        io::XdrMemReader reader(header);
+        auto const hlbMagic = reader.read<std::uint32_t>();
+        auto const dcpMagic = reader.read<std::uint32_t>();
+        auto const version = reader.read<std::uint32_t>();
+        if (hlbMagic != fmt::HemeLbMagicNumber || dcpMagic != dcp::MagicNumber
+            || version != dcp::VersionNumber) {
+            log::Logger::Log<log::Info, log::Singleton>("%s is not a version %u decomposition cache, ignoring it",
+                                                        path.c_str(), dcp::VersionNumber);
+            return false;
+        }
+
+        auto const nRanks = reader.read<std::uint32_t>();
+        Key fileKey;
+        reader.read(fileKey.geometry);
+        reader.read(fileKey.lattice);
+        reader.read(fileKey.weights);
+        reader.read(fileKey.decomposition);
+        if (nRanks != std::uint32_t(comm.Size()) || !(fileKey == key)) {
+            log::Logger::Log<log::Info, log::Singleton>(
+                "Decomposition cache %s is for a different geometry, lattice, site weights, "
+                "decomposition mode or number of ranks, ignoring it", path.c_str()
+            );
+            return false;
+        }
+
+        // Check the total number of sites against the file's length,
+        // in case it was cut short.
+        std::vector<char> totalBuf(dcp::OffsetLength);
+        file.seekg(RecordsStart(nRanks) - dcp::OffsetLength);
+        file.read(totalBuf.data(), totalBuf.size());
+        file.seekg(0, std::ios::end);
+        if (!file
+            || std::uint64_t(file.tellg()) != RecordsStart(nRanks)
+               + io::XdrMemReader(totalBuf).read<std::uint64_t>() * dcp::SiteRecordLength) {
+            log::Logger::Log<log::Info, log::Singleton>("Decomposition cache %s is the wrong length, ignoring it",
+                                                        path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<SiteVec> DecompositionCache::Read() const
+    {
+        // Rank 0 checks the file and tells the others whether to use it
+        int usable = comm.Rank() == 0 ? IsUsable() : 0;
+        comm.Broadcast(usable, 0);
+        if (!usable)
+            return std::nullopt;
+
+        auto file = net::MpiFile::Open(comm, path, MPI_MODE_RDONLY);
+
+        // Where this rank's records are
+        std::vector<char> offsetBuf(2 * dcp::OffsetLength);
+        file.ReadAt(dcp::HeaderLength + std::uint64_t(comm.Rank()) * dcp::OffsetLength, to_span(offsetBuf));
+        io::XdrMemReader offsetReader(offsetBuf);
+        auto const first = offsetReader.read<std::uint64_t>();
+        auto const last = offsetReader.read<std::uint64_t>();
+
+        std::vector<char> recordBuf((last - first) * dcp::SiteRecordLength);
+        file.ReadAtAll(RecordsStart(comm.Size()) + first * dcp::SiteRecordLength, to_span(recordBuf));
+        file.Close();
+
+        io::XdrMemReader recordReader(recordBuf);
+        SiteVec ans(last - first);
+        for (auto& site: ans) {
+            recordReader.read(site[0]);
+            recordReader.read(site[1]);
+        }
+        return ans;
+    }
+
+    void DecompositionCache::Write(SiteVec const& sites) const
+    {
+        // Write to a new file and then rename it, so that other jobs
+        // reading the cache at the same time never see part of one.
+        int pid = getpid();
+        comm.Broadcast(pid, 0);
+        auto tmpPath = path;
+        tmpPath += ".tmp" + std::to_string(pid);
+
+        std::uint64_t const nSites = sites.size();
+        auto const last = comm.Scan(nSites, MPI_SUM);
+        auto const first = last - nSites;
+
+        auto file = net::MpiFile::Open(comm, tmpPath, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+        if (comm.Rank() == 0) {
+            io::XdrVectorWriter header(dcp::HeaderLength);
+            header << std::uint32_t(fmt::HemeLbMagicNumber)
+                   << std::uint32_t(dcp::MagicNumber)
+                   << std::uint32_t(dcp::VersionNumber)
+                   << std::uint32_t(comm.Size())
+                   << key.geometry << key.lattice << key.weights << key.decomposition;
+            HASSERT(header.GetBuf().size() == dcp::HeaderLength);
+            file.WriteAt(0, to_const_span(header.GetBuf()));
+        }
+
+        // Each rank writes its first record's index, and the last the
+        // end of them all.
+        io::XdrVectorWriter offsets(2 * dcp::OffsetLength);
+        offsets << first;
+        if (comm.Rank() == comm.Size() - 1)
+            offsets << last;
+        file.WriteAt(dcp::HeaderLength + std::uint64_t(comm.Rank()) * dcp::OffsetLength,
+                     to_const_span(offsets.GetBuf()));
+
+        io::XdrVectorWriter records(nSites * dcp::SiteRecordLength);
+        for (auto const& site: sites)
+            records << site[0] << site[1];
+        file.WriteAt(RecordsStart(comm.Size()) + first * dcp::SiteRecordLength,
+                     to_const_span(records.GetBuf()));
+        file.Close();
+
+        if (comm.Rank() == 0)
+            std::filesystem::rename(tmpPath, path);
+        comm.Barrier();
+    }
+}
@@ -0,0 +1,97 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "geometry/GmyReadResult.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "lb/lattices/LatticeInfo.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb::geometry::decomposition
+{
+    // Accumulates a 64-bit FNV-1a hash of the bytes of some values, to
+    // tell whether the inputs to a decomposition have changed.
+    class Fingerprint
+    {
+    public:
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        Fingerprint& Add(T const& val) {
+            return AddBytes(&val, sizeof(T));
+        }
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        Fingerprint& Add(std::span<T const> vals) {
+            return AddBytes(vals.data(), vals.size_bytes());
+        }
+
+        [[nodiscard]] std::uint64_t Get() const {
+            return hash;
+        }
+
+    private:
+        Fingerprint& AddBytes(void const* data, std::size_t n);
+
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+    };
+
+    // Reads and writes a decomposition cache file (see
+    // io/formats/decomposition.h), which holds the sites each rank
+    // ended up with after the domain decomposition. A later run can
+    // then read its sites directly instead of decomposing again.
+    //
+    // The file is only used if it was written by the same number of
+    // ranks for the same key, otherwise it is ignored and will be
+    // replaced.
+    class DecompositionCache
+    {
+    public:
+        struct Key
+        {
+            std::uint64_t geometry; //! Fingerprint of the GMY file
+            std::uint64_t lattice; //! Fingerprint of the lattice's velocities
+            std::uint64_t weights; //! Fingerprint of the site weights given to ParMETIS
+            std::uint64_t decomposition; //! Fingerprint of the decomposition mode and node layout
+
+            bool operator==(Key const&) const = default;
+        };
+
+        static std::uint64_t LatticeFingerprint(lb::LatticeInfo const& latticeInfo);
+        static std::uint64_t SiteWeightsFingerprint(SiteWeights const& weights);
+        // Collective. Whether the decomposition is hierarchical and, if
+        // so, which node each rank is on, as that changes the result.
+        static std::uint64_t DecompositionFingerprint(bool hierarchical, net::IOCommunicator const& comms);
+
+        DecompositionCache(std::filesystem::path path, Key key, net::MpiCommunicator comm);
+
+        // Collective. This rank's sites, sorted by block OCT index
+        // and then site index, or nothing if there is no usable file.
+        [[nodiscard]] std::optional<SiteVec> Read() const;
+
+        // Collective. Replace the file with one giving these sites
+        // (sorted as above) to this rank.
+        void Write(SiteVec const& sites) const;
+
+    private:
+        // Does the file exist, with a header matching ours and the
+        // right length? Only called on rank 0.
+        [[nodiscard]] bool IsUsable() const;
+
+        std::filesystem::path path;
+        Key key;
+        net::MpiCommunicator comm;
+    };
+}
+
+#endif // HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
@@ -0,0 +1,272 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/ParmetisHeader.h"
+#include "geometry/decomposition/HierarchicalPartition.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+
+#include "Exception.h"
+#include "log/Logger.h"
+#include "net/SparseExchange.h"
+#include "util/span.h"
+
+namespace hemelb::geometry::decomposition
+{
+    namespace {
+        // Receive a sparse exchange into a map keyed by source.
+        template <typename XCHG>
+        std::map<int, std::vector<idx_t>> ReceiveAll(XCHG& xchg) {
+            std::map<int, std::vector<idx_t>> ans;
+            xchg.receive(
+                [&](int src, int count) {
+                    auto& rbuf = ans[src];
+                    rbuf.resize(count);
+                    return rbuf.data();
+                },
+                [&](int src, idx_t* buf) {
+                    // no-op
+                }
+            );
+            return ans;
+        }
+
+        // The index of the last entry of a cumulative distribution
+        // that is not above v, i.e. the rank or node holding vertex v.
+        int Holder(std::span<idx_t const> dist, idx_t v) {
+            return int(std::upper_bound(dist.begin(), dist.end(), v) - dist.begin()) - 1;
+        }
+    }
+
+    std::vector<int> NodeOfEachRank(net::IOCommunicator const& comms)
+    {
+        int node = comms.AmNodeLeader() ? comms.GetLeadersComm().Rank() : 0;
+        comms.GetNodeComm().Broadcast(node, 0);
+        return comms.AllGather(node);
+    }
+
+    std::vector<idx_t> PartitionHierarchically(net::IOCommunicator const& comms,
+                                               DistributedGraph const& graph,
+                                               real_t imbalance)
+    {
+        auto const& nodeComm = comms.GetNodeComm();
+        auto const P = comms.Size();
+        auto const vtxdist = graph.vtxdist;
+
+        // Work out which ranks make up each node, in the order of
+        // their rank on the node.
+        auto const nodeOfRank = NodeOfEachRank(comms);
+        auto const rankOnNode = comms.AllGather(nodeComm.Rank());
+        int const N = *std::max_element(nodeOfRank.begin(), nodeOfRank.end()) + 1;
+        std::vector<std::vector<int>> ranksOfNode(N);
+        for (int r = 0; r < P; ++r) {
+            auto& ranks = ranksOfNode[nodeOfRank[r]];
+            if (std::size_t(rankOnNode[r]) >= ranks.size())
+                ranks.resize(rankOnNode[r] + 1, -1);
+            ranks[rankOnNode[r]] = r;
+        }
+        int const node = nodeOfRank[comms.Rank()];
+
+        // Number the vertices node by node, as the leaders will hold
+        // them.
+        std::vector<idx_t> nodeVtxdist(N + 1, 0);
+        std::vector<idx_t> firstOfRank(P);
+        idx_t total = 0;
+        for (int n = 0; n < N; ++n) {
+            for (auto r: ranksOfNode[n]) {
+                firstOfRank[r] = total;
+                total += vtxdist[r + 1] - vtxdist[r];
+            }
+            nodeVtxdist[n + 1] = total;
+        }
+        auto renumber = [&](idx_t v) {
+            auto const r = Holder(vtxdist, v);
+            return firstOfRank[r] + (v - vtxdist[r]);
+        };
+
+        // Gather the node's part of the graph onto its leader.
+        auto const nLocal = std::ssize(graph.xadj) - 1;
+        std::vector<idx_t> degree(nLocal);
+        for (std::ptrdiff_t i = 0; i < nLocal; ++i)
+            degree[i] = graph.xadj[i + 1] - graph.xadj[i];
+        std::vector<idx_t> adjacent(graph.adjncy.size());
+        std::transform(graph.adjncy.begin(), graph.adjncy.end(), adjacent.begin(), renumber);
+        std::vector<idx_t> const weight(graph.vwgt.begin(), graph.vwgt.end());
+
+        auto nodeDegree = nodeComm.Gather(degree, 0);
+        auto nodeAdjacent = nodeComm.Gather(adjacent, 0);
+        auto nodeWeight = nodeComm.Gather(weight, 0);
+
+        // The leader works out the rank for each of its node's vertices.
+        std::vector<idx_t> rankForVertex;
+        std::vector<int> counts;
+        if (comms.AmNodeLeader()) {
+            auto const& leadersComm = comms.GetLeadersComm();
+            auto const nVtx = std::ssize(nodeDegree);
+            auto const first = nodeVtxdist[node];
+            std::vector<idx_t> xadj(nVtx + 1, 0);
+            std::inclusive_scan(nodeDegree.begin(), nodeDegree.end(), xadj.begin() + 1);
+
+            // Level one: split the graph between the nodes, in
+            // proportion to their ranks.
+            std::vector<idx_t> nodePart(nVtx, 0);
+            if (N > 1) {
+                idx_t ncon = 1;
+                idx_t wgtflag = 2;
+                idx_t numflag = 0;
+                idx_t nparts = N;
+                std::vector<real_t> tpwgts(N);
+                for (int n = 0; n < N; ++n)
+                    tpwgts[n] = real_t(ranksOfNode[n].size()) / real_t(P);
+                idx_t options[4] = { 0, 0, 0, 0 };
+                idx_t edgesCut = 0;
+                real_t ubvec = imbalance;
+                MPI_Comm communicator = leadersComm;
+                int err = ParMETIS_V3_PartKway(
+                    nodeVtxdist.data(), xadj.data(), nodeAdjacent.data(), nodeWeight.data(),
+                    nullptr, &wgtflag, &numflag, &ncon, &nparts, tpwgts.data(), &ubvec,
+                    options, &edgesCut, nodePart.data(), &communicator
+                );
+                if (err != METIS_OK)
+                    throw Exception() << "ParMETIS error partitioning between nodes";
+                if (leadersComm.Rank() == 0)
+                    log::Logger::Log<log::Info, log::OnePerCore>("ParMetis cut %d edges between %d nodes.",
+                                                                 edgesCut, N);
+            } else {
+                std::fill(nodePart.begin(), nodePart.end(), node);
+            }
+
+            // Tell the other leaders which node gets each of our
+            // vertices that neighbours one of theirs.
+            std::map<int, std::vector<idx_t>> partsToSend;
+            std::vector<int> neighNodes;
+            for (idx_t i = 0; i < nVtx; ++i) {
+                neighNodes.clear();
+                for (auto j = xadj[i]; j < xadj[i + 1]; ++j) {
+                    auto const n = Holder(nodeVtxdist, nodeAdjacent[j]);
+                    if (n != node)
+                        neighNodes.push_back(n);
+                }
+                std::sort(neighNodes.begin(), neighNodes.end());
+                neighNodes.erase(std::unique(neighNodes.begin(), neighNodes.end()), neighNodes.end());
+                for (auto n: neighNodes) {
+                    partsToSend[n].push_back(first + i);
+                    partsToSend[n].push_back(nodePart[i]);
+                }
+            }
+            std::unordered_map<idx_t, idx_t> remotePart;
+            {
+                net::sparse_exchange<idx_t> xchg(leadersComm, 449);
+                for (auto const& [dest, data]: partsToSend)
+                    xchg.send(to_span(data), dest);
+                for (auto const& [_, data]: ReceiveAll(xchg))
+                    for (std::size_t k = 0; k < data.size(); k += 2)
+                        remotePart[data[k]] = data[k + 1];
+            }
+            auto partOf = [&](idx_t v) {
+                return (v >= first && v < nodeVtxdist[node + 1]) ? nodePart[v - first] : remotePart.at(v);
+            };
+
+            // Send each vertex to the leader of its node, with its
+            // weight and neighbours in the same node, as a run of
+            // {index, weight, neighbour count, neighbours...}.
+            std::map<int, std::vector<idx_t>> vertices;
+            for (idx_t i = 0; i < nVtx; ++i) {
+                auto const dest = nodePart[i];
+                auto& data = vertices[dest];
+                data.push_back(first + i);
+                data.push_back(nodeWeight[i]);
+                auto const countPos = data.size();
+                data.push_back(0);
+                for (auto j = xadj[i]; j < xadj[i + 1]; ++j) {
+                    if (partOf(nodeAdjacent[j]) == dest) {
+                        data.push_back(nodeAdjacent[j]);
+                        ++data[countPos];
+                    }
+                }
+            }
+            std::map<int, std::vector<idx_t>> received;
+            {
+                net::sparse_exchange<idx_t> xchg(leadersComm, 450);
+                for (auto const& [dest, data]: vertices)
+                    if (dest != node)
+                        xchg.send(to_span(data), dest);
+                received = ReceiveAll(xchg);
+                received[node] = std::move(vertices[node]);
+            }
+
+            // Level two: split this node's part between its ranks. Put
+            // the vertices in global order so the result doesn't
+            // depend on the order of arrival.
+            std::vector<idx_t const*> runs;
+            for (auto const& [_, data]: received)
+                for (auto p = data.data(); p < data.data() + data.size(); p += 3 + p[2])
+                    runs.push_back(p);
+            std::sort(runs.begin(), runs.end(), [](idx_t const* a, idx_t const* b) { return a[0] < b[0]; });
+            idx_t nSub = std::ssize(runs);
+            std::vector<idx_t> ids(nSub);
+            std::transform(runs.begin(), runs.end(), ids.begin(), [](idx_t const* p) { return p[0]; });
+
+            std::vector<idx_t> subXadj(nSub + 1, 0);
+            std::vector<idx_t> subAdjacent;
+            std::vector<idx_t> subWeight(nSub);
+            for (idx_t i = 0; i < nSub; ++i) {
+                auto const* p = runs[i];
+                subWeight[i] = p[1];
+                for (idx_t j = 0; j < p[2]; ++j)
+                    subAdjacent.push_back(std::lower_bound(ids.begin(), ids.end(), p[3 + j]) - ids.begin());
+                subXadj[i + 1] = subAdjacent.size();
+            }
+
+            std::vector<idx_t> subPart(nSub, 0);
+            idx_t nparts = ranksOfNode[node].size();
+            if (nparts > 1 && nSub > 0) {
+                idx_t ncon = 1;
+                idx_t cut = 0;
+                real_t ubvec = imbalance;
+                int err = METIS_PartGraphKway(
+                    &nSub, &ncon, subXadj.data(), subAdjacent.data(), subWeight.data(),
+                    nullptr, nullptr, &nparts, nullptr, &ubvec, nullptr, &cut, subPart.data()
+                );
+                if (err != METIS_OK)
+                    throw Exception() << "METIS error partitioning within node " << node;
+                log::Logger::Log<log::Debug, log::OnePerCore>("METIS cut %d edges within node %d.",
+                                                              cut, node);
+            }
+
+            // Tell the leaders that hold the vertices which rank
+            // each goes to.
+            std::map<int, std::vector<idx_t>> ranksToSend;
+            for (idx_t i = 0; i < nSub; ++i) {
+                auto& data = ranksToSend[Holder(nodeVtxdist, ids[i])];
+                data.push_back(ids[i]);
+                data.push_back(ranksOfNode[node][subPart[i]]);
+            }
+            rankForVertex.assign(nVtx, -1);
+            {
+                net::sparse_exchange<idx_t> xchg(leadersComm, 451);
+                for (auto const& [dest, data]: ranksToSend)
+                    if (dest != node)
+                        xchg.send(to_span(data), dest);
+                auto results = ReceiveAll(xchg);
+                results[node] = std::move(ranksToSend[node]);
+                for (auto const& [_, data]: results)
+                    for (std::size_t k = 0; k < data.size(); k += 2)
+                        rankForVertex[data[k] - first] = data[k + 1];
+            }
+            if (std::find(rankForVertex.begin(), rankForVertex.end(), -1) != rankForVertex.end())
+                throw Exception() << "Hierarchical partition left vertices of node " << node << " unassigned";
+
+            for (auto r: ranksOfNode[node])
+                counts.push_back(vtxdist[r + 1] - vtxdist[r]);
+        }
+
+        // Hand each rank on the node the ranks for its vertices.
+        return nodeComm.ScatterV(rankForVertex, counts, 0);
+    }
+}
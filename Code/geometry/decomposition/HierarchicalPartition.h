@@ -0,0 +1,51 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_HIERARCHICALPARTITION_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_HIERARCHICALPARTITION_H
+
+#include <span>
+#include <vector>
+
+#include "geometry/ParmetisForward.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb::geometry::decomposition
+{
+    // A graph distributed over the ranks of a communicator as
+    // ParMETIS takes it: each rank holds the vertices from
+    // vtxdist[rank] up to vtxdist[rank + 1], the neighbours (by
+    // global index) of its i'th being adjncy[xadj[i]] up to
+    // adjncy[xadj[i + 1]].
+    struct DistributedGraph
+    {
+        std::span<idx_t const> vtxdist;
+        std::span<idx_t const> xadj;
+        std::span<idx_t const> adjncy;
+        std::span<idx_t const> vwgt;
+    };
+
+    // Collective. The index of each rank's node, numbered as the
+    // node leaders are in the leaders' communicator.
+    std::vector<int> NodeOfEachRank(net::IOCommunicator const& comms);
+
+    // Collective. Partition the graph over the ranks of comms in two
+    // levels, returning the rank for each local vertex.
+    //
+    // First the graph is gathered onto the node leaders and ParMETIS
+    // splits it between the nodes, in proportion to their ranks, so
+    // the edges cut are those that cross the network. Then each
+    // leader splits its node's part between its ranks with METIS, so
+    // the edges cut there go through shared memory. ParMETIS runs on
+    // far fewer processes with far fewer parts than partitioning over
+    // all ranks at once.
+    //
+    // imbalance is the load imbalance tolerance for both levels.
+    std::vector<idx_t> PartitionHierarchically(net::IOCommunicator const& comms,
+                                               DistributedGraph const& graph,
+                                               real_t imbalance);
+}
+
+#endif // HEMELB_GEOMETRY_DECOMPOSITION_HIERARCHICALPARTITION_H
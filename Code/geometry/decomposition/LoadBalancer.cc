@@ -0,0 +1,367 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/decomposition/LoadBalancer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <numeric>
+
+#include "Exception.h"
+#include "geometry/Domain.h"
+#include "geometry/FieldData.h"
+#include "geometry/LookupTree.h"
+#include "geometry/ParmetisHeader.h"
+#include "log/Logger.h"
+#include "net/SparseExchange.h"
+#include "util/span.h"
+
+namespace hemelb::geometry::decomposition
+{
+    LoadBalancer::LoadBalancer(double threshold) : threshold(threshold)
+    {
+        if (threshold <= 0.0)
+            throw (Exception() << "Load balancing threshold must be positive, got " << threshold);
+    }
+
+    bool LoadBalancer::ShouldRebalance(double imbalance)
+    {
+        if (imbalance <= threshold) {
+            armed = true;
+            return false;
+        }
+        if (!armed)
+            return false;
+        armed = false;
+        return true;
+    }
+
+    double MeasuredImbalance(double seconds, net::MpiCommunicator const& comm)
+    {
+        auto const most = comm.AllReduce(seconds, MPI_MAX);
+        auto const mean = comm.AllReduce(seconds, MPI_SUM) / comm.Size();
+        return mean > 0.0 ? most / mean - 1.0 : 0.0;
+    }
+
+    double MeasuredLoadFactor(double seconds, double modelCost, net::MpiCommunicator const& comm)
+    {
+        std::array<double, 2> totals{seconds, modelCost};
+        comm.AllReduceInPlace(std::span<double>(totals), MPI_SUM);
+        if (seconds <= 0.0 || modelCost <= 0.0 || totals[0] <= 0.0)
+            return 1.0;
+        return (seconds / modelCost) / (totals[0] / totals[1]);
+    }
+
+    std::vector<double> ModelSiteCosts(Domain const& domain, SiteWeights const& weights,
+                                       std::span<site_t const> verticesPerSite,
+                                       double cellVertexWeight)
+    {
+        // Local sites are ordered by collision type, first those in
+        // the middle of the domain then those at its edge.
+        std::vector<double> ans;
+        ans.reserve(domain.GetLocalFluidSiteCount());
+        for (unsigned t = 0; t < COLLISION_TYPES; ++t)
+            ans.insert(ans.end(), domain.GetMidDomainCollisionCount(t), weights[t]);
+        for (unsigned t = 0; t < COLLISION_TYPES; ++t)
+            ans.insert(ans.end(), domain.GetDomainEdgeCollisionCount(t), weights[t]);
+
+        if (!verticesPerSite.empty()) {
+            if (verticesPerSite.size() != ans.size())
+                throw (Exception() << "Got vertex counts for " << verticesPerSite.size()
+                       << " sites but there are " << ans.size());
+            auto const perVertex = cellVertexWeight * weights[0];
+            for (std::size_t i = 0; i < ans.size(); ++i)
+                ans[i] += perVertex * verticesPerSite[i];
+        }
+        return ans;
+    }
+
+    std::vector<int> LoadWeights(std::span<double const> costs, double factor)
+    {
+        std::vector<int> ans(costs.size());
+        std::transform(costs.begin(), costs.end(), ans.begin(), [factor](double c) {
+            return std::max(1, int(std::lround(c * factor)));
+        });
+        return ans;
+    }
+
+    std::vector<idx_t> RepartitionSites(Domain const& domain, std::span<int const> loads,
+                                        double itr, net::MpiCommunicator const& comm)
+    {
+        auto const nSites = domain.GetLocalFluidSiteCount();
+        if (std::ssize(loads) != nSites)
+            throw (Exception() << "Got " << loads.size() << " loads for " << nSites << " sites");
+        auto const P = comm.Size();
+        auto const rank = comm.Rank();
+        if (P == 1)
+            return std::vector<idx_t>(nSites, 0);
+
+        // The graph has a vertex for each fluid site, numbered by rank
+        // then local index, joined to the fluid sites it streams to.
+        auto const counts = comm.AllGather(idx_t(nSites));
+        std::vector<idx_t> vtxdist(P + 1, 0);
+        std::inclusive_scan(counts.begin(), counts.end(), vtxdist.begin() + 1);
+        auto const total = vtxdist[P];
+        if (total < P)
+            throw (Exception() << "Can't share " << total << " sites between " << P << " ranks");
+
+        // Neighbours on other ranks are -1 here, to look up all at once.
+        auto const& lattice = domain.GetLatticeInfo();
+        auto const Q = lattice.GetNumVectors();
+        std::vector<idx_t> neighbours;
+        std::vector<std::size_t> firstNeighbour{0};
+        std::vector<util::Vector3D<site_t>> remote;
+        for (site_t i = 0; i < nSites; ++i) {
+            auto const& coords = domain.GetSite(i).GetGlobalSiteCoords();
+            for (Direction d = 1; d < Q; ++d) {
+                auto const neigh = coords + lattice.GetVector(d).as<site_t>();
+                if (!domain.IsValidLatticeSite(neigh))
+                    continue;
+                Vec16 blockCoords, siteCoords;
+                domain.GetBlockAndLocalSiteCoords(neigh, blockCoords, siteCoords);
+                if (domain.GetBlockOctIndexFromBlockCoords(blockCoords) == octree::Level::NC)
+                    continue;
+                auto const& block = domain.GetBlock(blockCoords);
+                auto const siteId = domain.GetLocalSiteIdFromLocalSiteCoords(siteCoords);
+                auto const proc = block.IsEmpty() ? UNKNOWN_PROCESS : block.GetProcessorRankForSite(siteId);
+                if (proc == SITE_OR_BLOCK_SOLID)
+                    continue;
+                if (proc == rank) {
+                    neighbours.push_back(vtxdist[rank] + block.GetLocalContiguousIndexForSite(siteId));
+                } else {
+                    neighbours.push_back(-1);
+                    remote.push_back(neigh);
+                }
+            }
+            firstNeighbour.push_back(neighbours.size());
+        }
+        auto const remoteIndices = domain.GetRankIndexFromGlobalCoords(remote);
+        auto r = remoteIndices.begin();
+        std::vector<idx_t> xadj{0};
+        std::vector<idx_t> adjncy;
+        adjncy.reserve(neighbours.size());
+        for (site_t i = 0; i < nSites; ++i) {
+            for (auto k = firstNeighbour[i]; k < firstNeighbour[i + 1]; ++k) {
+                if (neighbours[k] >= 0) {
+                    adjncy.push_back(neighbours[k]);
+                } else if (auto const [proc, idx] = *r++; proc != SITE_OR_BLOCK_SOLID) {
+                    adjncy.push_back(vtxdist[proc] + idx);
+                }
+            }
+            xadj.push_back(adjncy.size());
+        }
+
+        // A site's distributions are what moves with it.
+        std::vector<idx_t> vwgt(loads.begin(), loads.end());
+        std::vector<idx_t> vsize(nSites, Q);
+        std::vector<idx_t> part(nSites, rank);
+
+        idx_t edgesCut = 0;
+        auto const repartition = [&](std::span<idx_t const> dist, std::vector<idx_t>& x, std::vector<idx_t>& adj,
+                                     std::vector<idx_t>& w, std::vector<idx_t>& s, std::vector<idx_t>& p,
+                                     idx_t psr) {
+            idx_t ncon = 1;
+            idx_t wgtflag = 2;
+            idx_t numflag = 0;
+            idx_t nparts = P;
+            std::vector<real_t> tpwgts(nparts, real_t(1.0) / real_t(nparts));
+            real_t ubvec = 1.001F;
+            real_t ratio = std::clamp(itr, 1e-6, 1e6);
+            idx_t options[4] = { 1, 0, 0, psr };
+            MPI_Comm communicator = comm;
+            int err = ParMETIS_V3_AdaptiveRepart(
+                const_cast<idx_t*>(dist.data()), x.data(), adj.data(), w.data(), s.data(),
+                nullptr, &wgtflag, &numflag, &ncon, &nparts, tpwgts.data(), &ubvec, &ratio,
+                options, &edgesCut, p.data(), &communicator
+            );
+            if (err != METIS_OK)
+                throw Exception() << "ParMETIS error repartitioning";
+        };
+
+        if (std::find(counts.begin(), counts.end(), 0) == counts.end()) {
+            // The sites' ranks are the current partition.
+            repartition(vtxdist, xadj, adjncy, vwgt, vsize, part, PARMETIS_PSR_COUPLED);
+        } else {
+            // ParMETIS needs a vertex on every rank, so give it the
+            // graph split evenly, keeping the numbering, with each
+            // vertex's rank as its current part. Each rank's vertices
+            // go as one record per vertex: its weight, part, degree
+            // and neighbours.
+            std::vector<idx_t> even(P + 1);
+            for (int q = 0; q <= P; ++q)
+                even[q] = idx_t(std::int64_t(total) * q / P);
+            auto const holder = [](std::span<idx_t const> dist, idx_t v) {
+                return int(std::upper_bound(dist.begin(), dist.end(), v) - dist.begin()) - 1;
+            };
+
+            std::map<int, std::vector<idx_t>> records;
+            for (site_t i = 0; i < nSites; ++i) {
+                auto& rec = records[holder(even, vtxdist[rank] + i)];
+                rec.insert(rec.end(), {vwgt[i], part[i], xadj[i + 1] - xadj[i]});
+                rec.insert(rec.end(), adjncy.begin() + xadj[i], adjncy.begin() + xadj[i + 1]);
+            }
+            auto const receiveAll = [&](net::sparse_exchange<idx_t>& xchg, std::map<int, std::vector<idx_t>>& in) {
+                xchg.receive(
+                    [&](int src, int count) {
+                        auto& rbuf = in[src];
+                        rbuf.resize(count);
+                        return rbuf.data();
+                    },
+                    [](int, idx_t*) {
+                        // no-op
+                    }
+                );
+            };
+            std::map<int, std::vector<idx_t>> hosted;
+            {
+                net::sparse_exchange<idx_t> xchg(comm, 454);
+                for (auto const& [dest, rec]: records)
+                    if (dest != rank)
+                        xchg.send(to_span(rec), dest);
+                receiveAll(xchg, hosted);
+            }
+            if (records.contains(rank))
+                hosted[rank] = std::move(records[rank]);
+
+            // Both numberings are by rank, so the vertices arrive in
+            // order of their sender.
+            std::vector<idx_t> hXadj{0}, hAdjncy, hVwgt, hPart;
+            for (auto const& [src, rec]: hosted) {
+                for (std::size_t k = 0; k < rec.size(); k += 3 + rec[k + 2]) {
+                    hVwgt.push_back(rec[k]);
+                    hPart.push_back(rec[k + 1]);
+                    hAdjncy.insert(hAdjncy.end(), rec.begin() + k + 3, rec.begin() + k + 3 + rec[k + 2]);
+                    hXadj.push_back(hAdjncy.size());
+                }
+            }
+            if (std::ssize(hVwgt) != even[rank + 1] - even[rank])
+                throw (Exception() << "Hosting " << hVwgt.size() << " sites to repartition, not "
+                                   << even[rank + 1] - even[rank]);
+            std::vector<idx_t> hVsize(hVwgt.size(), Q);
+            repartition(even, hXadj, hAdjncy, hVwgt, hVsize, hPart, PARMETIS_PSR_UNCOUPLED);
+
+            // Send the answers back.
+            std::map<int, std::vector<idx_t>> answers;
+            for (std::size_t k = 0; k < hPart.size(); ++k)
+                answers[holder(vtxdist, even[rank] + idx_t(k))].push_back(hPart[k]);
+            std::map<int, std::vector<idx_t>> returned;
+            {
+                net::sparse_exchange<idx_t> xchg(comm, 455);
+                for (auto const& [dest, ans]: answers)
+                    if (dest != rank)
+                        xchg.send(to_span(ans), dest);
+                receiveAll(xchg, returned);
+            }
+            if (answers.contains(rank))
+                returned[rank] = std::move(answers[rank]);
+            part.clear();
+            for (auto const& [src, ans]: returned)
+                part.insert(part.end(), ans.begin(), ans.end());
+        }
+
+        auto const moving = comm.AllReduce(
+                std::int64_t(std::count_if(part.begin(), part.end(), [&](idx_t p) { return p != rank; })),
+                MPI_SUM
+        );
+        log::Logger::Log<log::Info, log::Singleton>("ParMetis repartitioned the sites, moving %ld and cutting %d edges.",
+                                                    long(moving), int(edgesCut));
+        return part;
+    }
+
+    void MigrateDistributions(FieldData const& from, MovesMap const& departing,
+                              FieldData& to, net::MpiCommunicator const& comm)
+    {
+        auto const& oldDomain = from.GetDomain();
+        auto const& newDomain = to.GetDomain();
+        auto const Q = oldDomain.GetLatticeInfo().GetNumVectors();
+
+        auto newIndex = [&](SiteDesc const& site) {
+            auto const coords = newDomain.GetGlobalCoords(site[0],
+                                                          newDomain.GetSiteCoordsFromSiteId(site[1]));
+            return newDomain.GetContiguousSiteId(coords);
+        };
+        // As for reading a checkpoint, the new field starts with both
+        // old and new distributions the same.
+        site_t filled = 0;
+        auto set = [&](site_t j, distribn_t const* f) {
+            for (Direction d = 0; d < Q; ++d) {
+                auto const idx = newDomain.GetDistributionIndex(j, d);
+                *to.GetFNew(idx) = *to.GetFOld(idx) = f[d];
+            }
+            ++filled;
+        };
+        auto get = [&](site_t i, distribn_t* f) {
+            for (Direction d = 0; d < Q; ++d)
+                f[d] = *from.GetFOld(from.GetFOldIndex(i, d));
+        };
+
+        // Copy the sites that stay here.
+        std::vector<distribn_t> f(Q);
+        for (site_t i = 0; i < oldDomain.GetLocalFluidSiteCount(); ++i) {
+            proc_t proc;
+            site_t j;
+            if (newDomain.GetContiguousSiteId(from.GetSite(i).GetGlobalSiteCoords(), proc, j)) {
+                get(i, f.data());
+                set(j, f.data());
+            }
+        }
+
+        // Send the others, first saying which sites they are.
+        std::map<int, std::vector<distribn_t>> sendValues;
+        for (auto const& [dest, sites]: departing) {
+            auto& values = sendValues[dest];
+            values.resize(sites.size() * Q);
+            for (std::size_t k = 0; k < sites.size(); ++k) {
+                auto const coords = oldDomain.GetGlobalCoords(
+                    sites[k][0], oldDomain.GetSiteCoordsFromSiteId(sites[k][1])
+                );
+                get(oldDomain.GetContiguousSiteId(coords), values.data() + k * Q);
+            }
+        }
+
+        std::map<int, SiteVec> arriving;
+        {
+            net::sparse_exchange<SiteDesc> xchg(comm, 447);
+            for (auto const& [dest, sites]: departing)
+                xchg.send(to_span(sites), dest);
+            xchg.receive(
+                [&](int src, int count) {
+                    auto& rbuf = arriving[src];
+                    rbuf.resize(count);
+                    return rbuf.data();
+                },
+                [&](int src, auto* buf) {
+                    // no-op
+                }
+            );
+        }
+        {
+            std::map<int, std::vector<distribn_t>> recvValues;
+            net::sparse_exchange<distribn_t> xchg(comm, 448);
+            for (auto const& [dest, values]: sendValues)
+                xchg.send(to_span(values), dest);
+            xchg.receive(
+                [&](int src, int count) {
+                    auto& rbuf = recvValues[src];
+                    rbuf.resize(count);
+                    return rbuf.data();
+                },
+                [&](int src, distribn_t* buf) {
+                    auto const& sites = arriving.at(src);
+                    if (recvValues[src].size() != sites.size() * Q)
+                        throw (Exception() << "Got distributions for the wrong number of sites from rank " << src);
+                    for (std::size_t k = 0; k < sites.size(); ++k)
+                        set(newIndex(sites[k]), buf + k * Q);
+                }
+            );
+        }
+
+        if (filled != newDomain.GetLocalFluidSiteCount())
+            throw (Exception() << "Migrated distributions for " << filled << " sites but the rank has "
+                   << newDomain.GetLocalFluidSiteCount());
+    }
+}
@@ -0,0 +1,91 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
+
+#include <span>
+#include <vector>
+
+#include "geometry/GmyReadResult.h"
+#include "geometry/ParmetisForward.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "net/MpiCommunicator.h"
+#include "units.h"
+
+namespace hemelb::geometry
+{
+    class Domain;
+    class FieldData;
+}
+
+namespace hemelb::geometry::decomposition
+{
+    // Decides when to decompose the domain again during a run, from
+    // the compute time measured on each rank.
+    //
+    // This triggers once each time the imbalance rises above the
+    // threshold; it must fall below it again before the next. That
+    // stops a decomposition that can't do better than the threshold
+    // (e.g. because a few sites are very expensive) from being
+    // redone every time it is checked.
+    class LoadBalancer
+    {
+    public:
+        // threshold is the fractional excess of the slowest rank's
+        // time over the mean, e.g. 0.1 for 10%.
+        explicit LoadBalancer(double threshold);
+
+        // Should we rebalance, given the latest imbalance?
+        bool ShouldRebalance(double imbalance);
+
+        [[nodiscard]] double GetThreshold() const {
+            return threshold;
+        }
+
+    private:
+        double threshold;
+        bool armed = true;
+    };
+
+    // Collective. The fractional excess of the largest of the ranks'
+    // times over their mean.
+    double MeasuredImbalance(double seconds, net::MpiCommunicator const& comm);
+
+    // Collective. How much slower this rank ran per unit of modelled
+    // cost than all ranks together, which is the factor to scale the
+    // costs of its sites by to match what was measured.
+    double MeasuredLoadFactor(double seconds, double modelCost, net::MpiCommunicator const& comm);
+
+    // The modelled cost of each local site, in the units of the site
+    // weights: the weight of its collision type plus, for each cell
+    // vertex nearest to it, cellVertexWeight times the bulk weight.
+    // verticesPerSite may be empty if there are no cells.
+    std::vector<double> ModelSiteCosts(Domain const& domain, SiteWeights const& weights,
+                                       std::span<site_t const> verticesPerSite,
+                                       double cellVertexWeight);
+
+    // ParMETIS vertex weights from site costs scaled by a load
+    // factor, rounded and at least 1.
+    std::vector<int> LoadWeights(std::span<double const> costs, double factor);
+
+    // Collective. The rank each local site should move to, as
+    // ParMETIS's adaptive repartitioning decides from the sites'
+    // loads (see LoadWeights). It trades off the balance and edges
+    // cut against how much data moves, by itr: the time steps until
+    // the balance is next checked, since the halo is exchanged every
+    // step but the sites move only once.
+    std::vector<idx_t> RepartitionSites(Domain const& domain, std::span<int const> loads,
+                                        double itr, net::MpiCommunicator const& comm);
+
+    // Collective. Fill the distributions of a newly decomposed field
+    // from those of the field it replaces, where departing gives the
+    // sites leaving this rank, keyed by their new rank. Both fields
+    // must be at the start of a time step.
+    void MigrateDistributions(FieldData const& from, MovesMap const& departing,
+                              FieldData& to, net::MpiCommunicator const& comm);
+}
+
+#endif // HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
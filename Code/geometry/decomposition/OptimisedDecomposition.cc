@@ -5,7 +5,7 @@
 
 #include "geometry/ParmetisHeader.h"
 #include "geometry/decomposition/OptimisedDecomposition.h"
-#include "geometry/decomposition/DecompositionWeights.h"
+#include "geometry/decomposition/HierarchicalPartition.h"
 #include "geometry/LookupTree.h"
 
 #include "lb/lattices/D3Q27.h"
@@ -20,12 +20,14 @@ namespace hemelb::geometry::decomposition
 
     OptimisedDecomposition::OptimisedDecomposition(
         reporting::Timers& timers,
-        net::MpiCommunicator c,
+        net::IOCommunicator c,
         const GmyReadResult& geometry,
-        const lb::LatticeInfo& latticeInfo
+        const lb::LatticeInfo& latticeInfo,
+        const SiteWeights& siteWeights,
+        bool hierarchical
     ) : timers(timers), comms(std::move(c)), geometry(geometry),
-        tree(geometry.block_store->GetTree()), latticeInfo(latticeInfo),
-        procForBlockOct(geometry.block_store->GetBlockOwnerRank()),
+        tree(geometry.block_store->GetTree()), latticeInfo(latticeInfo), siteWeights(siteWeights),
+        hierarchical(hierarchical),
         fluidSitesPerBlockOct(tree.levels.back().sites_per_node)
     {
         timers[reporting::Timers::InitialGeometryRead].Start(); //overall dbg timing
@@ -132,6 +134,17 @@ namespace hemelb::geometry::decomposition
         // Tolerance. 1 => perfect balance, npars => perfect imbalance.
         // Docs recommend 1.05 so we are being quite strict here.
         real_t ubvec = 1.001F;
+
+        if (hierarchical) {
+          log::Logger::Log<log::Debug, log::OnePerCore>("Partitioning between nodes, then within them");
+          partitionVector = PartitionHierarchically(
+              comms,
+              {vtxDistribn, adjacenciesPerVertex, localAdjacencies, vertexWeights},
+              ubvec
+          );
+          return;
+        }
+
         MPI_Comm communicator = comms;
 
         log::Logger::Log<log::Debug, log::OnePerCore>("Calling ParMetis");
@@ -178,12 +191,9 @@ namespace hemelb::geometry::decomposition
 
         vertexWeights.resize(localVertexCount);
         idx_t i_wgt = 0;
-        // For each block (counting up by lowest site id)...
-        for (auto [block_idx, block_rank]: enumerate_with<std::size_t>(procForBlockOct)) {
-            if (block_rank != comms.Rank())
-                // Only consider sites on this procesr.
-                continue;
-
+        // For each block on this process (counting up by lowest site id)...
+        auto const [first_block, last_block] = geometry.block_store->GetBlockRange(comms.Rank());
+        for (auto block_idx = first_block; block_idx < last_block; ++block_idx) {
             auto block_ijk = tree.GetLeafCoords(block_idx);
             auto block_gmy = geometry.GetBlockIdFromBlockCoordinates(block_ijk);
 
@@ -216,7 +226,7 @@ namespace hemelb::geometry::decomposition
                     }
                 }();
                 ++siteCounters[site_type_i];
-                vertexWeights[i_wgt++] = hemelbSiteWeights[site_type_i];
+                vertexWeights[i_wgt++] = siteWeights[site_type_i];
             }
         }
 
@@ -224,7 +234,7 @@ namespace hemelb::geometry::decomposition
           throw Exception() << "Wrong number of vertices: expected " << localVertexCount << " got " << i_wgt;
 
         int TotalCoreWeight = std::inner_product(begin(siteCounters), end(siteCounters),
-                                                 hemelbSiteWeights, 0);
+                                                 begin(siteWeights), 0);
         int TotalSites = std::reduce(begin(siteCounters), end(siteCounters), 0);
 
         log::Logger::Log<log::Debug, log::OnePerCore>("There are %u Bulk Flow Sites, %u Wall Sites, %u IO Sites, %u WallIO Sites on core %u. Total: %u (Weighted %u Points)",
@@ -261,22 +271,23 @@ namespace hemelb::geometry::decomposition
         // We will also need to be able to translate between a site's
         // GMY index in a block and it's fluid-only index.
 
-        auto& procForBlockOct = geometry.block_store->GetBlockOwnerRank();
-        auto& tree = geometry.block_store->GetTree();
-        auto& fluidSitesPerBlockOct = tree.levels[tree.n_levels].sites_per_node;
-        auto const NBLOCKS = geometry.block_store->GetBlockCount();
+        auto const& store = *geometry.block_store;
+        auto const NBLOCKS = store.GetBlockCount();
 
         // First, count the sites per process and assign contiguous
-        // IDs to the sites in each block.
+        // IDs to the sites in each block. Each process has a
+        // contiguous slice of the blocks.
         U64 total_sites = 0;
         vtxCountPerProc = std::vector<idx_t>(comms.Size(), 0);
         firstSiteIndexPerBlockOct.resize(NBLOCKS + 1);
 
-        for (site_t block = 0; block < NBLOCKS; ++block) {
-            auto block_rank = procForBlockOct[block];
-            firstSiteIndexPerBlockOct[block] = total_sites;
-            vtxCountPerProc[block_rank] += fluidSitesPerBlockOct[block];
-            total_sites += fluidSitesPerBlockOct[block];
+        for (int rank = 0; rank < comms.Size(); ++rank) {
+            auto const [first_block, last_block] = store.GetBlockRange(rank);
+            for (auto block = first_block; block < last_block; ++block) {
+                firstSiteIndexPerBlockOct[block] = total_sites;
+                vtxCountPerProc[rank] += fluidSitesPerBlockOct[block];
+                total_sites += fluidSitesPerBlockOct[block];
+            }
         }
         firstSiteIndexPerBlockOct[NBLOCKS] = total_sites;
 
@@ -292,12 +303,8 @@ namespace hemelb::geometry::decomposition
         // Now, for every block we've got data for, create the mapping
         // from block OCT id to a vector of the GMY local site ids of
         // the fluid sites.
-        for (auto [block_idx, block_rank]: enumerate_with<U64>(procForBlockOct)) {
-            auto block_ijk = tree.GetLeafCoords(block_idx);
-            auto block_gmy = geometry.GetBlockIdFromBlockCoordinates(block_ijk);
-            auto& blockReadResult = geometry.Blocks[block_gmy];
-            if (blockReadResult.Sites.empty())
-                continue;
+        for (auto const& [block_gmy, blockReadResult]: geometry.Blocks) {
+            auto block_idx = tree.GetLeaf(geometry.GetBlockCoordinatesFromBlockId(block_gmy)).index();
             std::vector<U16>& block_fluid_site_gmy_ids = gmySiteIdForBlockOct[block_idx];
             for (auto const& [i, s]: util::enumerate_with<U16>(blockReadResult.Sites)) {
                 // ... only looking at non-solid sites...
@@ -318,16 +325,13 @@ namespace hemelb::geometry::decomposition
         auto const lo_site = Vector3D<site_t>::Zero();
         auto const hi_site = block_dims.as<site_t>() * BS - Vector3D<site_t>::Ones();
 
-        // For each block (counting up by lowest site id)...
-        for (auto [block_idx, block_rank]: enumerate_with<std::size_t>(procForBlockOct)) {
-            if (block_rank != comms.Rank())
-                // ... considering only the ones which live on this proc...
-                continue;
-
+        // For each block which lives on this proc (counting up by lowest site id)...
+        auto const [first_block, last_block] = geometry.block_store->GetBlockRange(comms.Rank());
+        for (auto block_idx = first_block; block_idx < last_block; ++block_idx) {
             auto block_ijk = tree.GetLeafCoords(block_idx);
             auto block_gmy = geometry.GetBlockIdFromBlockCoordinates(block_ijk);
 
-            auto& blockReadResult = geometry.Blocks[block_gmy];
+            auto const blockReadResult = geometry.Blocks[block_gmy];
             for (auto [local_site_ijk, m]: IterSitesInBlock(geometry)) {
                 // ... only looking at non-solid sites...
                 if (blockReadResult.Sites[m].targetProcessor == SITE_OR_BLOCK_SOLID)
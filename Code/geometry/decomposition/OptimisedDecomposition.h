@@ -6,15 +6,17 @@
 #ifndef HEMELB_GEOMETRY_DECOMPOSITION_OPTIMISEDDECOMPOSITION_H
 #define HEMELB_GEOMETRY_DECOMPOSITION_OPTIMISEDDECOMPOSITION_H
 
+#include <span>
 #include <vector>
 #include <map>
 #include "geometry/GmyReadResult.h"
 #include "lb/lattices/LatticeInfo.h"
 #include "geometry/ParmetisForward.h"
 #include "reporting/Timers.h"
-#include "net/MpiCommunicator.h"
+#include "net/IOCommunicator.h"
 #include "geometry/SiteData.h"
 #include "geometry/GeometryBlock.h"
+#include "geometry/decomposition/SiteWeights.h"
 
 namespace hemelb::geometry {
     namespace octree { class LookupTree; }
@@ -32,9 +34,14 @@ namespace hemelb::geometry {
       {
       public:
           // Constructor actually does the optimisation - collective over comm.
-          OptimisedDecomposition(reporting::Timers& timers, net::MpiCommunicator comms,
+          //
+          // If hierarchical, partition between the nodes and then
+          // within each (see PartitionHierarchically).
+          OptimisedDecomposition(reporting::Timers& timers, net::IOCommunicator comms,
                                  const GmyReadResult& geometry,
-                                 const lb::LatticeInfo& latticeInfo);
+                                 const lb::LatticeInfo& latticeInfo,
+                                 const SiteWeights& siteWeights,
+                                 bool hierarchical = false);
 
           // NOTE! All the sites in staying, leaving and arriving are
           // sorted first by block ID and then by intra-block site ID.
@@ -113,12 +120,13 @@ namespace hemelb::geometry {
           MovesMap CompileMoveData();
 
           reporting::Timers& timers; //! Timers for reporting.
-          net::MpiCommunicator comms; //! Communicator
+          net::IOCommunicator comms; //! Communicator
           const GmyReadResult& geometry; //! The geometry being optimised.
           octree::LookupTree const& tree;
           const lb::LatticeInfo& latticeInfo; //! The lattice info to optimise for.
-          const std::vector<proc_t>& procForBlockOct; //! The initial MPI process for each block, in OCT layout
-          const std::vector<U64>& fluidSitesPerBlockOct; //! The number of fluid sites per block, in OCT layout
+          SiteWeights siteWeights; //! The relative cost of each collision type
+          bool hierarchical; //! Whether to partition between nodes first
+          std::span<U64 const> fluidSitesPerBlockOct; //! The number of fluid sites per block, in OCT layout
           std::vector<idx_t> vtxCountPerProc; //! The number of vertices on each process.
           std::vector<idx_t> vtxDistribn; //! The vertex distribution across participating cores.
           std::vector<idx_t> firstSiteIndexPerBlockOct; //! The global contiguous index of the first fluid site on each block.
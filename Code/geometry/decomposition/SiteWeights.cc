@@ -0,0 +1,98 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/decomposition/SiteWeights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Exception.h"
+#include "geometry/decomposition/DecompositionWeights.h"
+
+namespace hemelb::geometry::decomposition
+{
+    namespace {
+        constexpr std::array<char const*, COLLISION_TYPES> NAMES = {
+            "bulk", "wall", "inlet", "outlet", "inlet_wall", "outlet_wall"
+        };
+        // The weight of a bulk site in calibrated weights: large
+        // enough for the others to be resolved to within a few percent.
+        constexpr double BULK_WEIGHT = 10.0;
+    }
+
+    SiteWeights DefaultSiteWeights()
+    {
+        SiteWeights ans;
+        std::copy(std::begin(hemelbSiteWeights), std::end(hemelbSiteWeights), ans.begin());
+        return ans;
+    }
+
+    SiteWeights ReadSiteWeights(std::filesystem::path const& path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            throw (Exception() << "Could not open site weights file " << path);
+
+        SiteWeights ans;
+        std::array<bool, COLLISION_TYPES> seen{};
+        std::string line;
+        for (int lineNo = 1; std::getline(file, line); ++lineNo) {
+            std::istringstream words(line);
+            std::string name;
+            if (!(words >> name) || name[0] == '#')
+                continue;
+
+            auto const found = std::find(NAMES.begin(), NAMES.end(), name);
+            if (found == NAMES.end())
+                throw (Exception() << path << ":" << lineNo << ": unknown collision type '" << name << "'");
+            auto const i = found - NAMES.begin();
+            if (!(words >> ans[i]) || ans[i] <= 0)
+                throw (Exception() << path << ":" << lineNo << ": weight must be a positive integer");
+            seen[i] = true;
+        }
+        for (unsigned i = 0; i < COLLISION_TYPES; ++i)
+            if (!seen[i])
+                throw (Exception() << path << ": no weight given for " << NAMES[i] << " sites");
+        return ans;
+    }
+
+    void WriteSiteWeights(std::filesystem::path const& path, SiteWeights const& weights)
+    {
+        std::ofstream file(path);
+        file << "# HemeLB decomposition site weights\n";
+        for (unsigned i = 0; i < COLLISION_TYPES; ++i)
+            file << NAMES[i] << " " << weights[i] << "\n";
+        if (!file)
+            throw (Exception() << "Could not write site weights file " << path);
+    }
+
+    SiteWeights CalibrateSiteWeights(std::array<double, COLLISION_TYPES> const& seconds,
+                                     std::array<std::uint64_t, COLLISION_TYPES> const& sites,
+                                     SiteWeights const& fallback)
+    {
+        // Measure against bulk sites if there are any, else the first
+        // type that has some, whose weight is taken from fallback.
+        auto const measured = [&](unsigned i) { return sites[i] > 0 && seconds[i] > 0.0; };
+        unsigned ref = 0;
+        while (ref < COLLISION_TYPES && !measured(ref))
+            ++ref;
+        if (ref == COLLISION_TYPES)
+            return fallback;
+
+        double const scale = BULK_WEIGHT / fallback[0];
+        double const refCost = seconds[ref] / sites[ref];
+        double const refWeight = scale * fallback[ref];
+
+        SiteWeights ans;
+        for (unsigned i = 0; i < COLLISION_TYPES; ++i) {
+            double const w = measured(i) ? refWeight * (seconds[i] / sites[i]) / refCost : scale * fallback[i];
+            ans[i] = std::max(1, int(std::lround(w)));
+        }
+        return ans;
+    }
+}
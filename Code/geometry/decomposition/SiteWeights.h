@@ -0,0 +1,45 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+namespace hemelb::geometry::decomposition
+{
+    // The number of collision types, in the order used throughout:
+    // bulk, wall, inlet, outlet, inlet/wall and outlet/wall.
+    inline constexpr unsigned COLLISION_TYPES = 6;
+
+    // The relative cost of updating a site of each collision type,
+    // given to ParMETIS as vertex weights so that it balances work
+    // rather than site counts.
+    using SiteWeights = std::array<int, COLLISION_TYPES>;
+
+    // The weights compiled in for HEMELB_COMPUTE_ARCHITECTURE and the
+    // chosen boundary conditions (see DecompositionWeights.h.in).
+    SiteWeights DefaultSiteWeights();
+
+    // Read a site weights file. This is text, with lines giving a
+    // collision type's name (bulk, wall, inlet, outlet, inlet_wall or
+    // outlet_wall) then its weight, a positive integer. All types must
+    // be given. Blank lines and those starting with '#' are ignored.
+    SiteWeights ReadSiteWeights(std::filesystem::path const& path);
+
+    // Write a site weights file, as read by ReadSiteWeights.
+    void WriteSiteWeights(std::filesystem::path const& path, SiteWeights const& weights);
+
+    // Weights in proportion to the measured time per site of each
+    // collision type, with bulk sites having weight 10. Types with no
+    // sites keep their weight from fallback, rescaled to match.
+    SiteWeights CalibrateSiteWeights(std::array<double, COLLISION_TYPES> const& seconds,
+                                     std::array<std::uint64_t, COLLISION_TYPES> const& sites,
+                                     SiteWeights const& fallback);
+}
+
+#endif // HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
@@ -121,6 +121,14 @@ auto const site = localFieldData.GetSite(localContiguousId);
                              source);
 
         }
+        if constexpr (!CONTIGUOUS_SITE_VIEWS)
+        {
+          std::size_t nSends = 0;
+          for (auto const& needs: needsEachProcHasFromMe)
+            nSends += needs.size();
+          sendBuffer.resize(nSends * NV);
+        }
+        std::size_t sendOffset = 0;
         for (proc_t other = 0; other < net.Size(); other++)
         {
           for (std::vector<site_t>::iterator needOnProcFromMe =
@@ -131,11 +139,21 @@ auto const site = localFieldData.GetSite(localContiguousId);
                 local_dom.GetLocalContiguousIdFromGlobalNoncontiguousId(*needOnProcFromMe);
 //            Site<Domain> site =
 //                const_cast<Domain&>(localFieldData).GetSite(localContiguousId);
-            auto const site = localFieldData.GetSite(localContiguousId);
-            // have to cast away the const, because no respect for const-ness for sends in MPI
-            net.RequestSend(site.GetFOld(NV),
-                            NV,
-                            other);
+            if constexpr (CONTIGUOUS_SITE_VIEWS)
+            {
+              auto const site = localFieldData.GetSite(localContiguousId);
+              net.RequestSend(site.GetFOld(NV),
+                              NV,
+                              other);
+            }
+            else
+            {
+              distribn_t* const staged = &sendBuffer[sendOffset];
+              for (Direction l = 0; l < NV; ++l)
+                staged[l] = *localFieldData.GetFOld(localFieldData.GetFOldIndex(localContiguousId, l));
+              net.RequestSend(staged, NV, other);
+              sendOffset += NV;
+            }
 
           }
         }
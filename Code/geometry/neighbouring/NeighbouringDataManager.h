@@ -57,6 +57,9 @@ namespace hemelb
 
           std::vector<site_t> neededSites;
           std::vector<std::vector<site_t> > needsEachProcHasFromMe;
+          // Staging area for sends when the local distributions of a
+          // site are not contiguous in memory.
+          std::vector<distribn_t> sendBuffer;
 
           bool needsHaveBeenShared;
 
@@ -0,0 +1,88 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "io/Hdf5.h"
+
+#include <functional>
+#include <numeric>
+#include <utility>
+
+namespace hemelb::io::hdf5 {
+    Id::Id(hid_t result, std::string_view what) : id(Check(result, what)) {
+    }
+
+    Id::Id(Id&& other) noexcept : id(std::exchange(other.id, -1)) {
+    }
+
+    Id& Id::operator=(Id&& other) {
+        Close();
+        id = std::exchange(other.id, -1);
+        return *this;
+    }
+
+    Id::~Id() {
+        if (IsValid())
+            H5Idec_ref(id);
+    }
+
+    void Id::Close() {
+        if (IsValid())
+            Check(H5Idec_ref(std::exchange(id, -1)), "closing object");
+    }
+
+    namespace {
+        // File access through MPI-IO, with the metadata handled
+        // collectively so that every rank doesn't read it separately.
+        Id ParallelAccess(MPI_Comm comm) {
+            Id fapl(H5Pcreate(H5P_FILE_ACCESS), "creating file access properties");
+            Check(H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL), "setting MPI-IO file access");
+#if H5_VERSION_GE(1, 10, 0)
+            Check(H5Pset_all_coll_metadata_ops(fapl, true), "setting collective metadata reads");
+            Check(H5Pset_coll_metadata_write(fapl, true), "setting collective metadata writes");
+#endif
+            return fapl;
+        }
+    }
+
+    Id CreateFile(std::filesystem::path const& path, MPI_Comm comm) {
+        auto fapl = ParallelAccess(comm);
+        Id ans(H5Fcreate(path.c_str(), H5F_ACC_EXCL, H5P_DEFAULT, fapl), "creating file");
+        return ans;
+    }
+
+    Id OpenFile(std::filesystem::path const& path, MPI_Comm comm) {
+        auto fapl = ParallelAccess(comm);
+        hid_t const file = H5Fopen(path.c_str(), H5F_ACC_RDONLY, fapl);
+        if (file < 0)
+            throw Exception() << "HDF5 error: cannot open file " << path;
+        return Id(file, "opening file");
+    }
+
+    Id CollectiveTransfer() {
+        Id dxpl(H5Pcreate(H5P_DATASET_XFER), "creating transfer properties");
+        Check(H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE), "setting collective transfer");
+        return dxpl;
+    }
+
+    Id Dataspace(std::span<hsize_t const> dims, std::span<hsize_t const> maxdims) {
+        return Id(H5Screate_simple(int(dims.size()), dims.data(), maxdims.empty() ? nullptr : maxdims.data()),
+                  "creating dataspace");
+    }
+
+    Id SelectPart(hid_t space, std::span<hsize_t const> start, std::span<hsize_t const> count) {
+        auto const n = std::accumulate(count.begin(), count.end(), hsize_t{1}, std::multiplies<>{});
+        if (n == 0) {
+            // Select nothing from one element in memory, too.
+            Check(H5Sselect_none(space), "selecting nothing");
+            hsize_t const one = 1;
+            Id ans(H5Screate_simple(1, &one, nullptr), "creating dataspace");
+            Check(H5Sselect_none(ans), "selecting nothing");
+            return ans;
+        }
+        Check(H5Sselect_hyperslab(space, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr),
+              "selecting hyperslab");
+        return Id(H5Screate_simple(1, &n, nullptr), "creating dataspace");
+    }
+}
@@ -0,0 +1,107 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_HDF5_H
+#define HEMELB_IO_HDF5_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include <hdf5.h>
+#include <mpi.h>
+
+#include "Exception.h"
+
+namespace hemelb::io::hdf5 {
+    // Return the result of an HDF5 call, throwing if it failed
+    // (i.e. is negative).
+    template <typename T>
+    T Check(T result, std::string_view what) {
+        if (result < 0)
+            throw Exception() << "HDF5 error: " << what;
+        return result;
+    }
+
+    // Owns an HDF5 identifier (of a file, group, dataset, dataspace,
+    // property list, ...) and releases it when destroyed.
+    class Id {
+        hid_t id = -1;
+    public:
+        Id() = default;
+        // Take ownership of the result of an HDF5 call, throwing if
+        // the call failed.
+        Id(hid_t result, std::string_view what);
+
+        Id(Id const&) = delete;
+        Id& operator=(Id const&) = delete;
+        Id(Id&& other) noexcept;
+        Id& operator=(Id&& other);
+
+        // Errors are ignored here; call Close to see them. Closing
+        // a file opened for parallel access is collective.
+        ~Id();
+
+        // Release the identifier now, throwing if that fails.
+        void Close();
+
+        bool IsValid() const {
+            return id >= 0;
+        }
+        operator hid_t() const {
+            return id;
+        }
+    };
+
+    // The HDF5 type of T stored little-endian, as HemeLB writes
+    // everything.
+    template <typename T>
+    hid_t LittleEndianType() {
+        if constexpr (std::is_same_v<T, float>)
+            return H5T_IEEE_F32LE;
+        else if constexpr (std::is_same_v<T, double>)
+            return H5T_IEEE_F64LE;
+        else if constexpr (std::is_same_v<T, std::int32_t>)
+            return H5T_STD_I32LE;
+        else if constexpr (std::is_same_v<T, std::uint32_t>)
+            return H5T_STD_U32LE;
+        else if constexpr (std::is_same_v<T, std::int64_t>)
+            return H5T_STD_I64LE;
+        else {
+            static_assert(std::is_same_v<T, std::uint64_t>, "No HDF5 type for T");
+            return H5T_STD_U64LE;
+        }
+    }
+
+    // Create a new file (failing if it exists) or open an existing
+    // one read-only, for parallel access by all the ranks of
+    // comm. Collective.
+    Id CreateFile(std::filesystem::path const& path, MPI_Comm comm);
+    Id OpenFile(std::filesystem::path const& path, MPI_Comm comm);
+
+    // A transfer property list for collective reads and writes.
+    Id CollectiveTransfer();
+
+    // A simple dataspace of the given shape. If maxdims is empty,
+    // it is the same as dims.
+    Id Dataspace(std::span<hsize_t const> dims, std::span<hsize_t const> maxdims = {});
+
+    // Select this rank's part of a dataset, which may be nothing,
+    // and return a dataspace for the data in memory.
+    Id SelectPart(hid_t space, std::span<hsize_t const> start, std::span<hsize_t const> count);
+
+    // Attach an attribute holding vals to the object.
+    template <typename T>
+    void WriteAttribute(hid_t obj, char const* name, std::span<T const> vals) {
+        hsize_t const n = vals.size();
+        Id space(H5Screate_simple(1, &n, nullptr), "creating attribute dataspace");
+        Id attr(H5Acreate(obj, name, LittleEndianType<T>(), space, H5P_DEFAULT, H5P_DEFAULT), name);
+        Id mem_type(H5Tget_native_type(LittleEndianType<T>(), H5T_DIR_ASCEND), name);
+        Check(H5Awrite(attr, mem_type, vals.data()), name);
+    }
+}
+#endif
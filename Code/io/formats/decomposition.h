@@ -0,0 +1,47 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_FORMATS_DECOMPOSITION_H
+#define HEMELB_IO_FORMATS_DECOMPOSITION_H
+
+#include <cstdint>
+
+namespace hemelb::io::formats::decomposition
+{
+    // A decomposition cache file records which sites of a geometry
+    // each rank was given by the domain decomposition, so that a later
+    // run with the same inputs can skip it.
+
+    //! Magic number to identify decomposition cache files.
+    //! ASCII for 'dcp' + EOF
+    inline constexpr std::uint32_t MagicNumber = 0x64637004;
+
+    //! The version number of the file format.
+    inline constexpr std::uint32_t VersionNumber = 2;
+
+    // Header contains, all XDR encoded:
+    // - HemeLb magic - uint32
+    // - Decomposition magic - uint32
+    // - Decomposition version - uint32
+    // - number of ranks - uint32
+    // - fingerprint of the geometry file - uint64
+    // - fingerprint of the lattice - uint64
+    // - fingerprint of the site weights - uint64
+    // - fingerprint of the decomposition mode and node layout - uint64
+    inline constexpr unsigned HeaderLength = 48;
+
+    // Then an array of (number of ranks + 1) uint64, where elem[i]
+    // is the index of the first site record for rank i and elem[i+1]
+    // the past the end one.
+    inline constexpr unsigned OffsetLength = sizeof(std::uint64_t);
+
+    // Then the site records, each rank's sorted by block and then
+    // site. Each is the block's index in the octree order of the
+    // blocks with fluid sites (uint64) and the site's index within the
+    // block (uint64).
+    inline constexpr unsigned SiteRecordLength = 2 * sizeof(std::uint64_t);
+}
+
+#endif // HEMELB_IO_FORMATS_DECOMPOSITION_H
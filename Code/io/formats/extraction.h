@@ -6,6 +6,12 @@
 #ifndef HEMELB_IO_FORMATS_EXTRACTION_H
 #define HEMELB_IO_FORMATS_EXTRACTION_H
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
 namespace hemelb::io::formats::extraction
 {
   // Magic number to identify extraction data files.
@@ -14,11 +20,41 @@ namespace hemelb::io::formats::extraction
     MagicNumber = 0x78747204
   };
 
-  // The version number of the file format.
+  // The version numbers of the file format. Version 5 is XDR
+  // throughout, with each site's position in every timestep. Version
+  // 6 has the same headers but a little-endian body in which the
+  // positions are stored once and each field is a single array.
   enum {
-    VersionNumber = 5
+    XdrVersionNumber = 5,
+    VersionNumber = 6
   };
 
+  // In a version 6 file, a record starting with this instead of a
+  // timestep number holds the positions of the sites for the
+  // timesteps that follow it.
+  inline constexpr std::uint64_t PositionTableTag = ~std::uint64_t{0};
+
+  // The body of version 6 files is little-endian, whatever the
+  // machine, so on most machines these are just a copy.
+  template <typename T>
+  void ToLittleEndian(T val, char* dest)
+  {
+    std::memcpy(dest, &val, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big)
+      std::reverse(dest, dest + sizeof(T));
+  }
+  template <typename T>
+  T FromLittleEndian(char const* src)
+  {
+    T ans;
+    std::memcpy(&ans, src, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+      auto bytes = reinterpret_cast<char*>(&ans);
+      std::reverse(bytes, bytes + sizeof(T));
+    }
+    return ans;
+  }
+
   // The length of the main header. Made up of:
   // uint - HemeLbMagicNumber
   // uint - ExtractionMagicNumber
@@ -57,6 +57,18 @@ namespace hemelb
           AVAILABLE = 1
 	};
 
+	// Codes for how each block's data is compressed: one for the
+	// whole file, in the last word of the preamble. That word was
+	// padding, always zero, in files written before this was added,
+	// so zlib must stay zero.
+	enum class Codec : std::uint32_t
+        {
+	  ZLIB = 0,
+          NONE = 1,
+          LZ4 = 2,
+          ZSTD = 3
+	};
+
 	// Number of displacements in the neighbourhood
 	static constexpr size_t NumberOfDisplacements = 26;
 
@@ -66,7 +78,7 @@ namespace hemelb
 	//  * 1 uint for the version
 	//  * 3 uints for the problem dimensions in blocks
 	//  * 1 uint for the number of sites along one block side
-	//  * 1 uint, value 0 to pad to 32 bytes
+	//  * 1 uint for the block Codec (which also pads to 32 bytes)
 	//
 	//  * 8 uints = 8 * 4  = 32
 	static constexpr size_t PreambleLength = 32;
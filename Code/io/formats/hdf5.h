@@ -0,0 +1,33 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_FORMATS_HDF5_H
+#define HEMELB_IO_FORMATS_HDF5_H
+
+#include <array>
+#include <cstdint>
+
+namespace hemelb::io::formats::hdf5
+{
+  // The first bytes of every HDF5 file (HemeLB never writes a user
+  // block, so they are at the start).
+  inline constexpr std::array<char, 8> Signature = {'\x89', 'H', 'D', 'F', '\r', '\n', '\x1a', '\n'};
+
+  // The version of the layout of extracted properties within an HDF5
+  // file, stored as the "version" attribute of the root group. See
+  // doc/dev/file-formats/hdf5.md.
+  inline constexpr std::uint32_t VersionNumber = 1;
+
+  // The names of the datasets in each group, other than the fields.
+  inline constexpr char const* GridName = "grid";
+  inline constexpr char const* CoordinatesName = "coordinates";
+  inline constexpr char const* TimeName = "time";
+
+  // Chunks of a field hold about this many bytes, which is the size
+  // of HDF5's default chunk cache.
+  inline constexpr std::uint64_t ChunkBytes = 1 << 20;
+}
+
+#endif // HEMELB_IO_FORMATS_HDF5_H
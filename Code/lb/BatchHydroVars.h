@@ -0,0 +1,107 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_BATCHHYDROVARS_H
+#define HEMELB_LB_BATCHHYDROVARS_H
+
+#include <array>
+#include <concepts>
+
+#include "lb/concepts.h"
+#include "util/simd.h"
+
+namespace hemelb::lb
+{
+    static_assert(std::same_as<distribn_t, double>,
+                  "SIMD kernels assume double precision distributions");
+
+    /**
+     * The hydrodynamic variables of a batch of util::simd::WIDTH
+     * sites, one site per SIMD lane. This is the multi-site analogue
+     * of HydroVarsBase, used by kernels' CollideBatch.
+     */
+    template <lattice_type L>
+    struct BatchHydroVars
+    {
+        using Vec = util::simd::Vec;
+        static constexpr std::size_t WIDTH = util::simd::WIDTH;
+
+        std::array<Vec, L::NUMVECTORS> f;
+        Vec density;
+        std::array<Vec, 3> momentum;
+        std::array<Vec, 3> velocity;
+        std::array<Vec, L::NUMVECTORS> f_eq;
+        std::array<Vec, L::NUMVECTORS> f_neq;
+        std::array<Vec, L::NUMVECTORS> f_post;
+    };
+
+    /**
+     * Batched equivalent of LatticeType::CalculateDensityMomentumFEq
+     * followed by f_neq = f - f_eq. Requires f to be set.
+     */
+    template <lattice_type L>
+    void CalculateDensityMomentumFEqNeq(BatchHydroVars<L>& v)
+    {
+        using Vec = util::simd::Vec;
+        constexpr auto Q = L::NUMVECTORS;
+
+        v.density = 0.0;
+        v.momentum = {0.0, 0.0, 0.0};
+        for (Direction i = 0; i < Q; ++i)
+        {
+            v.density += v.f[i];
+            // The lattice vectors' components are all -1, 0 or 1
+            for (int d = 0; d < 3; ++d)
+            {
+                if (L::VECTORS[i][d] > 0)
+                    v.momentum[d] += v.f[i];
+                else if (L::VECTORS[i][d] < 0)
+                    v.momentum[d] -= v.f[i];
+            }
+        }
+
+        if constexpr (L::IsLatticeCompressible()) {
+            for (int d = 0; d < 3; ++d)
+                v.velocity[d] = v.momentum[d] / v.density;
+        } else {
+            v.velocity = v.momentum;
+        }
+
+        Vec const density_1 = 1. / v.density;
+
+        Vec const momentumMagnitudeSquared = v.momentum[0] * v.momentum[0]
+                + v.momentum[1] * v.momentum[1] + v.momentum[2] * v.momentum[2];
+
+        for (Direction i = 0; i < Q; ++i)
+        {
+            Vec const mom_dot_ei = L::CXD[i] * v.momentum[0] + L::CYD[i] * v.momentum[1]
+                    + L::CZD[i] * v.momentum[2];
+
+            if constexpr (L::IsLatticeCompressible()) {
+                v.f_eq[i] = L::EQMWEIGHTS[i]
+                        * (v.density - (3. / 2.) * momentumMagnitudeSquared * density_1
+                           + (9. / 2.) * density_1 * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
+            } else {
+                v.f_eq[i] = L::EQMWEIGHTS[i]
+                        * (v.density - (3. / 2.) * momentumMagnitudeSquared
+                           + (9. / 2.) * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
+            }
+            v.f_neq[i] = v.f[i] - v.f_eq[i];
+        }
+    }
+
+    /**
+     * A kernel that can collide a batch of sites at once. CollideBatch
+     * must fill f_post from the other members, as set by
+     * CalculateDensityMomentumFEqNeq.
+     */
+    template <typename K>
+    concept batch_kernel = kernel_type<K> &&
+    requires (K k, LbmParameters const* lbmParams, BatchHydroVars<typename K::LatticeType>& v) {
+        { k.CollideBatch(lbmParams, v) };
+    };
+}
+
+#endif // HEMELB_LB_BATCHHYDROVARS_H
@@ -10,6 +10,7 @@
 
 #include "units.h"
 #include "lb/concepts.h"
+#include "geometry/DistributionLayout.h"
 #include "geometry/Site.h"
 #include "util/Vector3D.h"
 
@@ -49,10 +50,65 @@ namespace hemelb::lb
         }
         template<class DataSource>
         HydroVarsBase(geometry::Site<DataSource> const &_site) :
-                f(_site.template GetFOld<LatticeType>())
+                f(BindF(_site.template GetFOld<LatticeType>()))
         {
         }
 
+        // If f refers to our own gathered copy, a copy must refer to its own.
+        HydroVarsBase(HydroVarsBase const& other) :
+                f_gathered(other.f_gathered), density(other.density), tau(other.tau),
+                momentum(other.momentum), velocity(other.velocity), f(other.f),
+                f_eq(other.f_eq), f_neq(other.f_neq), fPostCollision(other.fPostCollision)
+        {
+            RebindF(other);
+        }
+
+        HydroVarsBase& operator=(HydroVarsBase const& other)
+        {
+            f_gathered = other.f_gathered;
+            density = other.density;
+            tau = other.tau;
+            momentum = other.momentum;
+            velocity = other.velocity;
+            f = other.f;
+            f_eq = other.f_eq;
+            f_neq = other.f_neq;
+            fPostCollision = other.fPostCollision;
+            RebindF(other);
+            return *this;
+        }
+
+    private:
+        // When a site's distributions are not contiguous in the field data, the kernels work on
+        // a contiguous copy held here. This must be declared before f.
+        using gathered_type = std::conditional_t<
+                geometry::CONTIGUOUS_SITE_VIEWS,
+                std::array<distribn_t, 0>,
+                FVector<LatticeType>
+        >;
+        [[no_unique_address]] gathered_type f_gathered;
+
+        template <typename View>
+        const_span BindF(View const& view)
+        {
+            if constexpr (std::is_constructible_v<const_span, View const&>) {
+                return const_span{view};
+            } else {
+                for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+                    f_gathered[i] = view[i];
+                return f_gathered;
+            }
+        }
+
+        void RebindF(HydroVarsBase const& other)
+        {
+            if constexpr (!geometry::CONTIGUOUS_SITE_VIEWS) {
+                if (other.f.data() == other.f_gathered.data())
+                    f = f_gathered;
+            }
+        }
+
+    public:
         distribn_t density, tau;
         util::Vector3D<distribn_t> momentum;
         util::Vector3D<distribn_t> velocity;
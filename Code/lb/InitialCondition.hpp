@@ -41,12 +41,11 @@ namespace hemelb {
       distribn_t f_eq[LatticeType::NUMVECTORS];
       LatticeType::CalculateFeq(density, mom_x, mom_y, mom_z, f_eq);
       
-      for (site_t i = 0; i < latDat->GetDomain().GetLocalFluidSiteCount(); i++) {
-	distribn_t* f_old_p = this->GetFOld(latDat, i * LatticeType::NUMVECTORS);
-	distribn_t* f_new_p = this->GetFNew(latDat, i * LatticeType::NUMVECTORS);
-	
+      auto&& dom = latDat->GetDomain();
+      for (site_t i = 0; i < dom.GetLocalFluidSiteCount(); i++) {
 	for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++) {
-	  f_new_p[l] = f_old_p[l] = f_eq[l];
+	  auto const idx = dom.template GetDistributionIndex<LatticeType>(i, l);
+	  *this->GetFNew(latDat, idx) = *this->GetFOld(latDat, idx) = f_eq[l];
 	}
       }
     }
@@ -38,6 +38,15 @@ namespace hemelb
       velDistributionsCache.UnsetRefreshFlag();
     }
 
+    bool MacroscopicPropertyCache::AnyRequiresRefresh() const
+    {
+      return densityCache.RequiresRefresh() || velocityCache.RequiresRefresh()
+          || vonMisesStressCache.RequiresRefresh() || wallShearStressMagnitudeCache.RequiresRefresh()
+          || shearRateCache.RequiresRefresh() || stressTensorCache.RequiresRefresh()
+          || tractionCache.RequiresRefresh() || tangentialProjectionTractionCache.RequiresRefresh()
+          || velDistributionsCache.RequiresRefresh();
+    }
+
     site_t MacroscopicPropertyCache::GetSiteCount() const
     {
       return siteCount;
@@ -38,6 +38,12 @@ namespace hemelb
          */
         void ResetRequirements();
 
+        /**
+         * Does any of the caches need refreshing this step?
+         * @return
+         */
+        bool AnyRequiresRefresh() const;
+
         /**
          * Returns the number of sites cached.
          * @return
@@ -0,0 +1,93 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_SITECHUNKING_H
+#define HEMELB_LB_SITECHUNKING_H
+
+#include <algorithm>
+#include <utility>
+
+#ifdef HEMELB_USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "units.h"
+
+namespace hemelb::lb
+{
+    // Chunk boundaries fall on multiples of this many sites, so that
+    // per-site arrays of doubles (kernel state such as LBGKNN's tau,
+    // the property caches, direction-major distributions) written by
+    // different threads never share a cache line.
+    inline constexpr site_t THREAD_CHUNK_ALIGNMENT = 8;
+
+    // Ranges shorter than this are not worth waking the other threads for.
+    inline constexpr site_t MIN_SITES_FOR_THREADING = 256;
+
+    // While halo messages are in flight, updates stop to let MPI progress
+    // them after roughly this many sites per thread.
+    inline constexpr site_t HALO_PROGRESS_INTERVAL = 4096;
+
+    // The number of threads ForEachThreadSiteChunk will use for a large range
+    inline int MaxThreadCount()
+    {
+#ifdef HEMELB_USE_OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    /**
+     * Split the sites [first, first + count) between nThreads threads
+     * and return the (first, count) of the part belonging to thread.
+     * The parts are contiguous, disjoint and in thread order.
+     */
+    constexpr std::pair<site_t, site_t> ThreadSiteChunk(site_t first, site_t count,
+                                                        int thread, int nThreads)
+    {
+        auto const end = first + count;
+        auto boundary = [&](int i) -> site_t {
+            if (i == 0)
+                return first;
+            if (i == nThreads)
+                return end;
+            auto const even = first + count * i / nThreads;
+            auto const aligned = (even + THREAD_CHUNK_ALIGNMENT - 1)
+                    / THREAD_CHUNK_ALIGNMENT * THREAD_CHUNK_ALIGNMENT;
+            return std::min(aligned, end);
+        };
+        auto const begin = boundary(thread);
+        return {begin, boundary(thread + 1) - begin};
+    }
+
+    /**
+     * Call f(first, count) on disjoint chunks covering the sites
+     * [first, first + count). With OpenMP, each thread of a parallel
+     * region handles one chunk; otherwise f is called once for the
+     * whole range.
+     *
+     * f must only touch data belonging to its own sites and must not
+     * throw.
+     */
+    template <typename F>
+    void ForEachThreadSiteChunk(site_t first, site_t count, F&& f)
+    {
+#ifdef HEMELB_USE_OPENMP
+#pragma omp parallel if (count >= MIN_SITES_FOR_THREADING)
+        {
+            auto const [chunkFirst, chunkCount] = ThreadSiteChunk(
+                    first, count, omp_get_thread_num(), omp_get_num_threads()
+            );
+            if (chunkCount > 0)
+                f(chunkFirst, chunkCount);
+        }
+#else
+        f(first, count);
+#endif
+    }
+}
+
+#endif // HEMELB_LB_SITECHUNKING_H
@@ -36,6 +36,9 @@ namespace hemelb::lb
                 net::PhasedBroadcastRegular<>(net, simState, SPREADFACTOR), mLatDat(std::move(iLatDat)),
                 mSimState(simState), timings(timings), testerConfig(testerConfig)
         {
+            if (geometry::SINGLE_BUFFER_STREAMING && testerConfig.doConvergenceCheck)
+                throw Exception() << "Convergence checking compares against the previous step's distributions, "
+                                     "which single-buffer (AA) streaming does not keep";
             Reset();
         }
 
@@ -102,7 +105,7 @@ namespace hemelb::lb
             {
               for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
               {
-                distribn_t value = *mLatDat->GetFNew(i * LatticeType::NUMVECTORS + l);
+                distribn_t value = *mLatDat->template GetFNew<LatticeType>(i, l);
 
                 // Note that by testing for value > 0.0, we also catch stray NaNs.
                 if (! (value > 0.0))
@@ -119,9 +122,9 @@ namespace hemelb::lb
 
               if (testerConfig.doConvergenceCheck)
               {
-                distribn_t relativeDifference =
-                    ComputeRelativeDifference(mLatDat->GetFNew<LatticeType>(i),
-                                              mLatDat->GetSite(i).GetFOld<LatticeType>());
+                auto const fNew = geometry::Contiguous(mLatDat->template GetFNew<LatticeType>(i));
+                auto const fOld = geometry::Contiguous(mLatDat->GetSite(i).template GetFOld<LatticeType>());
+                distribn_t relativeDifference = ComputeRelativeDifference(fNew, fOld);
 
                 if (relativeDifference > testerConfig.convergenceRelativeTolerance)
                 {
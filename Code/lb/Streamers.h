@@ -7,8 +7,11 @@
 #define HEMELB_LB_STREAMERS_H
 
 #include "build_info.h"
+#include "geometry/DistributionLayout.h"
 
 #include "lb/streamers/BulkStreamer.h"
+#include "lb/streamers/FusedBulkStreamer.h"
+#include "lb/streamers/SimdBulkStreamer.h"
 #include "lb/streamers/StreamerTypeFactory.h"
 #include "lb/streamers/SimpleBounceBack.h"
 #include "lb/streamers/BouzidiFirdaousLallemand.h"
@@ -19,16 +22,24 @@
 
 namespace hemelb::lb {
     namespace detail {
+        // Dependent on C so it is only checked for the wall streamer selected.
+        template <typename C>
+        constexpr bool fOld_survives_streaming = !geometry::SINGLE_BUFFER_STREAMING;
+
         template <typename C>
         constexpr auto get_default_wall_streamer(InitParams& i) {
             constexpr auto WALL = build_info::WALL_BOUNDARY;
             if constexpr (WALL == "BFL") {
                 return StreamerTypeFactory < BouzidiFirdaousLallemandLink < C >, NullLink < C >> {i};
             } else if constexpr (WALL == "GZS") {
+                static_assert(fOld_survives_streaming<C>,
+                              "GZS walls read their neighbours' fOld, which single-buffer streaming overwrites");
                 return StreamerTypeFactory < GuoZhengShiLink < C >, NullLink < C >> {i};
             } else if constexpr (WALL == "SIMPLEBOUNCEBACK") {
                 return StreamerTypeFactory < BounceBackLink < C >, NullLink < C >> {i};
             } else if constexpr (WALL == "JUNKYANG") {
+                static_assert(fOld_survives_streaming<C>,
+                              "Junk-Yang walls are not supported with single-buffer streaming");
                 return JunkYangFactory<NullLink<C> >{i};
             } else {
                 throw (Exception() << "Configured with invalid WALL_BOUNDARY");
@@ -54,8 +65,25 @@ namespace hemelb::lb {
 
     }
 
+    // The bulk streamer processes several sites at once if asked to
+    // by the build system and the kernel supports it. Otherwise it
+    // skips the intermediate HydroVars arrays when the kernel can.
+    namespace detail {
+        // Selected lazily, since naming a constrained streamer for a
+        // kernel that doesn't satisfy it is an error.
+        template <typename C>
+        constexpr auto get_default_bulk_streamer() {
+            if constexpr (build_info::USE_SIMD_KERNELS && batch_collision<C>) {
+                return std::type_identity<SimdBulkStreamer<C>>{};
+            } else if constexpr (fused_collision<C>) {
+                return std::type_identity<FusedBulkStreamer<C>>{};
+            } else {
+                return std::type_identity<BulkStreamer<C>>{};
+            }
+        }
+    }
     template <typename C>
-    using DefaultStreamer = BulkStreamer<C>;
+    using DefaultStreamer = typename decltype(detail::get_default_bulk_streamer<C>())::type;
 
     template <typename C>
     using DefaultWallStreamer = decltype(detail::get_default_wall_streamer<C>(std::declval<InitParams&>()));
@@ -141,6 +141,8 @@ namespace hemelb::lb
 
         /**
          * Stores the value of alpha (the relaxation parameter) from the previous iteration.
+         * Indexed by site and only touched by the update of that site, so threads working on
+         * disjoint site ranges may share this kernel.
          */
         std::vector<distribn_t> oldAlpha;
     };
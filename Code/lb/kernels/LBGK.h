@@ -7,6 +7,7 @@
 #define HEMELB_LB_KERNELS_LBGK_H
 
 #include "lb/concepts.h"
+#include "lb/BatchHydroVars.h"
 #include "lb/HydroVars.h"
 #include "lb/LbmParameters.h"
 
@@ -61,6 +62,38 @@ namespace hemelb::lb
                                             + hydroVars.f_neq[direction]
                                               * lbmParams->GetOmega());
         }
+
+        /**
+         * Collide a site whose pre-collision distributions are the view
+         * f, without storing f_eq, f_neq or the post-collision values:
+         * each post-collision value is passed to stream(direction, value)
+         * as soon as it is known. A direction and its opposite are both
+         * read before either is streamed, so stream may overwrite them.
+         */
+        template <typename F, typename STREAM>
+        void CollideFused(const LbmParameters* const lbmParams, F const& f, STREAM&& stream)
+        {
+            const typename LatticeType::SiteMoments moments(f);
+            const distribn_t omega = lbmParams->GetOmega();
+            for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+            {
+                const Direction iBar = LatticeType::INVERSEDIRECTIONS[i];
+                if (iBar < i)
+                    continue;
+                const distribn_t f_i = f[i];
+                const distribn_t f_iBar = f[iBar];
+                stream(i, f_i + (f_i - moments.Feq(i)) * omega);
+                if (iBar != i)
+                    stream(iBar, f_iBar + (f_iBar - moments.Feq(iBar)) * omega);
+            }
+        }
+
+        void CollideBatch(const LbmParameters* const lbmParams, BatchHydroVars<LatticeType>& hydroVars)
+        {
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                hydroVars.f_post[direction] = hydroVars.f[direction]
+                        + hydroVars.f_neq[direction] * lbmParams->GetOmega();
+        }
     };
 }
 #endif /* HEMELB_LB_KERNELS_LBGK_H */
@@ -128,7 +128,9 @@ namespace hemelb::lb
         /**
           * Vector containing the current relaxation time for each site in the domain. It will be initialised
           * with the relaxation time corresponding to HemeLB's default Newtonian viscosity and each time step
-          * will be updated based on the local hydrodynamic configuration
+          * will be updated based on the local hydrodynamic configuration.
+          * Entries are only touched by the update of their own site, so threads working on
+          * disjoint site ranges may share this kernel (see lb/SiteChunking.h).
           */
         std::vector<distribn_t> mTau;
 
@@ -6,6 +6,7 @@
 #ifndef HEMELB_LB_KERNELS_MRT_H
 #define HEMELB_LB_KERNELS_MRT_H
 
+#include "lb/BatchHydroVars.h"
 #include "lb/SimulationState.h"
 #include <cassert>
 #include <cmath>
@@ -74,15 +75,15 @@ namespace hemelb::lb
         {
             LatticeType::CalculateFeq(hydroVars.density,
                                                hydroVars.momentum,
-                                               hydroVars.f_eq.f);
+                                               hydroVars.f_eq);
 
             for (unsigned int ii = 0; ii < NUMVECTORS; ++ii)
             {
-              hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+              hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
 
             /** @todo #222 consider computing m_neq directly in the moment space. See d'Humieres 2002. */
-            MomentType::ProjectVelsIntoMomentSpace(hydroVars.f_neq.f, hydroVars.m_neq);
+            ProjectVelsIntoMomentSpace(hydroVars.f_neq, hydroVars.m_neq);
           }
 
         void Collide(const LbmParameters* const lbmParams, VarsType& hydroVars)
@@ -104,6 +105,33 @@ namespace hemelb::lb
             }
           }
 
+        void CollideBatch(const LbmParameters* const lbmParams, BatchHydroVars<LatticeType>& hydroVars)
+        {
+            using Vec = util::simd::Vec;
+            std::array<Vec, NUMMOMENTS> m_neq;
+            for (unsigned momentIndex = 0; momentIndex < NUMMOMENTS; momentIndex++)
+            {
+                m_neq[momentIndex] = 0.;
+                for (Direction velocityIndex = 0; velocityIndex < NUMVECTORS; velocityIndex++)
+                {
+                    m_neq[momentIndex] +=
+                            MomentType::REDUCED_MOMENT_BASIS[momentIndex][velocityIndex] * hydroVars.f_neq[velocityIndex];
+                }
+            }
+
+            for (Direction direction = 0; direction < NUMVECTORS; ++direction)
+            {
+                Vec collision = 0.;
+                for (unsigned momentIndex = 0; momentIndex < NUMMOMENTS; momentIndex++)
+                {
+                    collision += collisionMatrixDiagonals[momentIndex]
+                                 * normalisedReducedMomentBasis[momentIndex][direction]
+                                 * m_neq[momentIndex];
+                }
+                hydroVars.f_post[direction] = hydroVars.f[direction] - collision;
+            }
+        }
+
         /**
          *  This method is used in unit testing in order to make an MRT kernel behave as LBGK, regardless of the
          *  moment basis, by setting all the relaxation parameters to be the same.
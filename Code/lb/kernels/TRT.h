@@ -7,6 +7,7 @@
 #define HEMELB_LB_KERNELS_TRT_H
 
 #include <cstdlib>
+#include "lb/BatchHydroVars.h"
 #include "lb/HFunction.h"
 #include "util/utilityFunctions.h"
 
@@ -36,8 +37,8 @@ namespace hemelb::lb
         static constexpr bool HasZero = iZero < LatticeType::NUMVECTORS;
         // Odd number => has a zero, so rounding down correct.
         static constexpr std::size_t NPAIRS = LatticeType::NUMVECTORS / 2;
-        // Store the directions as pairs of opposites
-        // (Note that the zero vector is its own opposite)
+        // Store the non-zero directions as pairs of opposites
+        // (the zero vector, its own opposite, is handled separately)
         using Opposites = std::pair<Direction, Direction>;
         static constexpr auto MakeOpposites() {
             std::array<Opposites, NPAIRS> ans;
@@ -45,7 +46,7 @@ namespace hemelb::lb
             for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
             {
                 Direction iBar = LatticeType::INVERSEDIRECTIONS[i];
-                if (iBar >= i) {
+                if (iBar > i) {
                     ans[j] = {i, iBar};
                     ++j;
                 }
@@ -63,31 +64,25 @@ namespace hemelb::lb
         {
             LatticeType::CalculateDensityMomentumFEq(hydroVars.f,
                                                      hydroVars.density,
-                                                     hydroVars.momentum.x,
-                                                     hydroVars.momentum.y,
-                                                     hydroVars.momentum.z,
-                                                     hydroVars.velocity.x,
-                                                     hydroVars.velocity.y,
-                                                     hydroVars.velocity.z,
-                                                     hydroVars.f_eq.f);
+                                                     hydroVars.momentum,
+                                                     hydroVars.velocity,
+                                                     hydroVars.f_eq);
 
             for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
             {
-                hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+                hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
         }
 
         void CalculateFeq(VarsType& hydroVars, site_t index)
         {
             LatticeType::CalculateFeq(hydroVars.density,
-                                      hydroVars.momentum.x,
-                                      hydroVars.momentum.y,
-                                      hydroVars.momentum.z,
-                                      hydroVars.f_eq.f);
+                                      hydroVars.momentum,
+                                      hydroVars.f_eq);
 
             for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
             {
-                hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+                hydroVars.f_neq[ii] = hydroVars.f[ii] - hydroVars.f_eq[ii];
             }
         }
 
@@ -108,18 +103,77 @@ namespace hemelb::lb
             if constexpr (HasZero) {
                 // Special case the null velocity.
                 hydroVars.SetFPostCollision(iZero,
-                                            hydroVars.f[iZero] + omega_plus * hydroVars.f_neq.f[iZero]);
+                                            hydroVars.f[iZero] + omega_plus * hydroVars.f_neq[iZero]);
             }
 
             // Now deal with the non-zero
             for (auto [i, iBar]: directionPairs)
             {
-                distribn_t sym = 0.5 * omega_plus * (hydroVars.f_neq.f[i] + hydroVars.f_neq.f[iBar]);
-                distribn_t asym = 0.5 * omega_minus * (hydroVars.f_neq.f[i] - hydroVars.f_neq.f[iBar]);
+                distribn_t sym = 0.5 * omega_plus * (hydroVars.f_neq[i] + hydroVars.f_neq[iBar]);
+                distribn_t asym = 0.5 * omega_minus * (hydroVars.f_neq[i] - hydroVars.f_neq[iBar]);
                 hydroVars.SetFPostCollision(i, hydroVars.f[i] + sym + asym);
                 hydroVars.SetFPostCollision(iBar, hydroVars.f[iBar] + sym - asym);
             }
         }
+
+        /**
+         * Collide a site without storing f_eq, f_neq or the post-collision
+         * values, passing each of the latter to stream(direction, value).
+         * See LBGK::CollideFused.
+         */
+        template <typename F, typename STREAM>
+        void CollideFused(const LbmParameters* const lbmParams, F const& f, STREAM&& stream)
+        {
+            // As for Collide
+            const distribn_t Lambda = 3.0 / 16.0;
+
+            const distribn_t tau_plus = lbmParams->GetTau();
+            const distribn_t omega_plus = lbmParams->GetOmega();
+            const distribn_t tau_minus = 0.5 + Lambda / (tau_plus - 0.5);
+            const distribn_t omega_minus =  -1.0 / tau_minus;
+
+            const typename LatticeType::SiteMoments moments(f);
+
+            if constexpr (HasZero) {
+                const distribn_t f_0 = f[iZero];
+                stream(iZero, f_0 + omega_plus * (f_0 - moments.Feq(iZero)));
+            }
+
+            for (auto [i, iBar]: directionPairs)
+            {
+                const distribn_t f_i = f[i];
+                const distribn_t f_iBar = f[iBar];
+                const distribn_t f_neq_i = f_i - moments.Feq(i);
+                const distribn_t f_neq_iBar = f_iBar - moments.Feq(iBar);
+                distribn_t sym = 0.5 * omega_plus * (f_neq_i + f_neq_iBar);
+                distribn_t asym = 0.5 * omega_minus * (f_neq_i - f_neq_iBar);
+                stream(i, f_i + sym + asym);
+                stream(iBar, f_iBar + sym - asym);
+            }
+        }
+
+        void CollideBatch(const LbmParameters* const lbmParams, BatchHydroVars<LatticeType>& hydroVars)
+        {
+            // As for Collide, but on a batch of sites
+            const distribn_t Lambda = 3.0 / 16.0;
+
+            const distribn_t tau_plus = lbmParams->GetTau();
+            const distribn_t omega_plus = lbmParams->GetOmega();
+            const distribn_t tau_minus = 0.5 + Lambda / (tau_plus - 0.5);
+            const distribn_t omega_minus =  -1.0 / tau_minus;
+
+            if constexpr (HasZero) {
+                hydroVars.f_post[iZero] = hydroVars.f[iZero] + omega_plus * hydroVars.f_neq[iZero];
+            }
+
+            for (auto [i, iBar]: directionPairs)
+            {
+                auto sym = 0.5 * omega_plus * (hydroVars.f_neq[i] + hydroVars.f_neq[iBar]);
+                auto asym = 0.5 * omega_minus * (hydroVars.f_neq[i] - hydroVars.f_neq[iBar]);
+                hydroVars.f_post[i] = hydroVars.f[i] + sym + asym;
+                hydroVars.f_post[iBar] = hydroVars.f[iBar] + sym - asym;
+            }
+        }
     };
 }
 
@@ -506,6 +506,51 @@ namespace hemelb::lb
               CalculateFeq(density, momentum, f_eq);
           }
 
+        /**
+         * The density and momentum of a single site, with the equilibrium
+         * distribution evaluated one direction at a time. This is for fused
+         * kernels that never store f_eq for the whole site.
+         */
+        class SiteMoments
+        {
+        public:
+            distribn_t density;
+            LatticeMomentum momentum;
+
+            // F is any view of the site's distributions that supports f[i]
+            template <typename F>
+            explicit SiteMoments(F const& f) : density(0.0), momentum(0.0)
+            {
+                for (Direction i = 0; i < NUMVECTORS; ++i)
+                {
+                    density += f[i];
+                    momentum += VECTORS[i] * f[i];
+                }
+                density_1 = 1. / density;
+                momentumMagnitudeSquared = momentum.GetMagnitudeSquared();
+            }
+
+            // As CalculateFeq would give for direction i
+            distribn_t Feq(Direction i) const
+            {
+                const distribn_t mom_dot_ei = CX[i] * momentum.x() + CY[i] * momentum.y()
+                    + CZ[i] * momentum.z();
+                if constexpr (COMPRESSIBLE) {
+                    return EQMWEIGHTS[i]
+                           * (density - (3. / 2.) * momentumMagnitudeSquared * density_1
+                              + (9. / 2.) * density_1 * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
+                } else {
+                    return EQMWEIGHTS[i]
+                           * (density - (3. / 2.) * momentumMagnitudeSquared
+                              + (9. / 2.) * mom_dot_ei * mom_dot_ei + 3. * mom_dot_ei);
+                }
+            }
+
+        private:
+            distribn_t density_1;
+            distribn_t momentumMagnitudeSquared;
+        };
+
           // von Mises stress computation given the non-equilibrium distribution functions.
           inline static void CalculateVonMisesStress(const_span f, distribn_t &stress,
                                                      const double iStressParameter)
@@ -13,6 +13,7 @@
 #include "lb/InitialCondition.h"
 #include "lb/iolets/BoundaryValues.h"
 #include "lb/MacroscopicPropertyCache.h"
+#include "lb/SiteChunking.h"
 #include "util/UnitConverter.h"
 #include "reporting/Timers.h"
 #include "Traits.h"
@@ -106,26 +107,55 @@ namespace hemelb::lb
         std::unique_ptr<tInletWallCollision> mInletWallCollision;
         std::unique_ptr<tOutletWallCollision> mOutletWallCollision;
 
+        // Update a range of sites, all of the given collision type (as
+        // numbered by the Domain's collision counts), split between
+        // threads if enabled (see SiteChunking.h). The time taken is
+        // recorded per collision type, for calibrating the site
+        // weights of the decomposition.
         void StreamAndCollide(streamer auto& s, const site_t iFirstIndex,
-                              const site_t iSiteCount)
+                              const site_t iSiteCount, unsigned collisionType)
         {
-            s.StreamAndCollide(iFirstIndex,
-                                                 iSiteCount,
-                                                 &mParams,
-                                                 *mLatDat,
-                                                 propertyCache);
+            auto& timer = timings[reporting::Timers::CollisionTypeTimer(collisionType)];
+            timer.Start();
+            ForEachThreadSiteChunk(iFirstIndex, iSiteCount, [&](site_t first, site_t count) {
+                s.StreamAndCollide(first, count, &mParams, *mLatDat, propertyCache);
+            });
+            timer.Stop();
         }
 
-        void PostStep(streamer auto& s, const site_t iFirstIndex, const site_t iSiteCount)
+        void PostStep(streamer auto& s, const site_t iFirstIndex, const site_t iSiteCount,
+                      unsigned collisionType)
         {
-            s.PostStep(iFirstIndex,
-                                           iSiteCount,
-                                           &mParams,
-                                           *mLatDat,
-                                           propertyCache);
+            auto& timer = timings[reporting::Timers::CollisionTypeTimer(collisionType)];
+            timer.Start();
+            ForEachThreadSiteChunk(iFirstIndex, iSiteCount, [&](site_t first, site_t count) {
+                s.PostStep(first, count, &mParams, *mLatDat, propertyCache);
+            });
+            timer.Stop();
+        }
 
+        // As StreamAndCollide, but calling ProgressHalo between blocks of
+        // sites, for use while the halo exchange is in flight.
+        void StreamAndCollideProgressingHalo(streamer auto& s, const site_t iFirstIndex,
+                                             const site_t iSiteCount, unsigned collisionType)
+        {
+            site_t const blockSize = HALO_PROGRESS_INTERVAL * MaxThreadCount();
+            for (site_t done = 0; done < iSiteCount; done += blockSize)
+            {
+                StreamAndCollide(s, iFirstIndex + done, std::min(blockSize, iSiteCount - done),
+                                 collisionType);
+                ProgressHalo();
+            }
         }
 
+        // Many MPI implementations only move messages along inside MPI calls, so
+        // without this the halo exchange may not really start until Wait.
+        // Stops the haloHidden timer once all the messages have arrived.
+        void ProgressHalo();
+
+        // Is the halo exchange started by Send still going?
+        bool haloInFlight = false;
+
         net::Net* mNet;
         geometry::FieldData* mLatDat;
         SimulationState* mState;
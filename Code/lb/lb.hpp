@@ -167,7 +167,9 @@ namespace hemelb::lb
       // (via the Net object).
       // NOTE that this doesn't actually *perform* the sends and receives, it asks the Net
       // to include them in the ISends and IRecvs that happen later.
-      mLatDat->SendAndReceive(mNet);
+      // Otherwise the exchange is started at the end of PreSend.
+      if constexpr (net::HALO_EXCHANGE_VIA_NET)
+        mLatDat->SendAndReceive(mNet);
 
       timings[hemelb::reporting::Timers::lb].Stop();
     }
@@ -188,24 +190,28 @@ namespace hemelb::lb
       site_t offset = dom.GetMidDomainSiteCount();
 
       log::Logger::Log<log::Debug, log::OnePerCore>("LBM - PreSend - StreamAndCollide");
-      StreamAndCollide(*mMidFluidCollision, offset, dom.GetDomainEdgeCollisionCount(0));
+      StreamAndCollide(*mMidFluidCollision, offset, dom.GetDomainEdgeCollisionCount(0), 0);
       offset += dom.GetDomainEdgeCollisionCount(0);
 
-      StreamAndCollide(*mWallCollision, offset, dom.GetDomainEdgeCollisionCount(1));
+      StreamAndCollide(*mWallCollision, offset, dom.GetDomainEdgeCollisionCount(1), 1);
       offset += dom.GetDomainEdgeCollisionCount(1);
 
       mInletValues->FinishReceive();
-      StreamAndCollide(*mInletCollision, offset, dom.GetDomainEdgeCollisionCount(2));
+      StreamAndCollide(*mInletCollision, offset, dom.GetDomainEdgeCollisionCount(2), 2);
       offset += dom.GetDomainEdgeCollisionCount(2);
 
       mOutletValues->FinishReceive();
-      StreamAndCollide(*mOutletCollision, offset, dom.GetDomainEdgeCollisionCount(3));
+      StreamAndCollide(*mOutletCollision, offset, dom.GetDomainEdgeCollisionCount(3), 3);
       offset += dom.GetDomainEdgeCollisionCount(3);
 
-      StreamAndCollide(*mInletWallCollision, offset, dom.GetDomainEdgeCollisionCount(4));
+      StreamAndCollide(*mInletWallCollision, offset, dom.GetDomainEdgeCollisionCount(4), 4);
       offset += dom.GetDomainEdgeCollisionCount(4);
 
-      StreamAndCollide(*mOutletWallCollision, offset, dom.GetDomainEdgeCollisionCount(5));
+      StreamAndCollide(*mOutletWallCollision, offset, dom.GetDomainEdgeCollisionCount(5), 5);
+
+      // All the values to send have now been streamed.
+      if constexpr (!net::HALO_EXCHANGE_VIA_NET)
+        mLatDat->StartHaloExchange();
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
@@ -228,31 +234,66 @@ namespace hemelb::lb
       auto& dom = mLatDat->GetDomain();
       site_t offset = 0;
 
+      // The sends were posted in the Send step just before this one.
+      haloInFlight = true;
+      timings[hemelb::reporting::Timers::haloHidden].Start();
+
       log::Logger::Log<log::Debug, log::OnePerCore>("LBM - PreReceive - StreamAndCollide");
-      StreamAndCollide(*mMidFluidCollision, offset, dom.GetMidDomainCollisionCount(0));
+      StreamAndCollideProgressingHalo(*mMidFluidCollision, offset, dom.GetMidDomainCollisionCount(0), 0);
       offset += dom.GetMidDomainCollisionCount(0);
 
-      StreamAndCollide(*mWallCollision, offset, dom.GetMidDomainCollisionCount(1));
+      StreamAndCollideProgressingHalo(*mWallCollision, offset, dom.GetMidDomainCollisionCount(1), 1);
       offset += dom.GetMidDomainCollisionCount(1);
 
-      StreamAndCollide(*mInletCollision, offset, dom.GetMidDomainCollisionCount(2));
+      StreamAndCollideProgressingHalo(*mInletCollision, offset, dom.GetMidDomainCollisionCount(2), 2);
       offset += dom.GetMidDomainCollisionCount(2);
 
-      StreamAndCollide(*mOutletCollision, offset, dom.GetMidDomainCollisionCount(3));
+      StreamAndCollideProgressingHalo(*mOutletCollision, offset, dom.GetMidDomainCollisionCount(3), 3);
       offset += dom.GetMidDomainCollisionCount(3);
 
-      StreamAndCollide(*mInletWallCollision, offset, dom.GetMidDomainCollisionCount(4));
+      StreamAndCollideProgressingHalo(*mInletWallCollision, offset, dom.GetMidDomainCollisionCount(4), 4);
       offset += dom.GetMidDomainCollisionCount(4);
 
-      StreamAndCollide(*mOutletWallCollision, offset, dom.GetMidDomainCollisionCount(5));
+      StreamAndCollideProgressingHalo(*mOutletWallCollision, offset, dom.GetMidDomainCollisionCount(5), 5);
+
+      // Whatever is left of the exchange is exposed, and is counted by the mpiWait timer.
+      if (haloInFlight)
+      {
+        haloInFlight = false;
+        timings[hemelb::reporting::Timers::haloHidden].Stop();
+      }
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
     }
 
+    template<class TRAITS>
+    void LBM<TRAITS>::ProgressHalo()
+    {
+      if (!haloInFlight)
+        return;
+      bool done;
+      if constexpr (net::HALO_EXCHANGE_VIA_NET)
+        done = mNet->Progress();
+      else
+        done = mLatDat->TestHaloExchange();
+      if (done)
+      {
+        haloInFlight = false;
+        timings[hemelb::reporting::Timers::haloHidden].Stop();
+      }
+    }
+
     template<class TRAITS>
     void LBM<TRAITS>::PostReceive()
     {
+      if constexpr (!net::HALO_EXCHANGE_VIA_NET)
+      {
+        timings[hemelb::reporting::Timers::mpiWait].Start();
+        mLatDat->WaitHaloExchange();
+        timings[hemelb::reporting::Timers::mpiWait].Stop();
+      }
+
       timings[hemelb::reporting::Timers::lb].Start();
 
       // Copy the distribution functions received from the neighbouring
@@ -268,41 +309,41 @@ namespace hemelb::lb
 
       log::Logger::Log<log::Debug, log::OnePerCore>("LBM - PostReceive - StreamAndCollide");
       //TODO yup, this is horrible. If you read this, please improve the following code.
-      PostStep(*mMidFluidCollision, offset, dom.GetDomainEdgeCollisionCount(0));
+      PostStep(*mMidFluidCollision, offset, dom.GetDomainEdgeCollisionCount(0), 0);
       offset += dom.GetDomainEdgeCollisionCount(0);
 
-      PostStep(*mWallCollision, offset, dom.GetDomainEdgeCollisionCount(1));
+      PostStep(*mWallCollision, offset, dom.GetDomainEdgeCollisionCount(1), 1);
       offset += dom.GetDomainEdgeCollisionCount(1);
 
-      PostStep(*mInletCollision, offset, dom.GetDomainEdgeCollisionCount(2));
+      PostStep(*mInletCollision, offset, dom.GetDomainEdgeCollisionCount(2), 2);
       offset += dom.GetDomainEdgeCollisionCount(2);
 
-      PostStep(*mOutletCollision, offset, dom.GetDomainEdgeCollisionCount(3));
+      PostStep(*mOutletCollision, offset, dom.GetDomainEdgeCollisionCount(3), 3);
       offset += dom.GetDomainEdgeCollisionCount(3);
 
-      PostStep(*mInletWallCollision, offset, dom.GetDomainEdgeCollisionCount(4));
+      PostStep(*mInletWallCollision, offset, dom.GetDomainEdgeCollisionCount(4), 4);
       offset += dom.GetDomainEdgeCollisionCount(4);
 
-      PostStep(*mOutletWallCollision, offset, dom.GetDomainEdgeCollisionCount(5));
+      PostStep(*mOutletWallCollision, offset, dom.GetDomainEdgeCollisionCount(5), 5);
 
       offset = 0;
 
-      PostStep(*mMidFluidCollision, offset, dom.GetMidDomainCollisionCount(0));
+      PostStep(*mMidFluidCollision, offset, dom.GetMidDomainCollisionCount(0), 0);
       offset += dom.GetMidDomainCollisionCount(0);
 
-      PostStep(*mWallCollision, offset, dom.GetMidDomainCollisionCount(1));
+      PostStep(*mWallCollision, offset, dom.GetMidDomainCollisionCount(1), 1);
       offset += dom.GetMidDomainCollisionCount(1);
 
-      PostStep(*mInletCollision, offset, dom.GetMidDomainCollisionCount(2));
+      PostStep(*mInletCollision, offset, dom.GetMidDomainCollisionCount(2), 2);
       offset += dom.GetMidDomainCollisionCount(2);
 
-      PostStep(*mOutletCollision, offset, dom.GetMidDomainCollisionCount(3));
+      PostStep(*mOutletCollision, offset, dom.GetMidDomainCollisionCount(3), 3);
       offset += dom.GetMidDomainCollisionCount(3);
 
-      PostStep(*mInletWallCollision, offset, dom.GetMidDomainCollisionCount(4));
+      PostStep(*mInletWallCollision, offset, dom.GetMidDomainCollisionCount(4), 4);
       offset += dom.GetMidDomainCollisionCount(4);
 
-      PostStep(*mOutletWallCollision, offset, dom.GetMidDomainCollisionCount(5));
+      PostStep(*mOutletWallCollision, offset, dom.GetMidDomainCollisionCount(5), 5);
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
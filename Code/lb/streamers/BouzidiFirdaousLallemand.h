@@ -45,7 +45,7 @@ namespace hemelb::lb
                         const Direction& direction)
         {
             site_t invDirection = LatticeType::INVERSEDIRECTIONS[direction];
-            site_t bbDestination = (site.GetIndex() * LatticeType::NUMVECTORS) + invDirection;
+            site_t bbDestination = latticeData.GetDomain().GetDistributionIndex<LatticeType>(site.GetIndex(), invDirection);
             distribn_t q = site.GetWallDistance<LatticeType>(direction);
 
             if (site.HasWall(invDirection) || q < 0.5)
@@ -71,7 +71,7 @@ namespace hemelb::lb
                           const geometry::Site<geometry::FieldData>& site,
                           const Direction& direction)
         {
-            distribn_t* fNew = latticeData.GetFNew(site.GetIndex() * LatticeType::NUMVECTORS);
+            auto fNew = latticeData.GetFNew<LatticeType>(site.GetIndex());
             site_t invDirection = LatticeType::INVERSEDIRECTIONS[direction];
             distribn_t q = site.GetWallDistance<LatticeType>(direction);
             // If there is no fluid site in the opposite direction, fall back to simple
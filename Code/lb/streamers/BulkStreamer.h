@@ -34,7 +34,7 @@ namespace hemelb::lb
                         VarsType& hydroVars,
                         const Direction& direction)
         {
-            * (latticeData.GetFNew(site.GetStreamedIndex<LatticeType>(direction))) =
+            * (latticeData.GetFNew(latticeData.GetStreamedIndex<LatticeType>(site.GetIndex(), direction))) =
                     hydroVars.GetFPostCollision()[direction];
         }
 
@@ -53,7 +53,7 @@ namespace hemelb::lb
         using LatticeType = typename C::LatticeType;
         using VarsType = typename C::VarsType;
 
-    private:
+    protected:
         CollisionType collider;
         BulkLink<CollisionType> bulkLinkDelegate;
         static_assert(link_streamer<BulkLink<CollisionType>>);
@@ -0,0 +1,72 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_STREAMERS_FUSEDBULKSTREAMER_H
+#define HEMELB_LB_STREAMERS_FUSEDBULKSTREAMER_H
+
+#include <utility>
+
+#include "lb/collisions/Normal.h"
+#include "lb/streamers/BulkStreamer.h"
+
+namespace hemelb::lb
+{
+    // Can a kernel collide a site and stream the result without
+    // going through HydroVars?
+    template <typename K>
+    concept fused_kernel = kernel_type<K> &&
+    requires (K k, LbmParameters const* lbmParams, FVector<typename K::LatticeType> const& f,
+              void (*stream)(Direction, distribn_t)) {
+        { k.CollideFused(lbmParams, f, stream) };
+    };
+
+    template <typename C>
+    concept fused_collision = collision_type<C> &&
+            std::same_as<C, Normal<typename C::KernelType>> &&
+            fused_kernel<typename C::KernelType>;
+
+    /**
+     * Bulk streamer that computes each site's moments, relaxes and
+     * streams in one pass with the kernel's CollideFused, so the
+     * f_eq, f_neq and post-collision arrays of HydroVars are never
+     * filled.
+     *
+     * On steps when the macroscopic property cache needs filling it
+     * falls back to the scalar BulkStreamer, which has those values
+     * to hand.
+     */
+    template<fused_collision C>
+    class FusedBulkStreamer : public BulkStreamer<C>
+    {
+        using Base = BulkStreamer<C>;
+
+    public:
+        using CollisionType = C;
+        using LatticeType = typename C::LatticeType;
+
+        using Base::Base;
+
+        void StreamAndCollide(const site_t firstIndex, const site_t siteCount,
+                              const LbmParameters* lbmParams,
+                              geometry::FieldData& latDat,
+                              lb::MacroscopicPropertyCache& propertyCache)
+        {
+            if (propertyCache.AnyRequiresRefresh())
+                return Base::StreamAndCollide(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+
+            for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
+            {
+                auto const f = std::as_const(latDat).GetFOld<LatticeType>(siteIndex);
+                this->collider.kernel.CollideFused(
+                        lbmParams, f,
+                        [&](Direction i, distribn_t fPostCollision) {
+                            *latDat.GetFNew(latDat.GetStreamedIndex<LatticeType>(siteIndex, i)) = fPostCollision;
+                        }
+                );
+            }
+        }
+    };
+}
+#endif
@@ -6,6 +6,8 @@
 #ifndef HEMELB_LB_STREAMERS_GUOZHENGSHI_H
 #define HEMELB_LB_STREAMERS_GUOZHENGSHI_H
 
+#include <utility>
+
 #include "lb/iolets/BoundaryValues.h"
 #include "lb/iolets/InOutLetVelocity.h"
 #include "geometry/neighbouring/RequiredSiteInformation.h"
@@ -213,7 +215,7 @@ namespace hemelb::lb
                 else
                 {
                   // There is a neighbour site to use for standard GZS to calculate u_w2.
-                  auto neighbourFOld = GetNeighbourFOld(site, i, latDat);
+                  auto const neighbourFOld = geometry::Contiguous(GetNeighbourFOld(site, i, latDat));
                   // Now calculate this field information.
                   LatticeVelocity neighbourVelocity;
                   distribn_t neighbourFEq[LatticeType::NUMVECTORS];
@@ -278,8 +280,7 @@ namespace hemelb::lb
             // Perform collision
             collider.Collide(lbmParams, hydroVarsWall);
             // stream
-            distribn_t* fNew = latDat.GetFNew(site.GetIndex() * LatticeType::NUMVECTORS);
-            fNew[i] = hydroVarsWall.GetFPostCollision()[i];
+            *latDat.GetFNew<LatticeType>(site.GetIndex(), i) = hydroVarsWall.GetFPostCollision()[i];
 
           }
 
@@ -289,7 +290,7 @@ namespace hemelb::lb
             // Nothing to do
         }
     private:
-        auto GetNeighbourFOld(const geometry::Site<geometry::FieldData>& site,
+        geometry::ConstSiteDistSpan<LatticeType::NUMVECTORS> GetNeighbourFOld(const geometry::Site<geometry::FieldData>& site,
                                     const Direction& i,
                                     geometry::FieldData& latDat)
         {
@@ -306,7 +307,8 @@ namespace hemelb::lb
             }
             else
             {
-                auto neighbourSite = latDat.GetNeighbouringData().GetSite(
+                // Use the const lookup: other threads may be reading it too.
+                auto neighbourSite = std::as_const(latDat.GetNeighbouringData()).GetSite(
                         domain.GetGlobalNoncontiguousSiteIdFromGlobalCoords(neighbourGlobalLocation)
                 );
                 return neighbourSite.GetFOld<LatticeType>();
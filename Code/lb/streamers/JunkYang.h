@@ -123,26 +123,26 @@ namespace hemelb::lb
               // TODO: Ideally, this should be done in the loop over directions above
               // but the f's are permuted by the below making it tricky.
               unsigned index = 0;
-              for (auto incomingVelocityIter = incomingVelocities[siteIndex].begin();
-                  incomingVelocityIter != incomingVelocities[siteIndex].end();
+              for (auto incomingVelocityIter = incomingVelocities.at(siteIndex).begin();
+                  incomingVelocityIter != incomingVelocities.at(siteIndex).end();
                   ++incomingVelocityIter, ++index)
               {
                 int inverseDirection = LatticeType::INVERSEDIRECTIONS[*incomingVelocityIter];
 
-                fPostCollision[siteIndex](index) =
+                fPostCollision.at(siteIndex)(index) =
                     hydroVars.GetFPostCollision()[*incomingVelocityIter];
-                fPostCollisionInverseDir[siteIndex](index) =
+                fPostCollisionInverseDir.at(siteIndex)(index) =
                     hydroVars.GetFPostCollision()[inverseDirection];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*incomingVelocityIter];
+                fOld.at(siteIndex)(index) = site.GetFOld<LatticeType>()[*incomingVelocityIter];
               }
 
-              for (auto outgoingVelocityIter = outgoingVelocities[siteIndex].begin();
-                  outgoingVelocityIter != outgoingVelocities[siteIndex].end();
+              for (auto outgoingVelocityIter = outgoingVelocities.at(siteIndex).begin();
+                  outgoingVelocityIter != outgoingVelocities.at(siteIndex).end();
                   ++outgoingVelocityIter, ++index)
               {
-                fPostCollision[siteIndex](index) =
+                fPostCollision.at(siteIndex)(index) =
                     hydroVars.GetFPostCollision()[*outgoingVelocityIter];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*outgoingVelocityIter];
+                fOld.at(siteIndex)(index) = site.GetFOld<LatticeType>()[*outgoingVelocityIter];
               }
 
                 UpdateCachePostCollision(site,
@@ -167,26 +167,26 @@ namespace hemelb::lb
               AssembleRVector(siteIndex, latticeData,rVector);
 
               // assemble RHS
-              vector systemRHS = fPostCollisionInverseDir[siteIndex] - rVector;
+              vector systemRHS = fPostCollisionInverseDir.at(siteIndex) - rVector;
 
               // lu_substitue will overwrite the RHS with the solution
               vector &systemSolution = systemRHS;
-              lu_substitute(lMatrices[siteIndex],
-                            *luPermutationMatrices[siteIndex],
+              lu_substitute(lMatrices.at(siteIndex),
+                            *luPermutationMatrices.at(siteIndex),
                             systemSolution);
 
               // Update the distribution function for incoming velocities with the solution of the linear system
               unsigned index = 0;
-              for (auto incomingVelocityIter = incomingVelocities[siteIndex].begin();
-                  incomingVelocityIter != incomingVelocities[siteIndex].end();
+              for (auto incomingVelocityIter = incomingVelocities.at(siteIndex).begin();
+                  incomingVelocityIter != incomingVelocities.at(siteIndex).end();
                   ++incomingVelocityIter, ++index)
               {
-                * (latticeData.GetFNew(siteIndex * LatticeType::NUMVECTORS + *incomingVelocityIter)) =
+                * (latticeData.GetFNew<LatticeType>(siteIndex, *incomingVelocityIter)) =
                     systemSolution[index];
               }
 
               auto&& site = latticeData.GetSite(siteIndex);
-              for (unsigned int outgoingVelocityIter : outgoingVelocities[siteIndex])
+              for (unsigned int outgoingVelocityIter : outgoingVelocities.at(siteIndex))
               {
                   if constexpr (has_iolet) {
                       if (site.HasIolet(outgoingVelocityIter)) {
@@ -256,6 +256,10 @@ namespace hemelb::lb
               }
             }
             fPostCollisionInverseDir[contiguousSiteIndex].resize(incomingVelocities[contiguousSiteIndex].size());
+            // Create the remaining per-site entries now: stepping only looks
+            // them up with at(), so different threads may update different sites.
+            fPostCollision[contiguousSiteIndex];
+            fOld[contiguousSiteIndex];
           }
 
           /**
@@ -427,8 +431,8 @@ namespace hemelb::lb
           {
             HASSERT(fPostCollision.find(contiguousSiteIndex) != fPostCollision.end());
             HASSERT(fOld.find(contiguousSiteIndex) != fOld.end());
-            sigmaVector = fPostCollision[contiguousSiteIndex]
-                - (1 - THETA) * fOld[contiguousSiteIndex];
+            sigmaVector = fPostCollision.at(contiguousSiteIndex)
+                - (1 - THETA) * fOld.at(contiguousSiteIndex);
           }
 
           /**
@@ -444,8 +448,8 @@ namespace hemelb::lb
             c_vector sigmaVector;
             AssembleSigmaVector(contiguousSiteIndex, sigmaVector);
 
-            unsigned incomingVelsSetSize = incomingVelocities[contiguousSiteIndex].size();
-            unsigned outgoingVelsSetSize = outgoingVelocities[contiguousSiteIndex].size();
+            unsigned incomingVelsSetSize = incomingVelocities.at(contiguousSiteIndex).size();
+            unsigned outgoingVelsSetSize = outgoingVelocities.at(contiguousSiteIndex).size();
 
             vector fNew(outgoingVelsSetSize);
 
@@ -453,24 +457,23 @@ namespace hemelb::lb
              *  Assemble a vector with the updated values of the distribution function for the outgoing velocities,
              *  which have already been streamed
              */
-            HASSERT(fNew.size() == outgoingVelocities[contiguousSiteIndex].size());
+            HASSERT(fNew.size() == outgoingVelocities.at(contiguousSiteIndex).size());
             unsigned index = 0;
             for (auto outgoingDirIter =
-                outgoingVelocities[contiguousSiteIndex].begin();
-                outgoingDirIter != outgoingVelocities[contiguousSiteIndex].end();
+                outgoingVelocities.at(contiguousSiteIndex).begin();
+                outgoingDirIter != outgoingVelocities.at(contiguousSiteIndex).end();
                 ++outgoingDirIter, ++index)
             {
-              fNew[index] = *fieldData.GetFNew(contiguousSiteIndex * LatticeType::NUMVECTORS
-                  + *outgoingDirIter);
+              fNew[index] = *fieldData.GetFNew<LatticeType>(contiguousSiteIndex, *outgoingDirIter);
             }
 
             rVector = THETA
-                * prod(subrange(kMatrices[contiguousSiteIndex],
+                * prod(subrange(kMatrices.at(contiguousSiteIndex),
                                               0,
                                               incomingVelsSetSize,
                                               incomingVelsSetSize,
                                               LatticeType::NUMVECTORS),
-                              fNew) + prod(kMatrices[contiguousSiteIndex], sigmaVector);
+                              fNew) + prod(kMatrices.at(contiguousSiteIndex), sigmaVector);
           }
       };
 }
@@ -60,7 +60,8 @@ namespace hemelb::lb
             distribn_t correction = 2. * LatticeType::EQMWEIGHTS[ii]
                                     * Dot(wallMom, LatticeType::VECTORS[ii]) / Cs2;
 
-            * (latticeData.GetFNew(BounceBackLink<CollisionType>::GetBBIndex(site.GetIndex(),
+            * (latticeData.GetFNew(BounceBackLink<CollisionType>::GetBBIndex(latticeData.GetDomain(),
+                                                                             site.GetIndex(),
                                                                              ii))) =
                     hydroVars.GetFPostCollision()[ii] - correction;
         }
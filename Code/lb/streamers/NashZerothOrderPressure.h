@@ -55,7 +55,7 @@ namespace hemelb::lb
 
             Direction unstreamed = LatticeType::INVERSEDIRECTIONS[direction];
 
-            *latticeData.GetFNew(site.GetIndex() * LatticeType::NUMVECTORS + unstreamed) =
+            *latticeData.GetFNew<LatticeType>(site.GetIndex(), unstreamed) =
                 ghostHydrovars.GetFEq()[unstreamed];
         }
 
@@ -0,0 +1,94 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_STREAMERS_SIMDBULKSTREAMER_H
+#define HEMELB_LB_STREAMERS_SIMDBULKSTREAMER_H
+
+#include "geometry/DistributionLayout.h"
+#include "lb/BatchHydroVars.h"
+#include "lb/collisions/Normal.h"
+#include "lb/streamers/BulkStreamer.h"
+
+namespace hemelb::lb
+{
+    // Can a collision's kernel work on batches of sites?
+    template <typename C>
+    concept batch_collision = collision_type<C> &&
+            std::same_as<C, Normal<typename C::KernelType>> &&
+            batch_kernel<typename C::KernelType>;
+
+    /**
+     * Bulk streamer that collides util::simd::WIDTH sites at once,
+     * with one site per SIMD lane, using the kernel's CollideBatch.
+     *
+     * Falls back to the scalar BulkStreamer for the sites left over
+     * at the end of a range and on steps when the macroscopic
+     * property cache needs filling.
+     */
+    template<batch_collision C>
+    class SimdBulkStreamer : public BulkStreamer<C>
+    {
+        using Base = BulkStreamer<C>;
+        using Vec = util::simd::Vec;
+        static constexpr site_t WIDTH = util::simd::WIDTH;
+
+        // Are the pre-collision values of consecutive sites adjacent
+        // for a given direction?
+        static constexpr bool CONTIGUOUS_LANES =
+                !geometry::DistributionLayout::SITE_CONTIGUOUS && !geometry::SINGLE_BUFFER_STREAMING;
+
+    public:
+        using CollisionType = C;
+        using LatticeType = typename C::LatticeType;
+
+        using Base::Base;
+
+        void StreamAndCollide(const site_t firstIndex, const site_t siteCount,
+                              const LbmParameters* lbmParams,
+                              geometry::FieldData& latDat,
+                              lb::MacroscopicPropertyCache& propertyCache)
+        {
+            if (propertyCache.AnyRequiresRefresh())
+                return Base::StreamAndCollide(firstIndex, siteCount, lbmParams, latDat, propertyCache);
+
+            auto const end = firstIndex + siteCount;
+            auto siteIndex = firstIndex;
+            BatchHydroVars<LatticeType> hydroVars;
+            for (; siteIndex + WIDTH <= end; siteIndex += WIDTH)
+            {
+                Gather(latDat, siteIndex, hydroVars);
+                CalculateDensityMomentumFEqNeq(hydroVars);
+                this->collider.kernel.CollideBatch(lbmParams, hydroVars);
+                Scatter(latDat, siteIndex, hydroVars);
+            }
+            Base::StreamAndCollide(siteIndex, end - siteIndex, lbmParams, latDat, propertyCache);
+        }
+
+    private:
+        static void Gather(geometry::FieldData const& latDat, site_t firstSite,
+                           BatchHydroVars<LatticeType>& hydroVars)
+        {
+            for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+            {
+                if constexpr (CONTIGUOUS_LANES) {
+                    hydroVars.f[i] = util::simd::Load(latDat.GetFOld<LatticeType>(firstSite, i));
+                } else {
+                    for (site_t lane = 0; lane < WIDTH; ++lane)
+                        hydroVars.f[i][lane] = *latDat.GetFOld<LatticeType>(firstSite + lane, i);
+                }
+            }
+        }
+
+        static void Scatter(geometry::FieldData& latDat, site_t firstSite,
+                            BatchHydroVars<LatticeType> const& hydroVars)
+        {
+            for (site_t lane = 0; lane < WIDTH; ++lane)
+                for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
+                    *latDat.GetFNew(latDat.GetStreamedIndex<LatticeType>(firstSite + lane, i)) =
+                            hydroVars.f_post[i][lane];
+        }
+    };
+}
+#endif
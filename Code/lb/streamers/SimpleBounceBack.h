@@ -20,9 +20,9 @@ namespace hemelb::lb
         using VarsType = typename CollisionType::VarsType;
         using LatticeType = typename CollisionType::LatticeType;
 
-        static site_t GetBBIndex(site_t siteIndex, int direction)
+        static site_t GetBBIndex(geometry::Domain const& domain, site_t siteIndex, int direction)
         {
-            return (siteIndex * LatticeType::NUMVECTORS) + LatticeType::INVERSEDIRECTIONS[direction];
+            return domain.GetDistributionIndex<LatticeType>(siteIndex, LatticeType::INVERSEDIRECTIONS[direction]);
         }
 
         BounceBackLink(CollisionType& delegatorCollider,
@@ -37,7 +37,7 @@ namespace hemelb::lb
                         const Direction& direction)
         {
             // Propagate the outgoing post-collisional f into the opposite direction.
-            * (latticeData.GetFNew(GetBBIndex(site.GetIndex(), direction))) =
+            * (latticeData.GetFNew(GetBBIndex(latticeData.GetDomain(), site.GetIndex(), direction))) =
                     hydroVars.GetFPostCollision()[direction];
         }
         void PostStepLink(geometry::FieldData& latticeData,
@@ -207,7 +207,7 @@ namespace hemelb::lb
               CalculateVirtualSiteDistributions(*latDat, *iolet, extra->hydroVarsCache, *vSite, t);
               // Stream this direction
               Direction i = vSiteIt->second.direction;
-              * (latDat->GetFNew(siteIdx * LatticeType::NUMVECTORS + i)) = vSite->hv.fPostColl[i];
+              * (latDat->GetFNew<LatticeType>(siteIdx, i)) = vSite->hv.fPostColl[i];
               //* (m_fieldData->GetFNew(GetBBIndex(site.GetIndex(), direction))) = hydroVars.GetFPostCollision()[direction];
               //return (siteIndex * LatticeType::NUMVECTORS) + LatticeType::INVERSEDIRECTIONS[direction];
             }
@@ -66,6 +66,11 @@ namespace hemelb
       countsBuffer.clear();
     }
 
+    bool BaseNet::Progress()
+    {
+      return ProgressPointToPoint();
+    }
+
     std::vector<int> & BaseNet::GetDisplacementsBuffer()
     {
       displacementsBuffer.push_back(std::vector<int>());
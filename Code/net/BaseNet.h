@@ -38,6 +38,13 @@ namespace hemelb
         void Send();
         virtual void Wait();
 
+        /***
+         * Give MPI a chance to progress the outstanding point-to-point requests without
+         * blocking. Only valid between Send and Wait.
+         * @return true if they have all completed
+         */
+        bool Progress();
+
         /***
          * Carry out a complete send-receive-wait
          */
@@ -72,6 +79,12 @@ namespace hemelb
         virtual void WaitGatherVs()=0;
         virtual void WaitAllToAll()=0;
 
+        // Implementations whose requests are already complete by the end of Send needn't override this
+        virtual bool ProgressPointToPoint()
+        {
+          return true;
+        }
+
         // Interfaces exposing MPI_Datatype, not intended for client class use
         virtual void RequestSendImpl(void const* pointer, int count, proc_t rank, MPI_Datatype type)=0;
         virtual void RequestReceiveImpl(void* pointer, int count, proc_t rank, MPI_Datatype type)=0;
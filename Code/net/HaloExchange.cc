@@ -0,0 +1,133 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/HaloExchange.h"
+
+#include <algorithm>
+
+#include "Exception.h"
+#include "net/MpiDataType.h"
+#include "net/MpiError.h"
+
+namespace hemelb::net
+{
+    // Distinct from the tag used by the Net's point-to-point mixins, for clarity
+    // in traces; the communicator already keeps the messages apart.
+    constexpr int HALO_TAG = 11;
+
+    PersistentHaloExchange::PersistentHaloExchange(MpiCommunicator const& comm,
+                                                   std::vector<HaloBlock> blocks) :
+        comm(comm.Duplicate()), blocks(std::move(blocks))
+    {
+    }
+
+    PersistentHaloExchange::~PersistentHaloExchange()
+    {
+      for (auto& set: requestSets)
+        for (auto& req: set.requests)
+          MPI_Request_free(&req);
+    }
+
+    void PersistentHaloExchange::Start(distribn_t const* send, distribn_t* recv)
+    {
+      auto const found = std::find_if(requestSets.begin(), requestSets.end(),
+                                      [&](RequestSet const& s) {
+                                        return s.send == send && s.recv == recv;
+                                      });
+      if (found != requestSets.end())
+      {
+        active = &*found;
+      }
+      else
+      {
+        auto& set = requestSets.emplace_back(RequestSet{send, recv, {}});
+        set.requests.resize(2 * blocks.size());
+        auto const type = MpiDataType<distribn_t>();
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+          auto const& b = blocks[i];
+          MpiCall{MPI_Recv_init}(recv + b.Offset, b.Count, type, b.Rank, HALO_TAG, comm,
+                                 &set.requests[i]);
+          MpiCall{MPI_Send_init}(send + b.Offset, b.Count, type, b.Rank, HALO_TAG, comm,
+                                 &set.requests[blocks.size() + i]);
+        }
+        active = &set;
+      }
+      MpiCall{MPI_Startall}((int) active->requests.size(), active->requests.data());
+    }
+
+    bool PersistentHaloExchange::Test()
+    {
+      int done;
+      MpiCall{MPI_Testall}((int) active->requests.size(), active->requests.data(), &done,
+                           MPI_STATUSES_IGNORE);
+      return done;
+    }
+
+    void PersistentHaloExchange::Wait()
+    {
+      MpiCall{MPI_Waitall}((int) active->requests.size(), active->requests.data(),
+                           MPI_STATUSES_IGNORE);
+    }
+
+    namespace
+    {
+      std::vector<int> Ranks(std::vector<HaloBlock> const& blocks)
+      {
+        std::vector<int> ans;
+        for (auto const& b: blocks)
+          ans.push_back(b.Rank);
+        return ans;
+      }
+    }
+
+    NeighbourHaloExchange::NeighbourHaloExchange(MpiCommunicator const& comm,
+                                                 std::vector<HaloBlock> const& blocks) :
+        // No reordering: the neighbours must keep the order of the blocks.
+        graphComm(comm.DistGraphAdjacent(Ranks(blocks), false))
+    {
+      for (auto const& b: blocks)
+      {
+        counts.push_back(b.Count);
+        offsets.push_back(b.Offset);
+      }
+      // Makes sure the pointers are valid even with no neighbours
+      counts.reserve(1);
+      offsets.reserve(1);
+    }
+
+    void NeighbourHaloExchange::Start(distribn_t const* send, distribn_t* recv)
+    {
+      auto const type = MpiDataType<distribn_t>();
+      MpiCall{MPI_Ineighbor_alltoallv}(send, counts.data(), offsets.data(), type,
+                                       recv, counts.data(), offsets.data(), type,
+                                       graphComm, &request);
+    }
+
+    bool NeighbourHaloExchange::Test()
+    {
+      int done;
+      MpiCall{MPI_Test}(&request, &done, MPI_STATUS_IGNORE);
+      return done;
+    }
+
+    void NeighbourHaloExchange::Wait()
+    {
+      MpiCall{MPI_Wait}(&request, MPI_STATUS_IGNORE);
+    }
+
+    std::unique_ptr<HaloExchange> MakeHaloExchange(MpiCommunicator const& comm,
+                                                   std::vector<HaloBlock> blocks)
+    {
+      constexpr auto IMPL = build_info::HALO_EXCHANGE;
+      if constexpr (IMPL == "Persistent") {
+        return std::make_unique<PersistentHaloExchange>(comm, std::move(blocks));
+      } else if constexpr (IMPL == "Neighbour") {
+        return std::make_unique<NeighbourHaloExchange>(comm, blocks);
+      } else {
+        throw (Exception() << "No HaloExchange for HALO_EXCHANGE = " << IMPL.c_str());
+      }
+    }
+}
@@ -0,0 +1,114 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_HALOEXCHANGE_H
+#define HEMELB_NET_HALOEXCHANGE_H
+
+#include <memory>
+#include <vector>
+
+#include "build_info.h"
+#include "units.h"
+#include "net/MpiCommunicator.h"
+
+namespace hemelb::net
+{
+    // Does the LB distribution halo go through the Net object, as
+    // requests made by FieldData::SendAndReceive, rather than a
+    // HaloExchange?
+    inline constexpr bool HALO_EXCHANGE_VIA_NET = build_info::HALO_EXCHANGE == "Net";
+
+    //! A contiguous block of values sent to, and the same number received
+    //! from, a neighbouring rank, at the same offset in the send and
+    //! receive arrays.
+    struct HaloBlock
+    {
+        proc_t Rank;
+        int Offset;
+        int Count;
+    };
+
+    /**
+     * Exchanges the same blocks of distributions with the same neighbouring
+     * ranks every step, so that the MPI setup can be done once instead of
+     * being redone by the Net each time.
+     *
+     * Usage each step is Start, any number of Tests, then Wait.
+     */
+    class HaloExchange
+    {
+      public:
+        virtual ~HaloExchange() = default;
+
+        //! Begin sending each block of send to its rank, and receiving each into recv.
+        //! Both arrays must stay valid until Wait returns.
+        virtual void Start(distribn_t const* send, distribn_t* recv) = 0;
+        //! Let MPI progress the exchange, without blocking.
+        //! @return true if it has completed
+        virtual bool Test() = 0;
+        //! Block until the exchange is complete.
+        virtual void Wait() = 0;
+    };
+
+    /**
+     * Uses persistent point-to-point requests (MPI_Send_init and
+     * MPI_Recv_init). A set of requests is created the first time each
+     * pair of arrays is seen: two sets with separate old and new
+     * distribution arrays, one with single-buffer streaming.
+     */
+    class PersistentHaloExchange : public HaloExchange
+    {
+      public:
+        PersistentHaloExchange(MpiCommunicator const& comm, std::vector<HaloBlock> blocks);
+        ~PersistentHaloExchange() override;
+
+        void Start(distribn_t const* send, distribn_t* recv) override;
+        bool Test() override;
+        void Wait() override;
+
+      private:
+        struct RequestSet
+        {
+          distribn_t const* send;
+          distribn_t* recv;
+          std::vector<MPI_Request> requests;
+        };
+
+        //! Own communicator, so these messages can't match those of the Net
+        MpiCommunicator comm;
+        std::vector<HaloBlock> blocks;
+        std::vector<RequestSet> requestSets;
+        RequestSet* active = nullptr;
+    };
+
+    /**
+     * Uses a nonblocking neighbourhood collective (MPI_Ineighbor_alltoallv,
+     * as wrapped by INeighborAllToAllV) over a distributed graph communicator
+     * whose neighbours are the blocks' ranks. Unlike INeighborAllToAllV, this
+     * works on the caller's arrays, so nothing is copied.
+     */
+    class NeighbourHaloExchange : public HaloExchange
+    {
+      public:
+        NeighbourHaloExchange(MpiCommunicator const& comm, std::vector<HaloBlock> const& blocks);
+
+        void Start(distribn_t const* send, distribn_t* recv) override;
+        bool Test() override;
+        void Wait() override;
+
+      private:
+        MpiCommunicator graphComm;
+        std::vector<int> counts;
+        std::vector<int> offsets;
+        MPI_Request request = MPI_REQUEST_NULL;
+    };
+
+    //! The HaloExchange chosen by HEMELB_HALO_EXCHANGE.
+    //! Must not be called if that is "Net".
+    std::unique_ptr<HaloExchange> MakeHaloExchange(MpiCommunicator const& comm,
+                                                   std::vector<HaloBlock> blocks);
+}
+
+#endif // HEMELB_NET_HALOEXCHANGE_H
@@ -16,4 +16,12 @@ namespace hemelb::net
     {
     }
 
+    IOCommunicator::IOCommunicator(const MpiCommunicator& comm, const MpiCommunicator& node) :
+        MpiCommunicator(comm),
+        nodeComm(node),
+        amNodeLeader(nodeComm.Rank() == IO_RANK),
+        leadersComm(comm.Split(amNodeLeader))
+    {
+    }
+
 }
@@ -28,6 +28,10 @@ namespace hemelb::net {
         static constexpr int IO_RANK = 0;
 
         explicit IOCommunicator(const MpiCommunicator& comm);
+        // Take the nodes to be the groups of ranks in nodeComm, which
+        // must split comm, rather than the shared memory regions. For
+        // trying out multi-node code on one node.
+        IOCommunicator(const MpiCommunicator& comm, const MpiCommunicator& nodeComm);
 
         inline bool OnIORank() const {
             return Rank() == IO_RANK;
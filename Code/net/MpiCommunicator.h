@@ -182,6 +182,13 @@ namespace hemelb::net
         T Scatter(const std::vector<T>& vals, const int root) const;
         template <typename T>
         std::vector<T> Scatter(const std::vector<T>& vals, const size_t n, const int root) const;
+        //! \brief Scatter consecutive runs of vals, of the given
+        //! lengths, one to each rank.
+        //! \note The counts only matter on the root. Two collective MPI
+        //! operations are made, as for Gather.
+        template <typename T>
+        std::vector<T> ScatterV(const std::vector<T>& vals, const std::vector<int>& counts,
+                                const int root) const;
 
         template <typename T>
         std::vector<T> AllGather(const T& val) const;
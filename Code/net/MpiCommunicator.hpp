@@ -152,6 +152,30 @@ namespace hemelb::net
       return ans;
     }
 
+    template <typename T>
+    std::vector<T> MpiCommunicator::ScatterV(const std::vector<T>& vals, const std::vector<int>& counts,
+                                             const int root) const {
+      auto const n = Scatter(counts, root);
+      std::vector<T> ans(n);
+      std::vector<int> offsets;
+      if (Rank() == root)
+      {
+        offsets.push_back(0);
+        for (auto const& c: counts)
+          offsets.push_back(offsets.back() + c);
+      }
+      HEMELB_MPI_CALL(
+          MPI_Scatterv,
+          (Rank() == root ? vals.data() : nullptr,
+           Rank() == root ? counts.data() : nullptr,
+           Rank() == root ? offsets.data() : nullptr,
+           MpiDataType<T>(),
+           ans.data(), n, MpiDataType<T>(),
+           root, *this)
+      );
+      return ans;
+    }
+
     template<typename T>
     std::vector<T> MpiCommunicator::AllGather(const T& val) const
     {
@@ -18,7 +18,16 @@ namespace hemelb
     {
       if (!Initialized())
       {
+#ifdef HEMELB_USE_OPENMP
+        // Threads only work between communications, so the main
+        // thread makes all MPI calls.
+        int provided;
+        HEMELB_MPI_CALL(MPI_Init_thread, (&argc, &argv, MPI_THREAD_FUNNELED, &provided));
+        if (provided < MPI_THREAD_FUNNELED)
+          throw Exception() << "MPI library does not support MPI_THREAD_FUNNELED, needed for OpenMP";
+#else
         HEMELB_MPI_CALL(MPI_Init, (&argc, &argv));
+#endif
         HEMELB_MPI_CALL(MPI_Comm_set_errhandler, (MPI_COMM_WORLD, MPI_ERRORS_RETURN));
         doesOwnMpi = true;
       }
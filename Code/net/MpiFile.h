@@ -64,6 +64,15 @@ namespace hemelb::net
         template<typename T, std::size_t N>
         void WriteAt(MPI_Offset offset, std::span<T const, N> buffer, MPI_Status* stat =
                          MPI_STATUS_IGNORE);
+
+        /**
+         * Start a non-blocking write with MPI_File_iwrite_at. The
+         * buffer must not be changed or freed until the returned
+         * request has completed (e.g. with MPI_Wait), which must
+         * happen before the file is closed.
+         */
+        template<typename T, std::size_t N>
+        MPI_Request IWriteAt(MPI_Offset offset, std::span<T const, N> buffer);
     protected:
         MpiFile(const MpiCommunicator& parentComm, MPI_File fh);
 
@@ -38,6 +38,13 @@ namespace hemelb::net
     {
       MpiCall{MPI_File_write_at}(*filePtr, offset, buffer.data(), buffer.size(), MpiDataType<T>(), stat);
     }
+    template<typename T, std::size_t N>
+    MPI_Request MpiFile::IWriteAt(MPI_Offset offset, std::span<T const, N> buffer)
+    {
+      MPI_Request req;
+      MpiCall{MPI_File_iwrite_at}(*filePtr, offset, buffer.data(), buffer.size(), MpiDataType<T>(), &req);
+      return req;
+    }
 }
 
 #endif
@@ -6,12 +6,14 @@
 #ifndef HEMELB_NET_MPIWINDOW_H
 #define HEMELB_NET_MPIWINDOW_H
 
+#include <algorithm>
 #include <span>
 #include "net/MpiCommunicator.h"
 
 namespace hemelb::net
 {
-    // An MPI Window created with MPI_Win_allocate that gives access to the data, PGAS style
+    // An MPI Window created with MPI_Win_allocate (or MPI_Win_allocate_shared,
+    // see Shared) that gives access to the data, PGAS style
     constexpr MPI_Aint DYNAMIC_EXTENT = -1;
     template <typename T, MPI_Aint EXTENT = DYNAMIC_EXTENT>
     class WinData {
@@ -62,6 +64,35 @@ namespace hemelb::net
             Init(*this, EXTENT, comm, init);
         }
 
+        // Construct a window, with MPI_Win_allocate_shared, holding
+        // one copy of vals for all the ranks of a node. The
+        // communicator must be one per shared memory region
+        // (e.g. IOCommunicator::GetNodeComm()). Only rank zero's vals
+        // are used, so other ranks may pass an empty span; after this
+        // every rank's Span() is a view of rank zero's copy.
+        //
+        // Collective. The data must only be read after this.
+        static WinData Shared(std::span<T const> vals, MpiCommunicator const& nodeComm) requires (EXTENT == DYNAMIC_EXTENT) {
+            WinData self;
+            bool const leader = nodeComm.Rank() == 0;
+            MPI_Aint const n = leader ? vals.size() : 0;
+            T* tmp;
+            HEMELB_MPI_CALL(
+                    MPI_Win_allocate_shared,
+                    (n * sizeof(value_type), sizeof(value_type), MPI_INFO_NULL, nodeComm, &tmp, &self.window)
+            );
+            HEMELB_MPI_CALL(MPI_Win_set_errhandler, (self.window, MPI_ERRORS_RETURN));
+            MPI_Aint bytes;
+            int disp_unit;
+            HEMELB_MPI_CALL(MPI_Win_shared_query, (self.window, 0, &bytes, &disp_unit, &tmp));
+            self.data = span(tmp, bytes / sizeof(value_type));
+            if (leader)
+                std::copy(vals.begin(), vals.end(), self.data.begin());
+            // Make the leader's writes visible to the node
+            self.Fence(MPI_MODE_NOPRECEDE);
+            return self;
+        }
+
         // No copying, uniquely owns the window
         WinData(WinData const&) = delete;
         WinData& operator=(WinData const&) = delete;
@@ -177,6 +208,43 @@ namespace hemelb::net
             return {this};
         }
 
+        // This type groups a set of reads, from any ranks, into one
+        // passive target epoch so they can proceed together.
+        //
+        // Not collective. Requires that there NOT be an open RMA epoch
+        // on construction. The destination of a read must not be used
+        // until the session is destroyed, which completes them all.
+        class ReadSession {
+            WinData const* win;
+        public:
+            ReadSession(WinData const* w) : win{w} {
+                HEMELB_MPI_CALL(MPI_Win_lock_all, (MPI_MODE_NOCHECK, win->window));
+            }
+            ReadSession(ReadSession const&) = delete;
+            ReadSession& operator=(ReadSession const&) = delete;
+            ReadSession(ReadSession &&) = delete;
+            ReadSession& operator=(ReadSession&&) = delete;
+
+            ~ReadSession() noexcept(false) {
+                HEMELB_MPI_CALL(MPI_Win_unlock_all, (win->window));
+            }
+
+            // The output arg dest sets the size
+            template <std::size_t YTENT>
+            void Get(std::span<T, YTENT> dest, int rank, MPI_Aint i) {
+                HEMELB_MPI_CALL(MPI_Get, (
+                        dest.data(), dest.size(), MpiDataType<T>(),
+                                rank, i, dest.size(), MpiDataType<T>(),
+                                win->window
+                ));
+            }
+        };
+
+        // Start a load of reads
+        ReadSession begin_reads() const {
+            return {this};
+        }
+
         // Get reference to a possibly remote element
         // Read-only
         const_reference operator()(int rank, MPI_Aint i) const {
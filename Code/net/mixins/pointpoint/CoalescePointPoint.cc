@@ -111,6 +111,18 @@ namespace hemelb
       }
     }
 
+    bool CoalescePointPoint::ProgressPointToPoint()
+    {
+      // MPI_Testall leaves the requests alone unless they are all complete, in which case
+      // they become MPI_REQUEST_NULL and the MPI_Waitall in WaitPointToPoint returns at once.
+      int done;
+      MPI_Testall((int) (sendProcessorComms.size() + receiveProcessorComms.size()),
+                  requests.data(),
+                  &done,
+                  MPI_STATUSES_IGNORE);
+      return done;
+    }
+
     void CoalescePointPoint::WaitPointToPoint()
     {
 
@@ -24,6 +24,7 @@ namespace hemelb
         void WaitPointToPoint();
 
       protected:
+        bool ProgressPointToPoint();
         void ReceivePointToPoint();
         void SendPointToPoint();
 
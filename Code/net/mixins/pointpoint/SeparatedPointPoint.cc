@@ -98,6 +98,15 @@ namespace hemelb
     {
     }
 
+    bool SeparatedPointPoint::ProgressPointToPoint()
+    {
+      // See CoalescePointPoint::ProgressPointToPoint
+      int done;
+      MPI_Testall(static_cast<int>(count_sends + count_receives), requests.data(), &done,
+                  MPI_STATUSES_IGNORE);
+      return done;
+    }
+
     void SeparatedPointPoint::WaitPointToPoint()
     {
       MPI_Waitall(static_cast<int>(count_sends + count_receives), &requests[0], &statuses[0]);
@@ -25,6 +25,7 @@ namespace hemelb
         void WaitPointToPoint();
 
       protected:
+        bool ProgressPointToPoint();
         void ReceivePointToPoint();
         void SendPointToPoint();
 
@@ -7,6 +7,7 @@
 #define HEMELB_REDBLOOD_CELLARMY_H
 
 #include <algorithm>
+#include <map>
 #include <vector>
 #include <memory>
 #include <iomanip>
@@ -15,6 +16,9 @@
 
 #include "Exception.h"
 #include "geometry/Domain.h"
+#include "io/readers/XdrMemReader.h"
+#include "io/writers/XdrVectorWriter.h"
+#include "net/SparseExchange.h"
 #include "redblood/Cell.h"
 #include "redblood/CellCell.h"
 #include "redblood/WallCellPairIterator.h"
@@ -24,6 +28,7 @@
 #include "redblood/parallel/SpreadForces.h"
 #include "redblood/parallel/IntegrateVelocities.h"
 #include "reporting/Timers.h"
+#include "util/span.h"
 
 namespace hemelb
 {
@@ -147,6 +152,16 @@ namespace hemelb
         //! Adds input cell to simulation
         void AddCell(CellContainer::value_type cell);
 
+        //! \brief Counts the cell vertices nearest to each local site
+        //! \details Covers the vertices of owned and lent cells, so each vertex is counted once
+        //! over all processes.
+        std::vector<site_t> CountVerticesPerSite() const;
+
+        //! \brief Gives all cells to an army built on a new decomposition of the domain
+        //! \details Collective. Each cell is sent only to the process holding its barycenter
+        //! in the new decomposition, and the successor takes over the cell insertion.
+        void HandOverCells(CellArmy &successor) const;
+
         //! \brief Sets cell to cell interaction forces
         //! \details Forwards arguments to Node2NodeForce constructor.
         template<class ... ARGS> void SetCell2Cell(ARGS && ... args)
@@ -165,6 +180,9 @@ namespace hemelb
         }
 
       protected:
+        //! Inserts a cell with its barycenter on this process. Unlike AddCell, not collective.
+        void InsertCell(CellContainer::value_type cell);
+
         //! All lattice information and then some
         geometry::FieldData &fieldData;
         //! Contains all cells
@@ -332,6 +350,143 @@ namespace hemelb
       timings[hemelb::reporting::Timers::cellRemoval].Stop();
     }
 
+    template<class TRAITS>
+    std::vector<site_t> CellArmy<TRAITS>::CountVerticesPerSite() const
+    {
+      auto const& domain = fieldData.GetDomain();
+      std::vector<site_t> counts(domain.GetLocalFluidSiteCount(), 0);
+      auto countCell = [&](CellContainer::value_type const& cell)
+      {
+        for (auto const& vertex : cell->GetVertices())
+        {
+          LatticeVector const nearest(std::lround(vertex.x()),
+                                      std::lround(vertex.y()),
+                                      std::lround(vertex.z()));
+          proc_t proc;
+          site_t site;
+          if (domain.GetContiguousSiteId(nearest, proc, site))
+          {
+            ++counts[site];
+          }
+        }
+      };
+      std::for_each(cells.begin(), cells.end(), countCell);
+      for (auto const& [_, lent] : lentCells)
+      {
+        std::for_each(lent.begin(), lent.end(), countCell);
+      }
+      return counts;
+    }
+
+    template<class TRAITS>
+    void CellArmy<TRAITS>::HandOverCells(CellArmy &successor) const
+    {
+      // Find the new owner of each cell's barycenter, all at once.
+      // TODO: #759 truncation of barycenter
+      auto const& newDomain = successor.fieldData.GetDomain();
+      std::vector<CellContainer::value_type> handed;
+      std::vector<LatticeVector> barycenters;
+      for (auto const& cell : cells)
+      {
+        LatticeVector const site = Vec16{cell->GetBarycenter()}.as<site_t>();
+        if (newDomain.IsValidLatticeSite(site))
+        {
+          handed.push_back(cell);
+          barycenters.push_back(site);
+        }
+        else
+        {
+          log::Logger::Log<log::Info, log::OnePerCore>("Dropping cell %s outside the domain",
+                                                       boost::uuids::to_string(cell->GetTag()).c_str());
+        }
+      }
+      auto const owners = newDomain.GetRankIndexFromGlobalCoords(barycenters);
+
+      std::map<int, io::XdrVectorWriter> writers;
+      for (std::size_t i = 0; i < handed.size(); ++i)
+      {
+        auto const owner = owners[i][0];
+        if (owner == SITE_OR_BLOCK_SOLID)
+        {
+          log::Logger::Log<log::Info, log::OnePerCore>("Dropping cell %s with a solid barycenter",
+                                                       boost::uuids::to_string(handed[i]->GetTag()).c_str());
+          continue;
+        }
+        auto const& cell = handed[i];
+        auto const& tag = cell->GetTag();
+        auto& writer = writers[owner];
+        writer << std::string(tag.begin(), tag.end()) << cell->GetTemplateName()
+            << double(cell->GetScale()) << uint64_t(cell->GetNumberOfNodes());
+        for (auto const& vertex : cell->GetVertices())
+        {
+          writer << double(vertex.x()) << double(vertex.y()) << double(vertex.z());
+        }
+      }
+
+      auto const& comm = fieldData.GetDomain().GetCommunicator();
+      auto const rank = comm.Rank();
+      std::map<int, std::vector<char>> received;
+      {
+        net::sparse_exchange<char> xchg(comm, 456);
+        for (auto const& [dest, writer] : writers)
+        {
+          if (dest != rank)
+          {
+            xchg.send(to_span(writer.GetBuf()), dest);
+          }
+        }
+        xchg.receive([&](int src, int count)
+                     {
+                       auto& rbuf = received[src];
+                       rbuf.resize(count);
+                       return rbuf.data();
+                     },
+                     [](int, char*)
+                     {
+                       // no-op
+                     });
+      }
+      if (writers.contains(rank))
+      {
+        received[rank] = writers.at(rank).GetBuf();
+      }
+
+      for (auto const& [src, buf] : received)
+      {
+        io::XdrMemReader reader(buf);
+        while (reader.GetPosition() < buf.size())
+        {
+          auto const tagBytes = reader.read<std::string>();
+          auto const templateName = reader.read<std::string>();
+          auto const templateCell = cellTemplates->find(templateName);
+          if (templateCell == cellTemplates->end())
+          {
+            throw Exception() << "Unknown cell template " << templateName;
+          }
+          std::shared_ptr<CellBase> cell = templateCell->second->clone();
+          boost::uuids::uuid tag;
+          std::copy(tagBytes.begin(), tagBytes.end(), tag.begin());
+          cell->SetTag(tag);
+          cell->SetScale(reader.read<double>());
+          auto const nodes = reader.read<uint64_t>();
+          if (nodes != uint64_t(cell->GetNumberOfNodes()))
+          {
+            throw Exception() << "Cell " << tag << " has " << nodes << " vertices but its template has "
+                              << cell->GetNumberOfNodes();
+          }
+          for (auto& vertex : cell->GetVertices())
+          {
+            vertex.x() = reader.read<double>();
+            vertex.y() = reader.read<double>();
+            vertex.z() = reader.read<double>();
+          }
+          successor.InsertCell(cell);
+        }
+      }
+      // Keep the state of the inserters, e.g. when they last inserted.
+      successor.SetCellInsertion(cellInsertionCallBack);
+    }
+
     template<class TRAITS>
     void CellArmy<TRAITS>::AddCell(CellContainer::value_type cell)
     {
@@ -343,20 +498,7 @@ namespace hemelb
       bool insertAtThisRank = (iter != globalCoordsToProcMap.end()) && (iter->second == neighbourDependenciesGraph.Rank());
       if (insertAtThisRank)
       {
-        log::Logger::Log<log::Info, log::OnePerCore>("Adding cell at (%f, %f, %f)",
-            barycenter.x(),
-            barycenter.y(),
-            barycenter.z());
-        cellDnC.insert(cell);
-        cells.insert(cell);
-
-        nodeDistributions.emplace(std::piecewise_construct,
-            std::forward_as_tuple(cell->GetTag()),
-            std::forward_as_tuple(parallel::details::AssessMPIFunction<
-              Stencil>(globalCoordsToProcMap),
-              cell));
-        log::Logger::Log<log::Info, log::OnePerCore>("Cell has %i edge nodes",
-          nodeDistributions.find(cell->GetTag())->second.BoundaryIndices().size());
+        InsertCell(cell);
       }
 
 #ifndef NDEBUG
@@ -375,6 +517,26 @@ namespace hemelb
 #endif
 
     }
+
+    template<class TRAITS>
+    void CellArmy<TRAITS>::InsertCell(CellContainer::value_type cell)
+    {
+      auto const barycenter = cell->GetBarycenter();
+      log::Logger::Log<log::Info, log::OnePerCore>("Adding cell at (%f, %f, %f)",
+          barycenter.x(),
+          barycenter.y(),
+          barycenter.z());
+      cellDnC.insert(cell);
+      cells.insert(cell);
+
+      nodeDistributions.emplace(std::piecewise_construct,
+          std::forward_as_tuple(cell->GetTag()),
+          std::forward_as_tuple(parallel::details::AssessMPIFunction<
+            Stencil>(globalCoordsToProcMap),
+            cell));
+      log::Logger::Log<log::Info, log::OnePerCore>("Cell has %i edge nodes",
+        nodeDistributions.find(cell->GetTag())->second.BoundaryIndices().size());
+    }
   }
 }
 
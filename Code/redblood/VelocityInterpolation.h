@@ -80,9 +80,9 @@ namespace hemelb::redblood
         // Use distribution functions at the beginning of the previous timestep (stored in
         // FNew after the swap at the end of the timestep) in the IBM velocity interpolation.
         // Follows approach in Timm's code
-        auto const fDistribution = latticeData.GetFNew<LatticeType>(index);
+        auto const fDistribution = geometry::Contiguous(latticeData.template GetFNew<LatticeType>(index));
 #else
-        auto const fDistribution = site.GetFOld<LatticeType>();
+        auto const fDistribution = geometry::Contiguous(site.template GetFOld<LatticeType>());
 #endif
         LatticeType::CalculateDensityAndMomentum(fDistribution,
                                                  force,
@@ -102,9 +102,9 @@ namespace hemelb::redblood
         // Use distribution functions at the beginning of the previous timestep (stored in
         // FNew after the swap at the end of the timestep) in the IBM velocity interpolation.
         // Follows approach in Timm's code
-        auto const fDistribution = latticeData.GetFNew<LatticeType>(index);
+        auto const fDistribution = geometry::Contiguous(latticeData.template GetFNew<LatticeType>(index));
 #else
-        auto const fDistribution = domainData.GetSite(index).template GetFOld<LatticeType>();
+        auto const fDistribution = geometry::Contiguous(latticeData.GetSite(index).template GetFOld<LatticeType>());
 #endif
         LatticeType::CalculateDensityAndMomentum(fDistribution,
                                                  density,
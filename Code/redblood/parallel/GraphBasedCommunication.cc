@@ -72,7 +72,7 @@ namespace hemelb::redblood::parallel
         // Keep this sorted for easy lookup
         std::vector<int> ans;
 
-        // Neighbour site IDs that we have checked - kept sorted
+        // Neighbour site IDs to look up - kept sorted
         std::vector<U64> checked_ids;
         auto const grid_size = int(std::ceil(cellsEffectiveSize));
 
@@ -117,29 +117,33 @@ namespace hemelb::redblood::parallel
                             // Not seen it, but have the iterator to the first greater. Insert here.
                             checked_ids.insert(iter, neigh_idx);
                         }
-
-                        // Since we didn't continue, we have an unchecked coord that could have a fluid site.
-                        auto [neigh_rank, neigh_local_idx] = domain.GetRankIndexFromGlobalCoords(neigh);
-                        if (neigh_rank == SITE_OR_BLOCK_SOLID)
-                            // It was not a fluid site
-                            continue;
-
-                        if (neigh_rank != rank) {
-                            // And it doesn't live on this process.
-                            // Find out if the site is edge-of-domain
-                            if (domain.IsSiteDomainEdge(neigh_rank, neigh_local_idx)) {
-                                // Add that rank to the answer if not already there.
-                                auto p_iter = std::lower_bound(ans.begin(), ans.end(), neigh_rank);
-
-                                if (p_iter == ans.end()) {
-                                    ans.push_back(neigh_rank);
-                                } else if (*p_iter != neigh_rank) {
-                                    ans.insert(p_iter, neigh_rank);
-                                }
-                            }
-                        }
                     }
         }
+
+        // Look up all the sites that could have a fluid site at once.
+        std::vector<LatticeVector> neighs;
+        neighs.reserve(checked_ids.size());
+        for (auto id: checked_ids)
+            neighs.push_back(geometry::octree::oct_to_ijk(id).as<site_t>());
+        auto const rank_index = domain.GetRankIndexFromGlobalCoords(neighs);
+
+        // Of those that are fluid and don't live on this process, find
+        // out which are edge-of-domain.
+        std::vector<geometry::SiteRankIndex> remote;
+        std::copy_if(rank_index.begin(), rank_index.end(), std::back_inserter(remote),
+                     [&](geometry::SiteRankIndex const& ri) {
+                         return ri[0] != SITE_OR_BLOCK_SOLID && ri[0] != rank;
+                     });
+        auto const is_edge = domain.IsSiteDomainEdge(remote);
+        for (std::size_t i = 0; i < remote.size(); ++i) {
+            if (is_edge[i]) {
+                // Add that rank to the answer if not already there.
+                auto const neigh_rank = remote[i][0];
+                auto p_iter = std::lower_bound(ans.begin(), ans.end(), neigh_rank);
+                if (p_iter == ans.end() || *p_iter != neigh_rank)
+                    ans.insert(p_iter, neigh_rank);
+            }
+        }
         return ans;
     }
 
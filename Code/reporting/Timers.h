@@ -128,11 +128,28 @@ namespace hemelb::reporting
           cellRemoval,
           cellListeners,
           graphComm,
+          haloHidden, //!< Time the LB halo exchange was in flight while mid-domain sites were updated
+          lb_calc_bulk, //!< The part of lb_calc spent on bulk sites
+          lb_calc_wall, //!< The part of lb_calc spent on wall sites
+          lb_calc_inlet, //!< The part of lb_calc spent on inlet sites
+          lb_calc_outlet, //!< The part of lb_calc spent on outlet sites
+          lb_calc_inlet_wall, //!< The part of lb_calc spent on inlet/wall sites
+          lb_calc_outlet_wall, //!< The part of lb_calc spent on outlet/wall sites
+          rebalance, //!< Time spent repartitioning the domain during the run
           last
         //!< last, this has to be the last element of the enumeration so it can be used to track cardinality
         };
         static const unsigned int numberOfTimers = last;
 
+        /**
+         * The timer for the part of lb_calc spent on sites of a collision type
+         * @param collisionType as numbered by the Domain's collision counts (0 for bulk to 5)
+         */
+        static constexpr TimerName CollisionTypeTimer(unsigned collisionType)
+        {
+          return TimerName(lb_calc_bulk + collisionType);
+        }
+
         /**
          * String message label for each timer for reporting
          */
@@ -274,7 +291,15 @@ namespace hemelb::reporting
       "Update cell-cell and cell-wall interactions",
       "Remove cells",
       "Notify cell listeners",
-      "Create graph communicator"
+      "Create graph communicator",
+      "LB halo exchange hidden by computation",
+      "LB calc bulk sites",
+      "LB calc wall sites",
+      "LB calc inlet sites",
+      "LB calc outlet sites",
+      "LB calc inlet/wall sites",
+      "LB calc outlet/wall sites",
+      "Rebalancing"
     };
 }
 
@@ -48,5 +48,63 @@ namespace hemelb
       }
     }
 
+    // Rebalancing during a run moves the sites with their
+    // distributions, after which the run carries on.
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "SimulationMaster rebalances") {
+      const int argc = 3;
+      const char* argv[] = {
+	"hemelb",
+	"-in",
+	"four_cube.xml",
+      };
+
+      CopyResourceToTempdir("four_cube.xml");
+      CopyResourceToTempdir("four_cube.gmy");
+      ModifyXMLInput("four_cube.xml", {"geometry", "rebalance", "period"}, 5);
+
+      auto options = std::make_unique<hemelb::configuration::CommandLine>(argc, argv);
+      auto master = std::make_unique<SimulationMaster<>>(*options, Comms());
+
+      // Near equilibrium, but different at every site.
+      using Lattice = Traits<>::Lattice;
+      auto value = [](LatticeVector const& x, Direction d) {
+	return Lattice::EQMWEIGHTS[d] * (1.0 + 1e-4 * (x.x() + 3 * x.y() + 7 * x.z()));
+      };
+      auto forSites = [&](auto&& f) {
+	auto& field = master->GetFieldData();
+	auto const& dom = field.GetDomain();
+	for (site_t i = 0; i < dom.GetLocalFluidSiteCount(); ++i)
+	  for (Direction d = 0; d < Lattice::NUMVECTORS; ++d) {
+	    auto const idx = dom.GetDistributionIndex(i, d);
+	    f(*field.GetFOld(idx), *field.GetFNew(idx), value(field.GetSite(i).GetGlobalSiteCoords(), d));
+	  }
+      };
+      forSites([](distribn_t& fOld, distribn_t& fNew, distribn_t v) {
+	fOld = fNew = v;
+      });
+
+      // Make the ranks take different times.
+      master->ForceRebalance(1.0 + Comms().Rank());
+      forSites([](distribn_t& fOld, distribn_t& fNew, distribn_t v) {
+	REQUIRE(fOld == v);
+	REQUIRE(fNew == v);
+      });
+      auto const sites = Comms().AllGather(master->GetFieldData().GetDomain().GetLocalFluidSiteCount());
+      site_t total = 0;
+      for (auto n: sites) {
+	REQUIRE(n > 0);
+	total += n;
+      }
+      REQUIRE(total == 64);
+
+      // TODO: This test is fatal if run with LADDIOLET. See ticket #605.
+      LADD_FAIL();
+      master->RunSimulation();
+      for (auto&& p: {"results/report.txt", "results/report.xml"}) {
+	INFO(p);
+	REQUIRE(fs::exists(p));
+      }
+    }
+
   }
 }
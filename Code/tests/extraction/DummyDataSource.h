@@ -6,6 +6,7 @@
 #ifndef HEMELB_TESTS_EXTRACTION_DUMMYDATASOURCE_H
 #define HEMELB_TESTS_EXTRACTION_DUMMYDATASOURCE_H
 
+#include <algorithm>
 #include <vector>
 
 #include "util/Vector3D.h"
@@ -55,6 +56,13 @@ namespace hemelb::tests
 
           }
 
+          // Reverse the order of the sites, as if they had been
+          // redistributed.
+          void Reverse()
+          {
+            std::reverse(gridPositions.begin(), gridPositions.end());
+          }
+
           void Reset()
           {
             location = 0 - 1;
@@ -66,6 +74,12 @@ namespace hemelb::tests
             return location < siteCount;
           }
 
+          bool ReadAt(site_t index) override
+          {
+            location = index;
+            return location < siteCount;
+          }
+
           hemelb::util::Vector3D<site_t> GetPosition() const
           {
             return gridPositions[location];
@@ -0,0 +1,265 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "io/Hdf5.h"
+#include "io/formats/hdf5.h"
+#include "extraction/PropertyOutputFile.h"
+#include "extraction/OutputField.h"
+#include "extraction/WholeGeometrySelector.h"
+#include "extraction/Hdf5PropertyOutput.h"
+#include "extraction/LbDataSourceIterator.h"
+#include "extraction/LocalDistributionInput.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+#include "util/UnitConverter.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+#include "tests/helpers/FourCubeLatticeData.h"
+#include "tests/extraction/DummyDataSource.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      const char* tempH5FileName = "simple.h5";
+      const char* tempXdmfFileName = "simple.xdmf";
+      constexpr double REFERENCE_PRESSURE_mmHg = 8.0;
+
+      template <typename T>
+      Approx apprx(T&& x) {
+	return Approx(std::forward<T>(x)).epsilon(1e-5);
+      }
+
+      // Read all of a dataset, checking its shape.
+      template <typename T>
+      std::vector<T> ReadDataset(hid_t file, std::string const& name, std::vector<hsize_t> const& shape) {
+	io::hdf5::Id ds(H5Dopen(file, name.c_str(), H5P_DEFAULT), name);
+	io::hdf5::Id space(H5Dget_space(ds), name);
+	std::vector<hsize_t> dims(H5Sget_simple_extent_ndims(space));
+	H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+	REQUIRE(dims == shape);
+
+	std::vector<T> ans(H5Sget_simple_extent_npoints(space));
+	io::hdf5::Id type(H5Tget_native_type(io::hdf5::LittleEndianType<T>(), H5T_DIR_ASCEND), name);
+	io::hdf5::Check(H5Dread(ds, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, ans.data()), name);
+	return ans;
+      }
+
+      // Every rank has the same dummy data, so this shares its planes
+      // of constant x amongst the ranks, in order. With more than one
+      // rank, the last has no sites, which must still work.
+      class RankPlanesSelector : public extraction::GeometrySelector
+      {
+	int rank;
+	int writers;
+      public:
+	RankPlanesSelector(net::MpiCommunicator const& comms) :
+	  rank(comms.Rank()), writers(std::max(1, comms.Size() - 1))
+	{
+	}
+
+	GeometrySelector* clone() const override
+	{
+	  return new RankPlanesSelector(*this);
+	}
+
+      protected:
+	bool IsWithinGeometry(const extraction::IterableDataSource&,
+			      const util::Vector3D<site_t>& location) const override
+	{
+	  return location.x() * writers / 4 == rank;
+	}
+      };
+    }
+
+    // Errors are reported by Flush, not on destruction.
+    static_assert(std::is_nothrow_destructible_v<extraction::PropertyOutput>);
+    static_assert(std::is_nothrow_destructible_v<extraction::Hdf5PropertyOutput>);
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "Hdf5PropertyOutput") {
+      namespace h5fmt = io::formats::hdf5;
+      // The code won't overwrite any existing file
+      if (Comms().OnIORank()) {
+	std::remove(tempH5FileName);
+	std::remove(tempXdmfFileName);
+      }
+      Comms().Barrier();
+
+      auto simpleOutFile = extraction::PropertyOutputFile{tempH5FileName, 100, util::make_clone_ptr<RankPlanesSelector>(Comms())};
+      simpleOutFile.hdf5 = true;
+#if H5_VERSION_GE(1, 10, 2)
+      // Compression must not change what is read back.
+      simpleOutFile.compression = GENERATE(0U, 4U);
+#endif
+
+      extraction::OutputField pressure{"Pressure", extraction::source::Pressure{}, float{0}, 1, {REFERENCE_PRESSURE_mmHg}};
+      simpleOutFile.fields.push_back(pressure);
+      extraction::OutputField velocity{"Velocity", extraction::source::Velocity{}, float{0}, 0};
+      simpleOutFile.fields.push_back(velocity);
+
+      auto simpleDataSource = std::make_unique<DummyDataSource>();
+      {
+	auto propertyWriter = std::make_unique<extraction::Hdf5PropertyOutput>(*simpleDataSource, simpleOutFile, Comms());
+	for (unsigned long t: {100, 150, 200}) {
+	  simpleDataSource->FillFields();
+	  // 150 is not a multiple of the period, so isn't written.
+	  propertyWriter->Write(t, 9999);
+	}
+	propertyWriter->Flush();
+      }
+
+      auto file = io::hdf5::OpenFile(tempH5FileName, Comms());
+      std::size_t const n = 64;
+
+      // The signature, by which checkpoints are recognised.
+      {
+	std::ifstream raw(tempH5FileName, std::ios::binary);
+	std::array<char, h5fmt::Signature.size()> signature;
+	raw.read(signature.data(), signature.size());
+	REQUIRE(signature == h5fmt::Signature);
+      }
+
+      auto const times = ReadDataset<std::uint64_t>(file, "0/time", {2});
+      REQUIRE(times == std::vector<std::uint64_t>{100, 200});
+
+      auto const grid = ReadDataset<std::uint32_t>(file, "0/grid", {n, 3});
+      auto const coords = ReadDataset<double>(file, "0/coordinates", {n, 3});
+      auto const pressures = ReadDataset<float>(file, "0/Pressure", {2, n});
+      auto const velocities = ReadDataset<float>(file, "0/Velocity", {2, n, 3});
+
+      // The second timestep's data are in the source, and the ranks'
+      // sites are in their order.
+      double const voxel = simpleDataSource->GetVoxelSize();
+      auto const& origin = simpleDataSource->GetOrigin();
+      simpleDataSource->Reset();
+      for (std::size_t i = 0; simpleDataSource->ReadNext(); ++i) {
+	LatticeVector const pos = simpleDataSource->GetPosition();
+	for (int j = 0; j < 3; ++j) {
+	  REQUIRE(grid[3 * i + j] == pos[j]);
+	  REQUIRE(apprx(origin[j] + voxel * pos[j]) == coords[3 * i + j]);
+	}
+
+	REQUIRE(apprx(simpleDataSource->GetPressure()) == REFERENCE_PRESSURE_mmHg + double{pressures[n + i]});
+
+	auto const vel = simpleDataSource->GetVelocity();
+	for (int j = 0; j < 3; ++j)
+	  REQUIRE(apprx(vel[j]) == velocities[3 * (n + i) + j]);
+      }
+
+      // There is one grid of the XDMF collection per timestep, each
+      // picking its row of the fields.
+      Comms().Barrier();
+      {
+	std::ifstream xdmf(tempXdmfFileName);
+	std::stringstream contents;
+	contents << xdmf.rdbuf();
+	auto const text = contents.str();
+	REQUIRE(text.find("<Grid Name=\"100\"") != std::string::npos);
+	REQUIRE(text.find("<Grid Name=\"150\"") == std::string::npos);
+	REQUIRE(text.find("<Grid Name=\"200\"") != std::string::npos);
+	REQUIRE(text.find("simple.h5:/0/Velocity") != std::string::npos);
+	REQUIRE(text.find(">1 0 0 1 1 1 1 64 3<") != std::string::npos);
+	REQUIRE(text.ends_with("</Xdmf>\n"));
+      }
+
+      file.Close();
+      Comms().Barrier();
+      if (Comms().OnIORank()) {
+	std::remove(tempH5FileName);
+	std::remove(tempXdmfFileName);
+      }
+    }
+
+    // A checkpoint written as HDF5 must load back into the same
+    // decomposition. The four cube's sites are all on rank zero, so
+    // any other ranks have none.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "Hdf5CheckpointRoundTrip") {
+      const char* checkpointName = "checkpoint.h5";
+      if (Comms().OnIORank()) {
+	std::remove(checkpointName);
+	std::remove("checkpoint.xdmf");
+      }
+      Comms().Barrier();
+
+      auto latDat = std::unique_ptr<FourCubeLatticeData>{FourCubeLatticeData::Create(Comms(), 6, Comms().Size())};
+      auto& dom = latDat->GetDomain();
+      auto const Q = dom.GetLatticeInfo().GetNumVectors();
+      auto const nSites = dom.GetLocalFluidSiteCount();
+      // Distinct values for every site, direction and timestep.
+      auto value = [](site_t site, unsigned i, unsigned t) {
+	return 0.001 * site + 1e-6 * i + t;
+      };
+      auto fill = [&](unsigned t) {
+	for (site_t site = 0; site < nSites; ++site)
+	  for (unsigned i = 0; i < Q; ++i)
+	    *latDat->GetFOld(dom.GetDistributionIndex(site, i)) = value(site, i, t);
+      };
+
+      auto simState = lb::SimulationState{60.0 / (70.0 * 5000.0), 1000};
+      auto propertyCache = lb::MacroscopicPropertyCache(simState, dom);
+      auto unitConverter = std::make_shared<util::UnitConverter>(simState.GetTimeStepLength(), 0.01,
+								 PhysicalPosition::Zero(),
+								 DEFAULT_FLUID_DENSITY_Kg_per_m3, 0.0);
+      auto dataSource = extraction::LbDataSourceIterator(propertyCache, *latDat, Comms().Rank(), unitConverter);
+
+      auto checkpointFile = extraction::PropertyOutputFile{checkpointName, 10, util::make_clone_ptr<extraction::WholeGeometrySelector>()};
+      checkpointFile.hdf5 = true;
+      checkpointFile.fields.push_back(extraction::OutputField{"distributions", extraction::source::Distributions{}, distribn_t{0}, 0});
+      {
+	extraction::Hdf5PropertyOutput output(dataSource, checkpointFile, Comms());
+	for (unsigned t: {10, 20, 30}) {
+	  fill(t);
+	  output.Write(t, 100);
+	}
+	output.Flush();
+      }
+
+      auto load = [&](std::optional<LatticeTimeStep> target) {
+	fill(999);
+	extraction::LocalDistributionInput input(checkpointName, std::nullopt, Comms());
+	input.LoadDistribution(latDat.get(), target);
+	return target;
+      };
+      auto check = [&](unsigned t) {
+	for (site_t site = 0; site < nSites; ++site)
+	  for (unsigned i = 0; i < Q; ++i) {
+	    REQUIRE(*latDat->GetFOld(dom.GetDistributionIndex(site, i)) == value(site, i, t));
+	    REQUIRE(*latDat->GetFNew(dom.GetDistributionIndex(site, i)) == value(site, i, t));
+	  }
+      };
+
+      SECTION("Chosen timestep") {
+	REQUIRE(load(20) == 20U);
+	check(20);
+      }
+
+      SECTION("Last timestep") {
+	REQUIRE(load(std::nullopt) == 30U);
+	check(30);
+      }
+
+      SECTION("Missing timestep") {
+	REQUIRE_THROWS(load(25));
+      }
+
+      Comms().Barrier();
+      if (Comms().OnIORank()) {
+	std::remove(checkpointName);
+	std::remove("checkpoint.xdmf");
+      }
+    }
+  }
+}
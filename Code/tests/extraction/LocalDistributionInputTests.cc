@@ -0,0 +1,115 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+#include <memory>
+#include <optional>
+
+#include <catch2/catch.hpp>
+
+#include "io/formats/extraction.h"
+#include "extraction/PropertyOutputFile.h"
+#include "extraction/OutputField.h"
+#include "extraction/WholeGeometrySelector.h"
+#include "extraction/LocalPropertyOutput.h"
+#include "extraction/LbDataSourceIterator.h"
+#include "extraction/LocalDistributionInput.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+#include "util/UnitConverter.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+#include "tests/helpers/FourCubeLatticeData.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    // A version 6 checkpoint, as written by LocalPropertyOutput,
+    // must load back into the same decomposition. The four cube's
+    // sites are all on rank zero, so any other ranks have none.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "LocalDistributionInput") {
+      namespace xtr = io::formats::extraction;
+      const char* checkpointName = "checkpoint.xtr";
+      if (Comms().OnIORank())
+	std::remove(checkpointName);
+      Comms().Barrier();
+
+      auto latDat = std::unique_ptr<FourCubeLatticeData>{FourCubeLatticeData::Create(Comms(), 6, Comms().Size())};
+      auto& dom = latDat->GetDomain();
+      auto const Q = dom.GetLatticeInfo().GetNumVectors();
+      auto const nSites = dom.GetLocalFluidSiteCount();
+      // Distinct values for every site, direction and timestep.
+      auto value = [](site_t site, unsigned i, unsigned t) {
+	return 0.001 * site + 1e-6 * i + t;
+      };
+      // Set what is output, which with in-place (AA) streaming is
+      // fNew, as this step's fOld has been overwritten by then.
+      auto fill = [&](unsigned t) {
+	for (site_t site = 0; site < nSites; ++site)
+	  for (unsigned i = 0; i < Q; ++i)
+	    *(geometry::SINGLE_BUFFER_STREAMING
+	      ? latDat->GetFNew(latDat->GetFNewIndex(site, i))
+	      : latDat->GetFOld(dom.GetDistributionIndex(site, i))) = value(site, i, t);
+      };
+
+      auto simState = lb::SimulationState{60.0 / (70.0 * 5000.0), 1000};
+      auto propertyCache = lb::MacroscopicPropertyCache(simState, dom);
+      auto unitConverter = std::make_shared<util::UnitConverter>(simState.GetTimeStepLength(), 0.01,
+								 PhysicalPosition::Zero(),
+								 DEFAULT_FLUID_DENSITY_Kg_per_m3, 0.0);
+      auto dataSource = extraction::LbDataSourceIterator(propertyCache, *latDat, Comms().Rank(), unitConverter);
+
+      auto checkpointFile = extraction::PropertyOutputFile{checkpointName, 10, util::make_clone_ptr<extraction::WholeGeometrySelector>()};
+      checkpointFile.format_version = xtr::VersionNumber;
+      checkpointFile.fields.push_back(extraction::OutputField{"distributions", extraction::source::Distributions{}, distribn_t{0}, 0});
+      {
+	extraction::LocalPropertyOutput output(dataSource, checkpointFile, Comms());
+	for (unsigned t: {10, 20, 30}) {
+	  fill(t);
+	  output.Write(t, 100);
+	  // Taking the sites again starts a new position table, which
+	  // the later timesteps must be read with.
+	  if (t == 10)
+	    output.SetDataSource(dataSource);
+	}
+	output.Flush();
+      }
+
+      auto load = [&](std::optional<LatticeTimeStep> target) {
+	fill(999);
+	extraction::LocalDistributionInput input(checkpointName, std::nullopt, Comms());
+	input.LoadDistribution(latDat.get(), target);
+	return target;
+      };
+      auto check = [&](unsigned t) {
+	for (site_t site = 0; site < nSites; ++site)
+	  for (unsigned i = 0; i < Q; ++i) {
+	    REQUIRE(*latDat->GetFOld(dom.GetDistributionIndex(site, i)) == value(site, i, t));
+	    REQUIRE(*latDat->GetFNew(dom.GetDistributionIndex(site, i)) == value(site, i, t));
+	  }
+      };
+
+      SECTION("Chosen timestep") {
+	unsigned const t = GENERATE(10U, 20U);
+	REQUIRE(load(t) == t);
+	check(t);
+      }
+
+      SECTION("Last timestep") {
+	REQUIRE(load(std::nullopt) == 30U);
+	check(30);
+      }
+
+      SECTION("Missing timestep") {
+	REQUIRE_THROWS(load(25));
+      }
+
+      Comms().Barrier();
+      if (Comms().OnIORank())
+	std::remove(checkpointName);
+    }
+  }
+}
@@ -5,6 +5,8 @@
 
 #include <string>
 #include <cstdio>
+#include <vector>
+#include <type_traits>
 
 #include <catch2/catch.hpp>
 
@@ -15,6 +17,7 @@
 #include "extraction/OutputField.h"
 #include "extraction/WholeGeometrySelector.h"
 #include "extraction/LocalPropertyOutput.h"
+#include "resources/Resource.h"
 
 #include "tests/helpers/HasCommsTestFixture.h"
 #include "tests/extraction/DummyDataSource.h"
@@ -144,6 +147,11 @@ namespace hemelb
       }
 
       SECTION("Write") {
+	// The file must be the same whether or not the writes are
+	// left to finish in the background.
+	simpleOutFile.async_buffers = GENERATE(0U, 2U);
+	// Nor should it matter which rank does the writing.
+	simpleOutFile.ranks_per_writer = GENERATE(1U, 0U);
 	// Create the writer object; this should write the headers.
 	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, simpleOutFile, Comms());
 	// Open the file
@@ -215,6 +223,7 @@ namespace hemelb
 	simpleDataSource->FillFields();
 	// Write it
 	propertyWriter->Write(0, 9999);
+	propertyWriter->Flush();
 
 	CheckDataWriting(simpleDataSource.get(), 0, writtenFile);
 
@@ -224,6 +233,7 @@ namespace hemelb
 	propertyWriter->Write(10, 9999);
 	// This SHOULD write
 	propertyWriter->Write(100, 9999);
+	propertyWriter->Flush();
 
 	// The previous call to CheckDataWriting() sets the EOF indicator in writtenFile,
 	// the previous call to Write() ought to unset it but it isn't working properly in
@@ -233,6 +243,117 @@ namespace hemelb
 	CheckDataWriting(simpleDataSource.get(), 100, writtenFile);
       }
 
+      SECTION("Write version 6") {
+	namespace xtr = io::formats::extraction;
+	simpleOutFile.format_version = xtr::VersionNumber;
+	simpleOutFile.ranks_per_writer = GENERATE(1U, 0U);
+	// With asynchronous output, both timesteps are still on their
+	// way to (or waiting at) the writer until the flush.
+	simpleOutFile.async_buffers = GENERATE(0U, 2U);
+	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, simpleOutFile, Comms());
+	for (unsigned long t: {100, 200}) {
+	  simpleDataSource->FillFields();
+	  propertyWriter->Write(t, 9999);
+	}
+	propertyWriter->Flush();
+
+	// The headers only differ from version 5 in the version number
+	// but the rest is little-endian.
+	std::size_t const n = 64;
+	std::size_t const headerLength = xtr::MainHeaderLength + fieldHeaderLength;
+	std::size_t const tableLength = 8 + 12 * n;
+	std::size_t const recordLength = 8 + (4 + 12) * n;
+	std::vector<char> contents(headerLength + tableLength + 2 * recordLength);
+	auto writtenFile = io::FILE::open(simpleOutFile.filename, "r");
+	// Attempt to read one extra byte, to make sure we aren't under-reading
+	REQUIRE(writtenFile.read(contents.data(), 1, contents.size() + 1) == contents.size());
+	REQUIRE(contents[11] == 6);
+
+	// The positions come once, first.
+	char const* table = contents.data() + headerLength;
+	REQUIRE(xtr::FromLittleEndian<std::uint64_t>(table) == xtr::PositionTableTag);
+	// The second timestep's data are in the source.
+	char const* record = table + tableLength + recordLength;
+	REQUIRE(xtr::FromLittleEndian<std::uint64_t>(record) == 200);
+	char const* pressures = record + 8;
+	char const* velocities = pressures + 4 * n;
+
+	simpleDataSource->Reset();
+	for (std::size_t i = 0; simpleDataSource->ReadNext(); ++i) {
+	  LatticeVector const grid = simpleDataSource->GetPosition();
+	  for (int j = 0; j < 3; ++j)
+	    REQUIRE(xtr::FromLittleEndian<std::uint32_t>(table + 8 + 12 * i + 4 * j) == grid[j]);
+
+	  auto const pressure = xtr::FromLittleEndian<float>(pressures + 4 * i);
+	  REQUIRE(apprx(simpleDataSource->GetPressure()) == REFERENCE_PRESSURE_mmHg + double{pressure});
+
+	  auto const velocity = simpleDataSource->GetVelocity();
+	  for (int j = 0; j < 3; ++j)
+	    REQUIRE(apprx(velocity[j]) == xtr::FromLittleEndian<float>(velocities + 12 * i + 4 * j));
+	}
+      }
+
+      SECTION("Write version 6 after redistribution") {
+	namespace xtr = io::formats::extraction;
+	simpleOutFile.format_version = xtr::VersionNumber;
+	simpleOutFile.ranks_per_writer = GENERATE(1U, 0U);
+	simpleOutFile.async_buffers = GENERATE(0U, 2U);
+	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, simpleOutFile, Comms());
+	simpleDataSource->FillFields();
+	propertyWriter->Write(100, 9999);
+	simpleDataSource->Reverse();
+	propertyWriter->SetDataSource(*simpleDataSource);
+	simpleDataSource->FillFields();
+	propertyWriter->Write(200, 9999);
+	propertyWriter->Flush();
+
+	// The positions are written again before the timesteps in the
+	// new order.
+	std::size_t const n = 64 * Comms().Size();
+	std::size_t const headerLength = xtr::MainHeaderLength + fieldHeaderLength;
+	std::size_t const tableLength = 8 + 12 * n;
+	std::size_t const recordLength = 8 + (4 + 12) * n;
+	std::vector<char> contents(headerLength + 2 * (tableLength + recordLength));
+	auto writtenFile = io::FILE::open(simpleOutFile.filename, "r");
+	REQUIRE(writtenFile.read(contents.data(), 1, contents.size() + 1) == contents.size());
+
+	char const* first = contents.data() + headerLength;
+	char const* second = first + tableLength + recordLength;
+	REQUIRE(xtr::FromLittleEndian<std::uint64_t>(first) == xtr::PositionTableTag);
+	REQUIRE(xtr::FromLittleEndian<std::uint64_t>(first + tableLength) == 100);
+	REQUIRE(xtr::FromLittleEndian<std::uint64_t>(second) == xtr::PositionTableTag);
+	REQUIRE(xtr::FromLittleEndian<std::uint64_t>(second + tableLength) == 200);
+	// Every rank has the same sites, so the last rank's come last.
+	simpleDataSource->Reset();
+	for (std::size_t i = n - 64; simpleDataSource->ReadNext(); ++i) {
+	  LatticeVector const grid = simpleDataSource->GetPosition();
+	  for (int j = 0; j < 3; ++j) {
+	    REQUIRE(xtr::FromLittleEndian<std::uint32_t>(first + 8 + 12 * i + 4 * j) == 3 - grid[j]);
+	    REQUIRE(xtr::FromLittleEndian<std::uint32_t>(second + 8 + 12 * i + 4 * j) == grid[j]);
+	  }
+	}
+
+	// This is the file the Python tools are tested with.
+	if (Comms().Size() == 1) {
+	  std::vector<char> expected(contents.size());
+	  auto expectedFile = io::FILE::open(resources::Resource("dummy_v6.xtr").Path(), "r");
+	  REQUIRE(expectedFile.read(expected.data(), 1, expected.size() + 1) == expected.size());
+	  REQUIRE(contents == expected);
+	}
+      }
+
+      SECTION("Destroy before flushing") {
+	// Flushing is the owner's job, as it is collective and can
+	// fail; destruction waits for this rank's writes but mustn't
+	// throw.
+	static_assert(std::is_nothrow_destructible_v<extraction::LocalPropertyOutput>);
+	simpleOutFile.async_buffers = 2;
+	simpleOutFile.ranks_per_writer = GENERATE(1U, 0U);
+	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, simpleOutFile, Comms());
+	simpleDataSource->FillFields();
+	propertyWriter->Write(100, 9999);
+	REQUIRE_NOTHROW(propertyWriter.reset());
+      }
 
       // tearDown
 
@@ -0,0 +1,96 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <array>
+#include <set>
+#include <span>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "geometry/DistributionLayout.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry;
+
+    // Every (site, direction) pair must map to a distinct slot within
+    // the first Q * Stride(N) entries.
+    template <distribution_layout L>
+    void CheckBijective(site_t N, unsigned Q) {
+        auto const stride = L::Stride(N);
+        REQUIRE(stride >= N);
+        std::set<site_t> seen;
+        for (site_t s = 0; s < N; ++s)
+            for (Direction d = 0; d < Q; ++d) {
+                auto const idx = L::Index(s, d, Q, stride);
+                REQUIRE(idx >= 0);
+                REQUIRE(idx < Q * stride);
+                REQUIRE(seen.insert(idx).second);
+            }
+    }
+
+    TEST_CASE("DistributionLayout - site-major", "[geometry]") {
+        using L = SiteMajorLayout;
+        STATIC_REQUIRE(L::SITE_CONTIGUOUS);
+        REQUIRE(L::Stride(13) == 13);
+        REQUIRE(L::Index(2, 3, 19, L::Stride(13)) == 2 * 19 + 3);
+        CheckBijective<L>(GENERATE(1, 7, 16, 33), GENERATE(15u, 19u, 27u));
+    }
+
+    TEST_CASE("DistributionLayout - direction-major", "[geometry]") {
+        using L = DirectionMajorLayout;
+        STATIC_REQUIRE(!L::SITE_CONTIGUOUS);
+        REQUIRE(L::Stride(0) == 0);
+        REQUIRE(L::Stride(1) == L::PADDING);
+        REQUIRE(L::Stride(L::PADDING) == L::PADDING);
+        REQUIRE(L::Stride(L::PADDING + 1) == 2 * L::PADDING);
+        auto const stride = L::Stride(13);
+        REQUIRE(L::Index(2, 3, 19, stride) == 3 * stride + 2);
+        CheckBijective<L>(GENERATE(1, 7, 16, 33), GENERATE(15u, 19u, 27u));
+    }
+
+    TEST_CASE("DistributionLayout - strided view", "[geometry]") {
+        constexpr std::size_t Q = 5;
+        constexpr site_t stride = 4;
+        std::vector<distribn_t> data(Q * stride);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = i;
+
+        StridedDistSpan<distribn_t, Q> view(&data[1], stride);
+        REQUIRE(view.size() == Q);
+        for (std::size_t d = 0; d < Q; ++d)
+            REQUIRE(view[d] == distribn_t(1 + d * stride));
+
+        view[2] = -1.0;
+        REQUIRE(data[1 + 2 * stride] == -1.0);
+
+        StridedDistSpan<const distribn_t, Q> cview = view;
+        auto const copy = Contiguous(cview);
+        for (std::size_t d = 0; d < Q; ++d)
+            REQUIRE(copy[d] == cview[d]);
+    }
+
+    TEST_CASE("DistributionLayout - indirect view", "[geometry]") {
+        constexpr std::size_t Q = 4;
+        std::vector<distribn_t> data{10, 11, 12, 13, 14, 15};
+
+        IndirectDistSpan<distribn_t, Q> view(data.data(), {5, 0, 3, 1});
+        REQUIRE(view[0] == 15);
+        REQUIRE(view[2] == 13);
+        view[1] = -1.0;
+        REQUIRE(data[0] == -1.0);
+
+        // Contiguous data, e.g. a copy of a site from another rank.
+        std::array<distribn_t, Q> neighbour{1, 2, 3, 4};
+        IndirectDistSpan<const distribn_t, Q> nview = std::span<distribn_t, Q>(neighbour);
+        for (std::size_t d = 0; d < Q; ++d)
+            REQUIRE(nview[d] == neighbour[d]);
+
+        IndirectDistSpan<const distribn_t, Q> cview = view;
+        auto const copy = Contiguous(cview);
+        for (std::size_t d = 0; d < Q; ++d)
+            REQUIRE(copy[d] == view[d]);
+    }
+}
@@ -3,13 +3,32 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <vector>
+
+#include <zlib.h>
+#ifdef HEMELB_USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef HEMELB_USE_ZSTD
+#include <zstd.h>
+#endif
 
 #include <catch2/catch.hpp>
 
+#include "build_info.h"
 #include "configuration/SimConfig.h"
 #include "geometry/Domain.h"
 #include "geometry/GeometryReader.h"
+#include "geometry/decomposition/DecompositionCache.h"
+#include "io/formats/decomposition.h"
+#include "io/formats/geometry.h"
+#include "io/readers/XdrMemReader.h"
+#include "io/writers/XdrVectorWriter.h"
 #include "lb/lattices/D3Q15.h"
 #include "reporting/Timers.h"
 #include "resources/Resource.h"
@@ -23,6 +42,85 @@ namespace hemelb
 {
   namespace tests
   {
+    namespace {
+      using gmy = io::formats::geometry;
+
+      // Write a copy of a (zlib) GMY file with the blocks' data
+      // encoded with another codec, as the geometry tool would.
+      void Reencode(std::filesystem::path const& from, std::filesystem::path const& to, gmy::Codec codec)
+      {
+	std::ifstream in(from, std::ios::binary);
+	std::vector<char> const file{std::istreambuf_iterator<char>(in), {}};
+
+	io::XdrMemReader preamble(file.data(), gmy::PreambleLength);
+	std::array<std::uint32_t, 8> words;
+	for (auto& w: words)
+	  preamble.read(w);
+	REQUIRE(words[7] == std::uint32_t(gmy::Codec::ZLIB));
+	auto const nBlocks = std::size_t(words[3]) * words[4] * words[5];
+
+	io::XdrMemReader header(file.data() + gmy::PreambleLength, nBlocks * gmy::HeaderRecordLength);
+	io::XdrVectorWriter newPreamble(gmy::PreambleLength);
+	for (int i = 0; i < 7; ++i)
+	  newPreamble << words[i];
+	newPreamble << std::uint32_t(codec);
+	io::XdrVectorWriter newHeader(nBlocks * gmy::HeaderRecordLength);
+	std::vector<char> newData;
+
+	auto data = file.data() + gmy::PreambleLength + nBlocks * gmy::HeaderRecordLength;
+	for (std::size_t b = 0; b < nBlocks; ++b) {
+	  std::uint32_t sites, bytes, uncompressedBytes;
+	  header.read(sites);
+	  header.read(bytes);
+	  header.read(uncompressedBytes);
+
+	  std::vector<char> block(uncompressedBytes);
+	  std::vector<char> encoded;
+	  if (bytes) {
+	    uLongf n = block.size();
+	    REQUIRE(uncompress(reinterpret_cast<Bytef*>(block.data()), &n,
+			       reinterpret_cast<Bytef const*>(data), bytes) == Z_OK);
+	    REQUIRE(n == uncompressedBytes);
+	    switch (codec) {
+	    case gmy::Codec::ZLIB: {
+	      uLongf m = compressBound(block.size());
+	      encoded.resize(m);
+	      REQUIRE(compress2(reinterpret_cast<Bytef*>(encoded.data()), &m,
+				reinterpret_cast<Bytef const*>(block.data()), block.size(), 9) == Z_OK);
+	      encoded.resize(m);
+	      break;
+	    }
+	    case gmy::Codec::NONE:
+	      encoded = block;
+	      break;
+	    case gmy::Codec::LZ4:
+#ifdef HEMELB_USE_LZ4
+	      encoded.resize(LZ4_compressBound(block.size()));
+	      encoded.resize(LZ4_compress_default(block.data(), encoded.data(), block.size(), encoded.size()));
+	      REQUIRE(!encoded.empty());
+#endif
+	      break;
+	    case gmy::Codec::ZSTD:
+#ifdef HEMELB_USE_ZSTD
+	      encoded.resize(ZSTD_compressBound(block.size()));
+	      encoded.resize(ZSTD_compress(encoded.data(), encoded.size(), block.data(), block.size(), 19));
+	      REQUIRE(!encoded.empty());
+#endif
+	      break;
+	    }
+	  }
+	  data += bytes;
+	  newHeader << sites << std::uint32_t(encoded.size()) << uncompressedBytes;
+	  newData.insert(newData.end(), encoded.begin(), encoded.end());
+	}
+
+	std::ofstream out(to, std::ios::binary);
+	out.write(newPreamble.GetBuf().data(), newPreamble.GetBuf().size());
+	out.write(newHeader.GetBuf().data(), newHeader.GetBuf().size());
+	out.write(newData.data(), newData.size());
+      }
+    }
+
     TEST_CASE_METHOD(helpers::FolderTestFixture, "GeometryReaderTests") {
       auto timings = std::make_unique<reporting::Timers>(Comms());
       
@@ -75,6 +173,143 @@ namespace hemelb
 
       }
 
+      SECTION("TestDecompositionCache") {
+        LADD_FAIL();
+        // Keep the cache in the temporary directory, so no later run
+        // can pick up a stale one.
+        auto const cachePath = GetTempdir() / "four_cube.gmy.decomp";
+        // The first read decomposes and writes the cache...
+        auto decomposed = reader->LoadAndDecompose(simConfig->GetDataFilePath(), cachePath);
+        REQUIRE(std::filesystem::exists(cachePath));
+
+        // ... which the second reads instead.
+        geometry::GeometryReader cachedReader(lb::D3Q15::GetLatticeInfo(), *timings, Comms());
+        auto cached = cachedReader.LoadAndDecompose(simConfig->GetDataFilePath(), cachePath);
+
+        REQUIRE(cached.Blocks.size() == decomposed.Blocks.size());
+        auto const rank = Comms().Rank();
+        for (auto const& [b, block]: decomposed.Blocks) {
+          auto const expected = block.Sites;
+          auto const actual = cached.Blocks[b].Sites;
+          for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (expected[i].targetProcessor == rank) {
+              REQUIRE(actual.size() == expected.size());
+              REQUIRE(actual[i].targetProcessor == rank);
+            }
+          }
+          for (std::size_t i = 0; i < actual.size(); ++i) {
+            if (actual[i].targetProcessor == rank) {
+              REQUIRE(expected.size() == actual.size());
+              REQUIRE(expected[i].targetProcessor == rank);
+            }
+          }
+        }
+
+        Comms().Barrier();
+        if (Comms().OnIORank())
+          std::filesystem::remove(cachePath);
+      }
+
+      SECTION("TestDecompositionCacheMode") {
+        LADD_FAIL();
+        using geometry::decomposition::DecompositionCache;
+        auto const cachePath = GetTempdir() / "four_cube.gmy.decomp";
+        // The decomposition fingerprint in the cache's header, which
+        // is rewritten whenever the cache isn't used.
+        auto writtenMode = [&]() {
+          Comms().Barrier();
+          std::ifstream file(cachePath, std::ios::binary);
+          std::vector<char> header(io::formats::decomposition::HeaderLength);
+          file.read(header.data(), header.size());
+          return io::XdrMemReader(header.data() + header.size() - 8, 8).read<std::uint64_t>();
+        };
+
+        reader->LoadAndDecompose(simConfig->GetDataFilePath(), cachePath);
+        auto const flat = writtenMode();
+        REQUIRE(flat == DecompositionCache::DecompositionFingerprint(false, Comms()));
+
+        // A hierarchical decomposition doesn't use the flat one's
+        // cache, nor the other way round.
+        geometry::GeometryReader hierarchicalReader(lb::D3Q15::GetLatticeInfo(), *timings, Comms());
+        hierarchicalReader.SetHierarchicalDecomposition(true);
+        hierarchicalReader.LoadAndDecompose(simConfig->GetDataFilePath(), cachePath);
+        auto const hierarchical = writtenMode();
+        REQUIRE(hierarchical == DecompositionCache::DecompositionFingerprint(true, Comms()));
+        REQUIRE(hierarchical != flat);
+
+        geometry::GeometryReader flatReader(lb::D3Q15::GetLatticeInfo(), *timings, Comms());
+        flatReader.LoadAndDecompose(simConfig->GetDataFilePath(), cachePath);
+        REQUIRE(writtenMode() == flat);
+
+        Comms().Barrier();
+        if (Comms().OnIORank())
+          std::filesystem::remove(cachePath);
+      }
+
+    }
+
+    // Nor is a hierarchical decomposition's cache used with the ranks
+    // spread over the nodes differently.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "DecompositionCacheNodeLayout") {
+      using geometry::decomposition::DecompositionCache;
+      net::IOCommunicator const oneNode(Comms(), Comms().Split(0));
+      net::IOCommunicator const nodePerRank(Comms(), Comms().Split(Comms().Rank()));
+      auto const one = DecompositionCache::DecompositionFingerprint(true, oneNode);
+      auto const each = DecompositionCache::DecompositionFingerprint(true, nodePerRank);
+      if (Comms().Size() > 1)
+        REQUIRE(one != each);
+      else
+        REQUIRE(one == each);
+      // Which doesn't matter to a flat decomposition.
+      REQUIRE(DecompositionCache::DecompositionFingerprint(false, oneNode)
+              == DecompositionCache::DecompositionFingerprint(false, nodePerRank));
+    }
+
+    // The geometry must read the same whichever codec its blocks are
+    // stored with.
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "GeometryReaderCodecs") {
+      LADD_FAIL();
+      auto timings = std::make_unique<reporting::Timers>(Comms());
+      CopyResourceToTempdir("four_cube.gmy");
+
+      std::vector<gmy::Codec> codecs{gmy::Codec::ZLIB, gmy::Codec::NONE};
+      if constexpr (build_info::USE_LZ4)
+	codecs.push_back(gmy::Codec::LZ4);
+      if constexpr (build_info::USE_ZSTD)
+	codecs.push_back(gmy::Codec::ZSTD);
+      auto const codec = GENERATE_COPY(from_range(codecs));
+      CAPTURE(unsigned(codec));
+
+      if (Comms().OnIORank())
+	Reencode("four_cube.gmy", "four_cube_codec.gmy", codec);
+      Comms().Barrier();
+
+      geometry::GeometryReader zlibReader(lb::D3Q15::GetLatticeInfo(), *timings, Comms());
+      auto const expected = zlibReader.LoadAndDecompose("four_cube.gmy");
+      geometry::GeometryReader reader(lb::D3Q15::GetLatticeInfo(), *timings, Comms());
+      auto const actual = reader.LoadAndDecompose("four_cube_codec.gmy");
+
+      REQUIRE(actual.GetBlockCount() == expected.GetBlockCount());
+      for (site_t b = 0; b < expected.GetBlockCount(); ++b) {
+	auto const expectedSites = expected.Blocks[b].Sites;
+	auto const actualSites = actual.Blocks[b].Sites;
+	REQUIRE(actualSites.size() == expectedSites.size());
+	for (std::size_t i = 0; i < expectedSites.size(); ++i) {
+	  auto const& e = expectedSites[i];
+	  auto const& a = actualSites[i];
+	  REQUIRE(a.isFluid == e.isFluid);
+	  REQUIRE(a.targetProcessor == e.targetProcessor);
+	  REQUIRE(a.wallNormalAvailable == e.wallNormalAvailable);
+	  if (e.wallNormalAvailable)
+	    REQUIRE(a.wallNormal == e.wallNormal);
+	  REQUIRE(a.links.size() == e.links.size());
+	  for (std::size_t d = 0; d < e.links.size(); ++d) {
+	    REQUIRE(a.links[d].type == e.links[d].type);
+	    REQUIRE(a.links[d].distanceToIntersection == e.links[d].distanceToIntersection);
+	    REQUIRE(a.links[d].ioletId == e.links[d].ioletId);
+	  }
+	}
+      }
     }
   }
 }
@@ -0,0 +1,99 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <numeric>
+
+#include <catch2/catch.hpp>
+
+#include "geometry/GmyHeader.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry;
+
+    namespace {
+        // Append an unsigned to the buffer as XDR does.
+        void PutXdr(std::vector<char>& buf, unsigned val) {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                buf.push_back(char((val >> shift) & 0xff));
+        }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "GmyHeader", "[geometry]") {
+        auto const& comms = Comms();
+        auto const P = U64(comms.Size());
+        Vec16 const dims(3, 4, 5);
+        U64 const N = 60;
+        std::size_t const dataStart = 1000;
+
+        // Every third block is solid; the others vary in size.
+        std::vector<site_t> fluidSites(N);
+        std::vector<unsigned> compressed(N), uncompressed(N);
+        std::vector<char> records;
+        for (U64 b = 0; b < N; ++b) {
+            fluidSites[b] = (b % 3 == 0) ? 0 : b + 1;
+            compressed[b] = fluidSites[b] ? 10 + b % 7 : 4;
+            uncompressed[b] = 100 + b;
+            PutXdr(records, fluidSites[b]);
+            PutXdr(records, compressed[b]);
+            PutXdr(records, uncompressed[b]);
+        }
+        auto const recordLength = records.size() / N;
+
+        GmyHeader whole(dims, 0, records, dataStart, comms, false);
+        auto const first = N * comms.Rank() / P;
+        auto const last = N * (comms.Rank() + 1) / P;
+        auto const slice = std::span<char const>(records).subspan(first * recordLength,
+                                                                  (last - first) * recordLength);
+        GmyHeader distributed(dims, first, slice, dataStart, comms, true);
+
+        std::size_t const dataEnd = dataStart + std::accumulate(compressed.begin(), compressed.end(), std::size_t(0));
+        for (auto* header: {&whole, &distributed}) {
+            REQUIRE(header->GetDataStart() == dataStart);
+            REQUIRE(header->GetDataEnd() == dataEnd);
+        }
+
+        SECTION("Lookup") {
+            // Different ranks want different blocks.
+            std::vector<U64> wanted;
+            for (U64 b = comms.Rank() % 2; b < N; b += 2)
+                wanted.push_back(b);
+
+            for (auto* header: {&whole, &distributed}) {
+                auto const found = header->Lookup(wanted);
+                REQUIRE(found.size() == wanted.size());
+                for (std::size_t i = 0; i < wanted.size(); ++i) {
+                    auto const b = wanted[i];
+                    REQUIRE(found[i].fluidSites == fluidSites[b]);
+                    REQUIRE(found[i].compressedBytes == compressed[b]);
+                    REQUIRE(found[i].uncompressedBytes == uncompressed[b]);
+                    REQUIRE(found[i].offset == dataStart + std::accumulate(compressed.begin(), compressed.begin() + b, std::size_t(0)));
+                }
+            }
+        }
+
+        SECTION("Tree and fingerprint don't depend on distribution") {
+            auto const expected = octree::build_block_tree(dims, fluidSites);
+            for (auto* header: {&whole, &distributed}) {
+                auto const tree = header->BuildBlockTree();
+                REQUIRE(tree.n_levels == expected.n_levels);
+                for (U16 l = 0; l <= tree.n_levels; ++l) {
+                    REQUIRE(tree.levels[l].node_ids == expected.levels[l].node_ids);
+                    REQUIRE(tree.levels[l].sites_per_node == expected.levels[l].sites_per_node);
+                    REQUIRE(tree.levels[l].child_indices == expected.levels[l].child_indices);
+                }
+            }
+            REQUIRE(whole.Fingerprint() == distributed.Fingerprint());
+        }
+
+        SECTION("Slices must cover the header") {
+            REQUIRE_THROWS_AS(GmyHeader(dims, 1, std::span<char const>(records).subspan(recordLength),
+                                        dataStart, comms, false),
+                              Exception);
+        }
+    }
+}
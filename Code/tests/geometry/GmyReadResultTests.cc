@@ -0,0 +1,82 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <catch2/catch.hpp>
+
+#include "Exception.h"
+#include "geometry/GmyReadResult.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry;
+
+    TEST_CASE("GmyReadResult block storage", "[geometry]") {
+        GmyReadResult gmy(Vec16(2, 2, 1), 2);
+        auto const SPB = gmy.GetSitesPerBlock();
+
+        std::vector<U64> const first{0, 2};
+        std::vector<site_t> const firstLinks{4, 0};
+        gmy.AllocateBlocks(first, firstLinks);
+        // Only the blocks allocated are held.
+        REQUIRE(gmy.Blocks.size() == 2);
+        REQUIRE(gmy.Blocks.contains(0));
+        REQUIRE(!gmy.Blocks.contains(1));
+        REQUIRE(gmy.Blocks[0].Sites.size() == std::size_t(SPB));
+        REQUIRE(gmy.Blocks[0].Links.size() == 4);
+        REQUIRE(gmy.Blocks[1].Sites.empty());
+        REQUIRE(gmy.Blocks[2].Sites.size() == std::size_t(SPB));
+        REQUIRE(gmy.Blocks[2].Links.empty());
+        for (auto const& site: gmy.Blocks[0].Sites) {
+            REQUIRE(!site.isFluid);
+            REQUIRE(site.links.empty());
+        }
+
+        // Make site 3 of block 0 fluid, with the last two links.
+        auto& site = gmy.Blocks[0].Sites[3];
+        site.isFluid = true;
+        site.targetProcessor = 5;
+        site.links = gmy.Blocks[0].Links.subspan(2, 2);
+        site.links[1].ioletId = 7;
+
+        SECTION("Allocating other blocks keeps the rest") {
+            std::vector<U64> const second{1, 2};
+            std::vector<site_t> const secondLinks{2, 6};
+            gmy.AllocateBlocks(second, secondLinks);
+            REQUIRE(gmy.Blocks.size() == 3);
+            REQUIRE(gmy.Blocks[1].Links.size() == 2);
+            REQUIRE(gmy.Blocks[2].Links.size() == 6);
+            REQUIRE(gmy.Blocks[3].Sites.empty());
+
+            auto const& kept = gmy.Blocks[0];
+            REQUIRE(kept.Sites.size() == std::size_t(SPB));
+            REQUIRE(kept.Sites[3].isFluid);
+            REQUIRE(kept.Sites[3].targetProcessor == 5);
+            // The links moved with the block.
+            REQUIRE(kept.Sites[3].links.data() == kept.Links.data() + 2);
+            REQUIRE(kept.Sites[3].links[1].ioletId == 7);
+        }
+
+        SECTION("Allocating a block again replaces it") {
+            std::vector<U64> const again{0};
+            std::vector<site_t> const againLinks{4};
+            gmy.AllocateBlocks(again, againLinks);
+            REQUIRE(!gmy.Blocks[0].Sites[3].isFluid);
+            REQUIRE(gmy.Blocks[0].Links[3].ioletId == -1);
+            REQUIRE(gmy.Blocks[2].Sites.size() == std::size_t(SPB));
+        }
+
+        SECTION("Bad arguments") {
+            std::vector<U64> const unsorted{2, 1};
+            std::vector<site_t> const links{0, 0};
+            REQUIRE_THROWS_AS(gmy.AllocateBlocks(unsorted, links), Exception);
+            REQUIRE_THROWS_AS(gmy.AllocateBlocks(first, std::vector<site_t>{0}), Exception);
+        }
+
+        SECTION("Release") {
+            gmy.ReleaseBlocks();
+            REQUIRE(gmy.Blocks.empty());
+        }
+    }
+}
@@ -0,0 +1,110 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <catch2/catch.hpp>
+
+#include "geometry/decomposition/HierarchicalPartition.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry::decomposition;
+
+    namespace {
+        // An N^3 grid graph split between the ranks in contiguous
+        // slabs of vertex indices.
+        struct GridGraph
+        {
+            static constexpr idx_t N = 8;
+            static constexpr idx_t total = N * N * N;
+            std::vector<idx_t> vtxdist;
+            std::vector<idx_t> xadj{0};
+            std::vector<idx_t> adjncy;
+            std::vector<idx_t> vwgt;
+
+            explicit GridGraph(net::MpiCommunicator const& comms) : vtxdist(comms.Size() + 1)
+            {
+                auto const P = comms.Size();
+                for (int r = 0; r <= P; ++r)
+                    vtxdist[r] = total * r / P;
+
+                auto const first = vtxdist[comms.Rank()];
+                auto const last = vtxdist[comms.Rank() + 1];
+                for (auto v = first; v < last; ++v) {
+                    idx_t const x = v / (N * N), y = (v / N) % N, z = v % N;
+                    if (x > 0) adjncy.push_back(v - N * N);
+                    if (x < N - 1) adjncy.push_back(v + N * N);
+                    if (y > 0) adjncy.push_back(v - N);
+                    if (y < N - 1) adjncy.push_back(v + N);
+                    if (z > 0) adjncy.push_back(v - 1);
+                    if (z < N - 1) adjncy.push_back(v + 1);
+                    xadj.push_back(adjncy.size());
+                }
+                vwgt.assign(last - first, 1);
+            }
+
+            DistributedGraph Get() const
+            {
+                return {vtxdist, xadj, adjncy, vwgt};
+            }
+        };
+
+        // Check every vertex gets a rank on the communicator, with the
+        // whole graph covered and (for a graph this size) no rank left
+        // without any.
+        void CheckPartition(net::MpiCommunicator const& comms, GridGraph const& graph,
+                            std::vector<idx_t> const& parts)
+        {
+            auto const P = comms.Size();
+            REQUIRE(std::ssize(parts) == std::ssize(graph.vwgt));
+            for (auto p: parts) {
+                REQUIRE(p >= 0);
+                REQUIRE(p < P);
+            }
+
+            std::vector<int> local(P, 0);
+            for (auto p: parts)
+                ++local[p];
+            auto const counts = comms.AllReduce(local, MPI_SUM);
+            int sum = 0;
+            for (auto c: counts) {
+                REQUIRE(c > 0);
+                sum += c;
+            }
+            REQUIRE(sum == GridGraph::total);
+        }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "Hierarchical partition", "[geometry]") {
+        auto const& comms = Comms();
+        GridGraph const graph(comms);
+        auto const parts = PartitionHierarchically(comms, graph.Get(), 1.05);
+        CheckPartition(comms, graph, parts);
+    }
+
+    // Split the ranks into several pretend nodes, so the between-node
+    // level runs even on one real node.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "Hierarchical partition over fake nodes", "[geometry]") {
+        auto const P = Comms().Size();
+        int const nodes = GENERATE(2, 3);
+        // Consecutive ranks share a node, as a job's usually do. With
+        // fewer ranks than that, each is a node to itself.
+        auto const nodeOf = [&](int r) { return r * nodes / P; };
+        net::IOCommunicator const comms(Comms(), Comms().Split(nodeOf(Comms().Rank())));
+
+        // The nodes are numbered in order of their lowest rank.
+        auto const nodeOfRank = NodeOfEachRank(comms);
+        REQUIRE(std::ssize(nodeOfRank) == P);
+        REQUIRE(nodeOfRank[0] == 0);
+        for (int r = 1; r < P; ++r)
+            REQUIRE(nodeOfRank[r] == nodeOfRank[r - 1] + (nodeOf(r) != nodeOf(r - 1)));
+        REQUIRE(comms.AmNodeLeader() == (comms.Rank() == 0 || nodeOf(comms.Rank()) != nodeOf(comms.Rank() - 1)));
+
+        GridGraph const graph(comms);
+        auto const parts = PartitionHierarchically(comms, graph.Get(), 1.05);
+        CheckPartition(comms, graph, parts);
+    }
+}
@@ -6,6 +6,7 @@
 #include <catch2/catch.hpp>
 
 #include "geometry/Domain.h"
+#include "lb/lattices/D3Q15.h"
 
 #include "tests/helpers/FourCubeBasedTestFixture.h"
 
@@ -34,6 +35,28 @@ namespace hemelb
 	// situation to test this properly.
 	REQUIRE(dom->ProcProvidingSiteByGlobalNoncontiguousId(43) == 0);
       }
+
+      SECTION("TestStreamedIndices") {
+	// Each link streams to the same direction of the neighbouring
+	// site, or beyond the local sites if there is no local neighbour.
+	// With single-buffer streaming the index depends on the step.
+	if constexpr (!SINGLE_BUFFER_STREAMING) {
+	  using LATTICE = lb::D3Q15;
+	  auto const nLocal = dom->GetLocalDistributionCount();
+	  for (site_t i = 0; i < dom->GetLocalFluidSiteCount(); ++i) {
+	    auto const& coords = latDat->GetSite(i).GetGlobalSiteCoords();
+	    for (Direction d = 1; d < LATTICE::NUMVECTORS; ++d) {
+	      auto const to = latDat->GetStreamedIndex<LATTICE>(i, d);
+	      proc_t proc;
+	      site_t j;
+	      if (dom->GetContiguousSiteId(coords + LatticeVector(LATTICE::CX[d], LATTICE::CY[d], LATTICE::CZ[d]), proc, j))
+		REQUIRE(to == dom->GetDistributionIndex<LATTICE>(j, d));
+	      else
+		REQUIRE(to >= nLocal);
+	    }
+	  }
+	}
+      }
     }
   }
 }
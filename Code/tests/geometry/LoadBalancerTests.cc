@@ -0,0 +1,184 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <functional>
+
+#include <catch2/catch.hpp>
+
+#include "Exception.h"
+#include "geometry/decomposition/LoadBalancer.h"
+#include "geometry/Domain.h"
+#include "geometry/FieldData.h"
+#include "geometry/GeometryReader.h"
+#include "reporting/Timers.h"
+
+#include "tests/helpers/FourCubeLatticeData.h"
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry::decomposition;
+
+    namespace {
+        // Move each site of the domain to the rank given for its
+        // coordinates, returning the new domain.
+        std::shared_ptr<geometry::Domain> Redecompose(net::IOCommunicator const& comms,
+                                                      geometry::Domain const& from,
+                                                      std::function<int(LatticeVector const&)> const& rankOf,
+                                                      geometry::MovesMap& departing)
+        {
+            std::vector<idx_t> ranks;
+            for (site_t i = 0; i < from.GetLocalFluidSiteCount(); ++i)
+                ranks.push_back(rankOf(from.GetSite(i).GetGlobalSiteCoords()));
+            reporting::Timers timings(comms);
+            geometry::GeometryReader reader(from.GetLatticeInfo(), timings, comms);
+            auto geometry = reader.Redecompose(from, ranks, departing);
+            return std::make_shared<geometry::Domain>(from.GetLatticeInfo(), geometry, comms);
+        }
+
+        // The four cube's sites split between the ranks in slabs of x
+        // (and so in the same way when there are four).
+        std::function<int(LatticeVector const&)> Slabs(int P)
+        {
+            return [P](LatticeVector const& x) {
+                auto const g = ((x.x() - 1) * 4 + x.y() - 1) * 4 + x.z() - 1;
+                return int(g * P / 64);
+            };
+        }
+
+        // The sites each rank has.
+        std::vector<site_t> SitesOnRanks(net::MpiCommunicator const& comms, geometry::Domain const& domain)
+        {
+            std::vector<site_t> local(comms.Size(), 0);
+            local[comms.Rank()] = domain.GetLocalFluidSiteCount();
+            return comms.AllReduce(local, MPI_SUM);
+        }
+    }
+
+    TEST_CASE("LoadBalancer triggers once per excursion over the threshold", "[geometry]") {
+        LoadBalancer balancer(0.1);
+
+        REQUIRE_FALSE(balancer.ShouldRebalance(0.05));
+        REQUIRE(balancer.ShouldRebalance(0.2));
+        // Still over after rebalancing: don't keep trying.
+        REQUIRE_FALSE(balancer.ShouldRebalance(0.15));
+        REQUIRE_FALSE(balancer.ShouldRebalance(0.3));
+        // Back under, then over again.
+        REQUIRE_FALSE(balancer.ShouldRebalance(0.1));
+        REQUIRE(balancer.ShouldRebalance(0.12));
+
+        REQUIRE_THROWS_AS(LoadBalancer(0.0), Exception);
+    }
+
+    TEST_CASE("LoadWeights", "[geometry]") {
+        std::vector<double> const costs{4.0, 5.0, 16.0, 0.2};
+        REQUIRE(LoadWeights(costs, 1.0) == std::vector<int>{4, 5, 16, 1});
+        REQUIRE(LoadWeights(costs, 1.5) == std::vector<int>{6, 8, 24, 1});
+        REQUIRE(LoadWeights(costs, 0.1) == std::vector<int>{1, 1, 2, 1});
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "RepartitionSites", "[geometry]") {
+        auto const& comms = Comms();
+        auto const P = comms.Size();
+        auto const cube = FourCubeDomain::Create(comms);
+
+        SECTION("Sites all on one rank are shared out") {
+            std::vector<int> const loads(cube->GetLocalFluidSiteCount(), 1);
+            auto const ranks = RepartitionSites(*cube, loads, 10.0, comms);
+            REQUIRE(std::ssize(ranks) == cube->GetLocalFluidSiteCount());
+            std::vector<site_t> local(P, 0);
+            for (auto r: ranks) {
+                REQUIRE(r >= 0);
+                REQUIRE(r < P);
+                ++local[r];
+            }
+            auto const counts = comms.AllReduce(local, MPI_SUM);
+            for (auto c: counts)
+                REQUIRE(c > 0);
+        }
+
+        SECTION("Balanced sites stay put") {
+            geometry::MovesMap departing;
+            auto const slabs = Redecompose(comms, *cube, Slabs(P), departing);
+            std::vector<int> const loads(slabs->GetLocalFluidSiteCount(), 1);
+            auto const ranks = RepartitionSites(*slabs, loads, 1e-3, comms);
+            REQUIRE(std::ssize(ranks) == slabs->GetLocalFluidSiteCount());
+            // Only an exact split is as balanced as it can be.
+            if (64 % P == 0)
+                for (auto r: ranks)
+                    REQUIRE(r == comms.Rank());
+        }
+    }
+
+    // Out to slabs and back, the sites keep their data.
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "Redecompose from the Domain", "[geometry]") {
+        auto const& comms = Comms();
+        auto const P = comms.Size();
+        auto const cube = FourCubeDomain::Create(comms);
+        auto const slabOf = Slabs(P);
+
+        geometry::MovesMap departing;
+        auto const slabs = Redecompose(comms, *cube, slabOf, departing);
+        auto const counts = SitesOnRanks(comms, *slabs);
+        std::vector<site_t> expected(P, 0);
+        for (int g = 0; g < 64; ++g)
+            ++expected[g * P / 64];
+        for (int r = 0; r < P; ++r) {
+            REQUIRE(counts[r] == expected[r]);
+            if (comms.Rank() == 0 && r != 0)
+                REQUIRE(departing[r].size() == std::size_t(counts[r]));
+        }
+        REQUIRE(!departing.contains(comms.Rank()));
+        for (site_t i = 0; i < slabs->GetLocalFluidSiteCount(); ++i)
+            REQUIRE(slabOf(slabs->GetSite(i).GetGlobalSiteCoords()) == comms.Rank());
+
+        auto const back = Redecompose(comms, *slabs, [](LatticeVector const&) { return 0; }, departing);
+        REQUIRE(back->GetLocalFluidSiteCount() == cube->GetLocalFluidSiteCount());
+        auto const Q = cube->GetLatticeInfo().GetNumVectors();
+        for (site_t i = 0; i < cube->GetLocalFluidSiteCount(); ++i) {
+            auto const before = cube->GetSite(i);
+            auto const after = back->GetSite(back->GetContiguousSiteId(before.GetGlobalSiteCoords()));
+            REQUIRE(after.GetGlobalSiteCoords() == before.GetGlobalSiteCoords());
+            auto const& a = before.GetSiteData();
+            auto const& b = after.GetSiteData();
+            REQUIRE(b.GetSiteType() == a.GetSiteType());
+            REQUIRE(b.GetIoletId() == a.GetIoletId());
+            REQUIRE(b.GetWallIntersectionData() == a.GetWallIntersectionData());
+            REQUIRE(b.GetIoletIntersectionData() == a.GetIoletIntersectionData());
+            REQUIRE(after.GetWallNormal() == before.GetWallNormal());
+            for (Direction d = 0; d + 1 < Q; ++d)
+                REQUIRE(after.GetWallDistances()[d] == before.GetWallDistances()[d]);
+        }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "MigrateDistributions", "[geometry]") {
+        auto const& comms = Comms();
+        auto const cube = FourCubeDomain::Create(comms);
+        auto const Q = cube->GetLatticeInfo().GetNumVectors();
+        // Distinct values for every site and direction.
+        auto value = [](LatticeVector const& x, Direction d) {
+            return 100.0 * x.x() + 10.0 * x.y() + x.z() + 1e-3 * d;
+        };
+
+        geometry::FieldData from(cube);
+        for (site_t i = 0; i < cube->GetLocalFluidSiteCount(); ++i)
+            for (Direction d = 0; d < Q; ++d) {
+                auto const idx = cube->GetDistributionIndex(i, d);
+                *from.GetFOld(idx) = *from.GetFNew(idx) = value(cube->GetSite(i).GetGlobalSiteCoords(), d);
+            }
+
+        geometry::MovesMap departing;
+        auto const slabs = Redecompose(comms, *cube, Slabs(comms.Size()), departing);
+        geometry::FieldData to(slabs);
+        MigrateDistributions(from, departing, to, comms);
+        for (site_t i = 0; i < slabs->GetLocalFluidSiteCount(); ++i)
+            for (Direction d = 0; d < Q; ++d) {
+                auto const idx = slabs->GetDistributionIndex(i, d);
+                auto const expected = value(slabs->GetSite(i).GetGlobalSiteCoords(), d);
+                REQUIRE(*to.GetFOld(idx) == expected);
+                REQUIRE(*to.GetFNew(idx) == expected);
+            }
+    }
+}
@@ -177,7 +177,7 @@ namespace hemelb::tests
     }
 
     template <typename T>
-    void check_vec(std::vector<T> const& actual, std::vector<T> const& expected) {
+    void check_vec(Column<T> const& actual, Column<T> const& expected) {
         REQUIRE(actual.size() == expected.size());
         for (int i = 0; i < std::ssize(actual); ++i) {
             REQUIRE(actual[i] == expected[i]);
@@ -202,6 +202,12 @@ namespace hemelb::tests
         REQUIRE(ijk == 990);
 
         LookupTree actual = build_block_tree(hi, fluidSitesPerBlock);
+        // Sharing the tree on the node mustn't change it.
+        if (GENERATE(false, true)) {
+            net::IOCommunicator comms(net::MpiCommunicator::World());
+            actual.ShareOnNode(comms.GetNodeComm());
+            REQUIRE_THROWS(actual.levels[0].node_ids.push_back(0));
+        }
 
         REQUIRE(actual.n_levels == ref_tree.n_levels);
 
@@ -219,6 +225,8 @@ namespace hemelb::tests
         auto reader = std::make_unique<geometry::GeometryReader>(lb::D3Q15::GetLatticeInfo(),
                                                                  *timings,
                                                                  Comms());
+        // The tree should be the same whether or not the header is distributed.
+        reader->SetDistributedHeader(GENERATE(false, true));
         auto result = reader->LoadAndDecompose("large_cylinder.gmy");
         auto& tree = result.block_store->GetTree();
         //auto tree = //result.StealBlockTree();
@@ -303,4 +311,60 @@ namespace hemelb::tests
         REQUIRE(tree.levels[1].sites_per_node[0] == 5084);
         REQUIRE(tree.levels[1].sites_per_node[1] == 492);
     }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "DistributedStore - batched lookups", "[geometry]") {
+        auto const& comms = Comms();
+        // Every other block of the domain is fluid, spread over the ranks in octree order.
+        Vec16 const dims(4, 3, 5);
+        site_t const spb = 8;
+        std::vector<site_t> fluidSitesPerBlock(dims.x() * dims.y() * dims.z());
+        for (std::size_t i = 0; i < fluidSitesPerBlock.size(); ++i)
+            fluidSitesPerBlock[i] = (i % 2) ? spb : 0;
+        auto tree = build_block_tree(dims, fluidSitesPerBlock);
+        auto const nBlocks = tree.levels.back().node_ids.size();
+        auto const P = std::size_t(comms.Size());
+        std::vector<U64> firstBlockOfRank(P + 1);
+        for (std::size_t r = 0; r <= P; ++r)
+            firstBlockOfRank[r] = (r * nBlocks + P - 1) / P;
+        std::vector<int> ranks(nBlocks);
+        for (std::size_t i = 0; i < nBlocks; ++i)
+            ranks[i] = (i * P) / nBlocks;
+        DistributedStore store(spb, std::move(tree), firstBlockOfRank, comms);
+
+        // The slices are the blocks of each rank.
+        for (std::size_t i = 0; i < nBlocks; ++i)
+            REQUIRE(store.GetBlockOwner(i) == ranks[i]);
+        REQUIRE(store.GetBlockCount() == nBlocks);
+
+        // Each rank writes its blocks' sites.
+        {
+            auto writes = store.begin_writes();
+            auto const [first, last] = store.GetBlockRange(comms.Rank());
+            for (std::size_t i = first; i < last; ++i) {
+                auto block = writes(i);
+                for (site_t s = 0; s < spb; ++s)
+                    block(s) = geometry::SiteRankIndex{comms.Rank(), int(i * spb + s)};
+            }
+        }
+
+        // Look up every site in the bounding box, including with a
+        // cache too small to hold all the blocks.
+        store.SetCacheCapacity(GENERATE(1, 3, 100));
+        std::vector<DistributedStore::BlockSite> sites;
+        for (auto ijk: IterBounds{dims})
+            for (site_t s = spb - 1; s >= 0; --s)
+                sites.emplace_back(ijk, s);
+        auto const batch = store.GetSiteData(sites);
+
+        REQUIRE(batch.size() == sites.size());
+        for (std::size_t i = 0; i < sites.size(); ++i) {
+            auto const& [ijk, s] = sites[i];
+            auto const leaf = store.GetTree().GetPath(ijk).leaf();
+            auto const expected = leaf == Level::NC ?
+                    geometry::SiteRankIndex{SITE_OR_BLOCK_SOLID, -1} :
+                    geometry::SiteRankIndex{ranks[leaf], int(leaf * spb + s)};
+            REQUIRE(batch[i] == expected);
+            REQUIRE(store.GetSiteData(ijk, s) == expected);
+        }
+    }
 }
@@ -0,0 +1,54 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <map>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "geometry/SiteOrdering.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry;
+    using Coord = util::Vector3D<site_t>;
+
+    // All the sites of an n^3 cube at the origin, in x, y, z order
+    std::vector<Coord> Cube(site_t n) {
+        std::vector<Coord> ans;
+        for (site_t i = 0; i < n; ++i)
+            for (site_t j = 0; j < n; ++j)
+                for (site_t k = 0; k < n; ++k)
+                    ans.emplace_back(i, j, k);
+        return ans;
+    }
+
+    TEST_CASE("MortonKey interleaves the coordinate bits", "[geometry]") {
+        REQUIRE(MortonKey({0, 0, 0}) == 0);
+        REQUIRE(MortonKey({0, 0, 1}) == 1);
+        REQUIRE(MortonKey({0, 1, 0}) == 2);
+        REQUIRE(MortonKey({1, 0, 0}) == 4);
+        REQUIRE(MortonKey({3, 0, 5}) == 0b001'100'101);
+    }
+
+    TEST_CASE("HilbertKey orders a cube as a path of neighbouring sites", "[geometry]") {
+        auto const cube = Cube(8);
+        std::map<curve_key_t, Coord> byKey;
+        for (auto const& x: cube)
+            byKey[HilbertKey(x)] = x;
+        // Distinct keys, starting at the origin
+        REQUIRE(byKey.size() == cube.size());
+        REQUIRE(byKey.begin()->first == 0);
+        for (auto it = byKey.begin(), next = std::next(it); next != byKey.end(); ++it, ++next) {
+            auto const step = next->second - it->second;
+            REQUIRE(std::abs(step.x()) + std::abs(step.y()) + std::abs(step.z()) == 1);
+        }
+    }
+
+    TEST_CASE("CurveOrder sorts by key and keeps ties in order", "[geometry]") {
+        std::vector<Coord> const coords{{1, 0, 0}, {0, 0, 1}, {1, 0, 0}, {0, 0, 0}};
+        auto const order = CurveOrder(coords, MortonKey);
+        REQUIRE(order == std::vector<std::size_t>{3, 1, 0, 2});
+    }
+}
@@ -0,0 +1,55 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <fstream>
+#include <catch2/catch.hpp>
+
+#include "Exception.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "tests/helpers/FolderTestFixture.h"
+
+namespace hemelb::tests
+{
+    using namespace geometry::decomposition;
+
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "Site weights files", "[geometry]") {
+        SiteWeights const weights{10, 23, 31, 32, 47, 48};
+
+        SECTION("Round trip") {
+            WriteSiteWeights("weights.txt", weights);
+            REQUIRE(ReadSiteWeights("weights.txt") == weights);
+        }
+
+        SECTION("Any order, with comments") {
+            std::ofstream("weights.txt") << "# comment\n\noutlet_wall 48\ninlet_wall 47\n"
+                                         << "outlet 32\ninlet 31\nwall 23\nbulk 10\n";
+            REQUIRE(ReadSiteWeights("weights.txt") == weights);
+        }
+
+        SECTION("Missing type") {
+            std::ofstream("weights.txt") << "bulk 10\nwall 23\n";
+            REQUIRE_THROWS_AS(ReadSiteWeights("weights.txt"), Exception);
+        }
+
+        SECTION("Bad weight") {
+            std::ofstream("weights.txt") << "bulk 0\n";
+            REQUIRE_THROWS_AS(ReadSiteWeights("weights.txt"), Exception);
+        }
+    }
+
+    TEST_CASE("CalibrateSiteWeights", "[geometry]") {
+        SiteWeights const fallback{4, 5, 16, 16, 20, 20};
+
+        // Costs per site of 1, 2.5 and 4 for bulk, wall and inlet;
+        // no outlet sites, so the fallback is scaled to bulk = 10.
+        std::array<double, COLLISION_TYPES> const seconds{100.0, 50.0, 8.0, 0.0, 3.0, 0.0};
+        std::array<std::uint64_t, COLLISION_TYPES> const sites{100, 20, 2, 0, 1, 0};
+        auto const ans = CalibrateSiteWeights(seconds, sites, fallback);
+        REQUIRE(ans == SiteWeights{10, 25, 40, 40, 30, 50});
+
+        // With nothing measured, the fallback is kept as it is.
+        REQUIRE(CalibrateSiteWeights({}, {}, fallback) == fallback);
+    }
+}
@@ -61,8 +61,12 @@ namespace hemelb::tests
         site_t sitesAlongCube = sitesPerBlockUnit - 2;
         site_t minInd = 1, maxInd = sitesAlongCube;
       
-        geometry::BlockReadResult& block = readResult.Blocks[0];
-        block.Sites.resize(readResult.GetSitesPerBlock(), geometry::GeometrySite(false));
+        constexpr auto linksPerSite = lb::D3Q15::NUMVECTORS - 1;
+        U64 const blockIds[] = {0};
+        site_t const linkCounts[] = {sitesAlongCube * sitesAlongCube * sitesAlongCube * linksPerSite};
+        readResult.AllocateBlocks(blockIds, linkCounts);
+        auto const block = readResult.Blocks[0];
+        auto freeLinks = block.Links;
 
         site_t index = -1;
         for (site_t i = 0; i < sitesPerBlockUnit; ++i) {
@@ -79,6 +83,8 @@ namespace hemelb::tests
 
 	    site.isFluid = true;
 	    site.targetProcessor = 0;
+	    site.links = freeLinks.first(linksPerSite);
+	    freeLinks = freeLinks.subspan(linksPerSite);
 
 	    for (Direction direction = 1; direction < lb::D3Q15::NUMVECTORS; ++direction)
 	      {
@@ -111,7 +117,7 @@ namespace hemelb::tests
                     link.distanceToIntersection = randomDistance;
                   }
 
-		site.links.push_back(link);
+		site.links[direction - 1] = link;
 
 	      }
 
@@ -144,13 +150,16 @@ namespace hemelb::tests
             }
         }
 
+        // The one block is on rank zero.
+        std::vector<U64> firstBlockOfRank(comm.Size() + 1, 1);
+        firstBlockOfRank[0] = 0;
         readResult.block_store = std::make_unique<octree::DistributedStore>(
                 readResult.GetSitesPerBlock(),
                 octree::build_block_tree(
                         readResult.GetBlockDimensions().as<octree::U16>(),
                         {readResult.GetSitesPerBlock()}
                 ),
-                std::vector{0},
+                std::move(firstBlockOfRank),
                 comm
         );
         auto domain = std::make_shared<FourCubeDomain>(
@@ -160,12 +169,13 @@ namespace hemelb::tests
         );
 
       // First, fiddle with the fluid site count, for tests that require this set.
-      domain->fluidSitesOnEachProcessor.resize(rankCount);
-        domain->fluidSitesOnEachProcessor[0] = sitesAlongCube * sitesAlongCube
-	* sitesAlongCube;
+      std::vector<site_t> fluidSitesOnEachProcessor(rankCount);
+      fluidSitesOnEachProcessor[0] = sitesAlongCube * sitesAlongCube * sitesAlongCube;
       for (proc_t rank = 1; rank < rankCount; ++rank) {
-          domain->fluidSitesOnEachProcessor[rank] = rank * 1000;
+          fluidSitesOnEachProcessor[rank] = rank * 1000;
       }
+      domain->fluidSitesOnEachProcessor = net::WinData<site_t>::Shared(fluidSitesOnEachProcessor,
+                                                                        comm.GetNodeComm());
         return domain;
     }
 
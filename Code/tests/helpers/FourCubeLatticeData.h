@@ -56,7 +56,7 @@ namespace hemelb::tests
       void SetFOld(site_t site, distribn_t* fOldIn)
       {
 	for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction) {
-            *GetFOld(site * LatticeType::NUMVECTORS + direction) = fOldIn[direction];
+            *GetFOld<LatticeType>(site, direction) = fOldIn[direction];
           }
         }
 
@@ -9,7 +9,7 @@ namespace hemelb::tests::helpers
 {
 
     LatticeDataAccess::LatticeDataAccess(geometry::FieldData * const latDat) :
-            latDat(latDat)
+            latDat(latDat), domain(&latDat->GetDomain())
     {
     }
 
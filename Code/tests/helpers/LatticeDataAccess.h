@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <utility>
 #include "geometry/Domain.h"
 #include "geometry/FieldData.h"
 #include "lb/lattices/D3Q15.h"
@@ -20,7 +21,7 @@ namespace hemelb::tests::helpers
 
     // FNew at given site
     template<class Lattice>
-    distribn_t const * GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos);
+    auto GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos);
     distribn_t const * GetFNew(geometry::FieldData& latDat, site_t const &index);
 
     // Population i set to some distribution
@@ -49,14 +50,22 @@ namespace hemelb::tests::helpers
 
         // Get FNew for a given site and direction
         template<class LATTICE>
-        distribn_t const * GetFNew(site_t _x, site_t _y, site_t _z) const
+        auto GetFNew(site_t _x, site_t _y, site_t _z) const
         {
             return GetFNew<LATTICE>(LatticeVector(_x, _y, _z));
         }
         template<class LATTICE>
-        distribn_t const * GetFNew(LatticeVector const &_pos) const;
+        auto GetFNew(LatticeVector const &_pos) const;
         distribn_t const * GetFNew(site_t index) const;
 
+        // Index of the distribution that (site, direction) streams to in
+        // the two-array scheme, whatever the streaming pattern.
+        template<class LATTICE>
+        site_t GetStreamedIndex(site_t site, Direction direction) const
+        {
+            return domain->GetStreamedIndex<LATTICE>(site, direction);
+        }
+
         void SetMinWallDistance(PhysicalDistance _mindist);
         void SetWallDistance(PhysicalDistance _mindist);
 
@@ -85,26 +94,19 @@ namespace hemelb::tests::helpers
     void LatticeDataAccess::SetFOld(LatticeVector const &_pos, site_t _dir,
                                     distribn_t _value) const
     {
-        // Figure location of distribution in memory using const access to FOld.
-        // This way, access is resilient versus (some) changes in memory layout.
-        geometry::Site<geometry::FieldData> const site(latDat->GetSite(_pos));
-        auto siteFOld = site.GetFOld<LATTICE>();
-        distribn_t const * const firstFOld = &latDat->m_currentDistributions[0];
-        size_t const indexFOld(siteFOld.data() - firstFOld);
-        latDat->m_currentDistributions[indexFOld + _dir] = _value;
+        // Ask the field data where the distribution lives, so this is
+        // resilient versus changes in memory layout.
+        site_t const index = latDat->GetDomain().GetContiguousSiteId(_pos);
+        *latDat->template GetFOld<LATTICE>(index, _dir) = _value;
     }
 
     template<class LATTICE>
-    distribn_t const *
-    LatticeDataAccess::GetFNew(LatticeVector const &_pos) const
+    auto LatticeDataAccess::GetFNew(LatticeVector const &_pos) const
     {
-        // Figure location of distribution in memory using const access to FOld.
-        // This way, access is resilient versus (some) changes in memory layout.
-        auto site = latDat->GetSite(_pos);
-        auto siteFOld = site.GetFOld<LATTICE>();
-        distribn_t const * const firstFOld = &latDat->m_currentDistributions[0];
-        size_t const indexFOld = siteFOld.data() - firstFOld;
-        return latDat->GetFNew(indexFOld);
+        // View of the site's distributions, so this is resilient versus
+        // changes in memory layout.
+        site_t const index = latDat->GetDomain().GetContiguousSiteId(_pos);
+        return std::as_const(*latDat).template GetFNew<LATTICE>(index);
     }
 
     inline void ZeroOutFOld(geometry::FieldData* const latDat)
@@ -130,10 +132,8 @@ namespace hemelb::tests::helpers
             auto site = latDat->GetSite(i);
             LatticeVector const pos = site.GetGlobalSiteCoords();
             LatticePosition const pos_real(pos[0], pos[1], pos[2]);
-            distribn_t const * const siteFOld = site.GetFOld<LATTICE>().data();
-            distribn_t const * const firstFOld = &latDat->m_currentDistributions[0];
-            size_t const indexFOld(siteFOld - firstFOld);
-            latDat->m_nextDistributions[indexFOld + _i] = latDat->m_currentDistributions[indexFOld + _i] = _function(pos_real);
+            site_t const indexF = dom.GetDistributionIndex<LATTICE>(i, _i);
+            latDat->NextDistributions()[indexF] = latDat->m_currentDistributions[indexF] = _function(pos_real);
         }
     }
 
@@ -159,7 +159,7 @@ namespace hemelb::tests::helpers
     }
 
     template<class LATTICE>
-    distribn_t const * GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos)
+    auto GetFNew(geometry::FieldData& latDat, LatticeVector const &_pos)
     {
         return LatticeDataAccess(&latDat).GetFNew<LATTICE>(_pos);
     }
@@ -203,7 +203,8 @@ namespace hemelb::tests::LbTestsHelper
             util::Vector3D<distribn_t> momentum;
             util::Vector3D<distribn_t> velocity;
 
-            Lattice::CalculateDensityMomentumFEq(latDat.GetSite(site).GetFOld<Lattice> (),
+            auto const fOld = geometry::Contiguous(latDat.GetSite(site).GetFOld<Lattice>());
+            Lattice::CalculateDensityMomentumFEq(fOld,
                                                  density,
                                                  momentum,
                                                  velocity,
@@ -0,0 +1,99 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "lb/Kernels.h"
+#include "lb/kernels/DHumieresD3Q15MRTBasis.h"
+#include "lb/streamers/SimdBulkStreamer.h"
+#include "lb/MacroscopicPropertyCache.h"
+
+#include "tests/lb/LbTestsHelper.h"
+#include "tests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb::tests
+{
+    using LATTICE = lb::D3Q15;
+    constexpr auto NV = LATTICE::NUMVECTORS;
+    constexpr auto WIDTH = util::simd::WIDTH;
+
+    template <typename KERNEL>
+    struct BatchKernelTester : helpers::FourCubeBasedTestFixture<> {
+    };
+
+    // The batched kernels must agree, lane by lane, with the scalar
+    // ones.
+    TEMPLATE_TEST_CASE_METHOD(BatchKernelTester,
+                              "CollideBatch matches Collide", "[lb]",
+                              lb::LBGK<LATTICE>, lb::TRT<LATTICE>, lb::MRT<lb::DHumieresD3Q15MRTBasis>) {
+        using KERNEL = TestType;
+        STATIC_REQUIRE(lb::batch_kernel<KERNEL>);
+        KERNEL kernel(this->initParams);
+
+        std::array<std::array<distribn_t, NV>, WIDTH> f;
+        lb::BatchHydroVars<LATTICE> batch;
+        for (std::size_t lane = 0; lane < WIDTH; ++lane) {
+            LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(3 * lane + 1, f[lane].data());
+            for (Direction i = 0; i < NV; ++i)
+                batch.f[i][lane] = f[lane][i];
+        }
+        lb::CalculateDensityMomentumFEqNeq(batch);
+        kernel.CollideBatch(&this->lbmParams, batch);
+
+        for (std::size_t lane = 0; lane < WIDTH; ++lane) {
+            lb::HydroVars<KERNEL> hv(f[lane]);
+            kernel.CalculateDensityMomentumFeq(hv, 0);
+            kernel.Collide(&this->lbmParams, hv);
+
+            REQUIRE(batch.density[lane] == Approx(hv.density).epsilon(1e-12));
+            for (int d = 0; d < 3; ++d) {
+                REQUIRE(batch.momentum[d][lane] == Approx(hv.momentum[d]).margin(1e-12));
+                REQUIRE(batch.velocity[d][lane] == Approx(hv.velocity[d]).margin(1e-12));
+            }
+            for (Direction i = 0; i < NV; ++i) {
+                REQUIRE(batch.f_eq[i][lane] == Approx(hv.GetFEq()[i]).margin(1e-12));
+                REQUIRE(batch.f_post[i][lane] == Approx(hv.GetFPostCollision()[i]).margin(1e-12));
+            }
+        }
+    }
+
+    // Streaming a range whose length isn't a multiple of the SIMD
+    // width must give the same result as the scalar bulk streamer.
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture<>, "SimdBulkStreamer matches BulkStreamer", "[lb]") {
+        if constexpr (geometry::SINGLE_BUFFER_STREAMING) {
+            // Streaming in place overwrites the input, so the two
+            // can't be run on the same data.
+            SUCCEED("Not applicable to in-place streaming");
+        } else {
+            using COLLISION = lb::Normal<lb::LBGK<LATTICE>>;
+            lb::BulkStreamer<COLLISION> scalar(initParams);
+            lb::SimdBulkStreamer<COLLISION> batched(initParams);
+            lb::MacroscopicPropertyCache propertyCache(*simState, *dom);
+
+            LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*latDat);
+            // The bulk streamer ignores walls, so any range of sites works.
+            site_t const first = 1;
+            site_t const count = 4 * WIDTH + 3;
+            REQUIRE(first + count <= numSites);
+
+            auto const nDist = latDat->GetDomain().GetLocalDistributionCount();
+            // Clear fNew first, so that any values not written are noticed
+            auto run = [&](auto& streamer) {
+                for (site_t i = 0; i < nDist; ++i)
+                    *latDat->GetFNew(i) = -1.0;
+                streamer.StreamAndCollide(first, count, &lbmParams, *latDat, propertyCache);
+                std::vector<distribn_t> ans;
+                for (site_t i = 0; i < nDist; ++i)
+                    ans.push_back(*latDat->GetFNew(i));
+                return ans;
+            };
+            auto const expected = run(scalar);
+            auto const actual = run(batched);
+            for (site_t i = 0; i < nDist; ++i)
+                REQUIRE(actual[i] == Approx(expected[i]).margin(1e-12));
+        }
+    }
+}
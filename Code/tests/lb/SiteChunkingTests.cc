@@ -0,0 +1,57 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdlib>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "lb/SiteChunking.h"
+
+namespace hemelb::tests
+{
+    using namespace lb;
+
+    TEST_CASE("ThreadSiteChunk partitions the range", "[lb]") {
+        site_t const first = GENERATE(0, 3, 64, 1001);
+        site_t const count = GENERATE(0, 1, 7, 100, 4097);
+        int const nThreads = GENERATE(1, 2, 3, 8, 48);
+
+        site_t expected = first;
+        for (int t = 0; t < nThreads; ++t) {
+            auto [begin, n] = ThreadSiteChunk(first, count, t, nThreads);
+            // Contiguous and in order
+            REQUIRE(begin == expected);
+            REQUIRE(n >= 0);
+            // Interior boundaries are aligned
+            if (n > 0 && begin != first)
+                REQUIRE(begin % THREAD_CHUNK_ALIGNMENT == 0);
+            expected = begin + n;
+        }
+        REQUIRE(expected == first + count);
+    }
+
+    TEST_CASE("ThreadSiteChunk balances large ranges", "[lb]") {
+        site_t const count = 100000;
+        int const nThreads = 12;
+        for (int t = 0; t < nThreads; ++t) {
+            auto [begin, n] = ThreadSiteChunk(5, count, t, nThreads);
+            REQUIRE(std::abs(n - count / nThreads) <= THREAD_CHUNK_ALIGNMENT);
+        }
+    }
+
+    TEST_CASE("ForEachThreadSiteChunk visits every site once", "[lb]") {
+        site_t const first = 17;
+        site_t const count = GENERATE(5, 1000);
+        std::vector<int> visits(first + count, 0);
+        ForEachThreadSiteChunk(first, count, [&](site_t b, site_t n) {
+            for (site_t i = b; i < b + n; ++i)
+                ++visits[i];
+        });
+        for (site_t i = 0; i < first; ++i)
+            REQUIRE(visits[i] == 0);
+        for (site_t i = first; i < first + count; ++i)
+            REQUIRE(visits[i] == 1);
+    }
+}
@@ -4,6 +4,7 @@
 // license in the file LICENSE.
 
 #include <iostream>
+#include <utility>
 
 #include <catch2/catch.hpp>
 
@@ -12,6 +13,7 @@
 #include "geometry/SiteData.h"
 
 #include "tests/helpers/FourCubeBasedTestFixture.h"
+#include "tests/helpers/LatticeDataAccess.h"
 #include "tests/lb/LbTestsHelper.h"
 
 namespace hemelb::tests
@@ -35,6 +37,10 @@ namespace hemelb::tests
         auto apprx = [&](double x) {
             return Approx(x).margin(allowedError);
         };
+        // Where each link streams to with two arrays. The values are
+        // read back through GetFNew, which knows where the streaming
+        // pattern put them.
+        helpers::LatticeDataAccess access(latDat.get());
 
       SECTION("BulkStreamer") {
 	BulkStreamer<COLLISION> simpleCollideAndStream(initParams);
@@ -55,11 +61,11 @@ namespace hemelb::tests
 	for (site_t streamedToSite = 0; streamedToSite < dom->GetLocalFluidSiteCount(); ++streamedToSite) {
 	  auto streamedSite = latDat->GetSite(streamedToSite);
 
-	  distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	  auto const streamedToFNew = std::as_const(*latDat).GetFNew<LATTICE>(streamedToSite);
 
 	  for (auto streamedDirection = 0U; streamedDirection < NUMVECTORS; ++streamedDirection) {
 
-	    site_t streamerIndex = streamedSite.GetStreamedIndex<LATTICE>(LATTICE::INVERSEDIRECTIONS[streamedDirection]);
+	    site_t streamerIndex = access.GetStreamedIndex<LATTICE>(streamedToSite, LATTICE::INVERSEDIRECTIONS[streamedDirection]);
 
 	    // If this site streamed somewhere sensible, it must have been streamed to.
 	    if (streamerIndex >= 0 && streamerIndex < (NUMVECTORS * dom->GetLocalFluidSiteCount())) {
@@ -109,12 +115,12 @@ namespace hemelb::tests
 	for (site_t streamedToSite = 0; streamedToSite < dom->GetLocalFluidSiteCount(); ++streamedToSite) {
 	    const auto streamedSite = latDat->GetSite(streamedToSite);
 
-	    distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	    auto const streamedToFNew = std::as_const(*latDat).GetFNew<LATTICE>(streamedToSite);
 
 	    for (unsigned int streamedDirection = 0; streamedDirection < NUMVECTORS; ++streamedDirection) {
 	      unsigned int oppDirection = LATTICE::INVERSEDIRECTIONS[streamedDirection];
 
-	      site_t streamerIndex = streamedSite.GetStreamedIndex<LATTICE>(oppDirection);
+	      site_t streamerIndex = access.GetStreamedIndex<LATTICE>(streamedToSite, oppDirection);
 
 	      auto streamerSite = latDat->GetSite(streamerIndex);
 
@@ -175,7 +181,7 @@ namespace hemelb::tests
 		//   this direction.
 		distribn_t awayFromWallFOld[NUMVECTORS];
 
-		site_t awayFromWallIndex = streamedSite.GetStreamedIndex<LATTICE> (streamedDirection) / NUMVECTORS;
+		site_t awayFromWallIndex = access.GetStreamedIndex<LATTICE>(streamedToSite, streamedDirection) / NUMVECTORS;
 
 		// If there's a valid index in that direction, use BFL
 		if (awayFromWallIndex >= 0 && awayFromWallIndex  < dom->GetLocalFluidSiteCount()) {
@@ -207,13 +213,13 @@ namespace hemelb::tests
 		       << " direction " << streamedDirection);
 
 		  // Assert that this is the case.
-		  REQUIRE(apprx(streamed) == *(latDat->GetFNew(streamedToSite * NUMVECTORS + streamedDirection)));
+		  REQUIRE(apprx(streamed) == streamedToFNew[streamedDirection]);
 		} else {
 		  // With no valid lattice site, simple bounce-back will be performed.
 		  INFO("BouzidiFirdaousLallemand, PostStep by simple bounce-back:"
 		       << " site " << streamedToSite
 		       << " direction " << streamedDirection);
-		  REQUIRE(apprx(hydroVars.GetFPostCollision()[oppDirection]) == *(latDat->GetFNew(streamedToSite * NUMVECTORS + streamedDirection)));
+		  REQUIRE(apprx(hydroVars.GetFPostCollision()[oppDirection]) == streamedToFNew[streamedDirection]);
 		}
 	      }
 	    }
@@ -275,14 +281,14 @@ namespace hemelb::tests
 	for (site_t wallSiteLocalIndex = 0; wallSiteLocalIndex < wallSitesCount; wallSiteLocalIndex++) {
 	  site_t streamedToSite = firstWallSite + wallSiteLocalIndex;
 	  const auto streamedSite = latDat->GetSite(streamedToSite);
-	  distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	  auto const streamedToFNew = std::as_const(*latDat).GetFNew<LATTICE>(streamedToSite);
 
 	  for (unsigned int streamedDirection = 0; streamedDirection
 		 < NUMVECTORS; ++streamedDirection) {
 	    unsigned oppDirection = LATTICE::INVERSEDIRECTIONS[streamedDirection];
 
 	    // Index of the site streaming to streamedToSite via direction streamedDirection
-	    site_t streamerIndex = streamedSite.GetStreamedIndex<LATTICE> (oppDirection);
+	    site_t streamerIndex = access.GetStreamedIndex<LATTICE>(streamedToSite, oppDirection);
 
 	    // Is streamerIndex a valid index?
 	    if (streamerIndex >= 0 && streamerIndex < (NUMVECTORS * dom->GetLocalFluidSiteCount())) {
@@ -332,6 +338,9 @@ namespace hemelb::tests
 	}
       }
 
+      // GZS and Junk & Yang read fOld after streaming, which the
+      // in-place (AA) pattern has overwritten, so aren't built with it.
+      if constexpr (!geometry::SINGLE_BUFFER_STREAMING) {
       SECTION("GuoZhengShi") {
     using GZS = StreamerTypeFactory<GuoZhengShiLink<COLLISION>, NullLink<COLLISION>>;
 	GZS guoZhengShi(initParams);
@@ -397,7 +406,7 @@ namespace hemelb::tests
 		if (assignedWallDistance < 0.75) {
 		  // This is the second method for estimating: using
 		  // the next fluid site away from the wall.
-		  const site_t nextSiteAwayFromWall = streamer.GetStreamedIndex<LATTICE> (streamedDirection) / NUMVECTORS;
+		  const site_t nextSiteAwayFromWall = access.GetStreamedIndex<LATTICE>(chosenSite, streamedDirection) / NUMVECTORS;
 		  const auto& nextSiteAway = latDat->GetSite(nextSiteAwayFromWall);
 		  distribn_t nextSiteOutFOld[NUMVECTORS];
 		  LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(nextSiteAwayFromWall,
@@ -434,7 +443,7 @@ namespace hemelb::tests
 		// Perform collision on the wall f's
 		distribn_t prediction = fEqm[streamedDirection] + (1.0 + lbmParams.GetOmega()) * fNeqWall;
 		// This is the answer from the code we're testing
-		distribn_t streamedFNew = latDat->GetFNew(NUMVECTORS * chosenSite)[streamedDirection];
+		distribn_t streamedFNew = *latDat->GetFNew<LATTICE>(chosenSite, streamedDirection);
 		REQUIRE(apprx(prediction) == streamedFNew);
 		break;
 	      }
@@ -448,7 +457,7 @@ namespace hemelb::tests
 		Direction inv = LATTICE::INVERSEDIRECTIONS[streamedDirection];
 		distribn_t prediction = streamerHydroVars.GetFPostCollision()[inv];
 		// This is the answer from the code we're testing
-		distribn_t streamedFNew = latDat->GetFNew(NUMVECTORS * chosenSite)[streamedDirection];
+		distribn_t streamedFNew = *latDat->GetFNew<LATTICE>(chosenSite, streamedDirection);
 		REQUIRE(apprx(prediction) == streamedFNew);
 	      } else {
 		// It's GZS with extrapolation from this site only
@@ -470,7 +479,7 @@ namespace hemelb::tests
 		// Perform collision on the wall f's
 		distribn_t prediction = fEqm[streamedDirection] + (1.0 + lbmParams.GetOmega()) * fNeqWall;
 		// This is the answer from the code we're testing
-		distribn_t streamedFNew = latDat->GetFNew(NUMVECTORS * chosenSite)[streamedDirection];
+		distribn_t streamedFNew = *latDat->GetFNew<LATTICE>(chosenSite, streamedDirection);
 		REQUIRE(apprx(prediction) == streamedFNew);
 	      }
 	      break;
@@ -480,7 +489,7 @@ namespace hemelb::tests
 
 	    default:
 	      // We have nothing to do with a wall so simple streaming
-	      const site_t streamedIndex = streamer.GetStreamedIndex<LATTICE> (streamedDirection);
+	      const site_t streamedIndex = access.GetStreamedIndex<LATTICE>(chosenSite, streamedDirection);
 	      distribn_t streamedToFNew = *latDat->GetFNew(streamedIndex);
 
 	      // F_new should be equal to the value that was streamed
@@ -563,7 +572,7 @@ namespace hemelb::tests
 	for (site_t wallSiteLocalIndex = 0; wallSiteLocalIndex < wallSitesCount; wallSiteLocalIndex++) {
 	  site_t streamedToSite = firstWallSite + wallSiteLocalIndex;
 	  const auto streamedSite = latDat->GetSite(streamedToSite);
-	  distribn_t* streamedToFNew = latDat->GetFNew(NUMVECTORS * streamedToSite);
+	  auto const streamedToFNew = std::as_const(*latDat).GetFNew<LATTICE>(streamedToSite);
 
 	  for (unsigned int streamedDirection = 0;
 	       streamedDirection < NUMVECTORS; ++streamedDirection) {
@@ -571,7 +580,7 @@ namespace hemelb::tests
 
 	    // Index of the site streaming to streamedToSite via
 	    // direction streamedDirection
-	    site_t streamerIndex = streamedSite.GetStreamedIndex<LATTICE> (oppDirection);
+	    site_t streamerIndex = access.GetStreamedIndex<LATTICE>(streamedToSite, oppDirection);
 
 	    // Is streamerIndex a valid index?
 	    if (streamerIndex >= 0 &&
@@ -621,6 +630,8 @@ namespace hemelb::tests
 	    }
 	  }
 	}
+      }
+
       }
 
         SECTION("NashZerothOrderPressureIolet") {
@@ -673,7 +684,7 @@ namespace hemelb::tests
 	    normalCollision->Collide(&lbmParams, streamerHydroVars);
 
 	    // Calculate the streamed-to index.
-	    const site_t streamedIndex = streamer.GetStreamedIndex<LATTICE> (streamedDirection);
+	    const site_t streamedIndex = access.GetStreamedIndex<LATTICE>(chosenSite, streamedDirection);
 
 	    // Check that simple collide and stream has happened when
 	    // appropriate.  Is streamerIndex a valid index? (And is
@@ -682,7 +693,7 @@ namespace hemelb::tests
 	    if (!streamer.HasIolet(streamedDirection)
 		&& streamedIndex >= 0
 		&& streamedIndex < (NUMVECTORS * dom->GetLocalFluidSiteCount())) {
-	      distribn_t streamedToFNew = *latDat->GetFNew(streamedIndex);
+	      distribn_t streamedToFNew = *latDat->GetFNew<LATTICE>(streamedIndex / NUMVECTORS, streamedIndex % NUMVECTORS);
 
 	      // F_new should be equal to the value that was streamed
 	      // from this other site in the same direction as we're
@@ -714,7 +725,7 @@ namespace hemelb::tests
 							ghostSiteMomentum,
 							ghostPostCollision);
 
-	      REQUIRE(latDat->GetFNew(chosenSite * NUMVECTORS)[chosenUnstreamedDirection]
+	      REQUIRE(*latDat->GetFNew<LATTICE>(chosenSite, chosenUnstreamedDirection)
 		      == apprx(ghostPostCollision[chosenUnstreamedDirection]));
 	    }
 	  }
@@ -774,7 +785,7 @@ namespace hemelb::tests
 	    normalCollision->Collide(&lbmParams, streamerHydroVars);
 
 	    // Calculate the streamed-to index.
-	    const site_t streamedIndex = streamer.GetStreamedIndex<LATTICE> (streamedDirection);
+	    const site_t streamedIndex = access.GetStreamedIndex<LATTICE>(chosenSite, streamedDirection);
 
 	    // Check that simple collide and stream has happened when
 	    // appropriate.  Is streamerIndex a valid index? (And is
@@ -784,7 +795,7 @@ namespace hemelb::tests
 		&& !streamer.HasWall(streamedDirection)
 		&& streamedIndex >= 0
 		&& streamedIndex < (NUMVECTORS * dom->GetLocalFluidSiteCount())) {
-	      distribn_t streamedToFNew = *latDat->GetFNew(streamedIndex);
+	      distribn_t streamedToFNew = *latDat->GetFNew<LATTICE>(streamedIndex / NUMVECTORS, streamedIndex % NUMVECTORS);
 
 	      // F_new should be equal to the value that was streamed
 	      // from this other site in the same direction as we're
@@ -795,9 +806,12 @@ namespace hemelb::tests
 
 	    Direction inverseDirection = LATTICE::INVERSEDIRECTIONS[streamedDirection];
 
-	    // Check the case by a wall.
-	    if (streamer.HasWall(streamedDirection)) {
-	      distribn_t streamedToFNew = *latDat->GetFNew(NUMVECTORS * chosenSite + inverseDirection);
+	    // Check the case by a wall. The wall we added cuts a link to
+	    // another fluid site; in-place streaming only keeps the
+	    // bounced-back value at home for links that leave the fluid.
+	    if (streamer.HasWall(streamedDirection)
+		&& !(geometry::SINGLE_BUFFER_STREAMING && streamedDirection == chosenWallDirection)) {
+	      distribn_t streamedToFNew = *latDat->GetFNew<LATTICE>(chosenSite, inverseDirection);
 
 	      REQUIRE(apprx(streamerHydroVars.GetFPostCollision()[streamedDirection])
 		      == streamedToFNew);
@@ -826,11 +840,78 @@ namespace hemelb::tests
 							ghostSiteMomentum,
 							ghostPostCollision);
 
-	      REQUIRE(latDat->GetFNew(chosenSite * NUMVECTORS)[chosenUnstreamedDirection]
+	      REQUIRE(*latDat->GetFNew<LATTICE>(chosenSite, chosenUnstreamedDirection)
 		      == apprx(ghostPostCollision[chosenUnstreamedDirection]));
 	    }
 	  }
 	}
       }
     }
+
+    // Several steps of collision with bounce-back on every link
+    // leaving the cube, checked against a plain two-array update
+    // done here. This covers both streaming patterns: with in-place
+    // (AA) streaming the distributions are stored in alternating
+    // places, but what each site collides next must be the same.
+    TEST_CASE_METHOD(public helpers::FourCubeBasedTestFixture<>, "StreamingMatchesTwoArrayReference") {
+        using LATTICE = lb::D3Q15;
+        using KERNEL = lb::LBGK<LATTICE>;
+        using COLLISION = lb::Normal<KERNEL>;
+        using SBB = StreamerTypeFactory<BounceBackLink<COLLISION>, BounceBackLink<COLLISION>>;
+        constexpr auto NUMVECTORS = LATTICE::NUMVECTORS;
+
+        lb::MacroscopicPropertyCache propertyCache(*simState, *dom);
+        COLLISION collision(initParams);
+        SBB streamer(initParams);
+        helpers::LatticeDataAccess access(latDat.get());
+
+        auto const nDist = dom->GetLocalDistributionCount();
+        // Reference distributions, indexed as in the domain; the
+        // extra entry is the rubbish site.
+        std::vector<distribn_t> refOld(nDist + 1), refNew(nDist + 1);
+        LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(*latDat);
+        for (site_t i = 0; i < numSites; ++i) {
+            distribn_t f[NUMVECTORS];
+            LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(i, f);
+            for (Direction d = 0; d < NUMVECTORS; ++d)
+                refOld[dom->GetDistributionIndex<LATTICE>(i, d)] = f[d];
+        }
+
+        // An odd number of steps leaves the in-place pattern mid-cycle.
+        for (int step = 0; step < 5; ++step) {
+            streamer.StreamAndCollide(0, numSites, &lbmParams, *latDat, propertyCache);
+            latDat->CopyReceived();
+            streamer.PostStep(0, numSites, &lbmParams, *latDat, propertyCache);
+            latDat->SwapOldAndNew();
+
+            for (site_t i = 0; i < numSites; ++i) {
+                auto const site = latDat->GetSite(i);
+                distribn_t f[NUMVECTORS];
+                for (Direction d = 0; d < NUMVECTORS; ++d)
+                    f[d] = refOld[dom->GetDistributionIndex<LATTICE>(i, d)];
+                lb::HydroVars<KERNEL> hydroVars(f);
+                hydroVars.tau = lbmParams.GetTau();
+                collision.CalculatePreCollision(hydroVars, site);
+                collision.Collide(&lbmParams, hydroVars);
+                for (Direction d = 0; d < NUMVECTORS; ++d) {
+                    auto const dest = access.GetStreamedIndex<LATTICE>(i, d);
+                    if (dest < nDist) {
+                        refNew[dest] = hydroVars.GetFPostCollision()[d];
+                    } else {
+                        REQUIRE((site.HasWall(d) || site.HasIolet(d)));
+                        refNew[dom->GetDistributionIndex<LATTICE>(i, LATTICE::INVERSEDIRECTIONS[d])] =
+                                hydroVars.GetFPostCollision()[d];
+                    }
+                }
+            }
+            refOld.swap(refNew);
+
+            for (site_t i = 0; i < numSites; ++i)
+                for (Direction d = 0; d < NUMVECTORS; ++d) {
+                    INFO("step " << step << " site " << i << " direction " << d);
+                    REQUIRE(*latDat->GetFOld<LATTICE>(i, d)
+                            == Approx(refOld[dom->GetDistributionIndex<LATTICE>(i, d)]).margin(allowedError));
+                }
+        }
+    }
 }
@@ -126,11 +126,13 @@ namespace hemelb::tests
                         LatticeVector pos(i, j, k);
                         site_t siteIdx = dom->GetContiguousSiteId(pos);
                         //geometry::Site < geometry::domain_type > site = latDat->GetSite(siteIdx);
-                        auto fOld = Lattice::mut_span{latDat->GetFNew(siteIdx * Lattice::NUMVECTORS), Lattice::NUMVECTORS};
+                        Lattice::FArray fOld;
                         LatticeDensity rho = GetDensity(pos);
                         LatticeVelocity u = GetVelocity(pos);
                         u *= rho;
                         Lattice::CalculateFeq(rho, u, fOld);
+                        for (Direction p = 0; p < Lattice::NUMVECTORS; ++p)
+                            *latDat->GetFNew<Lattice>(siteIdx, p) = fOld[p];
                     }
                 }
             }
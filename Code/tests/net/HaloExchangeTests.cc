@@ -0,0 +1,62 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <memory>
+#include <set>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "net/HaloExchange.h"
+
+namespace hemelb::tests
+{
+    using namespace hemelb::net;
+
+    // Exchange with the neighbouring ranks in a ring (just ourself when
+    // running on one), for a few steps, swapping the send and receive
+    // arrays each step as the LB does with separate old and new
+    // distributions.
+    TEMPLATE_TEST_CASE("HaloExchange swaps blocks with ring neighbours", "[net]",
+                       PersistentHaloExchange, NeighbourHaloExchange) {
+        auto world = MpiCommunicator::World();
+        int const rank = world.Rank();
+        int const size = world.Size();
+
+        std::set<int> const neighbourSet{(rank + size - 1) % size, (rank + 1) % size};
+        std::vector<int> const neighbours(neighbourSet.begin(), neighbourSet.end());
+
+        // The same number goes each way between a pair of ranks
+        auto const count = [](int i, int j) { return 2 + (i + j) % 3; };
+        auto const message = [](int from, int to, int k, int step) {
+            return distribn_t(1000 * step + 100 * from + 10 * to + k);
+        };
+
+        std::vector<HaloBlock> blocks;
+        int total = 0;
+        for (auto n: neighbours) {
+            blocks.push_back({n, total, count(rank, n)});
+            total += count(rank, n);
+        }
+
+        std::unique_ptr<HaloExchange> halo = std::make_unique<TestType>(world, blocks);
+        std::vector<distribn_t> a(total), b(total);
+        for (int step = 0; step < 4; ++step) {
+            auto& send = step % 2 ? b : a;
+            auto& recv = step % 2 ? a : b;
+            for (auto const& blk: blocks)
+                for (int k = 0; k < blk.Count; ++k)
+                    send[blk.Offset + k] = message(rank, blk.Rank, k, step);
+            std::fill(recv.begin(), recv.end(), -1.0);
+
+            halo->Start(send.data(), recv.data());
+            halo->Test();
+            halo->Wait();
+
+            for (auto const& blk: blocks)
+                for (int k = 0; k < blk.Count; ++k)
+                    REQUIRE(recv[blk.Offset + k] == message(blk.Rank, rank, k, step));
+        }
+    }
+}
@@ -6,6 +6,9 @@
 #include <catch2/catch.hpp>
 
 #include "net/mpi.h"
+#include "net/net.h"
+#include "net/IOCommunicator.h"
+#include "net/MpiWindow.h"
 
 namespace hemelb
 {
@@ -45,5 +48,50 @@ namespace hemelb
 	REQUIRE(commWorld2 != commWorld);
       }
     }
+
+    TEST_CASE("Net::Progress completes point-to-point requests") {
+      MpiCommunicator commWorld = MpiCommunicator::World();
+      Net net(commWorld);
+      int const rank = commWorld.Rank();
+
+      double const sent = 42.0 + rank;
+      double received = 0.0;
+      net.RequestReceiveR(received, rank);
+      net.RequestSendR(sent, rank);
+      net.Receive();
+      net.Send();
+
+      // A message to ourselves doesn't depend on any other process
+      bool done = false;
+      for (int i = 0; i < 1000 && !done; ++i)
+        done = net.Progress();
+      REQUIRE(done);
+
+      net.Wait();
+      REQUIRE(received == sent);
+    }
+
+    TEST_CASE("WinData::Shared gives the node one copy of the leader's data") {
+      IOCommunicator comms(MpiCommunicator::World());
+      auto const& nodeComm = comms.GetNodeComm();
+
+      // Only the leader's values count.
+      std::vector<int> vals;
+      if (comms.AmNodeLeader())
+	vals = {3, 1, 4, 1, 5};
+      else
+	vals = {-1};
+      auto win = WinData<int>::Shared(vals, nodeComm);
+
+      auto const shared = win.Span();
+      REQUIRE(shared.size() == 5);
+      REQUIRE(shared[2] == 4);
+      // Every rank on the node views the same memory, so sees a
+      // change the leader makes.
+      if (comms.AmNodeLeader())
+	shared[0] = 9;
+      win.Fence();
+      REQUIRE(shared[0] == 9);
+    }
   }
 }
@@ -0,0 +1,103 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UTIL_SIMD_H
+#define HEMELB_UTIL_SIMD_H
+
+#include <array>
+#include <cstddef>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define HEMELB_HAVE_STD_SIMD
+#endif
+
+namespace hemelb::util::simd
+{
+#ifdef HEMELB_HAVE_STD_SIMD
+    namespace stdx = std::experimental;
+
+    // A pack of doubles as wide as the target's vector registers
+    // (e.g. 4 with AVX2, 8 with AVX-512), as chosen by the compiler
+    // flags.
+    using Vec = stdx::native_simd<double>;
+
+    inline Vec Load(double const* p)
+    {
+        return Vec(p, stdx::element_aligned);
+    }
+
+    inline void Store(Vec const& v, double* p)
+    {
+        v.copy_to(p, stdx::element_aligned);
+    }
+#else
+    // Fallback for standard libraries without the Parallelism TS:
+    // a fixed-size pack whose element-wise loops the compiler can
+    // vectorise.
+    class Vec
+    {
+        static constexpr std::size_t N = 4;
+        std::array<double, N> x;
+
+    public:
+        static constexpr std::size_t size()
+        {
+            return N;
+        }
+
+        Vec() = default;
+
+        Vec(double v)
+        {
+            x.fill(v);
+        }
+
+        double& operator[](std::size_t i)
+        {
+            return x[i];
+        }
+        double operator[](std::size_t i) const
+        {
+            return x[i];
+        }
+
+#define HEMELB_SIMD_FALLBACK_OP(OP) \
+        Vec& operator OP##=(Vec const& o) { for (std::size_t i = 0; i < N; ++i) x[i] OP##= o.x[i]; return *this; } \
+        friend Vec operator OP(Vec a, Vec const& b) { return a OP##= b; }
+        HEMELB_SIMD_FALLBACK_OP(+)
+        HEMELB_SIMD_FALLBACK_OP(-)
+        HEMELB_SIMD_FALLBACK_OP(*)
+        HEMELB_SIMD_FALLBACK_OP(/)
+#undef HEMELB_SIMD_FALLBACK_OP
+
+        friend Vec operator-(Vec a)
+        {
+            for (auto& ai: a.x)
+                ai = -ai;
+            return a;
+        }
+    };
+
+    inline Vec Load(double const* p)
+    {
+        Vec ans;
+        for (std::size_t i = 0; i < Vec::size(); ++i)
+            ans[i] = p[i];
+        return ans;
+    }
+
+    inline void Store(Vec const& v, double* p)
+    {
+        for (std::size_t i = 0; i < Vec::size(); ++i)
+            p[i] = v[i];
+    }
+#endif
+
+    // Number of doubles in a Vec
+    inline constexpr std::size_t WIDTH = Vec::size();
+}
+
+#endif // HEMELB_UTIL_SIMD_H
@@ -0,0 +1,24 @@
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+include_guard()
+
+find_file(LZ4_TARBALL lz4-1.9.4.tar.gz
+  DOC "Path to download LZ4 (can be url http://)"
+  PATHS ${HEMELB_DEPENDENCIES_PATH}/distributions
+  )
+if(NOT LZ4_TARBALL)
+  message("No LZ4 source found, will download.")
+  set(LZ4_TARBALL https://github.com/lz4/lz4/releases/download/v1.9.4/lz4-1.9.4.tar.gz
+    CACHE STRING "Path to download LZ4 (can be local file://)" FORCE)
+endif()
+ExternalProject_Add(
+  dep_LZ4
+  INSTALL_DIR ${HEMELB_DEPENDENCIES_INSTALL_PREFIX}
+  URL ${LZ4_TARBALL}
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND make -j${HEMELB_SUBPROJECT_MAKE_JOBS} lib
+  INSTALL_COMMAND make install PREFIX=<INSTALL_DIR>
+  BUILD_IN_SOURCE 1
+)
@@ -0,0 +1,12 @@
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+include_guard()
+
+# LZ4 doesn't install a CMake package everywhere, but does a
+# pkg-config file. Provides the target PkgConfig::LZ4.
+find_package(PkgConfig ${DEPS_FIND_MODE_LZ4})
+if(PkgConfig_FOUND)
+  pkg_check_modules(LZ4 ${DEPS_FIND_MODE_LZ4} IMPORTED_TARGET liblz4)
+endif()
@@ -0,0 +1,24 @@
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+include_guard()
+
+find_file(ZSTD_TARBALL zstd-1.5.5.tar.gz
+  DOC "Path to download Zstd (can be url http://)"
+  PATHS ${HEMELB_DEPENDENCIES_PATH}/distributions
+  )
+if(NOT ZSTD_TARBALL)
+  message("No Zstd source found, will download.")
+  set(ZSTD_TARBALL https://github.com/facebook/zstd/releases/download/v1.5.5/zstd-1.5.5.tar.gz
+    CACHE STRING "Path to download Zstd (can be local file://)" FORCE)
+endif()
+ExternalProject_Add(
+  dep_Zstd
+  INSTALL_DIR ${HEMELB_DEPENDENCIES_INSTALL_PREFIX}
+  URL ${ZSTD_TARBALL}
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND make -j${HEMELB_SUBPROJECT_MAKE_JOBS} -C lib libzstd
+  INSTALL_COMMAND make -C lib install PREFIX=<INSTALL_DIR>
+  BUILD_IN_SOURCE 1
+)
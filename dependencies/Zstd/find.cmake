@@ -0,0 +1,12 @@
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+include_guard()
+
+# Zstd only installs a CMake package when built with CMake, but always
+# a pkg-config file. Provides the target PkgConfig::Zstd.
+find_package(PkgConfig ${DEPS_FIND_MODE_Zstd})
+if(PkgConfig_FOUND)
+  pkg_check_modules(Zstd ${DEPS_FIND_MODE_Zstd} IMPORTED_TARGET libzstd)
+endif()
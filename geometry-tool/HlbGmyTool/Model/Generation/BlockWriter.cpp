@@ -7,14 +7,21 @@
 
 #include <zlib.h>
 
+#ifdef HEMELB_USE_LZ4
+#include <lz4hc.h>
+#endif
+#ifdef HEMELB_USE_ZSTD
+#include <zstd.h>
+#endif
+
 #include "BlockWriter.h"
 #include "BufferPool.h"
 #include "GenerationError.h"
 #include "GeometryWriter.h"
 #include "Neighbours.h"
 
-BlockWriter::BlockWriter(BufferPool* bp)
-    : writer(NULL), buffer(NULL), bufferPool(bp) {
+BlockWriter::BlockWriter(BufferPool* bp, Codec c)
+    : writer(NULL), buffer(NULL), bufferPool(bp), codec(c) {
   this->Reset();
 }
 
@@ -47,50 +54,23 @@ void BlockWriter::Finish() {
   this->UncompressedBlockLength = 0;
 
   if (this->nFluidSites > 0) {
-    int ret;  // zlib return code
-
     // How much data to compress?
     this->UncompressedBlockLength = this->writer->getCurrentStreamPosition();
 
-    // Set up our compressor
-    z_stream stream;
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
-    // Max compression
-    ret = deflateInit(&stream, 9);
-    if (ret != Z_OK)
-      throw GenerationErrorMessage("Cannot init zlib structures");
-
-    //		// Compute upper bound for how much space we'll need.
-    //		int maxDeflatedLength = deflateBound(&stream,
-    //				this->UncompressedBlockLength);
-    char* compressedBuffer = this->bufferPool->New();
-
-    // Set input. The XDR buffer has to be char but zlib only works with
-    // unsigned char. Just cast for now...
-    stream.next_in = reinterpret_cast<unsigned char*>(this->buffer);
-    stream.avail_in = this->UncompressedBlockLength;
-    // Set output
-    stream.next_out = reinterpret_cast<unsigned char*>(compressedBuffer);
-    stream.avail_out = this->bufferPool->GetSize();
-
-    // Deflate. This should be it, if not their was an error.
-    ret = deflate(&stream, Z_FINISH);
-    if (ret != Z_STREAM_END)
-      throw GenerationErrorMessage("Error compressing buffer");
-
-    // How much space did we actually use?
-    this->CompressedBlockLength =
-        reinterpret_cast<char*>(stream.next_out) - compressedBuffer;
-
-    // Tell zlib to clean up.
-    ret = deflateEnd(&stream);
-    if (ret != Z_OK)
-      throw GenerationErrorMessage("Cannot free zlib structures");
-
-    std::swap(this->buffer, compressedBuffer);
-    this->bufferPool->Free(compressedBuffer);
+    switch (this->codec) {
+      case Codec::ZLIB:
+        this->Deflate();
+        break;
+      case Codec::NONE:
+        this->CompressedBlockLength = this->UncompressedBlockLength;
+        break;
+      case Codec::LZ4:
+      case Codec::ZSTD:
+        this->CompressWithLibrary();
+        break;
+      default:
+        throw GenerationErrorMessage("Unknown block codec");
+    }
   } else {
     this->bufferPool->Free(this->buffer);
     this->buffer = NULL;
@@ -101,6 +81,84 @@ void BlockWriter::Finish() {
   this->IsFinished = true;
 }
 
+void BlockWriter::CompressWithLibrary() {
+  char* compressedBuffer = this->bufferPool->New();
+  [[maybe_unused]] int const capacity = this->bufferPool->GetSize();
+  // Max compression, as for zlib. Both return zero or an error code on
+  // failure, including when the output doesn't fit in the buffer.
+  if (this->codec == Codec::LZ4) {
+#ifdef HEMELB_USE_LZ4
+    int const n = LZ4_compress_HC(this->buffer, compressedBuffer,
+                                  this->UncompressedBlockLength, capacity,
+                                  LZ4HC_CLEVEL_MAX);
+    if (n <= 0)
+      throw GenerationErrorMessage("Error compressing buffer");
+    this->CompressedBlockLength = n;
+#else
+    throw GenerationErrorMessage("Built without LZ4 support");
+#endif
+  } else {
+#ifdef HEMELB_USE_ZSTD
+    // Higher levels are much slower for little gain on blocks this small
+    constexpr int ZSTD_LEVEL = 19;
+    std::size_t const n =
+        ZSTD_compress(compressedBuffer, capacity, this->buffer,
+                      this->UncompressedBlockLength, ZSTD_LEVEL);
+    if (ZSTD_isError(n))
+      throw GenerationErrorMessage("Error compressing buffer");
+    this->CompressedBlockLength = n;
+#else
+    throw GenerationErrorMessage("Built without Zstd support");
+#endif
+  }
+  std::swap(this->buffer, compressedBuffer);
+  this->bufferPool->Free(compressedBuffer);
+}
+
+void BlockWriter::Deflate() {
+  int ret;  // zlib return code
+
+  // Set up our compressor
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  // Max compression
+  ret = deflateInit(&stream, 9);
+  if (ret != Z_OK)
+    throw GenerationErrorMessage("Cannot init zlib structures");
+
+  //		// Compute upper bound for how much space we'll need.
+  //		int maxDeflatedLength = deflateBound(&stream,
+  //				this->UncompressedBlockLength);
+  char* compressedBuffer = this->bufferPool->New();
+
+  // Set input. The XDR buffer has to be char but zlib only works with
+  // unsigned char. Just cast for now...
+  stream.next_in = reinterpret_cast<unsigned char*>(this->buffer);
+  stream.avail_in = this->UncompressedBlockLength;
+  // Set output
+  stream.next_out = reinterpret_cast<unsigned char*>(compressedBuffer);
+  stream.avail_out = this->bufferPool->GetSize();
+
+  // Deflate. This should be it, if not their was an error.
+  ret = deflate(&stream, Z_FINISH);
+  if (ret != Z_STREAM_END)
+    throw GenerationErrorMessage("Error compressing buffer");
+
+  // How much space did we actually use?
+  this->CompressedBlockLength =
+      reinterpret_cast<char*>(stream.next_out) - compressedBuffer;
+
+  // Tell zlib to clean up.
+  ret = deflateEnd(&stream);
+  if (ret != Z_OK)
+    throw GenerationErrorMessage("Cannot free zlib structures");
+
+  std::swap(this->buffer, compressedBuffer);
+  this->bufferPool->Free(compressedBuffer);
+}
+
 void BlockWriter::Write(GeometryWriter& gw) {
   if (this->nFluidSites > 0) {
     if (this->buffer == NULL)
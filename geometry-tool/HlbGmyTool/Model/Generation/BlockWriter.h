@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 #include <string>
+#include "io/formats/geometry.h"
 #include "io/writers/XdrMemWriter.h"
 
 class GeometryWriter;
@@ -20,7 +21,9 @@ class BufferPool;
 
 class BlockWriter {
  public:
-  BlockWriter(BufferPool* bp);
+  using Codec = hemelb::io::formats::geometry::Codec;
+
+  BlockWriter(BufferPool* bp, Codec codec);
   void Reset();
 
   ~BlockWriter();
@@ -38,9 +41,15 @@ class BlockWriter {
   }
 
  protected:
+  // Compress the buffer with zlib
+  void Deflate();
+  // Compress the buffer with LZ4 or Zstd
+  void CompressWithLibrary();
+
   char* buffer;
   hemelb::io::XdrMemWriter* writer;
   BufferPool* bufferPool;
+  Codec codec;
   unsigned int nFluidSites;
   unsigned int CompressedBlockLength;
   unsigned int UncompressedBlockLength;
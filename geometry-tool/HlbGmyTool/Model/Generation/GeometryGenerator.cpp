@@ -39,7 +39,7 @@ void GeometryGenerator::Execute(bool skipNonIntersectingBlocks) {
   Domain domain(this->OriginWorking, this->SiteCounts);
 
   GeometryWriter writer(this->OutputGeometryFile, domain.GetBlockSize(),
-                        domain.GetBlockCounts());
+                        domain.GetBlockCounts(), this->BlockCodec);
 
   for (BlockIterator blockIt = domain.begin(); blockIt != domain.end();
        ++blockIt) {
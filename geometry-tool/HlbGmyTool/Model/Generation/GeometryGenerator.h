@@ -11,6 +11,7 @@
 
 #include "GenerationError.h"
 #include "Iolet.h"
+#include "io/formats/geometry.h"
 
 class GeometryWriter;
 class Site;
@@ -30,6 +31,10 @@ class GeometryGenerator {
     this->OutputGeometryFile = val;
   }
 
+  using Codec = hemelb::io::formats::geometry::Codec;
+  inline Codec GetBlockCodec() const { return this->BlockCodec; }
+  inline void SetBlockCodec(Codec val) { this->BlockCodec = val; }
+
   inline std::vector<Iolet>& GetIolets() { return this->Iolets; }
   inline std::vector<Iolet> const& GetIolets() const { return this->Iolets; }
   inline void SetIolets(std::vector<Iolet> iv) { this->Iolets = iv; }
@@ -69,6 +74,7 @@ class GeometryGenerator {
   double OriginWorking[3];
   unsigned SiteCounts[3];
   std::string OutputGeometryFile;
+  Codec BlockCodec = Codec::ZLIB;
   std::vector<Iolet> Iolets;
   virtual int BlockInsideOrOutsideSurface(const Block& block) = 0;
 };
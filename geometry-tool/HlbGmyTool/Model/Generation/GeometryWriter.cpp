@@ -16,8 +16,11 @@ using hemelb::io::formats::geometry;
 
 GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
                                int BlockSize,
-                               Index BlockCounts)
-    : OutputGeometryFile(OutputGeometryFile), BlockSize(BlockSize) {
+                               Index BlockCounts,
+                               Codec BlockCodec)
+    : OutputGeometryFile(OutputGeometryFile),
+      BlockSize(BlockSize),
+      BlockCodec(BlockCodec) {
   this->BlockBufferPool =
       new BufferPool(geometry::GetMaxBlockRecordLength(BlockSize));
 
@@ -47,8 +50,8 @@ GeometryWriter::GeometryWriter(const std::string& OutputGeometryFile,
     // Sites along 1 dimension of a block
     encoder << this->BlockSize;
 
-    // padding
-    encoder << 0U;
+    // How the blocks are compressed (this also pads to 32 bytes)
+    encoder << static_cast<unsigned int>(this->BlockCodec);
     // TODO: Check that buffer length is 32 bytes
 
     // (Dummy) Header
@@ -105,5 +108,5 @@ void GeometryWriter::Close() {
 }
 
 BlockWriter* GeometryWriter::StartNextBlock() {
-  return new BlockWriter(this->BlockBufferPool);
+  return new BlockWriter(this->BlockBufferPool, this->BlockCodec);
 }
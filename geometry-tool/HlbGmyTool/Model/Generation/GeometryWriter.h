@@ -11,6 +11,7 @@
 
 #include "Index.h"
 
+#include "io/formats/geometry.h"
 #include "io/writers/XdrWriter.h"
 using hemelb::io::XdrWriter;
 
@@ -19,9 +20,12 @@ class BufferPool;
 
 class GeometryWriter {
  public:
+  using Codec = hemelb::io::formats::geometry::Codec;
+
   GeometryWriter(const std::string& OutputGeometryFile,
                  int BlockSize,
-                 Index BlockCounts);
+                 Index BlockCounts,
+                 Codec BlockCodec = Codec::ZLIB);
 
   ~GeometryWriter();
 
@@ -32,6 +36,7 @@ class GeometryWriter {
   std::string OutputGeometryFile;
   int BlockSize;
   Index BlockCounts;
+  Codec BlockCodec;
 
   int headerStart;
   XdrWriter* headerEncoder;
@@ -59,6 +59,13 @@ PYBIND11_MODULE(Generation, mod) {
       .def_readwrite("Id", &Iolet::Id)
       .def_readwrite("IsInlet", &Iolet::IsInlet);
 
+  // How the blocks of the GMY are compressed
+  py::enum_<GeometryGenerator::Codec>(mod, "GmyCodec")
+      .value("ZLIB", GeometryGenerator::Codec::ZLIB)
+      .value("NONE", GeometryGenerator::Codec::NONE)
+      .value("LZ4", GeometryGenerator::Codec::LZ4)
+      .value("ZSTD", GeometryGenerator::Codec::ZSTD);
+
   // ABC GeometryGenerator
   auto gmy_gen =
       py::class_<GeometryGenerator>(mod, "GeometryGenerator")
@@ -66,6 +73,8 @@ PYBIND11_MODULE(Generation, mod) {
                &GeometryGenerator::GetOutputGeometryFile)
           .def("SetOutputGeometryFile",
                &GeometryGenerator::SetOutputGeometryFile)
+          .def("GetBlockCodec", &GeometryGenerator::GetBlockCodec)
+          .def("SetBlockCodec", &GeometryGenerator::SetBlockCodec)
           .def("GetIolets", py::overload_cast<>(&GeometryGenerator::GetIolets))
           .def("SetIolets", &GeometryGenerator::SetIolets)
           .def("SetOriginWorking", &GeometryGenerator::SetOriginWorking)
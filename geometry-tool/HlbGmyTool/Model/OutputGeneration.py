@@ -95,6 +95,9 @@ class GeometryGenerator(object):
 
     def _SetCommonGeneratorProperties(self):
         self.generator.SetOutputGeometryFile(str(self._profile.OutputGeometryFile))
+        self.generator.SetBlockCodec(
+            getattr(Generation.GmyCodec, self._profile.GeometryCodec.upper())
+        )
         # # We need to keep a reference to this to make sure it's not GC'ed
         # self.ioletProxies =
         self.generator.SetIolets(self._MakeIoletProxies())
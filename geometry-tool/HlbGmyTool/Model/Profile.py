@@ -54,6 +54,8 @@ class Profile(Observable):
         "SeedPoint": Vector(),
         "OutputGeometryFile": None,
         "OutputXmlFile": None,
+        # How the GMY's blocks are compressed: zlib, none, lz4 or zstd
+        "GeometryCodec": "zlib",
     }
     _UnitChoices = [metre, millimetre, micrometre]
 
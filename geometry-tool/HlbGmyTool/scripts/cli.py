@@ -37,6 +37,13 @@ parser.add_argument(
     help="The voxel size in metres",
     metavar="FLOAT",
 )
+parser.add_argument(
+    "--codec",
+    default=None,
+    choices=["zlib", "none", "lz4", "zstd"],
+    dest="GeometryCodec",
+    help="How to compress the geometry's blocks",
+)
 
 
 def main():
@@ -12,6 +12,8 @@ from . import HemeLbMagicNumber
 ExtractionMagicNumber = 0x78747204
 MainHeaderLength = 60
 TimeStepDataLength = 8
+# In version 6 files, marks a record holding the site positions
+PositionTableTag = 2**64 - 1
 
 
 class FieldSpec:
@@ -30,9 +32,9 @@ class FieldSpec:
 
     """
 
-    def __init__(self, memspec):
+    def __init__(self, memspec, gridType=">i4"):
         # name, XDR dtype, in-memory dtype, length, offset
-        self._filespec = [("grid", ">i4", np.uint32, (3,), 0)]
+        self._filespec = [("grid", gridType, np.uint32, (3,), 0)]
 
         self._memspec = memspec
         return
@@ -123,6 +125,7 @@ class ExtractedPropertyV4Parser:
 class ExtractedPropertyV5Parser:
     TYPECODE_TYPE = [np.float32, np.float64, np.int32, np.uint32, np.int64, np.uint64]
     TYPECODE_STR = [">f4", ">f8", ">i4", ">u4", ">i8", ">u8"]
+    GRID_TYPE = ">i4"
     UNPACK_TYPE = [
         lambda up: up.unpack_float,
         lambda up: up.unpack_double,
@@ -141,7 +144,8 @@ class ExtractedPropertyV5Parser:
             [
                 ("id", None, np.uint64, (), None),
                 ("position", None, np.float32, (3,), None),
-            ]
+            ],
+            self.GRID_TYPE,
         )
         self._dataOffset = [None]
 
@@ -185,10 +189,60 @@ class ExtractedPropertyV5Parser:
         return result
 
 
+class ExtractedPropertyV6Parser(ExtractedPropertyV5Parser):
+    """The field header is as for version 5, but the data are
+    little-endian, each field is one array over the sites and the grid
+    positions are in separate tables.
+    """
+
+    TYPECODE_STR = ["<f4", "<f8", "<i4", "<u4", "<i8", "<u8"]
+    GRID_TYPE = "<u4"
+
+    def GetTableLength(self):
+        """Get the length of a position table record."""
+        return TimeStepDataLength + 12 * self._siteCount
+
+    def GetTimeStepLength(self):
+        """Get the length of a timestep record."""
+        rowLength = self._fieldSpec.GetRecordLength() - 12
+        return TimeStepDataLength + rowLength * self._siteCount
+
+    def parse(self, filename, tableStart, recordStart):
+        result = np.recarray(self._siteCount, dtype=self._fieldSpec.GetMem())
+        if self._siteCount == 0:
+            return result
+
+        # The grid is in the table; the fields follow each other in
+        # the timestep record.
+        fieldStart = recordStart + TimeStepDataLength
+        for (name, fileType, memType, length, offset), dataOffset in zip(
+            self._fieldSpec, self._dataOffset
+        ):
+            if name == "grid":
+                start = tableStart + TimeStepDataLength
+            else:
+                start = fieldStart
+            filedata = np.memmap(
+                filename,
+                dtype=fileType,
+                mode="r",
+                offset=start,
+                shape=(self._siteCount,) + length,
+            )
+            memdata = getattr(result, name)
+            memdata[:] = filedata[:]
+            if dataOffset is not None:
+                memdata += dataOffset
+            if name != "grid":
+                fieldStart += filedata.nbytes
+
+        return result
+
+
 class ExtractedProperty:
     """Represent the contents of a HemeLB property extraction file."""
 
-    HandledVersions = {4, 5}
+    HandledVersions = {4, 5, 6}
 
     def __init__(self, filename):
         """Read the file's headers and determine how many times and which times
@@ -237,10 +291,13 @@ class ExtractedProperty:
         self.fieldCount = decoder.unpack_uint()
         self._fieldHeaderLength = decoder.unpack_uint()
 
+        self.version = version
         if version == 4:
             self.parser = ExtractedPropertyV4Parser(self.fieldCount, self.siteCount)
         elif version == 5:
             self.parser = ExtractedPropertyV5Parser(self.fieldCount, self.siteCount)
+        elif version == 6:
+            self.parser = ExtractedPropertyV6Parser(self.fieldCount, self.siteCount)
         return
 
     def _ReadFieldHeader(self):
@@ -274,6 +331,9 @@ class ExtractedProperty:
         """
         filesize = os.path.getsize(self.filename)
         self._totalHeaderLength = MainHeaderLength + self._fieldHeaderLength
+        if self.version == 6:
+            return self._DetermineTimesV6(filesize)
+
         bodysize = filesize - self._totalHeaderLength
         assert bodysize % self._recordLength == 0, (
             "Extraction file appears to have partial record(s), residual %s / %s , bodysize %s"
@@ -296,6 +356,42 @@ class ExtractedProperty:
 
         return
 
+    def _DetermineTimesV6(self, filesize):
+        """Walk the records of a version 6 file, noting where each
+        timestep's data and the position table for it start.
+        """
+        tableLength = self.parser.GetTableLength()
+        recordLength = self.parser.GetTimeStepLength()
+
+        times = []
+        self._tableStarts = []
+        self._recordStarts = []
+        table = None
+        pos = self._totalHeaderLength
+        while pos < filesize:
+            self._file.seek(pos)
+            tag = int(np.frombuffer(self._file.read(TimeStepDataLength), dtype="<u8")[0])
+            if tag == PositionTableTag:
+                table = pos
+                pos += tableLength
+                continue
+            assert table is not None, "Timestep {} has no position table before it".format(tag)
+            times.append(tag)
+            self._tableStarts.append(table)
+            self._recordStarts.append(pos)
+            pos += recordLength
+
+        assert (
+            pos == filesize
+        ), "Extraction file appears to have partial record(s)"
+        times = np.array(times, dtype=int)
+        assert np.all(
+            np.argsort(times) == np.arange(len(times))
+        ), "Times in extraction file are not monotonically increasing!"
+        self.times = times
+
+        return
+
     def GetByIndex(self, idx):
         """Get the fields by time index."""
         # Attempt to look up the index in the times array to catch any
@@ -339,9 +435,12 @@ class ExtractedProperty:
 
         Fields are as specified in the file with the addition of
         """
-        mapped = self._MemMap(idx)
-
-        answer = self.parser.parse(mapped)
+        if self.version == 6:
+            answer = self.parser.parse(
+                self.filename, self._tableStarts[idx], self._recordStarts[idx]
+            )
+        else:
+            answer = self.parser.parse(self._MemMap(idx))
 
         answer.id = np.arange(self.siteCount)
         answer.position = self.voxelSizeMetres * answer.grid + self.originMetres
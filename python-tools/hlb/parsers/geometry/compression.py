@@ -14,26 +14,57 @@ import zlib
 
 import numpy as np
 
-from .simple import ConfigLoader
+from .simple import ConfigLoader, CODEC_ZLIB, CODEC_NONE, CODEC_LZ4, CODEC_ZSTD
+
+
+def _Compressor(codec):
+    """Return a function bytes -> bytes compressing with the codec.
+    LZ4 and Zstd need the lz4 and zstandard packages.
+    """
+    if codec == CODEC_ZLIB:
+        return lambda data: zlib.compress(data, 9)
+    if codec == CODEC_NONE:
+        return lambda data: data
+    if codec == CODEC_LZ4:
+        import lz4.block
+
+        return lambda data: lz4.block.compress(
+            data, mode="high_compression", compression=12, store_size=False
+        )
+    if codec == CODEC_ZSTD:
+        import zstandard
+
+        cctx = zstandard.ZstdCompressor(level=19)
+        return cctx.compress
+    raise ValueError("Unknown block codec %d" % codec)
+
+
+CODECS = {"zlib": CODEC_ZLIB, "none": CODEC_NONE, "lz4": CODEC_LZ4, "zstd": CODEC_ZSTD}
 
 
 class CompressionBase(ConfigLoader):
-    """Most of the functionality goes here.
+    """Rewrite a geometry file with its blocks compressed with another
+    codec, given by the class attribute OutputCodec unless passed."""
 
-    Subclasses need to override _LoadBlock to actually do the
-    (de)compression."""
+    OutputCodec = CODEC_ZLIB
 
-    def __init__(self, filename, outfilename):
+    def __init__(self, filename, outfilename, codec=None):
         ConfigLoader.__init__(self, filename)
         self.OutputFileName = outfilename
+        if codec is not None:
+            self.OutputCodec = codec
+        self._Compress = _Compressor(self.OutputCodec)
 
     def OnEndPreamble(self):
-        # Copy the preamble
+        # Copy the preamble, except for the codec in its last word
         pos = self.File.tell()
         self.File.seek(0)
 
         self.OutFile = open(self.OutputFileName, "wb")
-        self.OutFile.write(self.File.read(self.PreambleBytes))
+        self.OutFile.write(self.File.read(self.PreambleBytes - 4))
+        packer = xdrlib.Packer()
+        packer.pack_uint(self.OutputCodec)
+        self.OutFile.write(packer.get_buffer())
         self.File.seek(pos)
 
     def OnEndHeader(self):
@@ -53,30 +84,28 @@ class CompressionBase(ConfigLoader):
         self.OutFile.write(packer.get_buffer())
         self.OutFile.close()
 
-
-class Decompressor(CompressionBase):
-    def _LoadBlock(self, domain, bIdx, bIjk):
-        if domain.BlockFluidSiteCounts[bIjk] == 0:
-            return
-        compressed = self.File.read(self.BlockDataLength[bIjk])
-        uncompressed = zlib.decompress(compressed)
-        self.BlockDataLength[bIjk] = self.BlockUncompressedDataLength[bIjk]
-        self.OutFile.write(uncompressed)
-        return
-
-
-class Compressor(CompressionBase):
     def _LoadBlock(self, domain, bIdx, bIjk):
         if domain.BlockFluidSiteCounts[bIjk] == 0:
             return
-        uncompressed = self.File.read(self.BlockDataLength[bIjk])
-        compressed = zlib.compress(uncompressed)
+        data = self.File.read(self.BlockDataLength[bIjk])
+        uncompressed = self._Decompress(
+            data, int(self.BlockUncompressedDataLength[bIjk])
+        )
+        compressed = self._Compress(uncompressed)
         self.BlockUncompressedDataLength[bIjk] = len(uncompressed)
         self.BlockDataLength[bIjk] = len(compressed)
         self.OutFile.write(compressed)
         return
 
 
+class Decompressor(CompressionBase):
+    OutputCodec = CODEC_NONE
+
+
+class Compressor(CompressionBase):
+    OutputCodec = CODEC_ZLIB
+
+
 def mk_argparser():
     argp = argparse.ArgumentParser()
     argp.add_argument("input")
@@ -85,8 +114,12 @@ def mk_argparser():
 
 
 def compress_main():
-    args = mk_argparser().parse_args()
-    comp = Compressor(args.input, args.output)
+    argp = mk_argparser()
+    argp.add_argument(
+        "--codec", choices=[c for c in CODECS if c != "none"], default="zlib"
+    )
+    args = argp.parse_args()
+    comp = Compressor(args.input, args.output, CODECS[args.codec])
     comp.Load()
 
 
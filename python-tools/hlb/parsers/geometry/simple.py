@@ -33,7 +33,33 @@ class FakeUnpacker(object):
     pass
 
 
-PADDING_BYTE = 0
+# Block codecs, from the last word of the preamble (see
+# Code/io/formats/geometry.h). Files written before there was a choice
+# have zero there, i.e. zlib.
+CODEC_ZLIB = 0
+CODEC_NONE = 1
+CODEC_LZ4 = 2
+CODEC_ZSTD = 3
+
+
+def _Decompressor(codec):
+    """Return a function (data, uncompressed_length) -> bytes for the
+    codec. LZ4 and Zstd need the lz4 and zstandard packages.
+    """
+    if codec == CODEC_ZLIB:
+        return lambda data, n: zlib.decompress(data)
+    if codec == CODEC_NONE:
+        return lambda data, n: data
+    if codec == CODEC_LZ4:
+        import lz4.block
+
+        return lambda data, n: lz4.block.decompress(data, uncompressed_size=n)
+    if codec == CODEC_ZSTD:
+        import zstandard
+
+        dctx = zstandard.ZstdDecompressor()
+        return lambda data, n: dctx.decompress(data, max_output_size=n)
+    raise GeometryParsingError("Unknown block codec %d" % codec)
 
 
 class ConfigLoader(object):
@@ -103,7 +129,7 @@ class ConfigLoader(object):
         1 uints for version number
         3 uints for domain size in blocks
         1 uint for number of sites along one side of a block
-        1 uint of value 0 to pad to 72 bytes
+        1 uint for the block codec (also pads to 32 bytes)
         """
         self.OnBeginPreamble()
 
@@ -142,12 +168,8 @@ class ConfigLoader(object):
         )
         self.Domain.BlockSize = preambleLoader.unpack_uint()
 
-        padding = preambleLoader.unpack_uint()
-        if padding != PADDING_BYTE:
-            raise GeometryParsingError(
-                r"The preamble to this file is padded with the wrong value. Instead of %d, I found %d"
-                % (PADDING_BYTE, padding)
-            )
+        self.Domain.Codec = preambleLoader.unpack_uint()
+        self._Decompress = _Decompressor(self.Domain.Codec)
 
         self.OnEndPreamble()
         return
@@ -220,7 +242,9 @@ class ConfigLoader(object):
             b.Sites = np.zeros(domain.BlockSize**3, dtype=object)
 
             compressed = self.File.read(self.BlockDataLength[bIjk])
-            uncompressed = zlib.decompress(compressed)
+            uncompressed = self._Decompress(
+                compressed, int(self.BlockUncompressedDataLength[bIjk])
+            )
             blockLoader = xdr.Unpacker(uncompressed)
 
             # sl = site local
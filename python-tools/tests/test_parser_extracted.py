@@ -47,3 +47,58 @@ def test_load_xtr(diffTestDir):
     # shearstress is scalar C float
     assert data.shearstress.dtype == np.float32
     assert data.shearstress.shape == (N,)
+
+
+def DummyDataSourceValues(seed, steps, N):
+    """The pressures and velocities of the C++ tests' DummyDataSource
+    at each of its steps, from the same linear congruential generator
+    as tests/helpers/RandomSource.h.
+    """
+    state = np.uint32(seed)
+    norm = np.float32(2**32 - 1)
+
+    def uniform():
+        nonlocal state
+        state = np.uint32((int(state) * 1664525 + 1013904223) % 2**32)
+        return float(np.float32(state) / norm)
+
+    ans = []
+    for _ in range(steps):
+        pressure = np.empty(N)
+        velocity = np.empty((N, 3))
+        for i in range(N):
+            pressure[i] = 80.0 + 2.0 * uniform()
+            for j in range(3):
+                velocity[i, j] = 0.01 * uniform()
+        ans.append((pressure, velocity))
+    return ans
+
+
+def test_load_xtr_v6():
+    # Written by the C++ LocalPropertyOutput tests ("Write version 6
+    # after redistribution"), which check it stays the same. The sites
+    # are reversed after the first timestep, so a second position
+    # table comes before the second.
+    path = os.path.join(
+        os.path.dirname(__file__), "..", "..", "Code", "tests", "resources", "dummy_v6.xtr"
+    )
+    exp = ExtractedProperty(path)
+
+    N = 64
+    assert exp.version == 6
+    assert exp.siteCount == N
+    assert exp.fieldCount == 2
+    assert exp.voxelSizeMetres == 0.3e-3
+    assert np.all(exp.times == [100, 200])
+
+    grid = np.mgrid[:4, :4, :4].reshape(3, N).transpose()
+    origin = np.array([0.034, 0.001, 0.074])
+    values = DummyDataSourceValues(1358, 2, N)
+    for t, order, (pressure, velocity) in zip(exp.times, (grid, grid[::-1]), values):
+        data = exp.GetByTimeStep(t)
+        assert np.all(data.id == np.arange(N))
+        assert np.all(data.grid == order)
+        assert np.allclose(data.position, origin + 0.3e-3 * order)
+        # Pressure is stored relative to 8 mmHg, which the parser adds.
+        assert np.allclose(data.Pressure, pressure)
+        assert np.allclose(data.Velocity, velocity)